@@ -1,5 +1,8 @@
 #include "EventParser.h"
+#include "TradeBatchBuilder.h"
+#include "TradeKey.h"
 #include <benchmark/benchmark.h>
+#include <string>
 #include <vector>
 #include <cstring>
 
@@ -88,3 +91,73 @@ static void BM_CRC32_Calculation(benchmark::State& state) {
     state.SetBytesProcessed(state.iterations() * size);
 }
 BENCHMARK(BM_CRC32_Calculation)->Range(64, 8192);
+
+static void BM_TradeKey_DecodeUuid(benchmark::State& state) {
+    const std::string uuid = "550e8400-e29b-41d4-a716-446655440000";
+
+    for (auto _ : state) {
+        TradeKey key;
+        bool ok = TradeKey::fromUuid(uuid, key);
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(key);
+    }
+}
+BENCHMARK(BM_TradeKey_DecodeUuid);
+
+static std::vector<std::string> tradePayloads(size_t count) {
+    std::vector<std::string> payloads;
+    for (size_t i = 0; i < count; ++i) {
+        payloads.push_back(R"({"trade_id":"T)" + std::to_string(i) +
+                           R"(","account_id":"ACC001","symbol":"AAPL","quantity":)" +
+                           std::to_string(i % 500 + 1) + R"(,"price":150.25,"side":"BUY"})");
+    }
+    return payloads;
+}
+
+// Decode a batch of trade events straight into Arrow columns
+static void BM_TradeBatch_Build(benchmark::State& state) {
+    std::vector<std::string> payloads = tradePayloads(static_cast<size_t>(state.range(0)));
+    std::vector<EventView> views;
+    for (size_t i = 0; i < payloads.size(); ++i) {
+        views.push_back({i + 1, i, EventType::TRADE_CREATED, payloads[i], 0});
+    }
+    TradeBatchBuilder builder(views.size());
+
+    for (auto _ : state) {
+        builder.append(views.data(), views.size());
+        ArrowArray array;
+        ArrowSchema schema;
+        builder.finish(&array, &schema);
+        benchmark::DoNotOptimize(array.length);
+        array.release(&array);
+        schema.release(&schema);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TradeBatch_Build)->Arg(4096);
+
+// Consumer side: sum the quantity column of an exported batch
+static void BM_TradeBatch_SumQuantity(benchmark::State& state) {
+    std::vector<std::string> payloads = tradePayloads(static_cast<size_t>(state.range(0)));
+    TradeBatchBuilder builder(payloads.size());
+    for (size_t i = 0; i < payloads.size(); ++i) {
+        builder.append(EventView{i + 1, i, EventType::TRADE_CREATED, payloads[i], 0});
+    }
+    ArrowArray array;
+    ArrowSchema schema;
+    builder.finish(&array, &schema);
+    auto* quantity = static_cast<const int64_t*>(array.children[7]->buffers[1]);
+
+    for (auto _ : state) {
+        int64_t total = 0;
+        for (int64_t row = 0; row < array.length; ++row) {
+            total += quantity[2 * row];   // Low word; FixedPoint fits in 64 bits
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * array.length);
+    state.SetBytesProcessed(state.iterations() * array.length * 16);
+    array.release(&array);
+    schema.release(&schema);
+}
+BENCHMARK(BM_TradeBatch_SumQuantity)->Arg(1 << 16);
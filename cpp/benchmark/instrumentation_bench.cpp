@@ -0,0 +1,55 @@
+#include "AccountBalanceBook.h"
+#include "Instrumentation.h"
+#include "LatencyHistogram.h"
+#include <benchmark/benchmark.h>
+#include <string>
+
+using namespace trading_ledger;
+
+// Probe overhead on the consumer hot path: the same balance-book update,
+// uninstrumented and wrapped in the probes of each level. The NONE variant
+// should be indistinguishable from the baseline.
+
+static Event createLedgerEvent() {
+    Event event;
+    event.sequence_num = 1;
+    event.timestamp_ns = 1000;
+    event.event_type = EventType::LEDGER_ENTRIES_GENERATED;
+    event.payload =
+        R"({"trade_id":"550e8400-e29b-41d4-a716-446655440000","entries":[)"
+        R"({"account_id":"ACC001","entry_type":"DEBIT","amount":15000.50},)"
+        R"({"account_id":"ACC002","entry_type":"CREDIT","amount":15000.50}]})";
+    return event;
+}
+
+static void BM_Instrumentation_Baseline(benchmark::State& state) {
+    AccountBalanceBook book;
+    Event event = createLedgerEvent();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.applyEvent(event));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Instrumentation_Baseline);
+
+template<InstrumentationLevel Level>
+static void BM_Instrumentation_Level(benchmark::State& state) {
+    AccountBalanceBook book;
+    Event event = createLedgerEvent();
+    LatencyHistogram histogram;
+    BasicProbeCounter<Level> counter;
+
+    for (auto _ : state) {
+        BasicScopedTimer<Level> timer(histogram);
+        benchmark::DoNotOptimize(book.applyEvent(event));
+        counter.add();
+    }
+
+    benchmark::DoNotOptimize(counter.value());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_Instrumentation_Level, InstrumentationLevel::NONE);
+BENCHMARK_TEMPLATE(BM_Instrumentation_Level, InstrumentationLevel::COUNTERS);
+BENCHMARK_TEMPLATE(BM_Instrumentation_Level, InstrumentationLevel::TIMINGS);
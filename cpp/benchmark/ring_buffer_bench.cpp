@@ -1,4 +1,5 @@
 #include "RingBuffer.h"
+#include "NotifyingRingBuffer.h"
 #include <benchmark/benchmark.h>
 #include <thread>
 #include <atomic>
@@ -13,7 +14,7 @@ static void BM_RingBuffer_SingleThreaded(benchmark::State& state) {
 
     for (auto _ : state) {
         buffer.try_push(value);
-        int result;
+        int result = 0;
         buffer.try_pop(result);
         benchmark::DoNotOptimize(result);
     }
@@ -196,7 +197,7 @@ static void BM_RingBuffer_BufferSizeImpact(benchmark::State& state) {
     std::atomic<bool> stop{false};
 
     std::thread consumer([&]() {
-        int item;
+        int item = 0;
         while (!stop.load(std::memory_order_acquire)) {
             buffer.try_pop(item);
             benchmark::DoNotOptimize(item);
@@ -260,4 +261,20 @@ static void BM_RingBuffer_MoveSemantics(benchmark::State& state) {
 }
 BENCHMARK(BM_RingBuffer_MoveSemantics);
 
+// Benchmark: Notification overhead on the push path (consumer never armed)
+static void BM_NotifyingRingBuffer_SingleThreaded(benchmark::State& state) {
+    NotifyingRingBuffer<int, 1024> buffer;
+    int value = 42;
+
+    for (auto _ : state) {
+        buffer.try_push(value);
+        int result = 0;
+        buffer.try_pop(result);
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2);  // push + pop
+}
+BENCHMARK(BM_NotifyingRingBuffer_SingleThreaded);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,365 @@
+#include "ConsumerCore.h"
+#include "CommandLine.h"
+#include "EventFrames.h"
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <malloc.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace trading_ledger;
+using namespace trading_ledger::test;
+
+/**
+ * Long-running soak benchmark
+ *
+ * Drives the event processor's pipeline (readIntoRing -> ring -> consumeRing
+ * on a ConsumerCore: validator, balance book, positions) from a synthetic
+ * writer for a configurable duration, and once per sample interval appends
+ * a CSV row with:
+ *   RSS, virtual size, mapped log size, malloc heap stats, tracked trades,
+ *   interval latency percentiles and throughput.
+ *
+ * At the end, trends are compared between the first and last third of the
+ * run (medians, so a single GC-like spike does not fail the run). Exit code 1
+ * if RSS growth or p99 drift exceed the thresholds. Latency percentiles need
+ * an instrumentation level of TIMINGS or above.
+ *
+ * Usage:
+ *   soak_bench [--duration-sec N] [--sample-sec N] [--rate EVENTS_PER_SEC]
+ *              [--csv PATH] [--log PATH]
+ *              [--max-rss-growth-mb N] [--max-p99-growth-pct N]
+ */
+
+namespace {
+
+struct Options {
+    int duration_sec = 3600;
+    int sample_sec = 60;
+    int rate = 10000;
+    std::string csv_path = "soak_results.csv";
+    std::string log_path = "/tmp/soak_event_log.bin";
+    double max_rss_growth_mb = 256.0;
+    double max_p99_growth_pct = 50.0;
+};
+
+struct Sample {
+    double elapsed_sec = 0;
+    size_t events_written = 0;
+    size_t events_processed = 0;
+    size_t rss_bytes = 0;
+    size_t vm_bytes = 0;
+    size_t log_mapped_bytes = 0;
+    size_t heap_in_use_bytes = 0;
+    size_t heap_arena_bytes = 0;
+    size_t trade_states = 0;
+    size_t interval_events = 0;
+    int64_t p50_ns = 0;
+    int64_t p99_ns = 0;
+    int64_t p999_ns = 0;
+    int64_t max_ns = 0;
+};
+
+std::atomic<bool> g_running{true};
+
+std::string randomUuid(std::mt19937_64& rng) {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    uint64_t hi = rng();
+    uint64_t lo = (rng() & 0x3FFFFFFFFFFFFFFFULL) | 0x8000000000000000ULL;  // RFC 4122 variant
+
+    std::string out;
+    for (int i = 0; i < 32; ++i) {
+        if (i == 8 || i == 12 || i == 16 || i == 20) {
+            out.push_back('-');
+        }
+        uint64_t word = i < 16 ? hi : lo;
+        out.push_back(DIGITS[(word >> (60 - 4 * (i % 16))) & 0xF]);
+    }
+    return out;
+}
+
+/**
+ * Synthetic writer: appends TRADE_CREATED + LEDGER_ENTRIES_GENERATED pairs
+ * at the target rate, in 1ms batches
+ */
+void writerThread(int fd, int rate, std::atomic<size_t>& events_written) {
+    std::mt19937_64 rng(42);
+    static const char* SYMBOLS[] = {"AAPL", "NVDA", "MSFT", "AMZN", "GOOG"};
+
+    uint64_t seq = 0;
+    std::vector<uint8_t> batch;
+    auto start = std::chrono::steady_clock::now();
+
+    while (g_running.load(std::memory_order_acquire)) {
+        double elapsed = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        uint64_t target = static_cast<uint64_t>(elapsed * rate);
+
+        batch.clear();
+        while (seq < target) {
+            std::string trade_id = randomUuid(rng);
+            std::string account = "ACC" + std::to_string(rng() % 1000);
+            int quantity = static_cast<int>(rng() % 1000) + 1;
+
+            std::string trade = R"({"trade_id":")" + trade_id + R"(","account_id":")" + account +
+                                R"(","symbol":")" + SYMBOLS[rng() % 5] +
+                                R"(","quantity":)" + std::to_string(quantity) +
+                                R"(,"price":150.25,"side":"BUY"})";
+            appendFrame(batch, ++seq, EventType::TRADE_CREATED, trade);
+
+            std::string amount = std::to_string(quantity) + ".5";
+            std::string entries = R"({"trade_id":")" + trade_id + R"(","entries":[)"
+                R"({"account_id":")" + account + R"(","entry_type":"DEBIT","amount":)" + amount + "},"
+                R"({"account_id":"CASH","entry_type":"CREDIT","amount":)" + amount + "}]}";
+            appendFrame(batch, ++seq, EventType::LEDGER_ENTRIES_GENERATED, entries);
+        }
+
+        if (!batch.empty()) {
+            const uint8_t* data = batch.data();
+            size_t remaining = batch.size();
+            while (remaining > 0) {
+                ssize_t n = write(fd, data, remaining);
+                if (n <= 0) {
+                    std::cerr << "Soak writer: write failed: " << strerror(errno) << std::endl;
+                    g_running.store(false, std::memory_order_release);
+                    return;
+                }
+                data += n;
+                remaining -= static_cast<size_t>(n);
+            }
+            events_written.store(seq, std::memory_order_relaxed);
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void producerThread(const std::string& log_path, EventRing& ring, PipelineMetrics& metrics,
+                    UpgradeHandoff& upgrade) {
+    try {
+        readIntoRing(log_path, ring, metrics, upgrade);
+    } catch (const std::exception& e) {
+        std::cerr << "Soak producer error: " << e.what() << std::endl;
+        g_running.store(false, std::memory_order_release);
+    }
+}
+
+void consumerThread(EventRing& ring, ConsumerCore& core, UpgradeHandoff& upgrade) {
+    try {
+        consumeRing(ring, core, upgrade);
+    } catch (const std::exception& e) {
+        std::cerr << "Soak consumer error: " << e.what() << std::endl;
+        g_running.store(false, std::memory_order_release);
+    }
+}
+
+size_t fileSize(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+}
+
+void readProcessMemory(size_t& rss_bytes, size_t& vm_bytes) {
+    std::ifstream statm("/proc/self/statm");
+    size_t vm_pages = 0, rss_pages = 0;
+    statm >> vm_pages >> rss_pages;
+
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    rss_bytes = rss_pages * page_size;
+    vm_bytes = vm_pages * page_size;
+}
+
+double median(std::vector<double> values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+bool parseOptions(int argc, char** argv, Options& opts) {
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--duration-sec") {
+                opts.duration_sec = CommandLine::number<int>(argc, argv, i, 1, std::numeric_limits<int>::max());
+            } else if (arg == "--sample-sec") {
+                opts.sample_sec = CommandLine::number<int>(argc, argv, i, 1, std::numeric_limits<int>::max());
+            } else if (arg == "--rate") {
+                opts.rate = CommandLine::number<int>(argc, argv, i, 1, 10000000);
+            } else if (arg == "--csv") {
+                opts.csv_path = CommandLine::value(argc, argv, i);
+            } else if (arg == "--log") {
+                opts.log_path = CommandLine::value(argc, argv, i);
+            } else if (arg == "--max-rss-growth-mb") {
+                opts.max_rss_growth_mb = CommandLine::number<double>(argc, argv, i, 0.0, 1e9);
+            } else if (arg == "--max-p99-growth-pct") {
+                opts.max_p99_growth_pct = CommandLine::number<double>(argc, argv, i, 0.0, 1e9);
+            } else {
+                throw std::invalid_argument("unknown option " + arg);
+            }
+        }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "soak_bench: " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!parseOptions(argc, argv, opts)) {
+        std::cerr << "Usage: soak_bench [--duration-sec N] [--sample-sec N] [--rate N] "
+                     "[--csv PATH] [--log PATH] [--max-rss-growth-mb N] "
+                     "[--max-p99-growth-pct N]" << std::endl;
+        return 2;
+    }
+
+    // Fresh log with file header
+    createLog(opts.log_path);
+    int fd = ::open(opts.log_path.c_str(), O_WRONLY | O_APPEND);
+    if (fd < 0) {
+        std::cerr << "Failed to create " << opts.log_path << ": " << strerror(errno) << std::endl;
+        return 2;
+    }
+
+    std::ofstream csv(opts.csv_path);
+    csv << "elapsed_sec,events_written,events_processed,rss_bytes,vm_bytes,"
+           "log_mapped_bytes,heap_in_use_bytes,heap_arena_bytes,trade_states,"
+           "interval_events,p50_ns,p99_ns,p999_ns,max_ns\n";
+
+    std::cout << "Soak: " << opts.duration_sec << "s at " << opts.rate
+              << " events/sec, sampling every " << opts.sample_sec << "s -> "
+              << opts.csv_path << std::endl;
+
+    // The processor's pipeline, without checkpoints, outputs or upgrades
+    auto ring = std::make_unique<EventRing>();
+    PipelineMetrics metrics;
+    LatencyHistogram latency_histogram;
+    ContinuousQueryEngine queries;
+    EventTap tap;
+    CommandHandoff control([&ring] { ring->wake(); });
+    UpgradeHandoff upgrade(g_running);
+    ConsumerCore core(ConsumerCore::Config{}, metrics, latency_histogram, nullptr, nullptr, queries,
+                      tap, control, upgrade);
+    std::atomic<size_t> events_written{0};
+
+    std::thread writer(writerThread, fd, opts.rate, std::ref(events_written));
+    std::thread producer(producerThread, opts.log_path, std::ref(*ring), std::ref(metrics),
+                         std::ref(upgrade));
+    std::thread consumer(consumerThread, std::ref(*ring), std::ref(core), std::ref(upgrade));
+
+    std::vector<Sample> samples;
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::seconds(opts.duration_sec);
+    auto next_sample = start + std::chrono::seconds(opts.sample_sec);
+
+    while (g_running.load(std::memory_order_acquire) && next_sample <= deadline) {
+        std::this_thread::sleep_until(next_sample);
+        next_sample += std::chrono::seconds(opts.sample_sec);
+
+        // Ask the consumer for its interval percentiles (bounded wait)
+        IntervalLatency interval;
+        bool have_interval = false;
+        metrics.interval_latency.request();
+        for (int i = 0; i < 1000 && !have_interval; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            have_interval = metrics.interval_latency.collect(interval);
+        }
+
+        Sample s;
+        s.elapsed_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        s.events_written = events_written.load(std::memory_order_relaxed);
+        readProcessMemory(s.rss_bytes, s.vm_bytes);
+        s.log_mapped_bytes = fileSize(opts.log_path);   // The reader maps the whole log
+
+        // Core state is read on the consumer thread, between batches
+        try {
+            control.execute([&] {
+                s.events_processed = core.validator().getStats().events_processed;
+                s.trade_states = core.validator().tradeCount();
+                return std::string();
+            }, std::chrono::seconds(1));
+        } catch (const std::exception& e) {
+            std::cerr << "Soak: consumer did not answer: " << e.what() << std::endl;
+        }
+
+        struct mallinfo2 mi = mallinfo2();
+        s.heap_in_use_bytes = mi.uordblks + mi.hblkhd;
+        s.heap_arena_bytes = mi.arena + mi.hblkhd;
+
+        if (have_interval) {
+            s.interval_events = interval.count;
+            s.p50_ns = interval.p50_ns;
+            s.p99_ns = interval.p99_ns;
+            s.p999_ns = interval.p999_ns;
+            s.max_ns = interval.max_ns;
+        }
+
+        csv << s.elapsed_sec << ',' << s.events_written << ',' << s.events_processed << ','
+            << s.rss_bytes << ',' << s.vm_bytes << ',' << s.log_mapped_bytes << ','
+            << s.heap_in_use_bytes << ',' << s.heap_arena_bytes << ',' << s.trade_states << ','
+            << s.interval_events << ',' << s.p50_ns << ',' << s.p99_ns << ','
+            << s.p999_ns << ',' << s.max_ns << '\n';
+        csv.flush();
+
+        std::cout << "Soak t=" << static_cast<int>(s.elapsed_sec) << "s: processed "
+                  << s.events_processed << ", RSS " << (s.rss_bytes >> 20) << " MB, p99 "
+                  << s.p99_ns << " ns, trades " << s.trade_states << std::endl;
+        samples.push_back(s);
+    }
+
+    g_running.store(false, std::memory_order_release);
+    writer.join();
+    producer.join();
+    consumer.join();
+    close(fd);
+    std::remove(opts.log_path.c_str());
+
+    // Trend check: first third vs last third (medians)
+    if (samples.size() < 3) {
+        std::cout << "Soak: too few samples for trend analysis (" << samples.size()
+                  << "), increase --duration-sec or lower --sample-sec" << std::endl;
+        return 0;
+    }
+
+    size_t third = samples.size() / 3;
+    std::vector<double> early_rss, late_rss, early_p99, late_p99;
+    for (size_t i = 0; i < third; ++i) {
+        early_rss.push_back(static_cast<double>(samples[i].rss_bytes));
+        early_p99.push_back(static_cast<double>(samples[i].p99_ns));
+    }
+    for (size_t i = samples.size() - third; i < samples.size(); ++i) {
+        late_rss.push_back(static_cast<double>(samples[i].rss_bytes));
+        late_p99.push_back(static_cast<double>(samples[i].p99_ns));
+    }
+
+    double rss_growth_mb = (median(late_rss) - median(early_rss)) / (1024.0 * 1024.0);
+    double early_p99_median = median(early_p99);
+    double p99_growth_pct = early_p99_median > 0
+        ? (median(late_p99) - early_p99_median) * 100.0 / early_p99_median : 0.0;
+
+    bool rss_ok = rss_growth_mb <= opts.max_rss_growth_mb;
+    bool p99_ok = p99_growth_pct <= opts.max_p99_growth_pct;
+
+    std::cout << "\n=== Soak Trend Summary ===" << std::endl;
+    std::cout << "  RSS growth:   " << rss_growth_mb << " MB (limit "
+              << opts.max_rss_growth_mb << ") " << (rss_ok ? "PASS" : "FAIL") << std::endl;
+    std::cout << "  p99 drift:    " << p99_growth_pct << " % (limit "
+              << opts.max_p99_growth_pct << ") " << (p99_ok ? "PASS" : "FAIL") << std::endl;
+
+    return (rss_ok && p99_ok) ? 0 : 1;
+}
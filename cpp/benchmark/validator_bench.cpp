@@ -0,0 +1,171 @@
+#include "DoubleEntryValidator.h"
+#include "TieredTradeTable.h"
+#include "TradeKeyTable.h"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace trading_ledger;
+
+// Trade-state lookups with large state: one at a time each lookup is a
+// serialized cache miss; batched lookups prefetch a group's slots first.
+// Arg = trades already in the table (64K fits in cache, 4M does not).
+
+static std::vector<TradeKey> randomKeys(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<TradeKey> keys(count);
+    for (TradeKey& key : keys) {
+        key.hi = rng();
+        key.lo = rng() & ~TradeKey::INTERNED_MASK;
+    }
+    return keys;
+}
+
+// Lookup stream: present keys in random order, touching far more slots
+// than fit in cache (a short stream would keep its slots cache-hot)
+static std::vector<TradeKey> lookupStream(const std::vector<TradeKey>& keys) {
+    std::mt19937_64 rng(7);
+    std::vector<TradeKey> stream(1 << 20);
+    for (TradeKey& key : stream) {
+        key = keys[rng() % keys.size()];
+    }
+    return stream;
+}
+
+struct State {
+    double debit_total = 0.0;
+    double credit_total = 0.0;
+    int entry_count = 0;
+    bool created = false;
+};
+
+static void BM_TradeKeyTable_Upsert(benchmark::State& state) {
+    std::vector<TradeKey> keys = randomKeys(static_cast<size_t>(state.range(0)), 1);
+    TradeKeyTable<State> table;
+    for (const TradeKey& key : keys) {
+        table.upsert(key);
+    }
+    std::vector<TradeKey> stream = lookupStream(keys);
+    size_t next = 0;
+
+    for (auto _ : state) {
+        State& s = table.upsert(stream[next]);
+        s.entry_count++;
+        next = (next + 1) & (stream.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TradeKeyTable_Upsert)->Arg(1 << 16)->Arg(1 << 22);
+
+static void BM_TradeKeyTable_UpsertBatch(benchmark::State& state) {
+    std::vector<TradeKey> keys = randomKeys(static_cast<size_t>(state.range(0)), 1);
+    TradeKeyTable<State> table;
+    for (const TradeKey& key : keys) {
+        table.upsert(key);
+    }
+    std::vector<TradeKey> stream = lookupStream(keys);
+    constexpr size_t BATCH = DoubleEntryValidator::MAX_BATCH;
+    State* out[BATCH];
+    size_t next = 0;
+
+    for (auto _ : state) {
+        table.upsertBatch(&stream[next], BATCH, out);
+        for (State* s : out) {
+            s->entry_count++;
+        }
+        next = (next + BATCH) & (stream.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations() * BATCH);
+}
+BENCHMARK(BM_TradeKeyTable_UpsertBatch)->Arg(1 << 16)->Arg(1 << 22);
+
+// Tiered state, 4M trades with 256K hot: a skewed stream (15 of 16 lookups
+// from a 64K working set) against the whole-table TradeKeyTable numbers
+static void BM_TieredTradeTable_UpsertBatch(benchmark::State& state) {
+    std::vector<TradeKey> keys = randomKeys(1 << 22, 1);
+    TieredTradeTable<State> table;
+    table.enableColdTier("/tmp/validator_bench_cold.bin", 1 << 18);
+    for (const TradeKey& key : keys) {
+        table.upsert(key);
+    }
+    std::mt19937_64 rng(7);
+    std::vector<TradeKey> stream(1 << 22);   // Long enough that the cold picks rarely repeat
+    for (TradeKey& key : stream) {
+        key = rng() % 16 != 0 ? keys[rng() % (1 << 16)] : keys[rng() % keys.size()];
+    }
+    constexpr size_t BATCH = DoubleEntryValidator::MAX_BATCH;
+    State* out[BATCH];
+
+    // One pass first: the working set starts cold (inserted earliest)
+    for (size_t next = 0; next < stream.size(); next += BATCH) {
+        table.upsertBatch(&stream[next], BATCH, out);
+    }
+    uint64_t promoted = table.stats().cold.promoted;
+    size_t next = 0;
+
+    for (auto _ : state) {
+        table.upsertBatch(&stream[next], BATCH, out);
+        for (State* s : out) {
+            s->entry_count++;
+        }
+        next = (next + BATCH) & (stream.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations() * BATCH);
+    state.counters["promoted/item"] = static_cast<double>(table.stats().cold.promoted - promoted) /
+                                      static_cast<double>(state.iterations() * BATCH);
+}
+BENCHMARK(BM_TieredTradeTable_UpsertBatch);
+
+// Whole validator: replayed TRADE_CREATED events of known trades (every
+// event takes the duplicate path, so state stays a fixed size)
+class ValidatorFixture {
+public:
+    explicit ValidatorFixture(size_t trades) {
+        std::vector<TradeKey> keys = randomKeys(trades, 3);
+        validator.setLogging(false);
+        for (const TradeKey& key : keys) {
+            validator.restoreCreatedTrade(key);
+        }
+        for (const TradeKey& key : lookupStream(keys)) {
+            payloads.push_back(R"({"trade_id":")" + key.toUuidString() +
+                               R"(","symbol":"AAPL","quantity":100,"price":150.25})");
+        }
+        for (size_t i = 0; i < payloads.size(); ++i) {
+            views.push_back({i + 1, i, EventType::TRADE_CREATED, payloads[i], 0});
+        }
+    }
+
+    DoubleEntryValidator validator;
+    std::vector<std::string> payloads;
+    std::vector<EventView> views;
+};
+
+static void BM_Validator_PerEvent(benchmark::State& state) {
+    ValidatorFixture fixture(static_cast<size_t>(state.range(0)));
+    size_t next = 0;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fixture.validator.processEvent(fixture.views[next]));
+        next = (next + 1) & (fixture.views.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Validator_PerEvent)->Arg(1 << 16)->Arg(1 << 22);
+
+static void BM_Validator_Batch(benchmark::State& state) {
+    ValidatorFixture fixture(static_cast<size_t>(state.range(0)));
+    constexpr size_t BATCH = DoubleEntryValidator::MAX_BATCH;
+    Verdict verdicts[BATCH];
+    size_t next = 0;
+
+    for (auto _ : state) {
+        fixture.validator.processBatch(&fixture.views[next], BATCH, verdicts);
+        benchmark::DoNotOptimize(verdicts);
+        next = (next + BATCH) & (fixture.views.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations() * BATCH);
+}
+BENCHMARK(BM_Validator_Batch)->Arg(1 << 16)->Arg(1 << 22);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "Event.h"
+#include "DenseIdMap.h"
+#include "LedgerEntryDecoder.h"
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include <iostream>
+
+namespace trading_ledger {
+
+/**
+ * Per-account running balance book
+ *
+ * Maintains debit/credit totals and the running balance for every account,
+ * driven by LEDGER_ENTRIES_GENERATED events.
+ *
+ * Design:
+ * - Dense account ids (DenseIdMap): state lives in a flat vector, O(1) update
+ * - Fixed-point amounts (FixedPoint::SCALE): exact, no double rounding
+ * - Cache-line aligned records: one account per line
+ * - Single writer, no locks: only the consumer thread calls apply*() and
+ *   reads records (record(), find(), checkInvariant(), printSummary());
+ *   other threads must not touch them while it runs. Only the global totals
+ *   are atomics written with relaxed stores, so a monitor thread can sample
+ *   totalDebits() / totalCredits() without synchronization.
+ * - All-or-nothing events: every leg of an event is checked (decoding and
+ *   fixed-point overflow) before any is applied.
+ *
+ * Invariant (double-entry): global debit sum == global credit sum, checked
+ * every `invariant_check_interval` events, together with the per-account
+ * cross-check SUM(balance) == debits - credits.
+ */
+class AccountBalanceBook {
+public:
+    struct alignas(64) AccountRecord {
+        int64_t debit_total = 0;
+        int64_t credit_total = 0;
+        int64_t balance = 0;         // debit_total - credit_total
+        uint64_t entry_count = 0;
+        uint64_t last_sequence = 0;  // Sequence of last applied event
+    };
+
+    struct Stats {
+        size_t events_applied = 0;
+        size_t entries_applied = 0;
+        size_t malformed_events = 0;
+        size_t overflow_errors = 0;    // Events or entries rejected on overflow
+        size_t invariant_checks = 0;
+        size_t invariant_violations = 0;
+    };
+
+    static constexpr size_t DEFAULT_INVARIANT_CHECK_INTERVAL = 65536;
+
+    explicit AccountBalanceBook(size_t invariant_check_interval = DEFAULT_INVARIANT_CHECK_INTERVAL);
+
+    /**
+     * Apply a LEDGER_ENTRIES_GENERATED event (other event types are ignored)
+     * @return true if the event's entries were applied
+     */
+    bool applyEvent(const EventView& event);
+    bool applyEvent(const Event& event) { return applyEvent(event.view()); }
+
+    /**
+     * Apply a single decoded entry to a dense account id (O(1))
+     * @return false on fixed-point overflow (entry not applied)
+     */
+    bool applyEntry(uint32_t account_id, bool is_debit, int64_t amount, uint64_t sequence);
+
+    /**
+     * Dense id for an account, assigning one if unseen
+     */
+    uint32_t accountId(std::string_view account) { return accounts_.getOrAssign(account); }
+
+    /**
+     * Record for a dense account id
+     * @return nullptr if the id is unknown
+     */
+    const AccountRecord* record(uint32_t account_id) const {
+        return account_id < records_.size() ? &records_[account_id] : nullptr;
+    }
+
+    /**
+     * Account name for a dense id (id must be < accountCount())
+     */
+    const std::string& accountName(uint32_t account_id) const { return accounts_.name(account_id); }
+
+    /**
+     * Load an account's state from a snapshot (replaces any existing state)
+     * Global totals are adjusted so the invariant keeps holding.
+     */
+    void restoreAccount(std::string_view account, const AccountRecord& record);
+
+    /**
+     * Dirty tracking for incremental checkpoints: while enabled, each account
+     * changed since the last clearDirty() is listed once in dirtyAccounts()
+     */
+    void setDirtyTracking(bool enabled) { track_dirty_ = enabled; }
+    const std::vector<uint32_t>& dirtyAccounts() const { return dirty_ids_; }
+    void clearDirty();
+
+    /**
+     * Record lookup by account name
+     */
+    const AccountRecord* find(std::string_view account) const {
+        return record(accounts_.find(account));
+    }
+
+    /**
+     * Run the invariant check now
+     * @return true if debits == credits and per-account balances reconcile
+     */
+    bool checkInvariant();
+
+    size_t accountCount() const { return records_.size(); }
+
+    // Safe to call from any thread (relaxed snapshot)
+    int64_t totalDebits() const { return total_debits_.load(std::memory_order_relaxed); }
+    int64_t totalCredits() const { return total_credits_.load(std::memory_order_relaxed); }
+
+    Stats getStats() const { return stats_; }
+
+    void printSummary(std::ostream& out = std::cout) const;
+
+private:
+    DenseIdMap accounts_;
+    std::vector<AccountRecord> records_;
+
+    std::atomic<int64_t> total_debits_{0};
+    std::atomic<int64_t> total_credits_{0};
+
+    size_t invariant_check_interval_;
+    size_t events_since_check_ = 0;
+    Stats stats_;
+
+    // Scratch for applyEvent's dry run: the event's accounts after its legs
+    struct PendingAccount {
+        std::string_view name;
+        int64_t debit_total;
+        int64_t credit_total;
+        int64_t balance;
+    };
+    std::vector<PendingAccount> pending_;
+
+    bool track_dirty_ = false;
+    std::vector<uint8_t> dirty_flags_;    // By account id
+    std::vector<uint32_t> dirty_ids_;
+
+    void markDirty(uint32_t account_id) {
+        if (account_id >= dirty_flags_.size()) {
+            dirty_flags_.resize(records_.size());
+        }
+        if (!dirty_flags_[account_id]) {
+            dirty_flags_[account_id] = 1;
+            dirty_ids_.push_back(account_id);
+        }
+    }
+};
+
+}  // namespace trading_ledger
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+namespace trading_ledger {
+
+// Pipeline stage an allocation is attributed to
+enum class PipelineStage : uint8_t {
+    UNKNOWN = 0,
+    READER = 1,        // Log mapping, tail-following
+    PARSER = 2,        // Event decoding (payload copies)
+    VALIDATOR = 3,     // DoubleEntryValidator state
+    BALANCE_BOOK = 4,  // AccountBalanceBook state
+    OUTPUT = 5,        // Verdict log and other sinks
+    COUNT = 6
+};
+
+const char* pipelineStageName(PipelineStage stage);
+
+/**
+ * Sampled heap allocation profiler
+ *
+ * Opt-in: the global operator new/delete replacements that feed it live in
+ * AllocationHooks.cpp and are only linked when the build is configured with
+ * -DTRADING_LEDGER_ALLOC_PROFILING=ON. Without that option nothing calls
+ * onAllocation() and the profiler costs nothing.
+ *
+ * Sampling: each thread counts allocated bytes down from the sample interval;
+ * when the countdown crosses zero, the call-site stack is captured with
+ * backtrace() and stored with the thread's current PipelineStage. A sample
+ * therefore represents ~interval bytes, so hot allocation sites are found
+ * regardless of allocation size.
+ *
+ * Cost when compiled in but disabled: one relaxed atomic load per allocation.
+ * Cost when enabled: a thread-local subtraction per allocation, plus a stack
+ * capture once every `interval` bytes.
+ *
+ * Storage: a fixed-size sample buffer, mmap'd on first enable() (never via
+ * operator new). Writers claim slots with fetch_add, so recording is lock-free
+ * and safe from any thread; once full, further samples are counted as dropped.
+ */
+class AllocationProfiler {
+public:
+    static constexpr size_t MAX_FRAMES = 16;
+    static constexpr size_t MAX_SAMPLES = 65536;
+
+    struct Sample {
+        std::atomic<bool> ready;
+        PipelineStage stage;
+        uint8_t depth;
+        uint64_t size;     // Size of the sampled allocation
+        uint64_t weight;   // Bytes this sample stands for
+        void* frames[MAX_FRAMES];
+    };
+
+    /**
+     * Start sampling, one sample per `interval_bytes` allocated per thread
+     * @return false if the sample buffer could not be allocated
+     */
+    static bool enable(size_t interval_bytes);
+
+    static void disable();
+
+    static bool enabled() {
+        return interval_bytes_.load(std::memory_order_relaxed) != 0;
+    }
+
+    /**
+     * Allocation hook fast path (called from operator new)
+     */
+    static void onAllocation(size_t size) {
+        if (!enabled()) {
+            return;
+        }
+        bytes_until_sample_ -= static_cast<int64_t>(size);
+        if (bytes_until_sample_ <= 0) {
+            recordSample(size);
+        }
+    }
+
+    /**
+     * Stage attribution for allocations made by the current thread
+     */
+    static PipelineStage currentStage() { return current_stage_; }
+    static void setStage(PipelineStage stage) { current_stage_ = stage; }
+
+    /**
+     * RAII stage scope: allocations inside are attributed to `stage`
+     */
+    class ScopedStage {
+    public:
+        explicit ScopedStage(PipelineStage stage) : previous_(current_stage_) {
+            current_stage_ = stage;
+        }
+        ~ScopedStage() { current_stage_ = previous_; }
+
+        ScopedStage(const ScopedStage&) = delete;
+        ScopedStage& operator=(const ScopedStage&) = delete;
+
+    private:
+        PipelineStage previous_;
+    };
+
+    static size_t samplesRecorded();
+    static size_t samplesDropped() { return dropped_.load(std::memory_order_relaxed); }
+
+    /**
+     * Print allocation sites grouped by stage and call stack, heaviest first
+     */
+    static void report(std::ostream& out = std::cout, size_t top_n = 20);
+
+    /**
+     * Forget all samples (buffer stays allocated)
+     */
+    static void reset();
+
+private:
+    static void recordSample(size_t size);
+
+    static inline std::atomic<size_t> interval_bytes_{0};
+    static inline std::atomic<size_t> next_slot_{0};
+    static inline std::atomic<size_t> dropped_{0};
+    static inline Sample* samples_ = nullptr;
+
+    static inline thread_local int64_t bytes_until_sample_ = 0;
+    static inline thread_local PipelineStage current_stage_ = PipelineStage::UNKNOWN;
+    static inline thread_local bool in_profiler_ = false;  // Recursion guard
+};
+
+}  // namespace trading_ledger
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace trading_ledger {
+
+/**
+ * Little-endian writers for the on-disk formats (the readers are
+ * EventParser::readUint32LE / readUint64LE)
+ *
+ * write* store into a caller-sized buffer (mapped headers, fixed slots);
+ * append* grow a byte vector being serialized.
+ */
+inline void writeUint32LE(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<uint8_t>((value >> (i * 8)) & 0xFF);
+    }
+}
+
+inline void writeUint64LE(uint8_t* out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<uint8_t>((value >> (i * 8)) & 0xFF);
+    }
+}
+
+inline void appendUint32LE(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+inline void appendUint64LE(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<uint8_t>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+}  // namespace trading_ledger
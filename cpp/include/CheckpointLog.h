@@ -0,0 +1,183 @@
+#pragma once
+
+#include "AccountBalanceBook.h"
+#include "DoubleEntryValidator.h"
+#include "PositionBook.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trading_ledger {
+
+/**
+ * Log-structured incremental checkpoints of consumer state
+ *
+ * Covers the validator's created trades, the balance book and the position
+ * book. Each checkpoint appends one record holding only what changed since
+ * the previous one (the books' dirty lists), so its cost follows the rate
+ * of change, not the size of the state. When the log grows past
+ * `compact_ratio` times its last full image, it is rewritten as a single
+ * full record (temp file + rename); that cost is amortized over the deltas
+ * that triggered it.
+ *
+ * Records are encoded on the owner thread (they read the live state) and
+ * written by a background writer, so the owner never waits on the disk:
+ * appends, fdatasync and the compaction rewrite all happen there. Deltas
+ * queued while a write is in flight go out together under one sync, and a
+ * queued full image supersedes the deltas before it. A write failure is
+ * reported by the next checkpoint() or flush(); the checkpoint after that
+ * rewrites the whole state, since the failed records are gone.
+ *
+ * Every record is an upsert of whole entries (trades are only ever added,
+ * accounts and positions are replaced), so recovery replays the records in
+ * order. A torn last record is ignored and overwritten by the next append.
+ *
+ * Layout: 16-byte header ("CKPT", version 1), then records of
+ *   u32 body length | body | u32 crc32(body)
+ * Body: u8 kind (FULL / DELTA), u64 sequence, then
+ *   trades:    u32 count; per trade u8 tag, then hi, lo (UUID) or a name
+ *   accounts:  u32 count; per account name, debit, credit, balance,
+ *              entry count, last sequence
+ *   positions: u32 count; per position account, symbol, net, buy, sell,
+ *              trade count
+ * Names are u16 length + bytes; integers little-endian.
+ *
+ * The same header + one FULL record is the state image handed to a new
+ * binary during an upgrade (image() / restoreImage()). With an empty path
+ * the log is only that codec: no file and no dirty tracking.
+ *
+ * Single owner: call checkpoint(), compact() and flush() from the thread
+ * that owns the state.
+ */
+class CheckpointLog {
+public:
+    static constexpr uint32_t MAGIC = 0x54504B43;  // "CKPT"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 16;
+    static constexpr uint8_t KIND_FULL = 1;
+    static constexpr uint8_t KIND_DELTA = 2;
+
+    struct Config {
+        double compact_ratio = 2.0;                // Log size / last full image
+        size_t min_compact_bytes = 1 << 20;        // Never compact a small log
+        bool sync = true;                          // fdatasync each record
+    };
+
+    struct Stats {
+        size_t checkpoints = 0;
+        size_t compactions = 0;
+        size_t records_recovered = 0;
+        size_t last_trades = 0;                    // Entries in the last record
+        size_t last_accounts = 0;
+        size_t last_positions = 0;
+        size_t last_bytes = 0;
+        uint64_t log_bytes = 0;
+        uint64_t full_bytes = 0;                   // Last full image
+        double last_seconds = 0;                   // Owner thread time of the last checkpoint
+    };
+
+    CheckpointLog(std::string path, DoubleEntryValidator& validator,
+                  AccountBalanceBook& balances, PositionBook& positions, Config config);
+    CheckpointLog(std::string path, DoubleEntryValidator& validator,
+                  AccountBalanceBook& balances, PositionBook& positions)
+        : CheckpointLog(std::move(path), validator, balances, positions, Config{}) {}
+    ~CheckpointLog();
+
+    CheckpointLog(const CheckpointLog&) = delete;
+    CheckpointLog& operator=(const CheckpointLog&) = delete;
+
+    /**
+     * Load the log into the (empty) state and enable dirty tracking
+     * A missing file is an empty log.
+     * @return sequence of the last checkpoint (0 if none)
+     * Throws std::runtime_error if the file is not a checkpoint log
+     */
+    uint64_t recover();
+
+    /**
+     * Load a state image (from image()) instead of the file, then enable
+     * dirty tracking; the next checkpoint() rewrites the file as a full image
+     * @return sequence of the image
+     * Throws std::runtime_error if the image is corrupt
+     */
+    uint64_t restoreImage(const uint8_t* data, size_t size);
+
+    /**
+     * Header plus one full record of the current state, as of sequence
+     */
+    std::vector<uint8_t> image(uint64_t sequence) const;
+
+    /**
+     * Queue the changes since the last checkpoint for append, then compact
+     * if due; returns without waiting for the write
+     * Throws std::runtime_error if an earlier write failed (the next call
+     * then queues a full image)
+     */
+    void checkpoint(uint64_t sequence);
+
+    /**
+     * Queue a rewrite of the log as one full image of the current state
+     */
+    void compact(uint64_t sequence);
+
+    /**
+     * Wait until every queued record is written and synced
+     * Throws std::runtime_error if a write failed
+     */
+    void flush();
+
+    /**
+     * Sequence of the last checkpoint queued (see durableSequence())
+     */
+    uint64_t sequence() const { return sequence_; }
+
+    /**
+     * Sequence of the last checkpoint on disk
+     */
+    uint64_t durableSequence() const;
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    std::string path_;
+    DoubleEntryValidator& validator_;
+    AccountBalanceBook& balances_;
+    PositionBook& positions_;
+    Config config_;
+    Stats stats_;
+    uint64_t sequence_ = 0;
+    uint64_t valid_end_ = 0;       // End of the last record queued
+    bool recovered_ = false;
+    bool compact_pending_ = false; // Restored from an image, or a write failed
+
+    // Background writer state, under write_mutex_
+    mutable std::mutex write_mutex_;
+    std::condition_variable write_cv_;
+    std::vector<uint8_t> queued_image_;    // Replaces the file (empty = none)
+    std::vector<uint8_t> queued_records_;  // Appended after it
+    uint64_t queued_sequence_ = 0;
+    uint64_t durable_sequence_ = 0;
+    uint64_t file_end_ = 0;                // Writer only: end of the file on disk
+    bool writing_ = false;
+    bool stopping_ = false;
+    std::string write_error_;
+    std::thread writer_;
+
+    std::vector<uint8_t> encode(uint8_t kind, uint64_t sequence) const;
+    // Apply every intact record; returns the end of the last one
+    size_t replay(const uint8_t* data, size_t size, const std::string& source);
+    void enableTracking();
+    void applyRecord(const uint8_t* body, size_t length);
+    void clearDirty();
+    void enqueue(std::vector<uint8_t> bytes, bool full, uint64_t sequence);
+    void throwIfFailed(std::unique_lock<std::mutex>& lock);
+    void writerLoop();
+    void writeImage(const std::vector<uint8_t>& bytes);
+    void appendRecords(const std::vector<uint8_t>& bytes);
+};
+
+}  // namespace trading_ledger
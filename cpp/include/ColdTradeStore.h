@@ -0,0 +1,151 @@
+#pragma once
+
+#include "TradeKey.h"
+#include <zlib.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace trading_ledger {
+
+/**
+ * Cold tier for per-trade state: compressed records in a memory-mapped
+ * scratch file, found through a compact in-memory index
+ *
+ * Records (16-byte key + fixed-size value bytes) are appended to a pending
+ * block; every BLOCK_RECORDS records the block is deflated (raw deflate,
+ * fastest level, streams reused across blocks) and written to the file,
+ * which is mapped read-only in CHUNK_BYTES windows so the kernel pages cold
+ * blocks in and out on demand.
+ *
+ * The index is an open-addressing table of 8-byte entries, one per live
+ * record: a 32-bit hash tag and the block number. A lookup of an absent key
+ * (the common case: most lookups are new trades) costs one probe sequence
+ * in the index and touches no block; a tag match costs one block inflate
+ * (a few microseconds). RAM per cold record is about 12 bytes of index
+ * and block directory, against 64 for a hot TradeKeyTable slot.
+ *
+ * take() removes the record it returns (the caller promotes it to the hot
+ * tier), so a key has at most one live copy. Taken records are dead space
+ * until a compaction: once they outnumber the live records of the written
+ * blocks (and number at least COMPACT_MIN_DEAD), the next put() streams the
+ * live records into a fresh file that replaces the old one. Each record
+ * copied is paid for by a take, so the file stays within about twice the
+ * live data under any promote/evict churn.
+ *
+ * The file is scratch and is deleted on destruction (trade state is
+ * recovered from checkpoints, not from this file).
+ */
+class ColdTradeStore {
+public:
+    // Records per deflated block: a cold hit inflates one whole block (about
+    // 2us for 16), and the block directory costs 24 bytes per block
+    static constexpr size_t BLOCK_RECORDS = 16;
+    static constexpr size_t CHUNK_BYTES = 64u << 20;   // Mapping window; blocks never straddle one
+    static constexpr size_t COMPACT_MIN_DEAD = 64 * BLOCK_RECORDS;
+
+    struct Stats {
+        size_t records = 0;           // Live cold records
+        uint64_t spilled = 0;         // Records put
+        uint64_t promoted = 0;        // Records taken
+        uint64_t block_reads = 0;     // Blocks inflated by take()
+        uint64_t false_matches = 0;   // Tag matches in a block without the key
+        size_t dead_records = 0;      // Taken records still in the file
+        uint64_t compactions = 0;
+        uint64_t file_bytes = 0;
+        size_t index_bytes = 0;       // Index plus block directory
+    };
+
+    /**
+     * Create (truncate) the scratch file
+     * Throws std::runtime_error if it cannot be created
+     */
+    ColdTradeStore(std::string path, size_t value_size);
+    ~ColdTradeStore();
+
+    ColdTradeStore(const ColdTradeStore&) = delete;
+    ColdTradeStore& operator=(const ColdTradeStore&) = delete;
+
+    /**
+     * Add a record (key must not already be live here), compacting first
+     * if due
+     * Throws std::runtime_error if a block cannot be written (a failed
+     * compaction leaves the store as it was)
+     */
+    void put(const TradeKey& key, const void* value);
+
+    /**
+     * Remove key's record, copying its value_size bytes to value
+     * @return false if key is not here (value untouched)
+     */
+    bool take(const TradeKey& key, void* value);
+
+    size_t size() const { return live_; }
+    size_t valueSize() const { return value_size_; }
+
+    /**
+     * Visit every live record: fn(key, value bytes) (inflates every block)
+     */
+    void forEach(const std::function<void(const TradeKey&, const void*)>& fn) const;
+
+    Stats stats() const;
+
+private:
+    struct Block {
+        uint64_t offset = 0;          // File offset of the deflated bytes
+        uint32_t bytes = 0;
+        uint32_t records = 0;
+        uint64_t taken = 0;           // Bit r: record r was taken
+    };
+    static_assert(BLOCK_RECORDS <= 64, "taken is a 64-bit mask");
+
+    // Written blocks and their backing file; compaction swaps in a new one
+    struct File {
+        int fd = -1;
+        uint64_t bytes = 0;
+        std::vector<uint8_t*> chunks;   // Read-only mappings, CHUNK_BYTES each
+        std::vector<Block> blocks;
+        size_t records = 0;             // In blocks, taken ones included
+    };
+
+    std::string path_;
+    size_t value_size_;
+    size_t record_size_;
+    File file_;
+    std::vector<uint8_t> pending_;    // Records of block file_.blocks.size(), not yet written
+    mutable std::vector<uint8_t> scratch_;   // Inflated block
+    std::vector<uint8_t> deflated_;
+    z_stream deflater_{};
+    mutable z_stream inflater_{};
+
+    // Entry: tag << 32 | block; 0 = empty (tags are never 0)
+    std::vector<uint64_t> index_;
+    size_t index_mask_ = 0;
+    size_t live_ = 0;
+
+    uint64_t spilled_ = 0;
+    uint64_t promoted_ = 0;
+    uint64_t block_reads_ = 0;
+    uint64_t false_matches_ = 0;
+    size_t dead_ = 0;                 // Taken records in file_.blocks
+    uint64_t compactions_ = 0;
+
+    static uint32_t tagOf(const TradeKey& key);
+    void indexInsert(uint64_t entry);
+    void indexPlace(uint64_t entry);
+    void indexErase(size_t slot);
+
+    static void openFile(File& file, const std::string& path);
+    static void closeFile(File& file);
+    // Deflate pending_ into a new block of file (pending_ is left as is)
+    void writeBlock(File& file);
+    void flushBlock();
+    void compact();
+
+    // Records of a written block, inflated into scratch_
+    const uint8_t* readBlock(const File& file, const Block& block) const;
+};
+
+}  // namespace trading_ledger
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <charconv>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+namespace trading_ledger {
+
+/**
+ * Flag value helpers for the command-line tools
+ *
+ * Errors are std::invalid_argument naming the flag; tools print the message
+ * with their usage line and exit 2.
+ */
+class CommandLine {
+public:
+    /**
+     * Value of the flag at argv[i], advancing i past it
+     * Throws if the value is missing or is itself a flag ("--...")
+     */
+    static std::string value(int argc, char** argv, int& i) {
+        std::string flag = argv[i];
+        if (i + 1 >= argc || std::string(argv[i + 1]).rfind("--", 0) == 0) {
+            throw std::invalid_argument(flag + " needs a value");
+        }
+        return argv[++i];
+    }
+
+    /**
+     * Decimal number in [min, max]: whole for integer types (no sign for
+     * unsigned ones), plain or exponent notation for floating-point types;
+     * no trailing characters
+     * Throws std::invalid_argument naming the flag otherwise
+     */
+    template<typename T>
+    static T parse(const std::string& flag, const std::string& text,
+                   T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max()) {
+        T result{};
+        const char* end = text.data() + text.size();
+        auto [ptr, error] = std::from_chars(text.data(), end, result);
+        if (text.empty() || error == std::errc::invalid_argument || ptr != end) {
+            throw std::invalid_argument(flag + (std::is_floating_point_v<T> ? " needs a number"
+                                                                            : " needs a whole number") +
+                                        ", got '" + text + "'");
+        }
+        if (error == std::errc::result_out_of_range || result < min || result > max) {
+            throw std::invalid_argument(flag + " must be in [" + std::to_string(min) + ", " +
+                                        std::to_string(max) + "], got '" + text + "'");
+        }
+        return result;
+    }
+
+    /**
+     * parse() of the value of the flag at argv[i], advancing i past it
+     */
+    template<typename T>
+    static T number(int argc, char** argv, int& i,
+                    T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max()) {
+        std::string flag = argv[i];
+        return parse<T>(flag, value(argc, argv, i), min, max);
+    }
+};
+
+}  // namespace trading_ledger
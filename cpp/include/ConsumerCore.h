@@ -0,0 +1,283 @@
+#pragma once
+
+#include "AccountBalanceBook.h"
+#include "CheckpointLog.h"
+#include "ContinuousQuery.h"
+#include "ControlServer.h"
+#include "DoubleEntryValidator.h"
+#include "Event.h"
+#include "EventLogReader.h"
+#include "EventTap.h"
+#include "LatencyHistogram.h"
+#include "LogHistogram.h"
+#include "NotifyingRingBuffer.h"
+#include "PipelineMetrics.h"
+#include "PositionBook.h"
+#include "PostingsLogIndex.h"
+#include "ProgressWatermark.h"
+#include "StateHandoff.h"
+#include "Verdict.h"
+#include "VerdictLogWriter.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace trading_ledger {
+
+// Reader -> consumer ring; the consumer sleeps on its eventfd when idle
+using EventRing = NotifyingRingBuffer<Event, 4096>;
+
+/**
+ * Binary upgrade (--handoff-socket / --takeover): the state this process
+ * hands to a successor, or took over from a predecessor, and the stop
+ * condition of the loops below
+ *
+ * A takeover request stops the pipeline as a shutdown signal would. The
+ * reader records where it stopped; the thread owning the ConsumerCore
+ * processes every event before that offset, then sends the state image
+ * with the log descriptor and offset, so the successor continues from the
+ * exact next event. If the send fails or the successor does not
+ * acknowledge, the handoff is rolled back: reading resumes at that offset
+ * with the same state, and the socket takes the next request.
+ *
+ * Carried over: validator, balances, positions (the checkpoint image) and,
+ * flushed before the send, every verdict of the events processed. Not
+ * carried over: continuous queries and the tap filter registered through
+ * the control socket; re-register them on the successor.
+ */
+struct UpgradeHandoff {
+    enum class Outcome : int { PENDING, HANDED_OFF, ROLLED_BACK };
+
+    // running: cleared on shutdown (signal, or a thread's error)
+    explicit UpgradeHandoff(std::atomic<bool>& running) : running(running) {}
+
+    std::atomic<bool>& running;
+    StateHandoffServer* server = nullptr;     // Serves a successor
+    StateTakeover* takeover = nullptr;        // Taken over at startup
+    std::atomic<bool> reader_stopped{false};  // Producer: fields below are set
+    uint64_t resume_offset = 0;               // First event not pushed to the ring
+    int log_fd = -1;                          // Producer's log descriptor, dup'ed
+    int64_t paused_ns = 0;
+    bool stopped_for_handoff = false;         // Producer only
+    std::atomic<Outcome> outcome{Outcome::PENDING};   // Consumer -> producer
+
+    bool handingOff() const { return server != nullptr && server->requested(); }
+
+    // Readers and consumers stop on shutdown or a takeover request
+    bool stopping() const { return !running.load(std::memory_order_acquire) || handingOff(); }
+
+    // Producer: record where reading stopped (reader null on error)
+    void readerStopped(const EventLogReader* reader, uint64_t offset);
+
+    // Producer: wait for the handoff to end; true if it was rolled back and
+    // reading resumes at resume_offset
+    bool resumeAfterHandoff();
+
+    // Core owner, after a failed handoff: keep the log and listen again
+    void rollBack();
+};
+
+/**
+ * Consumer state and per-event work: validation, balances, positions,
+ * queries, tap, verdicts, checkpoints
+ *
+ * Owned by one thread at a time: the consumer thread of the two-thread
+ * pipeline or, in run-to-completion mode, the reader thread (and the
+ * offload worker while work is offloaded). Construction restores the
+ * checkpoint, or the predecessor's state on a takeover.
+ */
+class ConsumerCore {
+public:
+    struct Config {
+        std::string checkpoint_path;            // Empty = no checkpoints, no positions
+        size_t checkpoint_interval = 100000;    // Events between checkpoints
+        std::string cold_state_path;            // Empty = all trade state in memory
+        size_t hot_trades = 1u << 20;           // Trades kept in memory with a cold tier
+        std::string postings_path;              // Empty = no postings index (ledger_postings)
+    };
+
+    /**
+     * Throws std::runtime_error if the checkpoint or the handed-off state
+     * cannot be restored
+     */
+    ConsumerCore(Config config,
+                 PipelineMetrics& metrics,
+                 LatencyHistogram& latency_histogram,
+                 VerdictLogWriter* verdict_log,
+                 ProgressWatermark* watermark,
+                 ContinuousQueryEngine& queries,
+                 EventTap& tap,
+                 CommandHandoff& control,
+                 UpgradeHandoff& upgrade);
+
+    ConsumerCore(const ConsumerCore&) = delete;
+    ConsumerCore& operator=(const ConsumerCore&) = delete;
+
+    // A monitor interval or a control command is waiting (relaxed loads)
+    bool requestsPending() const {
+        return metrics_.interval_latency.requested() || control_.pending();
+    }
+
+    /**
+     * Serve the monitor's interval request and control commands (one
+     * relaxed load each otherwise); called between batches
+     */
+    void serviceRequests();
+
+    /**
+     * Process events in order (count <= DoubleEntryValidator::MAX_BATCH)
+     *
+     * Validation runs on the whole batch so its trade-state lookups overlap
+     * their misses; the rest runs per event.
+     */
+    void process(Event* events, size_t count);
+
+    /**
+     * Hand the state to the successor that requested it, after the final
+     * checkpoint and verdicts; reading stopped at log_offset, and every
+     * event before it has been processed
+     * A failed handoff is reported, not thrown.
+     * @return false if the successor did not take over: this process still
+     *         owns the log and keeps processing from log_offset
+     */
+    bool handOff(uint64_t log_offset, int log_fd, int64_t paused_ns);
+
+    /**
+     * Final checkpoint and summaries
+     */
+    void finish();
+
+    const DoubleEntryValidator& validator() const { return validator_; }
+    const AccountBalanceBook& balances() const { return balance_book_; }
+    const PositionBook& positions() const { return positions_; }
+    uint64_t logOffset() const { return log_offset_; }
+
+private:
+    /**
+     * Consumer latency sink: the exact 10,000-event summary window plus the
+     * O(1) per-interval histogram handed to the monitor
+     *
+     * Validation runs once per batch; each event is charged an equal share
+     * of it on top of its own work, so the figure covers the whole event.
+     */
+    struct Latency {
+        LatencyHistogram& window;
+        LogHistogram interval;
+        int64_t validation_share_ns = 0;   // Current batch
+
+        void record(int64_t latency_ns) {
+            latency_ns += validation_share_ns;
+            window.record(latency_ns);
+            interval.record(latency_ns);
+        }
+    };
+
+    // Sink for the batch validation timer: splits it over the batch's events
+    struct ValidationShare {
+        Latency& latency;
+        size_t events;
+
+        void record(int64_t latency_ns) {
+            latency.validation_share_ns =
+                latency_ns / static_cast<int64_t>(events > 0 ? events : 1);
+        }
+    };
+
+    void savePostings();
+
+    Config config_;
+    PipelineMetrics& metrics_;
+    LatencyHistogram& latency_histogram_;
+    Latency latency_;
+    VerdictLogWriter* verdict_log_;
+    ProgressWatermark* watermark_;
+    ContinuousQueryEngine& queries_;
+    EventTap& tap_;
+    CommandHandoff& control_;
+    UpgradeHandoff& upgrade_;
+    bool persist_;                 // Checkpoints go to a file
+
+    DoubleEntryValidator validator_;
+    AccountBalanceBook balance_book_;
+    PositionBook positions_;
+    std::unique_ptr<CheckpointLog> checkpoints_;
+    std::unique_ptr<PostingsLogIndex> postings_;
+    uint64_t resume_sequence_ = 0;
+    uint64_t last_sequence_ = 0;
+    size_t since_checkpoint_ = 0;
+    uint64_t log_offset_ = FileHeader::SIZE;   // Just past the last event consumed
+
+    std::array<Event*, DoubleEntryValidator::MAX_BATCH> batch_;
+    std::array<EventView, DoubleEntryValidator::MAX_BATCH> views_;
+    std::array<Verdict, DoubleEntryValidator::MAX_BATCH> verdicts_;
+};
+
+/**
+ * Two-thread pipeline, reader side: tail the log into the ring until
+ * upgrade.stopping(), resuming after a rolled-back handoff
+ * Throws on a read error (the reader position is recorded first)
+ */
+void readIntoRing(const std::string& log_path, EventRing& ring, PipelineMetrics& metrics,
+                  UpgradeHandoff& upgrade);
+
+/**
+ * Two-thread pipeline, consumer side: process the ring until stopped and
+ * drained, then hand off if a successor asked
+ */
+void consumeRing(EventRing& ring, ConsumerCore& core, UpgradeHandoff& upgrade);
+
+/**
+ * Ownership of the ConsumerCore between the run-to-completion thread and
+ * its offload worker
+ *
+ * The reader hands the core over by setting worker_owns (release) before
+ * its first push, and takes it back by stopping pushes and raising reclaim;
+ * the worker drains the ring and clears worker_owns (release).
+ *
+ * Requests (control commands, monitor intervals) are served by the reader
+ * thread in both modes, never by the worker that is busy with the slow
+ * work: the reader raises pause, the worker parks at its next batch
+ * boundary (PAUSED), the reader serves, and sets RUNNING.
+ */
+struct OffloadHandoff {
+    enum class Pause : int { RUNNING, REQUESTED, PAUSED };
+
+    ConsumerCore* core = nullptr;
+    std::atomic<bool> worker_owns{false};
+    std::atomic<bool> reclaim{false};
+    std::atomic<bool> exit{false};
+    std::atomic<Pause> pause{Pause::RUNNING};
+    std::atomic<uint64_t> worker_cost_ns{0};   // Worker's per-event cost (EWMA)
+};
+
+/**
+ * Offload worker: processes the ring while it owns the core, until exit
+ * An error is reported, clears running and gives the core back.
+ */
+void offloadWorker(EventRing& ring, OffloadHandoff& handoff, std::atomic<bool>& running);
+
+struct RunToCompletionStats {
+    size_t offloads = 0;
+    uint64_t events_offloaded = 0;
+};
+
+/**
+ * Run-to-completion: read, parse, validate and record inline on the
+ * calling thread, with no thread hand-off per event, until
+ * upgrade.stopping() (handing off if a successor asked)
+ *
+ * With an offload budget (ns per event, 0 = never), the measured cost of
+ * inline work is tracked; above the budget, events go to the offload
+ * worker through the ring so reading overlaps processing, and come back
+ * inline once the worker's cost falls below half the budget. Requests are
+ * served on this thread either way (see OffloadHandoff).
+ * Throws on a read or processing error, with the core taken back.
+ */
+RunToCompletionStats runToCompletion(const std::string& log_path, ConsumerCore& core, EventRing& ring,
+                                     OffloadHandoff& handoff, PipelineMetrics& metrics,
+                                     UpgradeHandoff& upgrade, uint64_t offload_budget_ns);
+
+}  // namespace trading_ledger
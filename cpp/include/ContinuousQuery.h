@@ -0,0 +1,213 @@
+#pragma once
+
+#include "DecodedTrade.h"
+#include "Event.h"
+#include "FixedPoint.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace trading_ledger {
+
+enum class TradeField : uint8_t {
+    TRADE_ID,
+    ACCOUNT_ID,
+    SYMBOL,
+    SIDE,
+    QUANTITY,
+    PRICE,
+    NOTIONAL
+};
+
+enum class CompareOp : uint8_t { EQ, NE, LT, LE, GT, GE };
+
+enum class AggregateKind : uint8_t {
+    COUNT,
+    SUM,
+    NET,    // Sum signed by side: BUY adds, SELL subtracts
+    MIN,
+    MAX,
+    AVG
+};
+
+/**
+ * One WHERE clause, resolved to a field and a typed operand at
+ * registration so evaluation is a switch and one comparison
+ */
+struct QueryPredicate {
+    TradeField field = TradeField::SYMBOL;
+    CompareOp op = CompareOp::EQ;
+    std::string text;           // String fields
+    WideAmount number = 0;      // Numeric fields (FixedPoint)
+
+    bool matches(const DecodedTrade& trade) const;
+};
+
+struct QueryAggregate {
+    AggregateKind kind = AggregateKind::COUNT;
+    TradeField field = TradeField::QUANTITY;   // Unused for COUNT
+};
+
+/**
+ * A registered filter / group / aggregate query, maintained incrementally
+ *
+ * Syntax (keywords are case-insensitive):
+ *   AGG[,AGG...] [where COND [and COND]...] [by FIELD[,FIELD...]]
+ *   AGG   count | sum(F) | net(F) | min(F) | max(F) | avg(F)
+ *         F = quantity | price | notional
+ *   COND  FIELD OP VALUE, written without spaces ("symbol=NVDA")
+ *         OP = = != < <= > >=  (string fields: = and != only)
+ *   FIELD trade_id | account_id | symbol | side | quantity | price | notional
+ *
+ * e.g. net BUY quantity in NVDA for account ACC1:
+ *   sum(quantity) where symbol=NVDA and account_id=ACC1 and side=BUY
+ *
+ * Results cover the events seen since registration. Per-event cost is
+ * bounded by construction: at most MAX_PREDICATES comparisons, one group
+ * lookup over at most MAX_GROUP_FIELDS fields, and MAX_AGGREGATES updates.
+ * Groups beyond max_groups are not created; their trades are counted as
+ * overflow.
+ */
+class ContinuousQuery {
+public:
+    static constexpr size_t MAX_PREDICATES = 8;
+    static constexpr size_t MAX_GROUP_FIELDS = 3;
+    static constexpr size_t MAX_AGGREGATES = 8;
+
+    struct Cost {
+        uint64_t evaluated = 0;      // Trades offered to the query
+        uint64_t matched = 0;        // Trades that passed every predicate
+        uint64_t overflow = 0;       // Matched but dropped (group limit)
+        uint64_t timed = 0;          // Sampled evaluations
+        uint64_t timed_ns = 0;
+
+        double nanosPerEvent() const {
+            return timed == 0 ? 0.0 : static_cast<double>(timed_ns) / static_cast<double>(timed);
+        }
+    };
+
+    /**
+     * Compile a query
+     * Throws std::invalid_argument on a syntax error or a limit exceeded
+     */
+    ContinuousQuery(std::string name, std::string text, size_t max_groups);
+
+    const std::string& name() const { return name_; }
+    const std::string& text() const { return text_; }
+    const Cost& cost() const { return cost_; }
+    size_t groupCount() const { return groups_.size(); }
+
+    void onTrade(const DecodedTrade& trade);
+
+    // Time this evaluation (sampled by the engine)
+    void onTradeTimed(const DecodedTrade& trade);
+
+    /**
+     * Current result, one line per group (sorted by group key)
+     */
+    void writeResult(std::ostream& out) const;
+
+    /**
+     * Aggregate value of a group as text (tests and tools)
+     * @param group Group key: group-by values joined by '|' ("" without BY)
+     * @return empty string if the group does not exist
+     */
+    std::string value(const std::string& group, size_t aggregate) const;
+
+private:
+    struct AggregateState {
+        WideAmount sum = 0;
+        WideAmount min = 0;
+        WideAmount max = 0;
+    };
+
+    struct GroupState {
+        uint64_t count = 0;
+        std::vector<AggregateState> aggregates;
+    };
+
+    // Heterogeneous lookup: find a group by string_view without allocating
+    struct KeyHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view key) const { return std::hash<std::string_view>{}(key); }
+    };
+
+    std::string name_;
+    std::string text_;
+    size_t max_groups_;
+    std::vector<QueryPredicate> predicates_;
+    std::vector<TradeField> group_by_;
+    std::vector<QueryAggregate> aggregates_;
+    std::unordered_map<std::string, GroupState, KeyHash, std::equal_to<>> groups_;
+    std::string key_buffer_;     // Reused group key
+    Cost cost_;
+
+    void parse();
+    std::string formatAggregate(const GroupState& group, size_t index) const;
+};
+
+/**
+ * Continuous queries registered at runtime, fed by the consumer
+ *
+ * Owned by the consumer thread (register / read through a CommandHandoff).
+ * Each TRADE_CREATED event is decoded once, only while at least one query
+ * is registered, and offered to every query. One event in TIMING_SAMPLE is
+ * timed per query to report its cost.
+ */
+class ContinuousQueryEngine {
+public:
+    static constexpr size_t MAX_QUERIES = 32;
+    static constexpr size_t DEFAULT_MAX_GROUPS = 10000;
+    static constexpr uint64_t TIMING_SAMPLE = 64;
+
+    explicit ContinuousQueryEngine(size_t max_groups = DEFAULT_MAX_GROUPS)
+        : max_groups_(max_groups) {}
+
+    /**
+     * Register a query (results start from the next event)
+     * Throws std::invalid_argument on a bad query, a duplicate name or
+     * too many queries
+     */
+    void add(const std::string& name, const std::string& text);
+
+    /**
+     * @return false if no query has this name
+     */
+    bool remove(const std::string& name);
+
+    const ContinuousQuery* find(const std::string& name) const;
+
+    bool empty() const { return queries_.empty(); }
+    size_t size() const { return queries_.size(); }
+
+    void onEvent(const EventView& event);
+    void onEvent(const Event& event) { onEvent(event.view()); }
+
+    /**
+     * One line per query: name, text, groups and cost
+     */
+    void writeList(std::ostream& out) const;
+
+    uint64_t undecodableTrades() const { return undecodable_; }
+
+    /**
+     * Serve a control request: ADD NAME QUERY | DROP NAME | GET NAME | LIST
+     * Throws std::invalid_argument on a bad request
+     */
+    std::string handle(const std::string& request);
+
+private:
+    size_t max_groups_;
+    std::vector<std::unique_ptr<ContinuousQuery>> queries_;
+    uint64_t trades_seen_ = 0;
+    uint64_t undecodable_ = 0;
+};
+
+}  // namespace trading_ledger
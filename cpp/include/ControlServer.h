@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace trading_ledger {
+
+/**
+ * Runs control-plane work on the consumer thread
+ *
+ * State owned by the consumer (validator, continuous queries) is never
+ * locked. A control command is posted here instead; the consumer checks
+ * pending() once per loop iteration (one relaxed load) and runs the task
+ * between two events. One task is in flight at a time.
+ */
+class CommandHandoff {
+public:
+    using Task = std::function<std::string()>;
+
+    // wake: called after posting so an idle consumer runs the task promptly
+    explicit CommandHandoff(std::function<void()> wake = {}) : wake_(std::move(wake)) {}
+
+    CommandHandoff(const CommandHandoff&) = delete;
+    CommandHandoff& operator=(const CommandHandoff&) = delete;
+
+    /**
+     * Control thread: run task on the consumer and return its result
+     * Rethrows the task's exception; throws std::runtime_error if the
+     * consumer does not pick the task up within timeout (task not run)
+     */
+    std::string execute(Task task, std::chrono::milliseconds timeout);
+
+    // Consumer: cheap check, call once per loop iteration
+    bool pending() const { return pending_.load(std::memory_order_relaxed); }
+
+    // Consumer: run the posted task, if any
+    void serve();
+
+private:
+    std::function<void()> wake_;
+    std::atomic<bool> pending_{false};
+
+    std::mutex execute_mutex_;   // Serializes execute() callers
+    std::mutex mutex_;
+    std::condition_variable done_cv_;
+    Task task_;
+    bool taken_ = false;
+    bool done_ = false;
+    std::string result_;
+    std::exception_ptr error_;
+};
+
+/**
+ * Line-oriented control socket (Unix domain, SOCK_STREAM)
+ *
+ * Each request is one line. The handler's response is written back followed
+ * by a status line: "OK", or "ERR <message>" if the handler threw. Several
+ * clients may be connected; requests are handled one at a time on the
+ * server's own thread, so the handler must hand consumer-owned work to a
+ * CommandHandoff rather than touch it directly.
+ *
+ *   $ ledger_ctl /tmp/ledger.sock STATS
+ */
+class ControlServer {
+public:
+    using Handler = std::function<std::string(const std::string& request)>;
+
+    static constexpr size_t MAX_REQUEST_LENGTH = 4096;
+    static constexpr size_t MAX_CLIENTS = 16;
+
+    ControlServer(std::string socket_path, Handler handler);
+    ~ControlServer();
+
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+
+    /**
+     * Bind the socket (replacing a stale one) and start serving
+     * Throws std::runtime_error on failure
+     */
+    void start();
+
+    /**
+     * Stop serving, close every connection and remove the socket file
+     * (unless another process has since bound its own at the same path)
+     */
+    void stop();
+
+    const std::string& path() const { return socket_path_; }
+
+private:
+    std::string socket_path_;
+    Handler handler_;
+    int listen_fd_ = -1;
+    int stop_fd_ = -1;           // eventfd: wakes the server thread on stop()
+    uint64_t socket_inode_ = 0;  // Our socket file, so stop() leaves a successor's alone
+    std::thread thread_;
+
+    void run();
+    std::string respond(const std::string& request);
+};
+
+}  // namespace trading_ledger
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "FixedPoint.h"
+#include "JsonFields.h"
+#include <cstdint>
+#include <string_view>
+
+namespace trading_ledger {
+
+/**
+ * TRADE_CREATED payload decoded once and shared by every consumer of it
+ * (continuous queries, position book). Views point into the event payload.
+ */
+struct DecodedTrade {
+    std::string_view trade_id;
+    std::string_view account_id;
+    std::string_view symbol;
+    std::string_view side;
+    int64_t quantity = 0;       // FixedPoint
+    int64_t price = 0;          // FixedPoint
+    WideAmount notional = 0;    // quantity * price, FixedPoint
+    int direction = 0;          // +1 BUY, -1 SELL, 0 otherwise
+
+    /**
+     * @return false if account_id, symbol, side, quantity or price is
+     *         missing or malformed
+     */
+    static bool decode(std::string_view payload, DecodedTrade& out) {
+        auto account = JsonFields::findString(payload, "account_id");
+        auto symbol = JsonFields::findString(payload, "symbol");
+        auto side = JsonFields::findString(payload, "side");
+        auto quantity = JsonFields::findNumber(payload, "quantity");
+        auto price = JsonFields::findNumber(payload, "price");
+        if (!account || !symbol || !side || !quantity || !price ||
+            !FixedPoint::parse(*quantity, out.quantity) || !FixedPoint::parse(*price, out.price)) {
+            return false;
+        }
+        out.trade_id = JsonFields::findString(payload, "trade_id").value_or(std::string_view{});
+        out.account_id = *account;
+        out.symbol = *symbol;
+        out.side = *side;
+        out.notional = static_cast<WideAmount>(out.quantity) * out.price / FixedPoint::SCALE;
+        out.direction = out.side == "BUY" ? 1 : (out.side == "SELL" ? -1 : 0);
+        return true;
+    }
+};
+
+}  // namespace trading_ledger
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace trading_ledger {
+
+/**
+ * Assigns dense, stable uint32 ids to strings (account ids, symbols)
+ *
+ * Dense ids let per-entity state live in flat vectors indexed by id instead of
+ * string-keyed hash maps. Each distinct string is stored once; lookups take a
+ * string_view, so the hot path never allocates for known strings.
+ *
+ * Not thread-safe: owned by a single writer.
+ */
+class DenseIdMap {
+public:
+    static constexpr uint32_t INVALID_ID = UINT32_MAX;
+
+    /**
+     * Get id for name, assigning the next id if unseen
+     */
+    uint32_t getOrAssign(std::string_view name) {
+        auto it = ids_.find(name);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+
+        uint32_t id = static_cast<uint32_t>(names_.size());
+        const std::string& stored = names_.emplace_back(name);
+        ids_.emplace(std::string_view(stored), id);
+        return id;
+    }
+
+    /**
+     * Get id for name without assigning
+     * @return id, or INVALID_ID if unseen
+     */
+    uint32_t find(std::string_view name) const {
+        auto it = ids_.find(name);
+        return it != ids_.end() ? it->second : INVALID_ID;
+    }
+
+    /**
+     * Reverse lookup (id must be < size())
+     */
+    const std::string& name(uint32_t id) const { return names_[id]; }
+
+    size_t size() const { return names_.size(); }
+
+private:
+    // deque: element addresses stay stable, so map keys can view into it
+    std::deque<std::string> names_;
+    std::unordered_map<std::string_view, uint32_t> ids_;
+};
+
+}  // namespace trading_ledger
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "Event.h"
+#include "TradeKey.h"
+#include "TieredTradeTable.h"
+#include "Verdict.h"
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 #include <iostream>
 
 namespace trading_ledger {
@@ -12,14 +16,57 @@ namespace trading_ledger {
  *
  * Validates that debits and credits balance for each trade.
  * Accumulates ledger entries and checks invariant: SUM(debits) = SUM(credits)
+ *
+ * Single-threaded: the validator and the trade state it owns (TradeKeyInterner,
+ * TradeKeyTable, TieredTradeTable, ColdTradeStore) belong to one consumer
+ * thread, and none of them synchronizes.
  */
 class DoubleEntryValidator {
 public:
+    /**
+     * Rule configuration (limits are fixed point, FixedPoint::SCALE; 0 = off)
+     */
+    struct Config {
+        int64_t max_quantity = 0;
+        int64_t max_notional = 0;
+        bool detect_duplicates = true;
+    };
+
+    explicit DoubleEntryValidator(Config config) : config_(config) {}
+    DoubleEntryValidator() : DoubleEntryValidator(Config{}) {}
+
+    const Config& config() const { return config_; }
+
     /**
      * Process an event
      * Currently validates TRADE_CREATED events
+     * @return verdict for the event (SKIPPED for types not validated)
+     */
+    Verdict processEvent(const Event& event) { return processEvent(event.view()); }
+
+    /**
+     * Process a non-owning event (payload in a caller-owned buffer)
+     */
+    Verdict processEvent(const EventView& event);
+
+    /**
+     * Process events in order, verdicts[i] for events[i]
+     *
+     * Same verdicts and stats as calling processEvent() on each, but the
+     * trade-state lookups of a batch are issued together (hash, prefetch,
+     * probe), overlapping their cache misses. Diagnostic lines for rejected
+     * payloads may precede those of earlier duplicates in the same batch.
+     */
+    void processBatch(const EventView* events, size_t count, Verdict* verdicts);
+
+    // Events per trade-state lookup batch (consumers pop up to this many)
+    static constexpr size_t MAX_BATCH = 32;
+
+    /**
+     * Enable/disable diagnostic lines (errors on stderr, progress on stdout)
+     * Embedders that report verdicts themselves turn this off.
      */
-    void processEvent(const Event& event);
+    void setLogging(bool enabled) { logging_ = enabled; }
 
     /**
      * Get validation statistics
@@ -28,17 +75,80 @@ public:
         size_t trades_validated = 0;
         size_t validation_errors = 0;
         size_t events_processed = 0;
+        size_t duplicate_trades = 0;
     };
 
     Stats getStats() const { return stats_; }
 
+    /**
+     * Number of distinct trades with tracked state (both tiers)
+     */
+    size_t tradeCount() const { return trade_states_.size(); }
+
+    /**
+     * Bound in-memory trade state: beyond hot_trades, trades not touched
+     * recently spill to a compressed cold tier in a scratch file at path and
+     * come back on their next event (see TieredTradeTable). Call before
+     * processing or restoring a checkpoint.
+     * Throws std::runtime_error if the file cannot be created
+     */
+    void enableColdTier(const std::string& path, size_t hot_trades) {
+        trade_states_.enableColdTier(path, hot_trades);
+    }
+
+    TradeTierStats tierStats() const { return trade_states_.stats(); }
+
+    /**
+     * Dirty tracking for incremental checkpoints: while enabled, each trade
+     * first created since the last clearDirty() is listed in dirtyTrades()
+     * (created trades are never forgotten, so this is all that changes)
+     */
+    void setDirtyTracking(bool enabled) { track_dirty_ = enabled; }
+    const std::vector<TradeKey>& dirtyTrades() const { return dirty_trades_; }
+    void clearDirty() { dirty_trades_.clear(); }
+
+    /**
+     * Visit every created trade (full checkpoints)
+     */
+    template<typename Fn>
+    void forEachCreatedTrade(Fn&& fn) const {
+        trade_states_.forEach([&](const TradeKey& key, const TradeState& state) {
+            if (state.created) {
+                fn(key);
+            }
+        });
+    }
+
+    /**
+     * Original id of an interned (non-UUID) key; empty for UUID keys
+     */
+    std::string_view internedTradeId(const TradeKey& key) const { return interner_.lookup(key); }
+
+    /**
+     * Size trade state for count trades before restoring them (a full image
+     * arrives in another table's slot order, which clusters badly in a
+     * table still growing)
+     */
+    void reserveTrades(size_t count) { trade_states_.reserve(count); }
+
+    /**
+     * Mark a trade created when loading a checkpoint
+     * UUID keys are restored as is; interned ids are re-interned by string.
+     */
+    void restoreCreatedTrade(const TradeKey& key) { trade_states_.upsert(key).created = true; }
+    void restoreCreatedTrade(std::string_view trade_id) {
+        trade_states_.upsert(interner_.resolve(trade_id)).created = true;
+    }
+
     /**
      * Print validation summary
      */
     void printSummary(std::ostream& out = std::cout) const;
 
 private:
+    Config config_;
     Stats stats_;
+    bool logging_ = true;
 
     // Track per-trade ledger state (for future multi-event validation)
     // Currently we validate complete trades in single event
@@ -46,15 +156,35 @@ private:
         double debit_total = 0.0;
         double credit_total = 0.0;
         int entry_count = 0;
+        bool created = false;  // TRADE_CREATED seen (duplicate detection)
     };
 
-    std::unordered_map<std::string, TradeState> trade_states_;
+    // Keyed by 128-bit trade key: 16 bytes per key instead of a heap string,
+    // in one flat open-addressing array (batched, prefetched lookups), with
+    // idle trades optionally spilled to a cold tier
+    TieredTradeTable<TradeState> trade_states_;
+
+    // Fallback for trade ids that are not UUIDs
+    TradeKeyInterner interner_;
+
+    bool track_dirty_ = false;
+    std::vector<TradeKey> dirty_trades_;
 
     // Validate a TRADE_CREATED event
-    void validateTradeCreated(const Event& event);
+    Verdict validateTradeCreated(const EventView& event);
+
+    // Payload checks that need no trade state (empty, required fields,
+    // trade_id); on PASSED, trade_id views the payload's id
+    Verdict checkTradePayload(const EventView& event, std::string_view& trade_id);
+
+    // Duplicate check against the trade's state, then accept
+    Verdict commitTrade(const EventView& event, const TradeKey& key, TradeState& state);
+
+    // Limits, then count a validated trade (progress line every 1000)
+    Verdict acceptTrade(const EventView& event);
 
-    // Extract trade_id from JSON payload (simple parsing)
-    std::string extractTradeId(const std::string& json_payload) const;
+    // Quantity / notional limits (only parses the numbers when a limit is set)
+    Verdict checkLimits(const EventView& event) const;
 };
 
 }  // namespace trading_ledger
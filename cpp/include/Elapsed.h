@@ -0,0 +1,14 @@
+#pragma once
+
+#include <chrono>
+
+namespace trading_ledger {
+
+/**
+ * Seconds of steady_clock time since start (phase timings in run stats)
+ */
+inline double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace trading_ledger
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace trading_ledger {
@@ -9,10 +10,12 @@ namespace trading_ledger {
 // Event types matching Java Event.EventType
 enum class EventType : uint8_t {
     TRADE_CREATED = 1,
-    LEDGER_ENTRIES_GENERATED = 2,  // Future
+    LEDGER_ENTRIES_GENERATED = 2,  // Payload: see LedgerEntryDecoder
     POSITION_UPDATED = 3            // Future
 };
 
+struct EventView;
+
 // Event record structure matching Java binary format
 // Layout (little-endian):
 //   Offset | Size | Field
@@ -35,8 +38,28 @@ struct Event {
     size_t totalSize() const {
         return 28 + payload.size();  // 28-byte header + payload + 4-byte CRC (included in 28)
     }
+
+    EventView view() const;
+};
+
+// Non-owning event: payload points into a caller-owned buffer
+// (mapped log, in-process batch). Valid only while that buffer lives.
+struct EventView {
+    uint64_t sequence_num;
+    uint64_t timestamp_ns;
+    EventType event_type;
+    std::string_view payload;
+    uint32_t crc32;
+
+    size_t totalSize() const {
+        return 28 + payload.size();
+    }
 };
 
+inline EventView Event::view() const {
+    return EventView{sequence_num, timestamp_ns, event_type, payload, crc32};
+}
+
 // File header structure (16 bytes, written once at start of log)
 struct FileHeader {
     uint32_t magic;      // 0x54524144 ("TRAD")
@@ -28,6 +28,20 @@ public:
      */
     void open();
 
+    /**
+     * Map an already-open descriptor of the log (handed over by the process
+     * being upgraded) and continue at offset, an event boundary
+     * Takes ownership of fd. Throws std::runtime_error on failure
+     */
+    void adopt(int fd, size_t offset);
+
+    /**
+     * Continue at an earlier event boundary (a rolled-back handoff re-reads
+     * the events it stopped on)
+     * Throws std::runtime_error if offset is outside the mapped log
+     */
+    void seek(size_t offset);
+
     /**
      * Read next event from log
      * @param event Output parameter to store event
@@ -57,6 +71,8 @@ public:
      */
     bool remapIfGrown();
 
+    int fd() const { return fd_; }
+
 private:
     std::string log_path_;
     int fd_;                    // File descriptor
@@ -65,6 +81,8 @@ private:
     size_t offset_;             // Current read offset
     FileHeader file_header_;    // Cached file header
     bool is_open_;
+
+    void map();
 };
 
 }  // namespace trading_ledger
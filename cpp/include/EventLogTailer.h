@@ -40,6 +40,27 @@ public:
      */
     bool waitForModification(int timeout_ms = 0);
 
+    /**
+     * File descriptor that becomes readable on modification, for callers that
+     * multiplex the tailer with other fds (rings, sockets) in one epoll.
+     * After it polls readable, call drain() to
+     * consume the pending inotify events.
+     * @return inotify fd, or -1 when polling (no fd to wait on)
+     */
+    int fd() const {
+#ifdef __linux__
+        return inotify_fd_;
+#else
+        return -1;
+#endif
+    }
+
+    /**
+     * Consume pending modification notifications without blocking
+     * @return true if at least one notification was pending
+     */
+    bool drain();
+
     /**
      * Check if using inotify (Linux) or polling (fallback)
      */
@@ -16,6 +16,14 @@ public:
         : ParseException("CRC32 mismatch: " + msg) {}
 };
 
+// A frame runs past the end of the log: a torn append, or a damaged length
+// field that cannot be told apart from one
+class TruncatedLogException : public ParseException {
+public:
+    explicit TruncatedLogException(const std::string& msg)
+        : ParseException("Truncated event log: " + msg) {}
+};
+
 class EventParser {
 public:
     // Parse event from byte buffer (little-endian format)
@@ -23,6 +31,10 @@ public:
     // Throws CorruptedEventException if CRC32 mismatch
     static Event parse(const uint8_t* data, size_t length);
 
+    // Parse without copying: the view's payload points into `data`
+    // Same validation and exceptions as parse()
+    static EventView parseView(const uint8_t* data, size_t length);
+
     // Parse file header
     static FileHeader parseFileHeader(const uint8_t* data, size_t length);
 
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "Event.h"
+#include "NotifyingRingBuffer.h"
+#include "Verdict.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace trading_ledger {
+
+/**
+ * Which events a tap copies out
+ *
+ *   type=TRADE_CREATED|LEDGER_ENTRIES_GENERATED|POSITION_UPDATED|<number>
+ *   seq=FROM-TO        (either bound may be omitted: seq=100-, seq=-200)
+ *   trade=TRADE_ID     (exact trade_id match)
+ *   verdict=FAILED     (only events the validator failed)
+ *   sample=N           (keep every Nth matching event)
+ */
+struct TapFilter {
+    std::optional<EventType> type;
+    uint64_t min_sequence = 0;
+    uint64_t max_sequence = UINT64_MAX;
+    std::string trade_id;               // Empty = any
+    bool failed_only = false;
+    uint64_t sample_every = 1;
+
+    /**
+     * Parse "key=value" tokens
+     * Throws std::invalid_argument on an unknown key or bad value
+     */
+    static TapFilter parse(const std::vector<std::string>& tokens);
+
+    bool matches(const EventView& event, const Verdict& verdict) const;
+
+    std::string describe() const;
+};
+
+/**
+ * One tapped event (payload truncated to MAX_PAYLOAD bytes)
+ */
+struct TapRecord {
+    static constexpr size_t MAX_PAYLOAD = 480;
+
+    uint64_t sequence = 0;
+    uint64_t timestamp_ns = 0;
+    uint32_t payload_length = 0;        // Original length
+    EventType type = EventType::TRADE_CREATED;
+    Verdict verdict;
+    char payload[MAX_PAYLOAD];
+};
+
+/**
+ * Runtime-toggleable event tap for live debugging
+ *
+ * The consumer calls offer() for every event after validation. While the
+ * tap is disarmed that is one load of a plain bool the consumer owns: a
+ * predictable, never-taken branch, no atomics and no filter work.
+ *
+ * When armed, matching events are copied into a side ring (never blocking;
+ * a full ring counts a drop) and written by a drainer thread as text lines
+ *   <sequence> <timestamp_ns> <type> <verdict> <payload>
+ * to a file (appended) or, for "unix:<path>", a listening Unix socket.
+ * The first failed write (reader gone, disk full) ends the output: it is
+ * reported in stats().error, records still queued are counted as
+ * discarded, and the next offer() disarms the tap.
+ *
+ * Threading: start()/stop() run on a control thread; arm()/disarm()/offer()
+ * only on the consumer (via CommandHandoff), so the filter needs no locks.
+ * Sequence: start(), arm() ... disarm(), stop().
+ */
+class EventTap {
+public:
+    static constexpr size_t RING_SIZE = 1024;
+
+    EventTap() = default;
+    ~EventTap();
+
+    EventTap(const EventTap&) = delete;
+    EventTap& operator=(const EventTap&) = delete;
+
+    /**
+     * Control thread: open the destination and start the drainer
+     * Throws std::runtime_error if it cannot be opened or a tap is running
+     */
+    void start(const std::string& destination);
+
+    /**
+     * Control thread: drain what is queued, stop the drainer, close the
+     * destination (disarm first). No-op if not started.
+     */
+    void stop();
+
+    bool running() const { return drainer_.joinable(); }
+
+    // Consumer thread
+    void arm(const TapFilter& filter);
+    void disarm() { armed_ = false; }
+    bool armed() const { return armed_; }
+
+    /**
+     * Consumer thread: the tap point (inline fast path)
+     */
+    void offer(const EventView& event, const Verdict& verdict) {
+        if (__builtin_expect(armed_, false)) {
+            capture(event, verdict);
+        }
+    }
+
+    struct Stats {
+        uint64_t matched = 0;     // Passed the filter (before sampling)
+        uint64_t queued = 0;
+        uint64_t dropped = 0;     // Side ring full
+        uint64_t written = 0;
+        uint64_t discarded = 0;   // Queued, then lost to a write failure
+        std::string error;        // Write failure that stopped the output
+    };
+
+    /**
+     * Any thread: relaxed snapshot
+     */
+    Stats stats() const;
+
+    std::string destination() const { return destination_; }
+
+private:
+    using Ring = NotifyingRingBuffer<TapRecord, RING_SIZE>;
+
+    // Consumer-owned
+    bool armed_ = false;
+    TapFilter filter_;
+    uint64_t sample_counter_ = 0;
+
+    std::unique_ptr<Ring> ring_;
+    std::thread drainer_;
+    std::atomic<bool> draining_{false};
+    int fd_ = -1;
+    std::string destination_;
+
+    std::atomic<uint64_t> matched_{0};
+    std::atomic<uint64_t> queued_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> discarded_{0};
+    std::atomic<bool> failed_{false};
+    std::string error_;           // Set by the drainer before failed_
+
+    void capture(const EventView& event, const Verdict& verdict);
+    void drainLoop();
+    bool writeRecord(const TapRecord& record, std::string& line);
+};
+
+}  // namespace trading_ledger
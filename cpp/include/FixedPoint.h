@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace trading_ledger {
+
+// 128-bit fixed-point accumulator (sums and products of many int64 amounts
+// overflow int64)
+__extension__ typedef __int128 WideAmount;
+
+/**
+ * Fixed-point decimal helpers
+ *
+ * Amounts are stored as int64 with 8 fractional digits, matching the
+ * NUMERIC(18,8) columns on the Java/PostgreSQL side. Parsing works directly on
+ * the JSON number text, so no precision is lost through double.
+ *
+ * Range: +/- 92,233,720,368.54775807 per value.
+ */
+class FixedPoint {
+public:
+    static constexpr int SCALE_DIGITS = 8;
+    static constexpr int64_t SCALE = 100000000;
+
+    /**
+     * Parse a decimal number ("-123.45", "1E+2", "0.00000001")
+     * Digits beyond 8 fractional places are truncated.
+     * @return false on malformed input or overflow
+     */
+    static bool parse(std::string_view text, int64_t& out) {
+        size_t pos = 0;
+        bool negative = false;
+        if (pos < text.size() && (text[pos] == '-' || text[pos] == '+')) {
+            negative = text[pos] == '-';
+            ++pos;
+        }
+
+        // Accumulate all significant digits, remembering where the point was
+        uint64_t mantissa = 0;
+        int fraction_digits = 0;
+        bool seen_point = false;
+        bool seen_digit = false;
+
+        for (; pos < text.size(); ++pos) {
+            char c = text[pos];
+            if (c >= '0' && c <= '9') {
+                seen_digit = true;
+                if (seen_point && fraction_digits >= SCALE_DIGITS) {
+                    continue;  // Truncate excess precision
+                }
+                uint64_t digit = static_cast<uint64_t>(c - '0');
+                if (mantissa > (MAX_MANTISSA - digit) / 10) {
+                    return false;
+                }
+                mantissa = mantissa * 10 + digit;
+                if (seen_point) {
+                    ++fraction_digits;
+                }
+            } else if (c == '.' && !seen_point) {
+                seen_point = true;
+            } else {
+                break;
+            }
+        }
+        if (!seen_digit) {
+            return false;
+        }
+
+        int exponent = 0;
+        if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+            ++pos;
+            bool exp_negative = false;
+            if (pos < text.size() && (text[pos] == '-' || text[pos] == '+')) {
+                exp_negative = text[pos] == '-';
+                ++pos;
+            }
+            if (pos >= text.size()) {
+                return false;
+            }
+            for (; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos) {
+                exponent = exponent * 10 + (text[pos] - '0');
+                if (exponent > 64) {
+                    return false;
+                }
+            }
+            if (exp_negative) {
+                exponent = -exponent;
+            }
+        }
+        if (pos != text.size()) {
+            return false;
+        }
+
+        // Rescale mantissa * 10^(exponent - fraction_digits) to 8 places
+        int shift = SCALE_DIGITS - fraction_digits + exponent;
+        for (; shift > 0; --shift) {
+            if (mantissa > MAX_MANTISSA / 10) {
+                return false;
+            }
+            mantissa *= 10;
+        }
+        for (; shift < 0; ++shift) {
+            mantissa /= 10;
+        }
+
+        int64_t value = static_cast<int64_t>(mantissa);
+        out = negative ? -value : value;
+        return true;
+    }
+
+    /**
+     * Format as a plain decimal string with 8 fractional digits
+     */
+    static std::string format(int64_t value) {
+        bool negative = value < 0;
+        uint64_t magnitude = negative ? 0 - static_cast<uint64_t>(value)
+                                      : static_cast<uint64_t>(value);
+
+        std::string whole = std::to_string(magnitude / SCALE);
+        std::string fraction = std::to_string(magnitude % SCALE);
+
+        // One buffer, no temporaries (chained operator+ trips -Wrestrict at -O2)
+        std::string out;
+        out.reserve(1 + whole.size() + 1 + SCALE_DIGITS);
+        if (negative) {
+            out.push_back('-');
+        }
+        out.append(whole);
+        out.push_back('.');
+        out.append(SCALE_DIGITS - fraction.size(), '0');
+        out.append(fraction);
+        return out;
+    }
+
+    /**
+     * Format a wide (128-bit) fixed-point value, same layout as format()
+     */
+    static std::string formatWide(WideAmount value) {
+        __extension__ typedef unsigned __int128 WideMagnitude;
+        bool negative = value < 0;
+        WideMagnitude magnitude = static_cast<WideMagnitude>(value);
+        if (negative) {
+            magnitude = -magnitude;  // Modular: well-defined for the minimum value too
+        }
+        WideMagnitude whole = magnitude / SCALE;
+        std::string fraction = std::to_string(static_cast<uint64_t>(magnitude % SCALE));
+
+        char digits[40];   // 2^128 has 39 decimal digits
+        size_t count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + static_cast<int>(whole % 10));
+            whole /= 10;
+        } while (whole > 0);
+
+        std::string out;
+        out.reserve(1 + count + 1 + SCALE_DIGITS);
+        if (negative) {
+            out.push_back('-');
+        }
+        while (count > 0) {
+            out.push_back(digits[--count]);
+        }
+        out.push_back('.');
+        out.append(SCALE_DIGITS - fraction.size(), '0');
+        out.append(fraction);
+        return out;
+    }
+
+private:
+    static constexpr uint64_t MAX_MANTISSA = 0x7FFFFFFFFFFFFFFFULL;
+};
+
+}  // namespace trading_ledger
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace trading_ledger {
+
+// One per-second snapshot of pipeline metrics (128 bytes, little-endian)
+// Layout:
+//   Offset | Size | Field
+//   -------|------|-------------
+//   0      | 8    | index (1-based, monotonic; 0 = slot never written)
+//   8      | 8    | timestamp_ns (wall clock)
+//   16     | 8    | events_read (cumulative)
+//   24     | 8    | events_processed (cumulative)
+//   32     | 8    | validation_failures (cumulative)
+//   40     | 8    | verdicts_dropped (cumulative)
+//   48     | 4    | ring_occupancy
+//   52     | 4    | ring_capacity
+//   56     | 8    | lag_events (read - processed)
+//   64     | 8    | interval_count (latency samples in the interval)
+//   72     | 8    | interval p50 (ns)
+//   80     | 8    | interval p99 (ns)
+//   88     | 8    | interval p99.9 (ns)
+//   96     | 8    | interval max (ns)
+//   104    | 20   | reserved (zero)
+//   124    | 4    | crc32 (over bytes 0-123)
+struct MetricSnapshot {
+    uint64_t index = 0;
+    uint64_t timestamp_ns = 0;
+    uint64_t events_read = 0;
+    uint64_t events_processed = 0;
+    uint64_t validation_failures = 0;
+    uint64_t verdicts_dropped = 0;
+    uint32_t ring_occupancy = 0;
+    uint32_t ring_capacity = 0;
+    uint64_t lag_events = 0;
+    uint64_t interval_count = 0;
+    int64_t p50_ns = 0;
+    int64_t p99_ns = 0;
+    int64_t p999_ns = 0;
+    int64_t max_ns = 0;
+
+    static constexpr size_t SIZE = 128;
+};
+
+// Flight recorder file header (64 bytes)
+//   0  | 4 | magic 0x464C5452 ("FLTR")
+//   4  | 4 | version (1)
+//   8  | 4 | record size (128)
+//   12 | 4 | slot count
+//   16 | 48| reserved
+struct FlightRecorderHeader {
+    uint32_t magic = EXPECTED_MAGIC;
+    uint32_t version = EXPECTED_VERSION;
+    uint32_t record_size = static_cast<uint32_t>(MetricSnapshot::SIZE);
+    uint32_t slot_count = 0;
+
+    static constexpr uint32_t EXPECTED_MAGIC = 0x464C5452;
+    static constexpr uint32_t EXPECTED_VERSION = 1;
+    static constexpr size_t SIZE = 64;
+
+    bool isValid() const {
+        return magic == EXPECTED_MAGIC && version == EXPECTED_VERSION &&
+               record_size == MetricSnapshot::SIZE && slot_count > 0;
+    }
+};
+
+/**
+ * Fixed-size, memory-mapped circular file of metric snapshots
+ *
+ * The file is created at its final size (header + slot_count records) and
+ * mapped MAP_SHARED, so record() is a 128-byte copy into the page cache: no
+ * syscall, no allocation. Because the data lives in the page cache rather
+ * than in the process, everything recorded up to a crash (including
+ * SIGKILL or abort) is in the file afterwards.
+ *
+ * Each record carries its own CRC32, so a record torn by a crash mid-copy
+ * is detected and skipped by the reader. Record order comes from the
+ * monotonic index stored in each record, not from a header pointer, so
+ * there is no second write that could be lost. Reopening an existing file
+ * continues after its newest valid record.
+ *
+ * Single writer (the monitor thread).
+ */
+class FlightRecorder {
+public:
+    static constexpr size_t DEFAULT_SLOT_COUNT = 86400;  // 24 h at 1/s (~11 MB)
+
+    explicit FlightRecorder(const std::string& path, size_t slot_count = DEFAULT_SLOT_COUNT);
+    ~FlightRecorder();
+
+    // Non-copyable
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    /**
+     * Create (or reopen) and map the file
+     * An existing file keeps its own slot count.
+     * Throws std::runtime_error on failure
+     */
+    void open();
+
+    /**
+     * Append a snapshot, overwriting the oldest once the file is full
+     * (snapshot.index is assigned here)
+     */
+    void record(MetricSnapshot snapshot);
+
+    void close();
+
+    size_t slotCount() const { return slot_count_; }
+    uint64_t nextIndex() const { return next_index_; }
+
+    /**
+     * Serialize a snapshot into its 128-byte frame (including CRC32)
+     */
+    static void encode(const MetricSnapshot& snapshot, uint8_t* out);
+
+    /**
+     * Decode a frame
+     * @return false if the slot is empty or its CRC does not match
+     */
+    static bool decode(const uint8_t* data, MetricSnapshot& snapshot);
+
+private:
+    std::string path_;
+    size_t slot_count_;
+    int fd_;
+    uint8_t* mapped_;
+    size_t mapped_size_;
+    uint64_t next_index_;
+};
+
+/**
+ * Read all valid snapshots of a flight recorder file, oldest first
+ * Safe while the recorder is running (sees a consistent set of records).
+ * Throws std::runtime_error if the file is missing or not a recorder file
+ */
+std::vector<MetricSnapshot> readFlightRecorder(const std::string& path);
+
+}  // namespace trading_ledger
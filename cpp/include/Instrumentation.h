@@ -0,0 +1,141 @@
+#pragma once
+
+#include "LatencyHistogram.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <type_traits>
+
+// Build-wide instrumentation level, set by CMake
+// (-DTRADING_LEDGER_INSTRUMENTATION_LEVEL=NONE|COUNTERS|TIMINGS|TRACING)
+#ifndef TRADING_LEDGER_INSTRUMENTATION_LEVEL
+#define TRADING_LEDGER_INSTRUMENTATION_LEVEL 2
+#endif
+
+namespace trading_ledger {
+
+/**
+ * Compile-time instrumentation levels (each includes the ones below it)
+ *
+ * - NONE:     no probes; every probe type compiles to nothing
+ * - COUNTERS: event counters and periodic progress lines
+ * - TIMINGS:  per-event latency measurement and periodic latency summaries
+ * - TRACING:  per-event trace lines on std::clog (debug builds only)
+ *
+ * Probes are templates on the level and use `if constexpr`, so a disabled
+ * probe has no code, no branch and no storage ([[no_unique_address]]).
+ * The Basic* templates take the level explicitly so benchmarks can compare
+ * levels in one binary; production code uses the aliases bound to
+ * INSTRUMENTATION_LEVEL.
+ */
+enum class InstrumentationLevel : int {
+    NONE = 0,
+    COUNTERS = 1,
+    TIMINGS = 2,
+    TRACING = 3
+};
+
+inline constexpr InstrumentationLevel INSTRUMENTATION_LEVEL =
+    static_cast<InstrumentationLevel>(TRADING_LEDGER_INSTRUMENTATION_LEVEL);
+
+constexpr bool instrumentationAtLeast(InstrumentationLevel required,
+                                      InstrumentationLevel active = INSTRUMENTATION_LEVEL) {
+    return static_cast<int>(active) >= static_cast<int>(required);
+}
+
+namespace detail {
+struct EmptyProbeState {};
+}  // namespace detail
+
+/**
+ * Event counter (COUNTERS and above)
+ *
+ * Single writer: increments are a relaxed load + store, not a locked RMW.
+ * Any thread may read value().
+ */
+template<InstrumentationLevel Level>
+class BasicProbeCounter {
+    static constexpr bool ENABLED = instrumentationAtLeast(InstrumentationLevel::COUNTERS, Level);
+
+public:
+    void add(size_t n = 1) {
+        if constexpr (ENABLED) {
+            value_.store(value_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+    }
+
+    size_t value() const {
+        if constexpr (ENABLED) {
+            return value_.load(std::memory_order_relaxed);
+        } else {
+            return 0;
+        }
+    }
+
+    static constexpr bool enabled() { return ENABLED; }
+
+private:
+    [[no_unique_address]] std::conditional_t<ENABLED, std::atomic<size_t>, detail::EmptyProbeState> value_{};
+};
+
+/**
+ * Scoped latency probe (TIMINGS and above)
+ *
+ * Records elapsed nanoseconds into any sink with record(int64_t);
+ * LatencyHistogram by default.
+ */
+template<InstrumentationLevel Level, typename Sink = LatencyHistogram>
+class BasicScopedTimer {
+    static constexpr bool ENABLED = instrumentationAtLeast(InstrumentationLevel::TIMINGS, Level);
+
+    struct State {
+        Sink* histogram;
+        std::chrono::steady_clock::time_point start;
+    };
+
+public:
+    explicit BasicScopedTimer([[maybe_unused]] Sink& histogram) {
+        if constexpr (ENABLED) {
+            state_.histogram = &histogram;
+            state_.start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~BasicScopedTimer() {
+        if constexpr (ENABLED) {
+            auto end = std::chrono::steady_clock::now();
+            state_.histogram->record(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - state_.start).count());
+        }
+    }
+
+    BasicScopedTimer(const BasicScopedTimer&) = delete;
+    BasicScopedTimer& operator=(const BasicScopedTimer&) = delete;
+
+    static constexpr bool enabled() { return ENABLED; }
+
+private:
+    [[no_unique_address]] std::conditional_t<ENABLED, State, detail::EmptyProbeState> state_;
+};
+
+/**
+ * Per-event trace line (TRACING only)
+ */
+template<InstrumentationLevel Level>
+struct BasicTrace {
+    static constexpr bool ENABLED = instrumentationAtLeast(InstrumentationLevel::TRACING, Level);
+
+    template<typename... Args>
+    static void log([[maybe_unused]] const Args&... args) {
+        if constexpr (ENABLED) {
+            (std::clog << ... << args) << '\n';
+        }
+    }
+};
+
+using ProbeCounter = BasicProbeCounter<INSTRUMENTATION_LEVEL>;
+using ScopedTimer = BasicScopedTimer<INSTRUMENTATION_LEVEL>;
+using Trace = BasicTrace<INSTRUMENTATION_LEVEL>;
+
+}  // namespace trading_ledger
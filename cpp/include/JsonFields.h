@@ -0,0 +1,115 @@
+#pragma once
+
+#include <optional>
+#include <string_view>
+
+namespace trading_ledger {
+
+/**
+ * Minimal field lookup over flat JSON objects
+ *
+ * Event payloads are small, flat objects produced by Jackson, so a full JSON
+ * parser is unnecessary. These helpers locate a top-level "key": value pair and
+ * return a view into the original buffer - no allocation, no copies.
+ *
+ * Limitations (acceptable for our payloads):
+ * - Keys are matched textually; a key name appearing inside a string value
+ *   would also match
+ * - String values are returned raw (escape sequences are not decoded)
+ */
+class JsonFields {
+public:
+    /**
+     * Find a string-valued field
+     * @return view of the characters between the quotes, or nullopt
+     */
+    static std::optional<std::string_view> findString(std::string_view json,
+                                                      std::string_view key) {
+        size_t pos = findValueStart(json, key);
+        if (pos == std::string_view::npos || json[pos] != '"') {
+            return std::nullopt;
+        }
+
+        size_t begin = pos + 1;
+        size_t end = json.find('"', begin);
+        if (end == std::string_view::npos) {
+            return std::nullopt;
+        }
+        return json.substr(begin, end - begin);
+    }
+
+    /**
+     * Find a numeric field (also accepts a quoted number, as BigDecimal
+     * values are sometimes serialized as strings)
+     * @return view of the number token, or nullopt
+     */
+    static std::optional<std::string_view> findNumber(std::string_view json,
+                                                      std::string_view key) {
+        size_t pos = findValueStart(json, key);
+        if (pos == std::string_view::npos) {
+            return std::nullopt;
+        }
+
+        if (json[pos] == '"') {
+            return findString(json, key);
+        }
+
+        size_t end = pos;
+        while (end < json.size() && isNumberChar(json[end])) {
+            ++end;
+        }
+        if (end == pos) {
+            return std::nullopt;
+        }
+        return json.substr(pos, end - pos);
+    }
+
+    /**
+     * Check whether a key is present
+     */
+    static bool hasField(std::string_view json, std::string_view key) {
+        return findValueStart(json, key) != std::string_view::npos;
+    }
+
+private:
+    // Return index of first character of the value for "key", or npos
+    static size_t findValueStart(std::string_view json, std::string_view key) {
+        size_t pos = 0;
+        while ((pos = json.find(key, pos)) != std::string_view::npos) {
+            size_t key_end = pos + key.size();
+
+            // Key must be quoted on both sides
+            if (pos == 0 || json[pos - 1] != '"' ||
+                key_end >= json.size() || json[key_end] != '"') {
+                pos = key_end;
+                continue;
+            }
+
+            size_t p = skipWhitespace(json, key_end + 1);
+            if (p < json.size() && json[p] == ':') {
+                p = skipWhitespace(json, p + 1);
+                if (p < json.size()) {
+                    return p;
+                }
+            }
+            pos = key_end;
+        }
+        return std::string_view::npos;
+    }
+
+    static size_t skipWhitespace(std::string_view json, size_t pos) {
+        while (pos < json.size() &&
+               (json[pos] == ' ' || json[pos] == '\t' ||
+                json[pos] == '\n' || json[pos] == '\r')) {
+            ++pos;
+        }
+        return pos;
+    }
+
+    static bool isNumberChar(char c) {
+        return (c >= '0' && c <= '9') || c == '-' || c == '+' ||
+               c == '.' || c == 'e' || c == 'E';
+    }
+};
+
+}  // namespace trading_ledger
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "FixedPoint.h"
+#include "JsonFields.h"
+#include <cstdint>
+#include <string_view>
+
+namespace trading_ledger {
+
+/**
+ * One ledger entry decoded from a LEDGER_ENTRIES_GENERATED payload
+ * (views point into the event payload)
+ */
+struct LedgerEntryRecord {
+    std::string_view account_id;
+    bool is_debit = false;
+    int64_t amount = 0;  // Fixed-point, FixedPoint::SCALE
+};
+
+/**
+ * Decoder for LEDGER_ENTRIES_GENERATED payloads
+ *
+ * Payload layout (mirrors the Java LedgerEntry fields):
+ *   {"trade_id":"...","entries":[
+ *      {"account_id":"ACC1","entry_type":"DEBIT","amount":15000.00},
+ *      {"account_id":"ACC1","entry_type":"CREDIT","amount":15000.00}]}
+ */
+class LedgerEntryDecoder {
+public:
+    /**
+     * Invoke fn(const LedgerEntryRecord&) for every entry in the payload
+     * @return number of entries decoded, or -1 if any entry is malformed
+     *         (entries before the malformed one have already been delivered)
+     */
+    template<typename Fn>
+    static int forEachEntry(std::string_view payload, Fn&& fn) {
+        size_t pos = payload.find("\"entries\"");
+        if (pos == std::string_view::npos) {
+            return -1;
+        }
+        pos = payload.find('[', pos);
+        if (pos == std::string_view::npos) {
+            return -1;
+        }
+
+        int count = 0;
+        while (true) {
+            size_t begin = payload.find_first_of("{]", pos);
+            if (begin == std::string_view::npos) {
+                return -1;
+            }
+            if (payload[begin] == ']') {
+                return count;
+            }
+
+            // Entries are flat objects: the first '}' closes this one
+            size_t end = payload.find('}', begin);
+            if (end == std::string_view::npos) {
+                return -1;
+            }
+
+            LedgerEntryRecord record;
+            if (!decodeEntry(payload.substr(begin, end - begin + 1), record)) {
+                return -1;
+            }
+            fn(record);
+            ++count;
+            pos = end + 1;
+        }
+    }
+
+    /**
+     * Decode a single entry object
+     */
+    static bool decodeEntry(std::string_view object, LedgerEntryRecord& record) {
+        auto account_id = JsonFields::findString(object, "account_id");
+        auto entry_type = JsonFields::findString(object, "entry_type");
+        auto amount = JsonFields::findNumber(object, "amount");
+        if (!account_id || !entry_type || !amount) {
+            return false;
+        }
+
+        if (*entry_type == "DEBIT") {
+            record.is_debit = true;
+        } else if (*entry_type == "CREDIT") {
+            record.is_debit = false;
+        } else {
+            return false;
+        }
+
+        record.account_id = *account_id;
+        return FixedPoint::parse(*amount, record.amount) && record.amount >= 0;
+    }
+};
+
+}  // namespace trading_ledger
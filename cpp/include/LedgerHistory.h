@@ -0,0 +1,160 @@
+#pragma once
+
+#include "AccountBalanceBook.h"
+#include "Event.h"
+#include "PositionBook.h"
+#include "SparseLogIndex.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace trading_ledger {
+
+/**
+ * Balances and positions after applying the log up to `sequence`
+ */
+struct LedgerState {
+    AccountBalanceBook balances{0};   // No periodic invariant checks on replay
+    PositionBook positions;
+    uint64_t sequence = 0;            // Last applied event (0 = none)
+    uint64_t timestamp_ns = 0;
+    uint64_t events_applied = 0;
+
+    void apply(const EventView& event);
+};
+
+/**
+ * Where a snapshot sits in the snapshot file
+ */
+struct SnapshotInfo {
+    uint64_t sequence = 0;
+    uint64_t timestamp_ns = 0;
+    uint64_t file_offset = 0;     // Start of the record
+    uint32_t length = 0;          // Body length
+};
+
+/**
+ * Append-only file of LedgerState snapshots
+ *
+ * Layout: 16-byte header ("SNAP", version 1), then records of
+ *   u32 body length | body | u32 crc32(body)
+ * Body: sequence, timestamp_ns, events_applied (u64), then the balances
+ * (count; per account: name, debit, credit, balance, entry count, last
+ * sequence) and positions (count; per position: account, symbol, net, buy,
+ * sell, trade count). Names are u16 length + bytes; integers little-endian.
+ *
+ * A torn last record (crash mid-append) is ignored on open and overwritten
+ * by the next append.
+ */
+class SnapshotStore {
+public:
+    static constexpr uint32_t MAGIC = 0x50414E53;  // "SNAP"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 16;
+
+    explicit SnapshotStore(std::string path) : path_(std::move(path)) {}
+
+    /**
+     * Read the catalog (a missing file is an empty store)
+     * Throws std::runtime_error if the file is not a snapshot file
+     */
+    void open();
+
+    /**
+     * Append a snapshot of state (creates the file if needed)
+     * Throws std::runtime_error on I/O failure
+     */
+    void append(const LedgerState& state);
+
+    /**
+     * Load a snapshot listed in the catalog
+     * Throws CorruptedEventException on a CRC mismatch
+     */
+    std::unique_ptr<LedgerState> load(const SnapshotInfo& info) const;
+
+    /**
+     * Latest snapshot at or before the target
+     * @return nullptr if there is none
+     */
+    const SnapshotInfo* floorBySequence(uint64_t sequence) const;
+    const SnapshotInfo* floorByTimestamp(uint64_t timestamp_ns) const;
+
+    const std::vector<SnapshotInfo>& catalog() const { return catalog_; }
+
+private:
+    std::string path_;
+    std::vector<SnapshotInfo> catalog_;
+    uint64_t valid_end_ = 0;      // End of the last intact record
+};
+
+/**
+ * Time-travel balance and position queries over one event log
+ *
+ * update() extends two sidecar files next to the log: the sparse index
+ * (<log>.idx) and a snapshot every `snapshot_interval` events
+ * (<log>.snap). It resumes from the last snapshot, so running it
+ * periodically costs only the new events.
+ *
+ * An as-of query loads the latest snapshot at or before the target,
+ * resolves its position in the log through the sparse index (at most
+ * `index_stride` header hops), and replays only the events in between:
+ * latency depends on the snapshot interval, not on the length of history.
+ *
+ * Time targets use the timestamp_ns written in the log (the writer's
+ * monotonic clock) and assume it never decreases along the log.
+ */
+class LedgerHistory {
+public:
+    static constexpr size_t DEFAULT_SNAPSHOT_INTERVAL = 100000;
+
+    struct Config {
+        size_t snapshot_interval = DEFAULT_SNAPSHOT_INTERVAL;
+        size_t index_stride = SparseLogIndex::DEFAULT_STRIDE;
+    };
+
+    struct UpdateStats {
+        size_t events_replayed = 0;
+        size_t snapshots_written = 0;
+        size_t index_entries_added = 0;
+        double seconds = 0;
+    };
+
+    struct QueryStats {
+        uint64_t snapshot_sequence = 0;   // 0 = replayed from the start
+        size_t events_replayed = 0;
+        double seconds = 0;
+    };
+
+    LedgerHistory(std::string log_path, Config config);
+    explicit LedgerHistory(std::string log_path) : LedgerHistory(std::move(log_path), Config{}) {}
+
+    std::string indexPath() const { return log_path_ + ".idx"; }
+    std::string snapshotPath() const { return log_path_ + ".snap"; }
+
+    /**
+     * Bring the index and snapshots up to the end of the log
+     * Throws std::runtime_error on I/O failure or if the snapshots do not
+     * belong to this log, CorruptedEventException on a CRC mismatch
+     */
+    UpdateStats update();
+
+    /**
+     * State after the last event with sequence <= target
+     */
+    std::unique_ptr<LedgerState> asOfSequence(uint64_t sequence, QueryStats* stats = nullptr);
+
+    /**
+     * State after the last event with timestamp_ns <= target
+     */
+    std::unique_ptr<LedgerState> asOfTime(uint64_t timestamp_ns, QueryStats* stats = nullptr);
+
+private:
+    std::string log_path_;
+    Config config_;
+
+    std::unique_ptr<LedgerState> asOf(bool by_time, uint64_t target, QueryStats* stats);
+};
+
+}  // namespace trading_ledger
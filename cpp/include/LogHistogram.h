@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+
+namespace trading_ledger {
+
+/**
+ * Fixed-size log-linear latency histogram
+ *
+ * Complements LatencyHistogram (exact, map-based) where recording must be
+ * O(1) and allocation-free: each power of two is split into 16 linear
+ * sub-buckets, so any recorded value is reported within ~6% of its true
+ * value. 960 buckets cover every non-negative int64_t.
+ *
+ * Single owner, not thread-safe.
+ */
+class LogHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT = 60 * SUB_BUCKETS;
+
+    void record(int64_t value) {
+        if (value < 0) {
+            value = 0;
+        }
+        counts_[bucketIndex(static_cast<uint64_t>(value))]++;
+        count_++;
+        if (value > max_) {
+            max_ = value;
+        }
+    }
+
+    uint64_t count() const { return count_; }
+    int64_t max() const { return max_; }
+
+    /**
+     * Percentile (0.0 to 1.0), reported as the upper bound of its bucket
+     * (never above the recorded maximum)
+     */
+    int64_t percentile(double p) const {
+        if (count_ == 0) {
+            return 0;
+        }
+        uint64_t target = static_cast<uint64_t>(p * static_cast<double>(count_));
+        if (target >= count_) {
+            target = count_ - 1;
+        }
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            cumulative += counts_[i];
+            if (cumulative > target) {
+                int64_t upper = bucketUpperBound(i);
+                return upper < max_ ? upper : max_;
+            }
+        }
+        return max_;
+    }
+
+    void clear() {
+        counts_.fill(0);
+        count_ = 0;
+        max_ = 0;
+    }
+
+    static size_t bucketIndex(uint64_t value) {
+        if (value < SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+        int msb = 63 - std::countl_zero(value);
+        int exponent = msb - (SUB_BUCKET_BITS - 1);
+        size_t mantissa = static_cast<size_t>(value >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+        return static_cast<size_t>(exponent) * SUB_BUCKETS + mantissa;
+    }
+
+    static int64_t bucketLowerBound(size_t index) {
+        if (index < SUB_BUCKETS) {
+            return static_cast<int64_t>(index);
+        }
+        size_t exponent = index / SUB_BUCKETS;
+        size_t mantissa = index % SUB_BUCKETS;
+        return static_cast<int64_t>((SUB_BUCKETS + mantissa) << (exponent - 1));
+    }
+
+    static int64_t bucketUpperBound(size_t index) {
+        if (index + 1 >= BUCKET_COUNT) {
+            return INT64_MAX;
+        }
+        return bucketLowerBound(index + 1) - 1;
+    }
+
+private:
+    std::array<uint32_t, BUCKET_COUNT> counts_{};
+    uint64_t count_ = 0;
+    int64_t max_ = 0;
+};
+
+}  // namespace trading_ledger
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace trading_ledger {
+
+/**
+ * Read-only mapping of a whole event log for batch jobs (settlement, replay)
+ *
+ * Unlike EventLogReader there is no cursor and no remapping: the mapping
+ * covers the file as it was when opened. The 16-byte file header is checked
+ * on open.
+ * Throws std::runtime_error if the file cannot be opened or mapped,
+ * ParseException on a bad file header
+ */
+class MappedLog {
+public:
+    explicit MappedLog(const std::string& path);
+    ~MappedLog();
+
+    MappedLog(const MappedLog&) = delete;
+    MappedLog& operator=(const MappedLog&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    /**
+     * Hint that the whole log will be read soon (MADV_WILLNEED)
+     */
+    void willNeed() const;
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+}  // namespace trading_ledger
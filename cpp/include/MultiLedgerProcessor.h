@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trading_ledger {
+
+/**
+ * Serves many ledger logs from one process
+ *
+ * Threads (independent of the number of ledgers):
+ * - One I/O thread tails every log. It sleeps in a single epoll over all
+ *   the tailers' inotify fds and reads new events into each ledger's ring.
+ *   A ledger whose ring is full is parked on the ring's space eventfd (in
+ *   the same epoll) until its worker frees a slot, so a slow ledger costs
+ *   the I/O thread no polling.
+ * - A pool of worker threads validates. Each ledger (tenant) has its own
+ *   DoubleEntryValidator and AccountBalanceBook; a tenant is processed by
+ *   at most one worker at a time, so tenant state needs no locks and is
+ *   never shared between ledgers.
+ *
+ * Scheduling: a tenant with pending events sits exactly once in a FIFO run
+ * queue. A worker takes it, processes at most `quantum` events, and puts
+ * it back at the tail if more are pending. A busy ledger therefore cannot
+ * starve a quiet one (round-robin in quanta), and idle workers block on a
+ * condition variable instead of spinning.
+ *
+ * Isolation: a corrupted log stops only its own tenant (reported in its
+ * stats); the other ledgers keep running.
+ */
+class MultiLedgerProcessor {
+public:
+    static constexpr size_t RING_SIZE = 4096;
+    static constexpr size_t DEFAULT_QUANTUM = 256;
+
+    struct Config {
+        size_t worker_count = 2;
+        size_t quantum = DEFAULT_QUANTUM;  // Events per scheduling turn
+    };
+
+    // Per-tenant counters (safe to read while running)
+    struct TenantStats {
+        std::string name;
+        uint64_t events_read = 0;
+        uint64_t events_processed = 0;
+        uint64_t validation_failures = 0;
+        uint64_t turns = 0;      // Scheduling turns taken
+        uint64_t full_waits = 0; // Times reading paused on a full ring
+        size_t backlog = 0;      // Events queued in the tenant's ring
+        bool failed = false;     // Log unreadable (corrupted); tenant stopped
+    };
+
+    explicit MultiLedgerProcessor(Config config);
+    MultiLedgerProcessor() : MultiLedgerProcessor(Config{}) {}
+    ~MultiLedgerProcessor();
+
+    // Non-copyable
+    MultiLedgerProcessor(const MultiLedgerProcessor&) = delete;
+    MultiLedgerProcessor& operator=(const MultiLedgerProcessor&) = delete;
+
+    /**
+     * Register a ledger log (before start())
+     * Throws std::runtime_error if the log cannot be opened
+     * @return tenant index
+     */
+    size_t addLedger(const std::string& name, const std::string& log_path);
+
+    /**
+     * Start the I/O thread and the worker pool
+     */
+    void start();
+
+    /**
+     * Stop tailing, process every event already read, and join all threads
+     */
+    void stop();
+
+    size_t ledgerCount() const { return tenants_.size(); }
+
+    std::vector<TenantStats> stats() const;
+
+    /**
+     * Per-ledger validator and balance summaries (after stop())
+     */
+    void printSummary(std::ostream& out = std::cout) const;
+
+private:
+    struct Tenant;
+
+    Config config_;
+    std::vector<std::unique_ptr<Tenant>> tenants_;
+
+    std::thread io_thread_;
+    std::vector<std::thread> workers_;
+    std::atomic<bool> running_;
+    int wake_fd_;  // eventfd: interrupts the I/O thread's epoll on stop()
+
+    // Run queue of tenants with pending events
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::deque<Tenant*> run_queue_;
+    bool workers_stopping_;
+
+    void ioLoop();
+    void workerLoop();
+
+    // Read new events of one tenant into its ring
+    // @return true if the tenant still has unread data and ring space (the
+    //         per-pass cap was hit); a full ring parks the tenant instead
+    bool pump(Tenant& tenant);
+
+    // On stop: push the events read but not yet queued (blocks on space)
+    void flushPending(Tenant& tenant);
+
+    // Process up to quantum events of one tenant
+    void runTurn(Tenant& tenant);
+
+    // Enqueue the tenant unless it is already queued or running
+    void schedule(Tenant& tenant);
+};
+
+}  // namespace trading_ledger
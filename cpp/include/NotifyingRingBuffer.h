@@ -0,0 +1,251 @@
+#pragma once
+
+#include "RingBuffer.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+
+namespace trading_ledger {
+
+/**
+ * SPSC ring buffer with an optional eventfd wake-up (Linux)
+ *
+ * Wraps RingBuffer so a consumer can sleep instead of spinning, and can sleep
+ * on the ring together with other fds (inotify, sockets) in one epoll/poll.
+ *
+ * Protocol (consumer):
+ *   while (!ring.try_pop(item)) {
+ *       if (ring.prepareWait()) {     // arm: "I am about to sleep"
+ *           poll/epoll on ring.fd() and other fds
+ *           ring.finishWait();        // disarm + drain eventfd
+ *       }
+ *   }
+ *
+ * Protocol (producer): try_push() as usual. The eventfd is written only when
+ * the consumer has armed it, i.e. only on the empty -> non-empty transition
+ * while the consumer sleeps. A busy consumer costs the producer one fence and
+ * one load per push - no syscall per event.
+ *
+ * The reverse direction works the same way on a second eventfd: a producer
+ * facing a full ring sleeps in waitForSpace() (or polls spaceFd() between
+ * prepareSpaceWait() and finishSpaceWait()), and try_pop() wakes it on the
+ * full -> not-full transition, at one fence and one load per pop.
+ *
+ * Memory ordering (Dekker pattern):
+ * - Consumer: store armed=true, full fence, re-check ring empty
+ * - Producer: publish tail, full fence, load armed
+ * At least one side observes the other, so a push can never slip between the
+ * consumer's emptiness check and its sleep without a wake-up (and a pop never
+ * slips past the producer's fullness check, symmetrically).
+ */
+template<typename T, size_t SIZE>
+class NotifyingRingBuffer {
+public:
+    NotifyingRingBuffer() requires (SIZE != DYNAMIC_RING_SIZE) : armed_(false), space_armed_(false) {
+        openEventFds();
+    }
+
+    // Runtime-sized ring (SIZE == DYNAMIC_RING_SIZE)
+    explicit NotifyingRingBuffer(size_t size) requires (SIZE == DYNAMIC_RING_SIZE)
+        : ring_(size), armed_(false), space_armed_(false) {
+        openEventFds();
+    }
+
+    ~NotifyingRingBuffer() {
+        close(event_fd_);
+        close(space_fd_);
+    }
+
+    // Non-copyable, non-movable (contains atomics and an fd)
+    NotifyingRingBuffer(const NotifyingRingBuffer&) = delete;
+    NotifyingRingBuffer& operator=(const NotifyingRingBuffer&) = delete;
+    NotifyingRingBuffer(NotifyingRingBuffer&&) = delete;
+    NotifyingRingBuffer& operator=(NotifyingRingBuffer&&) = delete;
+
+    /**
+     * Producer: push item, waking a sleeping consumer if needed
+     */
+    bool try_push(const T& item) {
+        if (!ring_.try_push(item)) {
+            return false;
+        }
+        notifyIfArmed();
+        return true;
+    }
+
+    bool try_push(T&& item) {
+        if (!ring_.try_push(std::move(item))) {
+            return false;
+        }
+        notifyIfArmed();
+        return true;
+    }
+
+    /**
+     * Consumer: pop item (non-blocking), waking a producer that sleeps on a
+     * full ring
+     */
+    bool try_pop(T& item) {
+        if (!ring_.try_pop(item)) {
+            return false;
+        }
+        signal(space_armed_, space_fd_);
+        return true;
+    }
+
+    /**
+     * Consumer: announce intent to sleep
+     * @return true if the ring is still empty and the caller may block on fd();
+     *         false if data arrived meanwhile (caller must not sleep)
+     */
+    bool prepareWait() {
+        armed_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (!ring_.empty()) {
+            armed_.store(false, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Consumer: called after waking (or timing out); disarms and drains
+     * the eventfd counter so the fd stops polling readable
+     */
+    void finishWait() {
+        armed_.store(false, std::memory_order_relaxed);
+        uint64_t count;
+        while (read(event_fd_, &count, sizeof(count)) < 0 && errno == EINTR) {}
+    }
+
+    /**
+     * Consumer: block until the ring is non-empty or timeout
+     * @param timeout_ms Max milliseconds to wait (-1 = infinite)
+     * @return true if the ring is non-empty
+     */
+    bool wait(int timeout_ms) {
+        if (prepareWait()) {
+            struct pollfd pfd;
+            pfd.fd = event_fd_;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            poll(&pfd, 1, timeout_ms);
+            finishWait();
+        }
+        return !ring_.empty();
+    }
+
+    /**
+     * Producer: announce intent to sleep on a full ring
+     * @return true if the ring is still full and the caller may block on
+     *         spaceFd(); false if a slot was freed meanwhile
+     */
+    bool prepareSpaceWait() {
+        space_armed_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (!ring_.full()) {
+            space_armed_.store(false, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Producer: called after waking (or timing out) from a space wait
+     */
+    void finishSpaceWait() {
+        space_armed_.store(false, std::memory_order_relaxed);
+        uint64_t count;
+        while (read(space_fd_, &count, sizeof(count)) < 0 && errno == EINTR) {}
+    }
+
+    /**
+     * Producer: block until the ring has a free slot or timeout
+     * @param timeout_ms Max milliseconds to wait (-1 = infinite)
+     * @return true if the ring has room
+     */
+    bool waitForSpace(int timeout_ms) {
+        if (prepareSpaceWait()) {
+            struct pollfd pfd;
+            pfd.fd = space_fd_;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            poll(&pfd, 1, timeout_ms);
+            finishSpaceWait();
+        }
+        return !ring_.full();
+    }
+
+    /**
+     * Any thread: wake a sleeping consumer without pushing (out-of-band work
+     * such as control commands). No syscall unless the consumer is asleep.
+     */
+    void wake() {
+        notifyIfArmed();
+    }
+
+    /**
+     * eventfd to register with poll/epoll (readable when consumer should wake)
+     */
+    int fd() const { return event_fd_; }
+
+    /**
+     * eventfd readable when a producer armed by prepareSpaceWait() should wake
+     */
+    int spaceFd() const { return space_fd_; }
+
+    bool empty() const { return ring_.empty(); }
+    size_t size() const { return ring_.size(); }
+    constexpr size_t capacity() const { return ring_.capacity(); }
+
+private:
+    RingBuffer<T, SIZE> ring_;
+
+    // Consumer is (about to be) asleep; producer must signal
+    alignas(64) std::atomic<bool> armed_;
+    int event_fd_;
+
+    // Producer is (about to be) asleep on a full ring; consumer must signal
+    alignas(64) std::atomic<bool> space_armed_;
+    int space_fd_;
+
+    void openEventFds() {
+        event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (event_fd_ < 0) {
+            throw std::runtime_error("Failed to create eventfd (error: " +
+                                     std::string(strerror(errno)) + ")");
+        }
+        space_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (space_fd_ < 0) {
+            int error = errno;
+            close(event_fd_);
+            throw std::runtime_error("Failed to create eventfd (error: " +
+                                     std::string(strerror(error)) + ")");
+        }
+    }
+
+    void notifyIfArmed() {
+        signal(armed_, event_fd_);
+    }
+
+    static void signal(std::atomic<bool>& armed, int fd) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // exchange: exactly one wake-up per sleep
+        if (armed.load(std::memory_order_relaxed) &&
+            armed.exchange(false, std::memory_order_relaxed)) {
+            uint64_t one = 1;
+            while (write(fd, &one, sizeof(one)) < 0 && errno == EINTR) {}
+        }
+    }
+};
+
+}  // namespace trading_ledger
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Event.h"
+#include "PipelineTopology.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace trading_ledger {
+
+/**
+ * A running pipeline instantiated from a TopologyConfig
+ *
+ * Each stage worker is a thread that pops from its input rings (SPSC,
+ * runtime-sized RingBuffer / NotifyingRingBuffer), applies its node's work,
+ * and pushes to the rings of every downstream node (routing to a shard by
+ * trade_id or account_id). Sources tail an event log exactly like the
+ * event_processor producer.
+ *
+ * Shutdown is ordered by the DAG: stop() ends the sources; a stage worker
+ * exits once every upstream worker has exited and its inputs are empty, so
+ * no event in flight is lost.
+ *
+ * A stage that throws is reported and keeps draining (dropping) its input
+ * so upstream never blocks, and the pipeline is stopped.
+ *
+ * Elastic validate stages (min= in the topology) keep their state in
+ * VIRTUAL_SHARDS validators, each owned by one active worker. A scaler
+ * thread samples per-event service time and input lag every
+ * SCALE_INTERVAL_MS and adds a worker when the estimated queueing delay
+ * exceeds the SLO (or workers are nearly saturated), or retires one when
+ * the rest could carry the load at under half utilization. Service time
+ * excludes time blocked pushing downstream, so a slow consumer does not
+ * scale up the stage that feeds it. Ownership moves
+ * under a barrier: upstream emits are paused, the inputs drain, every
+ * active worker parks, shards are reassigned, and everything resumes, so
+ * a shard's state and events never have two owners.
+ */
+class Pipeline {
+public:
+    struct NodeStats {
+        std::string name;
+        NodeKind kind = NodeKind::SINK;
+        size_t workers = 0;
+        uint64_t events = 0;          // Pushed (sources) or processed (stages)
+        uint64_t failures = 0;        // Validation failures (validate stages)
+        size_t queued = 0;            // Events in the node's input rings now
+        size_t capacity = 0;          // Total input ring capacity
+        std::string error;            // First worker error, if any
+        size_t active_workers = 0;    // Elastic: currently owning shards (else = workers)
+        uint64_t rebalances = 0;      // Elastic: completed ownership changes
+    };
+
+    static constexpr size_t VIRTUAL_SHARDS = 64;
+    static constexpr unsigned SCALE_INTERVAL_MS = 100;
+
+    /**
+     * @param log_path Log for sources without path=
+     * Throws std::invalid_argument if the topology is invalid
+     */
+    Pipeline(TopologyConfig config, std::string log_path);
+    ~Pipeline();
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    /**
+     * Create rings and start every worker thread
+     */
+    void start();
+
+    /**
+     * Stop the sources; the stages drain and exit (returns immediately)
+     */
+    void stop();
+
+    /**
+     * Wait for every worker
+     */
+    void join();
+
+    /**
+     * True once every worker has exited (sources with follow=no reach this
+     * on their own at end of log)
+     */
+    bool finished() const;
+
+    /**
+     * Any thread: relaxed per-node counters
+     */
+    std::vector<NodeStats> stats() const;
+
+    /**
+     * After join(): per-node results (validation summary, balance book
+     * invariant, position count)
+     */
+    void report(std::ostream& out = std::cout) const;
+
+    const TopologyConfig& config() const { return config_; }
+
+private:
+    struct Ring;
+    struct Edge;
+    struct Worker;
+    struct Node;
+    struct Elastic;
+
+    TopologyConfig config_;
+    std::string log_path_;
+    std::vector<std::unique_ptr<Node>> nodes_;      // Topological (file) order
+    std::vector<std::unique_ptr<Edge>> edges_;
+    std::atomic<bool> running_{true};
+    std::atomic<size_t> live_workers_{0};
+    bool started_ = false;
+
+    void runSource(Worker& worker);
+    void runStage(Worker& worker);
+    void process(Worker& worker, Event& event);
+    void emit(Worker& worker, Event&& event);
+    bool upstreamDone(const Node& node) const;
+    void waitForInput(Worker& worker, size_t idle_rounds);
+    void workerExited(Worker& worker);
+    void enterElastic(Worker& worker, Node& target);
+    bool parkIfPaused(Worker& worker);
+    void runScaler(Node& node);
+    bool rebalance(Node& node, size_t active);
+};
+
+}  // namespace trading_ledger
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Instrumentation.h"
+#include "LogHistogram.h"
+#include <atomic>
+#include <cstdint>
+
+namespace trading_ledger {
+
+/**
+ * Latency percentiles over one monitoring interval
+ */
+struct IntervalLatency {
+    uint64_t count = 0;
+    int64_t p50_ns = 0;
+    int64_t p99_ns = 0;
+    int64_t p999_ns = 0;
+    int64_t max_ns = 0;
+};
+
+/**
+ * Request/publish handoff of interval latency from the consumer
+ *
+ * The consumer owns its LogHistogram and never shares it. The monitor sets
+ * a request flag; the consumer, on its next loop iteration, computes the
+ * percentiles, publishes them and clears its histogram. The consumer's cost
+ * when no request is pending is one relaxed load per iteration.
+ */
+class IntervalLatencyHandoff {
+public:
+    // Monitor: ask for the interval ending now
+    void request() { requested_.store(true, std::memory_order_relaxed); }
+
+    // Monitor: read the published interval
+    // @return false if the consumer has not served the request yet
+    bool collect(IntervalLatency& out) const {
+        if (requested_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        out.count = count_.load(std::memory_order_relaxed);
+        out.p50_ns = p50_ns_.load(std::memory_order_relaxed);
+        out.p99_ns = p99_ns_.load(std::memory_order_relaxed);
+        out.p999_ns = p999_ns_.load(std::memory_order_relaxed);
+        out.max_ns = max_ns_.load(std::memory_order_relaxed);
+        return true;
+    }
+
+    // Consumer: cheap check, call once per loop iteration
+    bool requested() const { return requested_.load(std::memory_order_relaxed); }
+
+    // Consumer: publish the interval and start a new one
+    void publish(LogHistogram& histogram) {
+        count_.store(histogram.count(), std::memory_order_relaxed);
+        p50_ns_.store(histogram.percentile(0.50), std::memory_order_relaxed);
+        p99_ns_.store(histogram.percentile(0.99), std::memory_order_relaxed);
+        p999_ns_.store(histogram.percentile(0.999), std::memory_order_relaxed);
+        max_ns_.store(histogram.max(), std::memory_order_relaxed);
+        histogram.clear();
+        requested_.store(false, std::memory_order_release);
+    }
+
+private:
+    std::atomic<bool> requested_{false};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<int64_t> p50_ns_{0};
+    std::atomic<int64_t> p99_ns_{0};
+    std::atomic<int64_t> p999_ns_{0};
+    std::atomic<int64_t> max_ns_{0};
+};
+
+/**
+ * Counters shared between the pipeline threads and the monitor
+ *
+ * Each group is written by exactly one thread and sits on its own cache
+ * line, so the producer and consumer never contend on a line; the monitor
+ * only reads.
+ */
+struct PipelineMetrics {
+    // Producer
+    alignas(64) ProbeCounter events_read;
+
+    // Consumer
+    alignas(64) ProbeCounter events_processed;
+    ProbeCounter validation_failures;
+
+    // Consumer -> monitor
+    alignas(64) IntervalLatencyHandoff interval_latency;
+};
+
+}  // namespace trading_ledger
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace trading_ledger {
+
+/**
+ * How a stage worker waits when its input rings are empty
+ *
+ * SPIN:   busy-poll (lowest latency, burns the core)
+ * YIELD:  sched_yield between polls
+ * SLEEP:  exponential backoff sleep, 1 us up to 1 ms
+ * NOTIFY: sleep on the rings' eventfds (NotifyingRingBuffer); producers pay
+ *         one fence per push, a syscall only when the worker is asleep
+ */
+enum class WaitStrategy { SPIN, YIELD, SLEEP, NOTIFY };
+
+/**
+ * What a node does with each event
+ *
+ * SOURCE:    tails an event log (EventLogReader + EventLogTailer)
+ * VALIDATE:  DoubleEntryValidator; sharded by trade_id
+ * BALANCES:  AccountBalanceBook; one worker (an event touches many accounts)
+ * POSITIONS: PositionBook; sharded by account_id
+ * SINK:      counts and drops (ring / topology benchmarks)
+ */
+enum class NodeKind { SOURCE, VALIDATE, BALANCES, POSITIONS, SINK };
+
+const char* waitStrategyName(WaitStrategy wait);
+const char* nodeKindName(NodeKind kind);
+
+struct NodeConfig {
+    std::string name;
+    NodeKind kind = NodeKind::SINK;
+    std::vector<std::string> inputs;      // Upstream node names (stages only)
+    size_t parallelism = 1;               // Workers (stages only); elastic: the maximum
+    size_t min_parallelism = 0;           // Elastic validate: active-worker floor (0 = fixed)
+    uint64_t slo_us = 1000;               // Elastic: target queueing delay
+    size_t ring_size = 4096;              // Slots per input ring (power of 2)
+    WaitStrategy wait = WaitStrategy::NOTIFY;
+    std::vector<int> cpus;                // Worker i pins to cpus[i % n]; empty = any
+    std::string path;                     // Source log (empty = command line)
+    bool follow = true;                   // Source: tail the log; false = stop at EOF
+
+    bool elastic() const { return min_parallelism != 0 && min_parallelism < parallelism; }
+};
+
+/**
+ * Pipeline described as a DAG, one node per line
+ *
+ *   # name       kind       options
+ *   source  events                          cpu=0
+ *   stage   validate  kind=validate  input=events    parallelism=2 ring=4096 wait=notify cpu=1,2
+ *   stage   balances  kind=balances  input=validate  ring=8192 wait=yield cpu=3
+ *   stage   positions kind=positions input=validate  ring=1024 wait=sleep
+ *   monitor interval=5
+ *
+ * Stage options: kind, input (comma-separated), parallelism, ring, wait
+ * (spin|yield|sleep|notify), cpu (comma-separated). Source options: path,
+ * follow (yes|no; "no" stops at end of log, for benchmarks), cpu.
+ * A node's inputs must be declared above it, so file order is a
+ * topological order and cycles cannot be written.
+ *
+ * A validate stage with min=K (K < parallelism) is elastic: it starts with
+ * K active workers and scales between K and parallelism to hold its input
+ * queueing delay under slo=MICROSECONDS (default 1000):
+ *   stage validate kind=validate input=events parallelism=8 min=1 slo=500
+ *
+ * Every edge is a set of SPSC rings, one per (upstream worker, downstream
+ * worker) pair: a sharded stage's workers never share a ring. Stages below
+ * a sharded stage therefore see per-shard order, not global order (the
+ * books they drive are order-independent sums).
+ */
+struct TopologyConfig {
+    std::vector<NodeConfig> nodes;
+    unsigned monitor_interval_seconds = 5;    // 0 = no monitor
+
+    /**
+     * Parse and validate a topology
+     * Throws std::invalid_argument ("line N: ...") on a bad line or graph
+     */
+    static TopologyConfig parse(std::istream& in);
+
+    /**
+     * Throws std::runtime_error if the file cannot be read
+     */
+    static TopologyConfig load(const std::string& path);
+
+    /**
+     * The single-producer, single-consumer topology event_processor uses
+     */
+    static TopologyConfig defaultTopology();
+
+    /**
+     * Check the graph (names, inputs, sizes, per-kind limits)
+     * Throws std::invalid_argument
+     */
+    void validate() const;
+
+    const NodeConfig* find(const std::string& name) const;
+
+    /**
+     * Write back in the file format
+     */
+    void write(std::ostream& out) const;
+};
+
+}  // namespace trading_ledger
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "DenseIdMap.h"
+#include "Event.h"
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace trading_ledger {
+
+/**
+ * Net security position per (account, symbol), driven by TRADE_CREATED
+ *
+ * Quantities are fixed point (FixedPoint::SCALE); BUY adds, SELL subtracts.
+ * Single writer, dense ids, no locks (same model as AccountBalanceBook).
+ */
+class PositionBook {
+public:
+    struct Position {
+        int64_t net_quantity = 0;
+        int64_t buy_quantity = 0;
+        int64_t sell_quantity = 0;
+        uint64_t trade_count = 0;
+    };
+
+    /**
+     * Apply a TRADE_CREATED event (other event types are ignored)
+     * @return true if the trade was applied; undecodable trades are counted
+     */
+    bool applyEvent(const EventView& event);
+    bool applyEvent(const Event& event) { return applyEvent(event.view()); }
+
+    /**
+     * Load a position from a snapshot (replaces any existing state)
+     */
+    void restore(std::string_view account, std::string_view symbol, const Position& position);
+
+    /**
+     * @return nullptr if the account never traded the symbol
+     */
+    const Position* find(std::string_view account, std::string_view symbol) const;
+
+    /**
+     * Visit every position: fn(account, symbol, position)
+     */
+    template<typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const auto& [key, slot] : positions_) {
+            fn(accounts_.name(static_cast<uint32_t>(key >> 32)),
+               symbols_.name(static_cast<uint32_t>(key)), slot.position);
+        }
+    }
+
+    /**
+     * Dirty tracking for incremental checkpoints: while enabled, each
+     * position changed since the last clearDirty() is visited once by
+     * forEachDirty()
+     */
+    void setDirtyTracking(bool enabled) { track_dirty_ = enabled; }
+    size_t dirtyCount() const { return dirty_.size(); }
+    void clearDirty();
+
+    template<typename Fn>
+    void forEachDirty(Fn&& fn) const {
+        for (const auto* entry : dirty_) {
+            fn(accounts_.name(static_cast<uint32_t>(entry->first >> 32)),
+               symbols_.name(static_cast<uint32_t>(entry->first)), entry->second.position);
+        }
+    }
+
+    size_t size() const { return positions_.size(); }
+    uint64_t malformedTrades() const { return malformed_trades_; }
+
+private:
+    struct Slot {
+        Position position;
+        bool dirty = false;
+    };
+    using Map = std::unordered_map<uint64_t, Slot>;   // account << 32 | symbol
+
+    DenseIdMap accounts_;
+    DenseIdMap symbols_;
+    Map positions_;
+    uint64_t malformed_trades_ = 0;
+
+    bool track_dirty_ = false;
+    std::vector<Map::value_type*> dirty_;   // Node addresses are stable
+
+    static uint64_t key(uint32_t account, uint32_t symbol) {
+        return (static_cast<uint64_t>(account) << 32) | symbol;
+    }
+};
+
+}  // namespace trading_ledger
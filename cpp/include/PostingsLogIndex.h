@@ -0,0 +1,154 @@
+#pragma once
+
+#include "DenseIdMap.h"
+#include "Event.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace trading_ledger {
+
+/**
+ * Inverted index over an event log: account id / symbol -> sorted offsets
+ * of the frames that mention it
+ *
+ * TRADE_CREATED events are posted under their account_id and symbol,
+ * LEDGER_ENTRIES_GENERATED events under every account_id in their entries.
+ * A history query then reads only the frames listed, instead of the whole
+ * log.
+ *
+ * Each posting list is stored in blocks of BLOCK offsets: a skip header
+ * (first and last offset, bit width) plus the 128 deltas bit-packed at the
+ * block's width. The packing is vertical: delta i sits in 32-bit lane i % 4,
+ * so unpacking four deltas is the same shift-and-mask on four adjacent
+ * words, which the compiler vectorizes. Deltas of 2^32 or more (rare: gaps
+ * of 4 GiB in one account's history) store the block unpacked. The newest
+ * offsets of a list stay uncompressed until they fill a block.
+ *
+ * Intersections (account AND symbol) skip whole blocks on the skip headers
+ * and unpack only blocks that can hold a match.
+ *
+ * Built incrementally: extend() from a mapped log (frame headers are hopped,
+ * CRCs are not checked), or add() per event during ingestion. Offsets
+ * below the scanned offset are already indexed and are ignored, so the
+ * same log can be fed again after a restart.
+ *
+ * File format (little-endian):
+ *   0  | 4 | magic "PIDX" (0x58444950)
+ *   4  | 4 | version (1)
+ *   8  | 8 | scanned offset (first byte not yet indexed)
+ *   16 | 8 | frames scanned
+ *   24 | 8 | offset of the last frame indexed
+ *   32 | 8 | sequence of the last frame indexed
+ *   40 | 4 | account count
+ *   44 | 4 | symbol count
+ *   48 | .. | posting lists, accounts then symbols, each:
+ *             u16 name length, name, u32 posting count,
+ *             per full block: u64 first, u64 last, u8 width, packed words,
+ *             then the unpacked tail (u64 offsets)
+ *   .. | 4 | crc32 of everything before it
+ */
+class PostingsLogIndex {
+public:
+    static constexpr uint32_t MAGIC = 0x58444950;   // "PIDX"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t BLOCK = 128;
+    static constexpr size_t LANES = 4;
+    static constexpr uint8_t UNPACKED = 64;         // Width of a block stored as raw deltas
+
+    enum class Field : uint8_t { ACCOUNT, SYMBOL };
+
+    PostingsLogIndex();
+
+    /**
+     * Index frames from the scanned offset up to the end of data (a whole
+     * mapped log, file header included). A trailing partial frame is left
+     * for the next call.
+     * @return number of frames indexed
+     */
+    size_t extend(const uint8_t* data, size_t size);
+
+    /**
+     * Index one event that starts at `offset` in the log
+     * @return false if the offset is already indexed
+     */
+    bool add(const EventView& event, uint64_t offset);
+
+    /**
+     * Sorted offsets of the frames that mention the name (empty if none)
+     */
+    std::vector<uint64_t> postings(Field field, std::string_view name) const;
+
+    /**
+     * Sorted offsets of the frames posted under both the account and the
+     * symbol (trades of that account in that symbol)
+     */
+    std::vector<uint64_t> intersect(std::string_view account, std::string_view symbol) const;
+
+    size_t keyCount(Field field) const { return names(field).size(); }
+    uint64_t postingCount() const { return posting_count_; }
+    uint64_t scannedOffset() const { return scanned_offset_; }
+    uint64_t framesScanned() const { return frames_scanned_; }
+    uint64_t lastOffset() const { return last_offset_; }
+    uint64_t lastSequence() const { return last_sequence_; }
+
+    /**
+     * Bytes held by the posting lists (skip headers, packed blocks, tails)
+     */
+    size_t compressedBytes() const;
+
+    /**
+     * Persist atomically (temp file + rename)
+     * Throws std::runtime_error on failure
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * Load a saved index
+     * @return false if the file is missing or corrupted (index left empty:
+     *         rebuild with extend())
+     */
+    bool load(const std::string& path);
+
+private:
+    struct Block {
+        uint64_t first;
+        uint64_t last;
+        size_t word_offset;     // Into PostingList::words
+        uint8_t width;
+    };
+
+    struct PostingList {
+        std::vector<Block> blocks;
+        std::vector<uint32_t> words;
+        std::vector<uint64_t> tail;   // < BLOCK newest offsets, not yet packed
+        uint64_t count = 0;
+
+        void add(uint64_t offset);
+        void seal();
+        void unpack(size_t block, uint64_t* out) const;
+    };
+
+    class Cursor;
+
+    const DenseIdMap& names(Field field) const {
+        return field == Field::ACCOUNT ? accounts_ : symbols_;
+    }
+    const PostingList* find(Field field, std::string_view name) const;
+    void post(Field field, std::string_view name, uint64_t offset);
+    void clear();
+
+    DenseIdMap accounts_;
+    DenseIdMap symbols_;
+    std::vector<PostingList> account_lists_;   // Indexed by DenseIdMap id
+    std::vector<PostingList> symbol_lists_;
+    uint64_t posting_count_ = 0;
+    uint64_t scanned_offset_;
+    uint64_t frames_scanned_ = 0;
+    uint64_t last_offset_ = 0;
+    uint64_t last_sequence_ = 0;
+};
+
+}  // namespace trading_ledger
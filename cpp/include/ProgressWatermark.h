@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace trading_ledger {
+
+// Progress watermark file (128 bytes: two cache lines, little-endian)
+// Layout:
+//   Offset | Size | Field
+//   -------|------|-------------
+//   0      | 4    | magic 0x4B524D57 ("WMRK")
+//   4      | 4    | version (1)
+//   8      | 4    | pid of the publishing process
+//   12     | 4    | reserved
+//   16     | 8    | started_ns (wall clock when the publisher opened the file)
+//   24     | 40   | reserved
+//   64     | 8    | sequence (last event consumed; 0 = none yet)
+//   72     | 8    | offset (log byte offset just past that event)
+//   80     | 8    | event_timestamp_ns (the writer's timestamp on that event)
+//   88     | 8    | published_ns (wall clock of the update)
+//   96     | 32   | reserved
+//
+// The header and the progress fields sit on separate cache lines, so
+// readers polling the progress line never share it with anything else.
+struct WatermarkProgress {
+    uint64_t sequence = 0;
+    uint64_t offset = 0;
+    uint64_t event_timestamp_ns = 0;
+    uint64_t published_ns = 0;
+};
+
+/**
+ * Consumer progress published through a small shared-memory file
+ *
+ * The processor maps the file MAP_SHARED and publish() updates it with
+ * plain stores once per batch: no syscall, no lock, no RPC. Writers and
+ * monitoring tools map the same file (WatermarkReader) and read how far the
+ * processor has got with a single load, e.g. for lag or for backpressure
+ * (stop appending while log offset - watermark offset exceeds a budget).
+ *
+ * sequence is stored last with release semantics; the other progress
+ * fields are relaxed, so a reader that loads sequence first sees fields at
+ * least as new as that sequence (possibly newer), never older.
+ *
+ * The file is reopened in place, not recreated, so readers keep their
+ * mapping across processor restarts and binary upgrades.
+ *
+ * Single writer.
+ */
+class ProgressWatermark {
+public:
+    static constexpr uint32_t MAGIC = 0x4B524D57;   // "WMRK"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t LINE = 64;
+    static constexpr size_t FILE_SIZE = 2 * LINE;
+
+    // The progress cache line, as mapped
+    struct alignas(LINE) Line {
+        std::atomic<uint64_t> sequence;
+        std::atomic<uint64_t> offset;
+        std::atomic<uint64_t> event_timestamp_ns;
+        std::atomic<uint64_t> published_ns;
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared across processes");
+    static_assert(sizeof(Line) == LINE);
+
+    explicit ProgressWatermark(std::string path);
+    ~ProgressWatermark();
+
+    ProgressWatermark(const ProgressWatermark&) = delete;
+    ProgressWatermark& operator=(const ProgressWatermark&) = delete;
+
+    /**
+     * Create or reopen the file and map it; progress already in the file is
+     * kept until the first publish()
+     * Throws std::runtime_error on failure
+     */
+    void open();
+
+    /**
+     * Record progress (hot path: four stores to one cache line)
+     */
+    void publish(uint64_t sequence, uint64_t offset, uint64_t event_timestamp_ns,
+                 uint64_t published_ns) {
+        line_->offset.store(offset, std::memory_order_relaxed);
+        line_->event_timestamp_ns.store(event_timestamp_ns, std::memory_order_relaxed);
+        line_->published_ns.store(published_ns, std::memory_order_relaxed);
+        line_->sequence.store(sequence, std::memory_order_release);
+    }
+
+    void close();
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    int fd_ = -1;
+    uint8_t* mapped_ = nullptr;
+    Line* line_ = nullptr;
+};
+
+/**
+ * Read-only view of a watermark file (another process publishes into it)
+ */
+class WatermarkReader {
+public:
+    /**
+     * Map the file read-only
+     * Throws std::runtime_error if it is missing or not a watermark file
+     */
+    explicit WatermarkReader(const std::string& path);
+    ~WatermarkReader();
+
+    WatermarkReader(const WatermarkReader&) = delete;
+    WatermarkReader& operator=(const WatermarkReader&) = delete;
+
+    // Last event consumed: one load
+    uint64_t sequence() const { return line_->sequence.load(std::memory_order_acquire); }
+
+    // Log offset consumed through: one load
+    uint64_t offset() const { return line_->offset.load(std::memory_order_relaxed); }
+
+    WatermarkProgress read() const;
+
+    uint32_t pid() const;
+    uint64_t startedNs() const;
+
+private:
+    const uint8_t* mapped_ = nullptr;
+    const ProgressWatermark::Line* line_ = nullptr;
+};
+
+}  // namespace trading_ledger
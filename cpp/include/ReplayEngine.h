@@ -0,0 +1,149 @@
+#pragma once
+
+#include "AccountBalanceBook.h"
+#include "DoubleEntryValidator.h"
+#include "Event.h"
+#include "Verdict.h"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace trading_ledger {
+
+// Decoded events of one batch; payloads point into the mapped log
+using ReplayBatch = std::vector<EventView>;
+
+/**
+ * One what-if configuration fed by ReplayEngine
+ *
+ * Each consumer runs on its own thread and sees every batch, in log order.
+ * Consumers share nothing with each other, so onBatch needs no locking.
+ */
+class ReplayConsumer {
+public:
+    explicit ReplayConsumer(std::string name) : name_(std::move(name)) {}
+    virtual ~ReplayConsumer() = default;
+
+    const std::string& name() const { return name_; }
+
+    virtual void onBatch(const ReplayBatch& batch) = 0;
+
+    /**
+     * Per-configuration result (called after the replay finished)
+     */
+    virtual void report(std::ostream& out) const = 0;
+
+private:
+    std::string name_;
+};
+
+/**
+ * Replays the log through a DoubleEntryValidator with its own rule
+ * configuration and counts verdicts per rule
+ */
+class ValidatorReplayConsumer : public ReplayConsumer {
+public:
+    ValidatorReplayConsumer(std::string name, DoubleEntryValidator::Config config);
+
+    void onBatch(const ReplayBatch& batch) override;
+    void report(std::ostream& out) const override;
+
+    size_t verdictCount(VerdictCode code) const {
+        return verdicts_[static_cast<size_t>(code)];
+    }
+    size_t ruleCount(ValidationRule rule) const {
+        return rules_[static_cast<size_t>(rule)];
+    }
+    const DoubleEntryValidator& validator() const { return validator_; }
+
+private:
+    DoubleEntryValidator validator_;
+    std::array<size_t, 3> verdicts_{};
+    std::array<size_t, static_cast<size_t>(ValidationRule::COUNT)> rules_{};
+};
+
+/**
+ * Replays the log into an AccountBalanceBook
+ */
+class BalanceBookReplayConsumer : public ReplayConsumer {
+public:
+    explicit BalanceBookReplayConsumer(
+        std::string name,
+        size_t invariant_check_interval = AccountBalanceBook::DEFAULT_INVARIANT_CHECK_INTERVAL);
+
+    void onBatch(const ReplayBatch& batch) override;
+    void report(std::ostream& out) const override;
+
+    const AccountBalanceBook& book() const { return book_; }
+
+private:
+    AccountBalanceBook book_;
+};
+
+/**
+ * Shared-scan replay of a historical event log
+ *
+ * The log is mapped, parsed and CRC-checked once by the calling thread.
+ * Each batch of decoded events is broadcast (one shared_ptr, no copies) to
+ * every consumer through a per-consumer SPSC ring, and each consumer runs on
+ * its own thread. K configurations therefore cost one scan plus K times the
+ * consumer work, running in parallel; the scan only waits when the slowest
+ * consumer falls a full ring behind.
+ *
+ * A consumer that throws is marked failed (ConsumerStats::error) and skips
+ * the remaining batches; the others run to completion. A corrupted frame
+ * aborts the whole replay (CorruptedEventException) after the consumers have
+ * been stopped, and so does a last frame that runs past the end of the file
+ * (TruncatedLogException), with or without CRC verification. The scan
+ * sleeps on the ring's space notifier while a consumer is a full ring behind.
+ */
+class ReplayEngine {
+public:
+    static constexpr size_t DEFAULT_BATCH_SIZE = 1024;
+
+    struct Config {
+        size_t batch_size = DEFAULT_BATCH_SIZE;
+        bool verify_crc = true;
+    };
+
+    struct ConsumerStats {
+        std::string name;
+        size_t batches = 0;
+        double busy_seconds = 0;   // Time spent inside onBatch
+        std::string error;         // Empty unless the consumer threw
+    };
+
+    struct Stats {
+        size_t events = 0;
+        size_t batches = 0;
+        double scan_seconds = 0;   // Parsing + CRC, excluding waits on full rings
+        double total_seconds = 0;
+        std::vector<ConsumerStats> consumers;
+    };
+
+    explicit ReplayEngine(Config config);
+    ReplayEngine() : ReplayEngine(Config{}) {}
+
+    /**
+     * Add a configuration to replay (before run)
+     */
+    void addConsumer(std::unique_ptr<ReplayConsumer> consumer);
+
+    const std::vector<std::unique_ptr<ReplayConsumer>>& consumers() const { return consumers_; }
+
+    /**
+     * Replay the whole log through every consumer
+     * Throws std::runtime_error if the log cannot be read,
+     * CorruptedEventException on a CRC mismatch
+     */
+    Stats run(const std::string& log_path);
+
+private:
+    Config config_;
+    std::vector<std::unique_ptr<ReplayConsumer>> consumers_;
+};
+
+}  // namespace trading_ledger
@@ -2,11 +2,20 @@
 
 #include <atomic>
 #include <array>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <type_traits>
 #include <cstddef>
 
 namespace trading_ledger {
 
+/**
+ * SIZE argument for a ring whose size is chosen at construction
+ * (e.g. from a topology file): RingBuffer<Event, DYNAMIC_RING_SIZE> ring(8192)
+ */
+inline constexpr size_t DYNAMIC_RING_SIZE = 0;
+
 /**
  * Lock-free Single-Producer Single-Consumer (SPSC) ring buffer
  *
@@ -27,14 +36,26 @@ namespace trading_ledger {
  * Power-of-2 sizing:
  * - Enables branchless modulo using bit-mask: (index & (SIZE-1))
  * - Faster than division/modulo instruction
+ *
+ * Runtime sizing (SIZE == DYNAMIC_RING_SIZE): same algorithm, the slots
+ * live on the heap and the mask is a member instead of an immediate.
  */
 template<typename T, size_t SIZE>
 class RingBuffer {
     static_assert((SIZE & (SIZE - 1)) == 0, "SIZE must be power of 2");
-    static_assert(SIZE > 0, "SIZE must be greater than 0");
+
+    static constexpr bool DYNAMIC = SIZE == DYNAMIC_RING_SIZE;
+    using Storage = std::conditional_t<DYNAMIC, std::unique_ptr<T[]>, std::array<T, SIZE>>;
 
 public:
-    RingBuffer() : head_(0), tail_(0), buffer_{} {}
+    RingBuffer() requires (!DYNAMIC) : head_(0), tail_(0), buffer_{} {}
+
+    /**
+     * Runtime-sized ring
+     * Throws std::invalid_argument unless size is a power of 2 >= 2
+     */
+    explicit RingBuffer(size_t size) requires DYNAMIC
+        : head_(0), tail_(0), buffer_(checkedSize(size) ? new T[size]() : nullptr), mask_(size - 1) {}
 
     // Non-copyable, non-movable (contains atomics)
     RingBuffer(const RingBuffer&) = delete;
@@ -58,7 +79,7 @@ public:
         size_t current_tail = tail_.load(std::memory_order_relaxed);
 
         // Calculate next tail position (wrap around using bit mask)
-        size_t next_tail = (current_tail + 1) & (SIZE - 1);
+        size_t next_tail = (current_tail + 1) & mask();
 
         // Check if buffer is full
         // Acquire: synchronize-with consumer's release store to head
@@ -83,7 +104,7 @@ public:
      */
     bool try_push(T&& item) {
         size_t current_tail = tail_.load(std::memory_order_relaxed);
-        size_t next_tail = (current_tail + 1) & (SIZE - 1);
+        size_t next_tail = (current_tail + 1) & mask();
 
         if (next_tail == head_.load(std::memory_order_acquire)) {
             return false;  // Full
@@ -123,7 +144,7 @@ public:
         // Publish new head position
         // Release: ensure item read happens-before this store
         // Producer will see freed slot when it reads this head value
-        head_.store((current_head + 1) & (SIZE - 1), std::memory_order_release);
+        head_.store((current_head + 1) & mask(), std::memory_order_release);
 
         return true;
     }
@@ -137,20 +158,28 @@ public:
                tail_.load(std::memory_order_relaxed);
     }
 
+    /**
+     * Approximate full check (may be stale)
+     */
+    bool full() const {
+        return ((tail_.load(std::memory_order_relaxed) + 1) & mask()) ==
+               head_.load(std::memory_order_relaxed);
+    }
+
     /**
      * Approximate size (may be stale)
      */
     size_t size() const {
         size_t h = head_.load(std::memory_order_relaxed);
         size_t t = tail_.load(std::memory_order_relaxed);
-        return (t >= h) ? (t - h) : (SIZE - h + t);
+        return (t >= h) ? (t - h) : (mask() + 1 - h + t);
     }
 
     /**
      * Maximum capacity (one slot reserved for full/empty distinction)
      */
     constexpr size_t capacity() const {
-        return SIZE - 1;
+        return mask();
     }
 
 private:
@@ -164,7 +193,25 @@ private:
     alignas(64) std::atomic<size_t> tail_;
 
     // Data buffer (aligned to prevent false sharing with indices)
-    alignas(64) std::array<T, SIZE> buffer_;
+    alignas(64) Storage buffer_;
+
+    // Slot count - 1 (runtime-sized rings only; read-only after construction)
+    const size_t mask_ = SIZE - 1;
+
+    constexpr size_t mask() const {
+        if constexpr (DYNAMIC) {
+            return mask_;
+        } else {
+            return SIZE - 1;   // Immediate: no load on the hot path
+        }
+    }
+
+    static bool checkedSize(size_t size) {
+        if (size < 2 || (size & (size - 1)) != 0) {
+            throw std::invalid_argument("Ring size must be a power of 2 >= 2, got " + std::to_string(size));
+        }
+        return true;
+    }
 };
 
 }  // namespace trading_ledger
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "DenseIdMap.h"
+#include "FixedPoint.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace trading_ledger {
+
+/**
+ * Net settlement position for one (account, symbol, currency)
+ * Quantities and cash are fixed point (FixedPoint::SCALE).
+ * Sign convention: BUY receives securities and pays cash, so
+ * net_quantity > 0 means securities to deliver to the account and
+ * net_cash < 0 means cash the account owes.
+ */
+struct NetPosition {
+    int64_t net_quantity = 0;
+    WideAmount net_cash = 0;
+    int64_t buy_quantity = 0;
+    int64_t sell_quantity = 0;
+    uint64_t trade_count = 0;
+
+    void merge(const NetPosition& other) {
+        net_quantity += other.net_quantity;
+        net_cash += other.net_cash;
+        buy_quantity += other.buy_quantity;
+        sell_quantity += other.sell_quantity;
+        trade_count += other.trade_count;
+    }
+};
+
+struct SettlementObligation {
+    std::string account_id;
+    std::string symbol;
+    std::string currency;
+    NetPosition position;
+};
+
+/**
+ * Decoded trades of one batch, stored column by column
+ *
+ * Ids are dense per-thread ids (the thread's DenseIdMaps); quantity is
+ * signed (+ buy, - sell).
+ */
+struct TradeColumns {
+    std::vector<uint32_t> account;
+    std::vector<uint32_t> symbol;
+    std::vector<uint32_t> currency;
+    std::vector<int64_t> quantity;
+    std::vector<int64_t> price;
+
+    size_t size() const { return account.size(); }
+
+    void clear() {
+        account.clear();
+        symbol.clear();
+        currency.clear();
+        quantity.clear();
+        price.clear();
+    }
+};
+
+/**
+ * End-of-day netting of a whole event log
+ *
+ * Phases:
+ * 1. Header hop (one thread): walk the mapped log reading only the 24-byte
+ *    headers to find every frame. No payload bytes are touched, so this
+ *    runs at memory bandwidth.
+ * 2. Decode + net (all threads): the frame list is split into contiguous
+ *    ranges. Each thread verifies the CRC of every frame in its range,
+ *    decodes its trades into columnar batches and folds each batch into a
+ *    thread-local partial aggregate keyed by dense (account, symbol,
+ *    currency) ids. Threads share nothing.
+ * 3. Merge (one thread): partial aggregates are combined by name and sorted.
+ *
+ * Trades without a "currency" field settle in Config::default_currency
+ * (the Java writer does not emit one today). The log is assumed to have
+ * passed validation: duplicates are not removed here. A corrupted frame of
+ * any type aborts the run (CorruptedEventException); a trade whose payload
+ * cannot be decoded is skipped and counted.
+ *
+ * A last frame that runs past the end of the file (a torn append, or a
+ * damaged length field, which look the same) aborts the run with
+ * TruncatedLogException, unless Config::allow_truncated_tail: the log is
+ * then netted up to that frame and the cut is reported in Stats.
+ */
+class SettlementNetting {
+public:
+    static constexpr size_t DEFAULT_BATCH_SIZE = 4096;
+
+    struct Config {
+        size_t thread_count = 0;          // 0 = hardware concurrency
+        size_t batch_size = DEFAULT_BATCH_SIZE;
+        bool verify_crc = true;
+        bool allow_truncated_tail = false;   // Net a log still being written
+        std::string default_currency = "USD";
+    };
+
+    struct Stats {
+        size_t events_scanned = 0;
+        size_t trades_netted = 0;
+        size_t trades_skipped = 0;        // Undecodable payloads
+        size_t truncated_bytes = 0;       // Partial last frame left out
+        size_t truncated_offset = 0;
+        size_t positions = 0;
+        size_t threads = 0;
+        double hop_seconds = 0;
+        double net_seconds = 0;
+        double merge_seconds = 0;
+    };
+
+    explicit SettlementNetting(Config config);
+    SettlementNetting() : SettlementNetting(Config{}) {}
+
+    /**
+     * Net every trade in the log
+     * Throws std::runtime_error if the log cannot be read,
+     * CorruptedEventException on a CRC mismatch,
+     * TruncatedLogException on a partial last frame (see Config)
+     * @return obligations sorted by (account, symbol, currency)
+     */
+    std::vector<SettlementObligation> run(const std::string& log_path);
+
+    Stats getStats() const { return stats_; }
+
+    /**
+     * Settlement file (CSV):
+     * account_id,symbol,currency,net_quantity,net_cash,buy_quantity,sell_quantity,trade_count
+     */
+    static void writeCsv(const std::vector<SettlementObligation>& obligations, std::ostream& out);
+
+    /**
+     * Write the settlement file atomically (temp file + rename)
+     * Throws std::runtime_error on failure
+     */
+    static void writeFile(const std::vector<SettlementObligation>& obligations,
+                          const std::string& path);
+
+    /**
+     * Decimal text of a fixed-point wide amount (FixedPoint::SCALE)
+     */
+    static std::string formatAmount(WideAmount value) { return FixedPoint::formatWide(value); }
+
+private:
+    Config config_;
+    Stats stats_;
+
+    // Thread-local state of phase 2
+    struct Partial {
+        DenseIdMap accounts;
+        DenseIdMap symbols;
+        DenseIdMap currencies;
+        std::unordered_map<uint64_t, NetPosition> positions;
+        size_t trades_netted = 0;
+        size_t trades_skipped = 0;
+    };
+
+    void netRange(const uint8_t* data, const std::vector<size_t>& offsets,
+                  size_t begin, size_t end, Partial& partial) const;
+
+    static void aggregate(const TradeColumns& columns, Partial& partial);
+};
+
+}  // namespace trading_ledger
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace trading_ledger {
+
+/**
+ * One sampled frame: where event `sequence` starts in the log
+ */
+struct IndexEntry {
+    uint64_t sequence = 0;
+    uint64_t timestamp_ns = 0;
+    uint64_t offset = 0;
+
+    static constexpr size_t SIZE = 24;
+};
+
+/**
+ * Sparse index over an event log: one entry every `stride` frames
+ *
+ * Built by hopping frame headers (no payload bytes, no CRC), and extended
+ * incrementally as the log grows. A lookup returns the nearest entry at or
+ * before the target; the caller hops at most `stride` frames from there.
+ *
+ * Timestamp lookups assume timestamps never decrease along the log (true
+ * for one writer process; the Java writer uses a monotonic clock).
+ *
+ * File format (little-endian):
+ *   0  | 4 | magic "SIDX" (0x58444953)
+ *   4  | 4 | version (1)
+ *   8  | 4 | stride
+ *   12 | 4 | entry count
+ *   16 | 8 | scanned offset (first byte not yet indexed)
+ *   24 | 8 | frames scanned
+ *   32 | 24 * count | entries (sequence, timestamp_ns, offset)
+ *   .. | 4 | crc32 of everything before it
+ */
+class SparseLogIndex {
+public:
+    static constexpr size_t DEFAULT_STRIDE = 4096;
+    static constexpr uint32_t MAGIC = 0x58444953;
+    static constexpr uint32_t VERSION = 1;
+
+    explicit SparseLogIndex(size_t stride = DEFAULT_STRIDE);
+
+    /**
+     * Index frames from the scanned offset up to the end of data (a whole
+     * mapped log, file header included). A trailing partial frame is left
+     * for the next call.
+     * @return number of entries added
+     */
+    size_t extend(const uint8_t* data, size_t size);
+
+    /**
+     * Entry at or before a sequence / timestamp
+     * @return nullptr if the target precedes the first entry
+     */
+    const IndexEntry* floorBySequence(uint64_t sequence) const;
+    const IndexEntry* floorByTimestamp(uint64_t timestamp_ns) const;
+
+    /**
+     * Offset of the frame holding `sequence`, hopping from the floor entry
+     * @return offset, or 0 if the sequence is not in the indexed range
+     */
+    uint64_t locate(const uint8_t* data, size_t size, uint64_t sequence) const;
+
+    const std::vector<IndexEntry>& entries() const { return entries_; }
+    size_t stride() const { return stride_; }
+    uint64_t scannedOffset() const { return scanned_offset_; }
+    uint64_t framesScanned() const { return frames_scanned_; }
+
+    /**
+     * Persist atomically (temp file + rename)
+     * Throws std::runtime_error on failure
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * Load a saved index
+     * @return false if the file is missing, corrupted, or has another stride
+     *         (index left empty: rebuild with extend())
+     */
+    bool load(const std::string& path);
+
+private:
+    size_t stride_;
+    std::vector<IndexEntry> entries_;
+    uint64_t scanned_offset_;
+    uint64_t frames_scanned_ = 0;
+};
+
+}  // namespace trading_ledger
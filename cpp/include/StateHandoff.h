@@ -0,0 +1,167 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trading_ledger {
+
+/**
+ * Fixed header of a state handoff message; the two descriptors travel with
+ * it as SCM_RIGHTS ancillary data (log first, state second)
+ *
+ * Both ends run on the same host, so the header is sent as raw bytes.
+ */
+struct HandoffHeader {
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t sequence = 0;        // Last event reflected in the state image
+    uint64_t log_offset = 0;      // First event the successor reads
+    uint64_t state_bytes = 0;     // Image size in the memfd
+    int64_t paused_ns = 0;        // Wall clock when the sender stopped reading the log
+};
+
+/**
+ * Where a handed-off process stopped: the successor continues from here
+ */
+struct HandoffState {
+    uint64_t sequence = 0;
+    uint64_t log_offset = 0;
+    int log_fd = -1;              // Event log descriptor (dup'ed by the kernel, not closed)
+    int64_t paused_ns = 0;        // Wall clock when reading stopped
+};
+
+/**
+ * Serving side of a zero-downtime binary upgrade
+ *
+ * Listens on a Unix socket for one "TAKEOVER" request from a new binary.
+ * On request, on_request runs on the listener thread (it should stop the
+ * pipeline, as a shutdown signal would); once the pipeline has drained,
+ * the thread owning the consumer state calls send() with a state image.
+ * The image is written to a sealed memfd and passed, with the event log
+ * descriptor and offset, over the socket; send() then waits for the
+ * successor to acknowledge that the state is loaded, and confirms. The
+ * successor continues only on that confirmation, so exactly one process
+ * owns the log: if the state cannot be sent or the acknowledgement does
+ * not arrive in time, send() throws, the caller resumes processing and
+ * calls rearm(), and the successor's acknowledge() fails.
+ *
+ * One takeover at a time; connections are not accepted while one is being
+ * served.
+ */
+class StateHandoffServer {
+public:
+    static constexpr uint32_t MAGIC = 0x46444E48;   // "HNDF"
+    static constexpr uint32_t VERSION = 2;
+
+    StateHandoffServer(std::string socket_path, std::function<void()> on_request);
+    ~StateHandoffServer();
+
+    StateHandoffServer(const StateHandoffServer&) = delete;
+    StateHandoffServer& operator=(const StateHandoffServer&) = delete;
+
+    /**
+     * Bind the socket (replacing a stale one or a predecessor's) and listen
+     * Throws std::runtime_error on failure
+     */
+    void start();
+
+    /**
+     * Stop listening, drop an unserved successor and remove the socket file
+     * (unless a successor has already bound its own at the same path)
+     */
+    void stop();
+
+    // A successor has asked for the state
+    bool requested() const { return requested_.load(std::memory_order_acquire); }
+
+    /**
+     * Hand state and image to the successor, wait for its acknowledgement
+     * and confirm it (the successor may then run)
+     * Throws std::runtime_error if there is no successor, on I/O failure, or
+     * if no acknowledgement arrives within ack_timeout: the handoff did not
+     * happen and this process still owns the log
+     */
+    void send(const HandoffState& state, const std::vector<uint8_t>& image,
+              std::chrono::milliseconds ack_timeout);
+
+    /**
+     * After a failed send(): hang up on the successor (its acknowledge()
+     * fails) and listen for the next takeover request
+     */
+    void rearm();
+
+    const std::string& path() const { return socket_path_; }
+
+private:
+    std::string socket_path_;
+    std::function<void()> on_request_;
+    int listen_fd_ = -1;
+    int stop_fd_ = -1;            // eventfd: wakes the listener thread on stop()
+    int client_fd_ = -1;          // Successor's connection, once requested
+    uint64_t socket_inode_ = 0;   // Our socket file, so stop() leaves a successor's alone
+    std::atomic<bool> requested_{false};
+    std::thread thread_;
+
+    void run();
+};
+
+/**
+ * Successor side: asks a running process for its state and receives it
+ *
+ * The constructor connects, sends "TAKEOVER" and waits for the state; the
+ * image is then mapped read-only until destruction. Call acknowledge() once
+ * the state is loaded, and start processing only if it returns: the
+ * predecessor confirms and exits, or has given up and kept running.
+ */
+class StateTakeover {
+public:
+    /**
+     * Throws std::runtime_error if nothing listens at socket_path, if the
+     * state does not arrive within timeout, or if the message is malformed
+     */
+    StateTakeover(const std::string& socket_path, std::chrono::milliseconds timeout);
+    ~StateTakeover();
+
+    StateTakeover(const StateTakeover&) = delete;
+    StateTakeover& operator=(const StateTakeover&) = delete;
+
+    uint64_t sequence() const { return header_.sequence; }
+    uint64_t logOffset() const { return header_.log_offset; }
+    int64_t pausedNs() const { return header_.paused_ns; }
+
+    const uint8_t* image() const { return image_; }
+    size_t imageSize() const { return header_.state_bytes; }
+
+    /**
+     * Take ownership of the event log descriptor (-1 once released); safe
+     * to call from another thread than acknowledge()
+     */
+    int releaseLogFd();
+
+    /**
+     * Tell the predecessor the state is loaded and wait for its confirmation,
+     * then unmap the image and hang up (the log descriptor is kept until
+     * released)
+     * Throws std::runtime_error if the predecessor does not confirm within
+     * timeout: it rolled the handoff back and still owns the log
+     */
+    void acknowledge(std::chrono::milliseconds timeout);
+
+private:
+    HandoffHeader header_;
+    int socket_fd_ = -1;
+    int log_fd_ = -1;
+    int state_fd_ = -1;
+    const uint8_t* image_ = nullptr;
+
+    void unmap();
+    void close();
+};
+
+}  // namespace trading_ledger
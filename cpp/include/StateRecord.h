@@ -0,0 +1,105 @@
+#pragma once
+
+#include "AccountBalanceBook.h"
+#include "ByteOrder.h"
+#include "EventParser.h"
+#include "PositionBook.h"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace trading_ledger {
+
+/**
+ * Little-endian record body builder for the state files (ledger history
+ * snapshots, checkpoint log records)
+ *
+ * `kind` names the file in errors ("snapshot", "checkpoint").
+ */
+class RecordWriter {
+public:
+    explicit RecordWriter(const char* kind) : kind_(kind) {}
+
+    void u8(uint8_t value) { bytes_.push_back(value); }
+    void u16(uint16_t value) {
+        bytes_.push_back(static_cast<uint8_t>(value & 0xFF));
+        bytes_.push_back(static_cast<uint8_t>(value >> 8));
+    }
+    void u32(uint32_t value) { appendUint32LE(bytes_, value); }
+    void u64(uint64_t value) { appendUint64LE(bytes_, value); }
+    void i64(int64_t value) { u64(static_cast<uint64_t>(value)); }
+
+    // u16 length, then the bytes
+    void name(std::string_view text) {
+        if (text.size() > UINT16_MAX) {
+            throw std::runtime_error(std::string("Name too long for ") + kind_);
+        }
+        u16(static_cast<uint16_t>(text.size()));
+        bytes_.insert(bytes_.end(), text.begin(), text.end());
+    }
+
+    // Patch a count written before its entries were known
+    void patchU32(size_t at, uint32_t value) { writeUint32LE(bytes_.data() + at, value); }
+
+    size_t size() const { return bytes_.size(); }
+    std::vector<uint8_t>& bytes() { return bytes_; }
+
+private:
+    const char* kind_;
+    std::vector<uint8_t> bytes_;
+};
+
+/**
+ * Bounds-checked reader over a record body written by RecordWriter
+ * Throws std::runtime_error if a field runs past the end
+ */
+class RecordReader {
+public:
+    RecordReader(const uint8_t* data, size_t size, const char* kind)
+        : data_(data), size_(size), kind_(kind) {}
+
+    uint8_t u8() { return *take(1); }
+    uint16_t u16() { return EventParser::readUint16LE(take(2)); }
+    uint32_t u32() { return EventParser::readUint32LE(take(4)); }
+    uint64_t u64() { return EventParser::readUint64LE(take(8)); }
+    int64_t i64() { return static_cast<int64_t>(u64()); }
+
+    std::string_view name() {
+        uint16_t length = u16();
+        return std::string_view(reinterpret_cast<const char*>(take(length)), length);
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+    const char* kind_;
+
+    const uint8_t* take(size_t n) {
+        if (pos_ + n > size_) {
+            throw std::runtime_error(std::string("Truncated ") + kind_ + " record");
+        }
+        const uint8_t* p = data_ + pos_;
+        pos_ += n;
+        return p;
+    }
+};
+
+/**
+ * Account and position entries, shared by snapshots and checkpoints:
+ *   account:  name, i64 debit_total, i64 credit_total, i64 balance,
+ *             u64 entry_count, u64 last_sequence
+ *   position: account name, symbol, i64 net_quantity, i64 buy_quantity,
+ *             i64 sell_quantity, u64 trade_count
+ * The read functions restore the entry into the book.
+ */
+void writeAccountRecord(RecordWriter& out, const AccountBalanceBook& balances, uint32_t account_id);
+void readAccountRecord(RecordReader& in, AccountBalanceBook& balances);
+void writePositionRecord(RecordWriter& out, std::string_view account, std::string_view symbol,
+                         const PositionBook::Position& position);
+void readPositionRecord(RecordReader& in, PositionBook& positions);
+
+}  // namespace trading_ledger
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "ColdTradeStore.h"
+#include "TradeKeyTable.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace trading_ledger {
+
+/**
+ * Occupancy of a TieredTradeTable
+ */
+struct TradeTierStats {
+    size_t hot = 0;
+    size_t hot_limit = 0;          // 0 = single tier
+    size_t hot_bytes = 0;
+    ColdTradeStore::Stats cold;
+};
+
+/**
+ * Trade-state table with an optional compressed cold tier
+ *
+ * Without enableColdTier() this is a TradeKeyTable. With it, at most
+ * hot_limit entries stay in the in-memory table; each insert beyond that
+ * first evicts an entry with a clock sweep (an entry touched since the
+ * sweep last passed gets a second chance) into a ColdTradeStore. A lookup
+ * that misses the hot table asks the cold tier, and a cold entry found there
+ * moves back (promotion), so callers never see the tiers.
+ *
+ * Hot hits cost what they did before plus a reference-bit store; only
+ * misses pay for the cold index probe, and only cold hits pay for a block
+ * inflate. Eviction work per insert is bounded (SWEEP_SLOTS per entry).
+ *
+ * Value must be trivially copyable (cold entries are raw bytes). Pointers
+ * returned by upsert/upsertBatch are valid until the next call.
+ */
+template<typename Value>
+class TieredTradeTable {
+    static_assert(std::is_trivially_copyable_v<Value>, "cold entries are stored as raw bytes");
+
+public:
+    // Slots examined per eviction before giving up (the table then runs
+    // briefly over its limit rather than stall)
+    static constexpr size_t SWEEP_SLOTS = 64;
+
+    /**
+     * Spill to a scratch file at path once more than hot_limit entries are
+     * in memory (entries already present stay hot until swept)
+     * Throws std::invalid_argument for hot_limit 0, std::runtime_error if
+     * the file cannot be created
+     */
+    void enableColdTier(const std::string& path, size_t hot_limit) {
+        if (hot_limit == 0) {
+            throw std::invalid_argument("TieredTradeTable: hot limit must be positive");
+        }
+        cold_ = std::make_unique<ColdTradeStore>(path, sizeof(Value));
+        hot_limit_ = hot_limit;
+    }
+
+    bool tiered() const { return cold_ != nullptr; }
+
+    /**
+     * Value for key, value-initialized if absent from both tiers
+     */
+    Value& upsert(const TradeKey& key) {
+        if (Entry* entry = hot_.find(key)) {
+            entry->referenced = true;
+            return entry->value;
+        }
+        if (!cold_) {
+            return hot_.upsert(key).value;
+        }
+        makeRoom(1);
+        return promote(key).value;
+    }
+
+    /**
+     * Batched upsert: out[i] = &upsert(keys[i]), all valid together
+     * Hot lookups are prefetched as in TradeKeyTable::upsertBatch.
+     */
+    void upsertBatch(const TradeKey* keys, size_t count, Value** out) {
+        Entry* entries[BATCH];
+        if (cold_) {
+            // Mark hits first: a referenced entry survives the sweep below
+            size_t misses = 0;
+            for (size_t base = 0; base < count; base += BATCH) {
+                size_t n = std::min(BATCH, count - base);
+                hot_.findBatch(keys + base, n, entries);
+                for (size_t i = 0; i < n; ++i) {
+                    if (entries[i] != nullptr) {
+                        entries[i]->referenced = true;
+                    } else {
+                        misses++;
+                    }
+                }
+            }
+            if (misses > 0) {
+                makeRoom(misses);
+                for (size_t i = 0; i < count; ++i) {
+                    if (hot_.find(keys[i]) == nullptr) {
+                        promote(keys[i]);
+                    }
+                }
+            }
+        }
+
+        // Grow once up front so no pointer handed out below is invalidated
+        hot_.reserve(hot_.size() + count);
+        for (size_t base = 0; base < count; base += BATCH) {
+            size_t n = std::min(BATCH, count - base);
+            hot_.upsertBatch(keys + base, n, entries);
+            for (size_t i = 0; i < n; ++i) {
+                entries[i]->referenced = true;
+                out[base + i] = &entries[i]->value;
+            }
+        }
+    }
+
+    /**
+     * Size the hot table for count entries (at most the hot limit)
+     */
+    void reserve(size_t count) {
+        hot_.reserve(cold_ ? std::min(count, hot_limit_) : count);
+    }
+
+    /**
+     * Entries in both tiers
+     */
+    size_t size() const { return hot_.size() + (cold_ ? cold_->size() : 0); }
+
+    /**
+     * Visit every entry: fn(const TradeKey&, const Value&); hot entries in
+     * slot order, then cold entries (inflating every cold block)
+     */
+    template<typename Fn>
+    void forEach(Fn&& fn) const {
+        hot_.forEach([&fn](const TradeKey& key, const Entry& entry) { fn(key, entry.value); });
+        if (cold_) {
+            cold_->forEach([&fn](const TradeKey& key, const void* bytes) {
+                Value value;
+                std::memcpy(&value, bytes, sizeof(Value));
+                fn(key, static_cast<const Value&>(value));
+            });
+        }
+    }
+
+    TradeTierStats stats() const {
+        TradeTierStats stats;
+        stats.hot = hot_.size();
+        stats.hot_limit = hot_limit_;
+        stats.hot_bytes = hot_.memoryBytes();
+        if (cold_) {
+            stats.cold = cold_->stats();
+        }
+        return stats;
+    }
+
+private:
+    static constexpr size_t BATCH = 64;   // Pointers staged per upsertBatch round
+
+    struct Entry {
+        Value value{};
+        bool referenced = false;   // Touched since the sweep last passed
+    };
+
+    TradeKeyTable<Entry> hot_;
+    std::unique_ptr<ColdTradeStore> cold_;
+    size_t hot_limit_ = 0;
+    size_t cursor_ = 0;            // Clock hand
+
+    // Evict enough entries that `incoming` inserts stay within the limit
+    void makeRoom(size_t incoming) {
+        if (hot_.size() + incoming <= hot_limit_) {
+            return;
+        }
+        size_t excess = hot_.size() + incoming - hot_limit_;
+        size_t slots = std::min(hot_.capacity() - 1, excess * SWEEP_SLOTS);
+        hot_.sweep(cursor_, slots, excess, [this](const TradeKey& key, Entry& entry) {
+            if (entry.referenced) {
+                entry.referenced = false;
+                return false;
+            }
+            cold_->put(key, &entry.value);
+            return true;
+        });
+    }
+
+    // Insert a missing key, restoring its value if it is cold
+    Entry& promote(const TradeKey& key) {
+        Entry& entry = hot_.upsert(key);
+        cold_->take(key, &entry.value);
+        entry.referenced = true;
+        return entry;
+    }
+};
+
+}  // namespace trading_ledger
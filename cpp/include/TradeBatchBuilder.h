@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Event.h"
+#include "arrow_c_data.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace trading_ledger {
+
+/**
+ * Decodes TRADE_CREATED events into Arrow columns and hands each
+ * batch over through the Arrow C Data Interface
+ *
+ * One struct array per batch, one row per trade event:
+ *   sequence_num  uint64             (L)
+ *   timestamp_ns  timestamp[ns]      (tsn:)   writer's clock
+ *   trade_id      utf8, nullable     (u)      null if absent
+ *   account_id    utf8, nullable     (u)      this column and the ones below
+ *   symbol        utf8, nullable     (u)      are null when the payload
+ *   side          utf8, nullable     (u)      does not decode (one shared
+ *   direction     int8, nullable     (c)      validity bitmap)
+ *   quantity      decimal128(18, 8)  (d:18,8) FixedPoint units
+ *   price         decimal128(18, 8)  (d:18,8)
+ *   notional      decimal128(38, 8)  (d:38,8) quantity * price
+ *
+ * Each payload is decoded into one stack DecodedTrade (views into the
+ * payload, no allocation) and then appended field by field, so a payload
+ * that fails part-way leaves no partial row. String bytes are copied once,
+ * into the column, because the batch outlives the events. finish() moves the buffers (64-byte aligned)
+ * to the consumer without copying; the consumer frees them by calling the
+ * release callbacks, and may release or move children independently.
+ *
+ * Not thread-safe; an exported batch may be used from any thread.
+ */
+class TradeBatchBuilder {
+public:
+    static constexpr size_t COLUMNS = 10;
+
+    explicit TradeBatchBuilder(size_t expected_rows = 1024);
+    ~TradeBatchBuilder();
+
+    TradeBatchBuilder(const TradeBatchBuilder&) = delete;
+    TradeBatchBuilder& operator=(const TradeBatchBuilder&) = delete;
+
+    /**
+     * Append the event's row
+     * @return false (nothing appended) if it is not a TRADE_CREATED event
+     */
+    bool append(const EventView& event);
+
+    /**
+     * Append the trade events of events[0..count); other types are skipped
+     */
+    void append(const EventView* events, size_t count);
+
+    size_t rows() const;
+    size_t malformed() const;   // Rows whose decoded columns are null
+
+    /**
+     * Export the batch as a struct array plus its schema and start an empty
+     * batch; the caller owns both and must call their release callbacks
+     */
+    void finish(ArrowArray* array, ArrowSchema* schema);
+
+    /**
+     * Export just the schema (same for every batch)
+     */
+    static void exportSchema(ArrowSchema* schema);
+
+private:
+    struct Columns;
+    std::unique_ptr<Columns> columns_;
+    size_t expected_rows_;
+};
+
+}  // namespace trading_ledger
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <deque>
+
+namespace trading_ledger {
+
+/**
+ * Canonical 128-bit trade identifier
+ *
+ * The Java service generates trade_id as a 36-character UUID string. Instead of
+ * keeping a heap std::string per trade (~70 bytes with allocator overhead), the
+ * UUID is decoded into two 64-bit words (big-endian byte order, so hi holds the
+ * first 8 bytes of the UUID).
+ *
+ * Non-UUID trade ids fall back to an interned id:
+ *   hi = 0, lo = INTERNED_TAG | intern_index
+ * INTERNED_TAG sets the top three bits of lo, which is the RFC 4122 variant
+ * field value 0b111 ("reserved for future definition"). UUIDs carrying that
+ * variant are never produced by java.util.UUID and are routed to the interner
+ * as well, so the two encodings cannot collide.
+ */
+struct TradeKey {
+    uint64_t hi = 0;
+    uint64_t lo = 0;
+
+    static constexpr uint64_t INTERNED_TAG = 0xE000000000000000ULL;
+    static constexpr uint64_t INTERNED_MASK = 0xE000000000000000ULL;
+
+    bool isInterned() const {
+        return hi == 0 && (lo & INTERNED_MASK) == INTERNED_TAG;
+    }
+
+    bool operator==(const TradeKey& other) const {
+        return hi == other.hi && lo == other.lo;
+    }
+
+    bool operator!=(const TradeKey& other) const {
+        return !(*this == other);
+    }
+
+    bool operator<(const TradeKey& other) const {
+        return hi != other.hi ? hi < other.hi : lo < other.lo;
+    }
+
+    /**
+     * Decode a canonical UUID string (8-4-4-4-12 hex, either case)
+     *
+     * Uses SSE2 to validate and convert all 32 hex digits at once on x86-64;
+     * falls back to a scalar loop elsewhere.
+     *
+     * @return true on success, false if text is not a UUID (out untouched)
+     */
+    static bool fromUuid(std::string_view text, TradeKey& out);
+
+    /**
+     * Format a UUID-backed key back to its canonical lowercase string
+     */
+    std::string toUuidString() const;
+};
+
+/**
+ * Hash functor for TradeKey
+ *
+ * UUID bits are already well distributed, but interned keys are small
+ * sequential integers, so both words go through a 64-bit mixer.
+ */
+struct TradeKeyHash {
+    size_t operator()(const TradeKey& key) const noexcept {
+        uint64_t h = key.hi ^ (key.lo * 0x9E3779B97F4A7C15ULL);
+        h ^= h >> 32;
+        h *= 0xD6E8FEB86659FD93ULL;
+        h ^= h >> 32;
+        return static_cast<size_t>(h);
+    }
+};
+
+/**
+ * Interner for trade ids that are not UUIDs
+ *
+ * Maps each distinct string to a stable interned TradeKey. Strings are stored
+ * once and never freed (trade ids live as long as their trade state).
+ */
+class TradeKeyInterner {
+public:
+    /**
+     * Resolve a raw trade id to its key (decoding UUIDs, interning the rest)
+     */
+    TradeKey resolve(std::string_view trade_id);
+
+    /**
+     * Intern a string unconditionally
+     */
+    TradeKey intern(std::string_view trade_id);
+
+    /**
+     * Reverse lookup for interned keys
+     * @return original string, or empty view if the key was not interned here
+     */
+    std::string_view lookup(const TradeKey& key) const;
+
+    /**
+     * Number of interned (non-UUID) ids
+     */
+    size_t size() const { return names_.size(); }
+
+private:
+    // deque: element addresses stay stable, so map keys can view into it
+    std::deque<std::string> names_;
+    std::unordered_map<std::string_view, uint64_t> ids_;
+};
+
+}  // namespace trading_ledger
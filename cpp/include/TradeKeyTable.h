@@ -0,0 +1,254 @@
+#pragma once
+
+#include "TradeKey.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace trading_ledger {
+
+/**
+ * Open-addressing hash table keyed by TradeKey, with batched lookups
+ *
+ * Per-trade state is touched once or twice per event, so with millions of
+ * trades every lookup is a cache miss. One-at-a-time lookups serialize those
+ * misses; findBatch()/upsertBatch() hash a group of keys, prefetch every home
+ * slot, and only then probe, so the misses overlap in the memory system.
+ *
+ * Layout: one flat array of {key, value} slots (power-of-two size, linear
+ * probing, max load 3/4), so a probe usually stays within the prefetched
+ * line. An empty slot holds EMPTY_KEY, a value TradeKey::fromUuid() and
+ * TradeKeyInterner never produce (hi != 0 with the reserved variant bits).
+ *
+ * erase() and sweep() use backward-shift deletion, so there are no
+ * tombstones. Pointers returned by find/upsert stay valid until the next
+ * insert that grows the table or the next erase.
+ */
+template<typename Value>
+class TradeKeyTable {
+public:
+    static constexpr TradeKey EMPTY_KEY{UINT64_MAX, UINT64_MAX};
+
+    // Keys hashed and prefetched together: enough misses in flight to cover
+    // memory latency, few enough that early prefetches are not evicted
+    static constexpr size_t BATCH_GROUP = 16;
+
+    explicit TradeKeyTable(size_t initial_capacity = 1024) {
+        slots_.resize(std::max<size_t>(16, roundUpPow2(initial_capacity)));
+        mask_ = slots_.size() - 1;
+    }
+
+    /**
+     * @return the value for key, or nullptr
+     */
+    Value* find(const TradeKey& key) {
+        return valueAt(probe(key, homeOf(key)), key);
+    }
+
+    const Value* find(const TradeKey& key) const {
+        return const_cast<TradeKeyTable*>(this)->find(key);
+    }
+
+    /**
+     * Value for key, value-initialized if absent
+     * Throws std::invalid_argument for EMPTY_KEY
+     */
+    Value& upsert(const TradeKey& key) {
+        reserve(size_ + 1);
+        return insertAt(probe(key, homeOf(key)), key);
+    }
+
+    Value& operator[](const TradeKey& key) { return upsert(key); }
+
+    /**
+     * Batched find: out[i] = find(keys[i])
+     */
+    void findBatch(const TradeKey* keys, size_t count, Value** out) {
+        size_t homes[BATCH_GROUP];
+        for (size_t base = 0; base < count; base += BATCH_GROUP) {
+            size_t n = std::min(BATCH_GROUP, count - base);
+            prefetchGroup(keys + base, n, homes, false);
+            for (size_t i = 0; i < n; ++i) {
+                out[base + i] = valueAt(probe(keys[base + i], homes[i]), keys[base + i]);
+            }
+        }
+    }
+
+    /**
+     * Batched upsert: out[i] = &upsert(keys[i]), all valid together
+     * Repeated keys in one batch get the same pointer.
+     * Throws std::invalid_argument for EMPTY_KEY (no key is inserted)
+     */
+    void upsertBatch(const TradeKey* keys, size_t count, Value** out) {
+        for (size_t i = 0; i < count; ++i) {
+            checkKey(keys[i]);
+        }
+        // Grow once up front so no pointer handed out below is invalidated
+        reserve(size_ + count);
+        size_t homes[BATCH_GROUP];
+        for (size_t base = 0; base < count; base += BATCH_GROUP) {
+            size_t n = std::min(BATCH_GROUP, count - base);
+            prefetchGroup(keys + base, n, homes, true);
+            for (size_t i = 0; i < n; ++i) {
+                const TradeKey& key = keys[base + i];
+                out[base + i] = &insertAt(probe(key, homes[i]), key);
+            }
+        }
+    }
+
+    /**
+     * Remove key
+     * @return false if absent
+     */
+    bool erase(const TradeKey& key) {
+        size_t index = probe(key, homeOf(key));
+        if (slots_[index].key != key || key == EMPTY_KEY) {
+            return false;
+        }
+        eraseAt(index);
+        return true;
+    }
+
+    /**
+     * Clock-style sweep for eviction: from cursor (advanced, wrapping), visit
+     * up to max_slots slots, calling evict(const TradeKey&, Value&) on each
+     * entry and erasing those it returns true for; stops after max_erase.
+     * Fewer than capacity() slots visit each entry at most once.
+     * @return entries erased
+     */
+    template<typename Fn>
+    size_t sweep(size_t& cursor, size_t max_slots, size_t max_erase, Fn&& evict) {
+        size_t erased = 0;
+        cursor &= mask_;
+        for (size_t visited = 0; visited < max_slots && erased < max_erase; ++visited) {
+            Slot& slot = slots_[cursor];
+            if (slot.key != EMPTY_KEY && evict(static_cast<const TradeKey&>(slot.key), slot.value)) {
+                eraseAt(cursor);
+                erased++;
+                continue;   // A later entry of the cluster may have shifted in
+            }
+            cursor = (cursor + 1) & mask_;
+        }
+        return erased;
+    }
+
+    /**
+     * Size the table for count keys without growing again
+     */
+    void reserve(size_t count) {
+        if (count * 4 > slots_.size() * 3) {
+            rehash(roundUpPow2(count * 4 / 3 + 1));
+        }
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return slots_.size(); }
+    size_t memoryBytes() const { return slots_.size() * sizeof(Slot); }
+
+    /**
+     * Visit every entry: fn(const TradeKey&, const Value&), in slot order
+     */
+    template<typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const Slot& slot : slots_) {
+            if (slot.key != EMPTY_KEY) {
+                fn(slot.key, slot.value);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        TradeKey key = EMPTY_KEY;
+        Value value{};
+    };
+
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    size_t size_ = 0;
+
+    static size_t roundUpPow2(size_t n) {
+        size_t pow2 = 1;
+        while (pow2 < n) {
+            pow2 <<= 1;
+        }
+        return pow2;
+    }
+
+    static void checkKey(const TradeKey& key) {
+        if (key == EMPTY_KEY) {
+            throw std::invalid_argument("TradeKeyTable: reserved empty key");
+        }
+    }
+
+    size_t homeOf(const TradeKey& key) const { return TradeKeyHash{}(key) & mask_; }
+
+    void prefetchGroup(const TradeKey* keys, size_t n, size_t* homes, bool for_write) const {
+        for (size_t i = 0; i < n; ++i) {
+            homes[i] = homeOf(keys[i]);
+            const char* slot = reinterpret_cast<const char*>(&slots_[homes[i]]);
+            // Both ends: a slot may straddle two cache lines
+            if (for_write) {
+                __builtin_prefetch(slot, 1);
+                __builtin_prefetch(slot + sizeof(Slot) - 1, 1);
+            } else {
+                __builtin_prefetch(slot, 0);
+                __builtin_prefetch(slot + sizeof(Slot) - 1, 0);
+            }
+        }
+    }
+
+    // Index of key's slot, or of the empty slot where it would go
+    size_t probe(const TradeKey& key, size_t index) const {
+        while (slots_[index].key != key && slots_[index].key != EMPTY_KEY) {
+            index = (index + 1) & mask_;
+        }
+        return index;
+    }
+
+    Value* valueAt(size_t index, const TradeKey& key) {
+        return slots_[index].key == key && key != EMPTY_KEY ? &slots_[index].value : nullptr;
+    }
+
+    // Caller guarantees room (reserve) before probing
+    Value& insertAt(size_t index, const TradeKey& key) {
+        Slot& slot = slots_[index];
+        if (slot.key == EMPTY_KEY) {
+            checkKey(key);
+            slot.key = key;
+            size_++;
+        }
+        return slot.value;
+    }
+
+    // Backward shift: pull later entries of the cluster into the hole when
+    // the hole lies between their home and their slot
+    void eraseAt(size_t hole) {
+        for (size_t next = (hole + 1) & mask_; slots_[next].key != EMPTY_KEY; next = (next + 1) & mask_) {
+            size_t home = homeOf(slots_[next].key);
+            if (((next - home) & mask_) >= ((next - hole) & mask_)) {
+                slots_[hole] = std::move(slots_[next]);
+                hole = next;
+            }
+        }
+        slots_[hole] = Slot{};
+        size_--;
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Slot> old(capacity);
+        old.swap(slots_);
+        mask_ = capacity - 1;
+        for (Slot& slot : old) {
+            if (slot.key != EMPTY_KEY) {
+                Slot& target = slots_[probe(slot.key, homeOf(slot.key))];
+                target.key = slot.key;
+                target.value = std::move(slot.value);
+            }
+        }
+    }
+};
+
+}  // namespace trading_ledger
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace trading_ledger {
+
+// Outcome of validating one event
+enum class VerdictCode : uint8_t {
+    PASSED = 0,
+    FAILED = 1,
+    SKIPPED = 2   // Event type not validated
+};
+
+// Rule that produced a FAILED verdict (NONE for PASSED/SKIPPED)
+enum class ValidationRule : uint8_t {
+    NONE = 0,
+    EMPTY_PAYLOAD = 1,
+    MISSING_FIELDS = 2,
+    DUPLICATE_TRADE = 3,
+    QUANTITY_LIMIT = 4,   // |quantity| above DoubleEntryValidator::Config::max_quantity
+    NOTIONAL_LIMIT = 5,   // quantity * price above Config::max_notional
+    INVALID_TRADE_ID = 6, // trade_id not a non-empty string (never enters duplicate state)
+    COUNT = 7
+};
+
+inline const char* validationRuleName(ValidationRule rule) {
+    switch (rule) {
+        case ValidationRule::NONE: return "NONE";
+        case ValidationRule::EMPTY_PAYLOAD: return "EMPTY_PAYLOAD";
+        case ValidationRule::MISSING_FIELDS: return "MISSING_FIELDS";
+        case ValidationRule::DUPLICATE_TRADE: return "DUPLICATE_TRADE";
+        case ValidationRule::QUANTITY_LIMIT: return "QUANTITY_LIMIT";
+        case ValidationRule::NOTIONAL_LIMIT: return "NOTIONAL_LIMIT";
+        case ValidationRule::INVALID_TRADE_ID: return "INVALID_TRADE_ID";
+        default: return "UNKNOWN";
+    }
+}
+
+struct Verdict {
+    VerdictCode code = VerdictCode::SKIPPED;
+    ValidationRule rule = ValidationRule::NONE;
+
+    static Verdict passed() { return {VerdictCode::PASSED, ValidationRule::NONE}; }
+    static Verdict skipped() { return {VerdictCode::SKIPPED, ValidationRule::NONE}; }
+    static Verdict failed(ValidationRule rule) { return {VerdictCode::FAILED, rule}; }
+};
+
+// Verdict log record (fixed size, little-endian)
+// Layout:
+//   Offset | Size | Field
+//   -------|------|-------------
+//   0      | 8    | sequence_num
+//   8      | 8    | timestamp_ns (wall clock when the verdict was produced)
+//   16     | 1    | verdict code
+//   17     | 1    | rule id
+//   18     | 2    | reserved (padding)
+//   20     | 4    | crc32 (over bytes 0-19)
+struct VerdictRecord {
+    uint64_t sequence_num = 0;
+    uint64_t timestamp_ns = 0;
+    VerdictCode code = VerdictCode::SKIPPED;
+    ValidationRule rule = ValidationRule::NONE;
+
+    static constexpr size_t SIZE = 24;
+};
+
+// Verdict log file header (16 bytes, same framing as the event log header)
+struct VerdictFileHeader {
+    uint32_t magic;      // 0x56524454 ("VRDT")
+    uint32_t version;    // 1
+    uint64_t reserved;   // 0
+
+    static constexpr uint32_t EXPECTED_MAGIC = 0x56524454;
+    static constexpr uint32_t EXPECTED_VERSION = 1;
+    static constexpr size_t SIZE = 16;
+
+    bool isValid() const {
+        return magic == EXPECTED_MAGIC && version == EXPECTED_VERSION;
+    }
+};
+
+}  // namespace trading_ledger
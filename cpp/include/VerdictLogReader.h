@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Verdict.h"
+#include <string>
+#include <cstdint>
+
+namespace trading_ledger {
+
+/**
+ * Memory-mapped verdict log reader
+ *
+ * Mirrors EventLogReader: maps the file, validates the header, returns one
+ * record per readNext() and supports tail-following via remapIfGrown().
+ */
+class VerdictLogReader {
+public:
+    explicit VerdictLogReader(const std::string& log_path);
+    ~VerdictLogReader();
+
+    // Non-copyable
+    VerdictLogReader(const VerdictLogReader&) = delete;
+    VerdictLogReader& operator=(const VerdictLogReader&) = delete;
+
+    /**
+     * Open log file and map to memory
+     * Throws std::runtime_error on failure, ParseException on bad header
+     */
+    void open();
+
+    /**
+     * Read next verdict record
+     * @return true if record read, false if EOF (or partial record at EOF)
+     * @throws CorruptedEventException on CRC mismatch
+     */
+    bool readNext(VerdictRecord& record);
+
+    size_t offset() const { return offset_; }
+    size_t fileSize() const { return file_size_; }
+    bool eof() const { return offset_ + VerdictRecord::SIZE > file_size_; }
+
+    /**
+     * Remap file if it has grown (for tail-following)
+     * @return true if file was remapped, false if unchanged
+     */
+    bool remapIfGrown();
+
+private:
+    std::string log_path_;
+    int fd_;
+    uint8_t* mapped_data_;
+    size_t file_size_;
+    size_t offset_;
+    bool is_open_;
+};
+
+}  // namespace trading_ledger
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Verdict.h"
+#include "NotifyingRingBuffer.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trading_ledger {
+
+/**
+ * Asynchronous, batched writer for the binary verdict log
+ *
+ * The validating thread calls submit(), which only pushes a 24-byte record
+ * into an SPSC ring - it never touches the file. A background thread drains
+ * the ring, frames up to `batch_size` records into one buffer and appends it
+ * with a single write() call.
+ *
+ * If the ring is full (writer thread cannot keep up with the disk), submit()
+ * blocks until the writer frees a slot: downstream consumers see every
+ * verdict, and the wait shows up in validation latency and in stalls().
+ * If the writer thread fails (write error), the error is kept (error()) and
+ * every record from then on - including any still queued - is counted in
+ * dropped() instead of being written.
+ *
+ * File format: VerdictFileHeader followed by VerdictRecord frames (Verdict.h),
+ * readable while being written with VerdictLogReader. open() appends to an
+ * existing log after checking its header and cutting off a partial trailing
+ * record left by a crash.
+ */
+class VerdictLogWriter {
+public:
+    static constexpr size_t RING_SIZE = 65536;
+    static constexpr size_t DEFAULT_BATCH_SIZE = 512;
+
+    explicit VerdictLogWriter(const std::string& log_path,
+                              size_t batch_size = DEFAULT_BATCH_SIZE);
+    ~VerdictLogWriter();
+
+    // Non-copyable
+    VerdictLogWriter(const VerdictLogWriter&) = delete;
+    VerdictLogWriter& operator=(const VerdictLogWriter&) = delete;
+
+    /**
+     * Open (or create) the log and start the writer thread
+     * Throws std::runtime_error on failure, or if the file exists and is not
+     * a verdict log
+     */
+    void open();
+
+    /**
+     * Queue a verdict (single producer); waits while the ring is full
+     * @return false if the writer has failed and the record was dropped
+     */
+    bool submit(const VerdictRecord& record);
+
+    /**
+     * Wait until every record submitted so far is written (or counted as
+     * dropped after a failure); the writer keeps running
+     * Called by the submitting thread, e.g. before a successor appends to
+     * the same log
+     */
+    void flush();
+
+    /**
+     * Drain all queued records, flush and stop the writer thread
+     */
+    void close();
+
+    size_t written() const { return written_.load(std::memory_order_relaxed); }
+    size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    size_t stalls() const { return stalls_.load(std::memory_order_relaxed); }   // Submits that waited
+
+    bool failed() const { return failed_.load(std::memory_order_acquire); }
+    std::string error() const;
+
+    /**
+     * Serialize a record into its 24-byte frame (including CRC32)
+     */
+    static void encode(const VerdictRecord& record, uint8_t* out);
+
+private:
+    std::string log_path_;
+    size_t batch_size_;
+    int fd_;
+
+    // Heap-allocated: 1.5 MB of records is too large for the caller's stack
+    std::unique_ptr<NotifyingRingBuffer<VerdictRecord, RING_SIZE>> ring_;
+
+    std::thread writer_thread_;
+    std::atomic<bool> running_;
+    std::atomic<bool> failed_;
+    std::atomic<size_t> written_;
+    std::atomic<size_t> dropped_;
+    std::atomic<size_t> stalls_;
+    size_t submitted_ = 0;        // Submitting thread only
+
+    mutable std::mutex error_mutex_;
+    std::string error_;
+
+    // Check the header of an existing log and cut a partial trailing record
+    void recoverExisting(off_t size);
+
+    void writerLoop();
+
+    // Count everything still queued as dropped (after a failure or stop)
+    void discardQueued();
+
+    // Frame and write up to batch_size queued records
+    // @return number of records written
+    size_t drainOnce(std::vector<uint8_t>& batch);
+
+    void writeAll(const uint8_t* data, size_t length);
+};
+
+}  // namespace trading_ledger
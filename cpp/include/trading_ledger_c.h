@@ -0,0 +1,174 @@
+#ifndef TRADING_LEDGER_C_H
+#define TRADING_LEDGER_C_H
+
+/*
+ * Stable C ABI for in-process validation (libtrading_ledger_c.so)
+ *
+ * Lets the writer (Java via JNI or Panama, or any C caller) run the same
+ * parser, ledger-entry decoder and validator as event_processor before it
+ * appends an event.
+ *
+ * Conventions:
+ * - Every function returns a tl_status; nothing throws across the boundary.
+ *   On failure, tl_last_error() describes the cause (per thread).
+ * - All buffers are caller-owned. Nothing returned by the library needs to
+ *   be freed, except the validator handle (tl_validator_destroy) and Arrow
+ *   structs, which are freed through their release callbacks.
+ * - Batch entry points take arrays so foreign-call overhead is paid once per
+ *   batch, not once per event.
+ * - Structs use fixed-width fields only and never shrink; new fields are
+ *   appended and TL_ABI_VERSION is bumped.
+ * - A tl_validator is not thread-safe: use one handle per thread, or
+ *   serialize calls on a shared handle.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arrow_c_data.h"
+
+#if defined(__GNUC__)
+#define TL_API __attribute__((visibility("default")))
+#else
+#define TL_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TL_ABI_VERSION 1
+
+/* Status codes */
+typedef int32_t tl_status;
+#define TL_OK 0
+#define TL_ERR_INVALID_ARGUMENT 1  /* NULL pointer or bad size */
+#define TL_ERR_TRUNCATED 2         /* Buffer ends inside an event frame */
+#define TL_ERR_CORRUPTED 3         /* CRC32 mismatch */
+#define TL_ERR_MALFORMED 4         /* Payload could not be decoded */
+#define TL_ERR_CAPACITY 5          /* Output array too small */
+#define TL_ERR_OUT_OF_MEMORY 6
+#define TL_ERR_INTERNAL 7
+
+/* Event types (same values as the event log) */
+#define TL_EVENT_TRADE_CREATED 1
+#define TL_EVENT_LEDGER_ENTRIES_GENERATED 2
+#define TL_EVENT_POSITION_UPDATED 3
+
+/* Verdict codes */
+#define TL_VERDICT_PASSED 0
+#define TL_VERDICT_FAILED 1
+#define TL_VERDICT_SKIPPED 2
+
+/* Rules behind a FAILED verdict (same ids as the verdict log) */
+#define TL_RULE_NONE 0
+#define TL_RULE_EMPTY_PAYLOAD 1
+#define TL_RULE_MISSING_FIELDS 2
+#define TL_RULE_DUPLICATE_TRADE 3
+#define TL_RULE_QUANTITY_LIMIT 4
+#define TL_RULE_NOTIONAL_LIMIT 5
+#define TL_RULE_INVALID_TRADE_ID 6
+
+/* Event (32 bytes). payload points into a caller-owned buffer and is not
+ * NUL-terminated. */
+typedef struct tl_event {
+    uint64_t sequence_num;
+    uint64_t timestamp_ns;
+    const char* payload;
+    uint32_t payload_length;
+    uint8_t event_type;
+    uint8_t reserved[3];
+} tl_event;
+
+/* Verdict for one event (16 bytes) */
+typedef struct tl_verdict {
+    uint64_t sequence_num;
+    uint8_t code;
+    uint8_t rule;
+    uint8_t reserved[6];
+} tl_verdict;
+
+/* Decoded ledger entry (24 bytes). account_id points into the payload. */
+typedef struct tl_ledger_entry {
+    const char* account_id;
+    uint32_t account_id_length;
+    uint8_t is_debit;
+    uint8_t reserved[3];
+    int64_t amount;  /* Fixed point, scaled by TL_AMOUNT_SCALE */
+} tl_ledger_entry;
+
+#define TL_AMOUNT_SCALE 100000000LL
+
+typedef struct tl_validator_stats {
+    uint64_t events_processed;
+    uint64_t trades_validated;
+    uint64_t validation_errors;
+    uint64_t duplicate_trades;
+    uint64_t tracked_trades;
+} tl_validator_stats;
+
+typedef struct tl_validator tl_validator;
+
+/* ABI version the library was built with (compare with TL_ABI_VERSION) */
+TL_API uint32_t tl_abi_version(void);
+
+/* Static description of a status code */
+TL_API const char* tl_status_string(tl_status status);
+
+/* Message for the last failed call on this thread ("" if none) */
+TL_API const char* tl_last_error(void);
+
+/* Parse one framed event (24-byte header, payload, CRC32) without copying:
+ * out->payload points into data. *consumed receives the frame size. */
+TL_API tl_status tl_parse_event(const uint8_t* data, size_t length,
+                                tl_event* out, size_t* consumed);
+
+/* Decode the entries of a LEDGER_ENTRIES_GENERATED payload into a
+ * caller-owned array. *count receives the number of entries (also when
+ * TL_ERR_CAPACITY is returned, so the caller can resize and retry). */
+TL_API tl_status tl_decode_ledger_entries(const char* payload, size_t payload_length,
+                                          tl_ledger_entry* entries, size_t capacity,
+                                          size_t* count);
+
+/* Decode the TRADE_CREATED events of events[0..count) into one columnar
+ * batch (other types are skipped), exported through the Arrow C Data
+ * Interface: a struct array with columns sequence_num, timestamp_ns,
+ * trade_id, account_id, symbol, side, direction, quantity, price, notional
+ * (see TradeBatchBuilder.h). Undecodable payloads become null rows. The
+ * library owns the buffers until the caller calls array->release and
+ * schema->release; the payloads may be freed as soon as this returns. */
+TL_API tl_status tl_decode_trades_arrow(const tl_event* events, size_t count,
+                                        struct ArrowArray* array, struct ArrowSchema* schema);
+
+TL_API tl_status tl_validator_create(tl_validator** out);
+TL_API void tl_validator_destroy(tl_validator* validator);
+
+/* Validate one event */
+TL_API tl_status tl_validate_event(tl_validator* validator, const tl_event* event,
+                                   tl_verdict* verdict);
+
+/* Validate events[0..count) in order; verdicts must hold count entries.
+ * Every event's arguments are checked before any is validated, so
+ * TL_ERR_INVALID_ARGUMENT leaves the validator untouched. Only
+ * TL_ERR_OUT_OF_MEMORY / TL_ERR_INTERNAL can stop a batch part-way. */
+TL_API tl_status tl_validate_batch(tl_validator* validator, const tl_event* events,
+                                   size_t count, tl_verdict* verdicts);
+
+/* Parse and validate consecutive framed events from data (the bytes about to
+ * be appended). Stops at the end of data, at a truncated trailing frame, or
+ * when `capacity` verdicts have been produced; *verdict_count and
+ * *bytes_consumed report how far it got. A corrupted frame stops the batch
+ * with TL_ERR_CORRUPTED (verdicts before it are still reported). */
+TL_API tl_status tl_validate_frames(tl_validator* validator,
+                                    const uint8_t* data, size_t length,
+                                    tl_verdict* verdicts, size_t capacity,
+                                    size_t* verdict_count, size_t* bytes_consumed);
+
+TL_API tl_status tl_validator_get_stats(const tl_validator* validator,
+                                        tl_validator_stats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRADING_LEDGER_C_H */
@@ -0,0 +1,156 @@
+#include "AccountBalanceBook.h"
+#include "FixedPoint.h"
+#include <algorithm>
+
+namespace trading_ledger {
+
+AccountBalanceBook::AccountBalanceBook(size_t invariant_check_interval)
+    : invariant_check_interval_(invariant_check_interval) {}
+
+bool AccountBalanceBook::applyEvent(const EventView& event) {
+    if (event.event_type != EventType::LEDGER_ENTRIES_GENERATED) {
+        return false;
+    }
+
+    // Dry run of the whole event first so a malformed entry or an overflow
+    // on a later leg never leaves the book half-applied
+    pending_.clear();
+    int64_t debits = totalDebits();
+    int64_t credits = totalCredits();
+    bool overflow = false;
+    int decoded = LedgerEntryDecoder::forEachEntry(event.payload, [&](const LedgerEntryRecord& entry) {
+        auto it = std::find_if(pending_.begin(), pending_.end(),
+                               [&](const PendingAccount& p) { return p.name == entry.account_id; });
+        if (it == pending_.end()) {
+            const AccountRecord* rec = find(entry.account_id);
+            pending_.push_back({entry.account_id, rec ? rec->debit_total : 0,
+                                rec ? rec->credit_total : 0, rec ? rec->balance : 0});
+            it = pending_.end() - 1;
+        }
+        int64_t& side_total = entry.is_debit ? it->debit_total : it->credit_total;
+        int64_t& global = entry.is_debit ? debits : credits;
+        overflow = overflow ||
+                   __builtin_add_overflow(side_total, entry.amount, &side_total) ||
+                   __builtin_add_overflow(it->balance, entry.is_debit ? entry.amount : -entry.amount,
+                                          &it->balance) ||
+                   __builtin_add_overflow(global, entry.amount, &global);
+    });
+    if (decoded < 0) {
+        stats_.malformed_events++;
+        std::cerr << "Balance book: malformed ledger entries at sequence "
+                  << event.sequence_num << std::endl;
+        return false;
+    }
+    if (overflow) {
+        stats_.overflow_errors++;
+        std::cerr << "Balance book: fixed-point overflow at sequence "
+                  << event.sequence_num << std::endl;
+        return false;
+    }
+
+    LedgerEntryDecoder::forEachEntry(event.payload, [&](const LedgerEntryRecord& entry) {
+        applyEntry(accounts_.getOrAssign(entry.account_id),
+                   entry.is_debit, entry.amount, event.sequence_num);
+    });
+
+    stats_.events_applied++;
+
+    // Check at event boundaries only: entries within an event balance together
+    if (invariant_check_interval_ > 0 &&
+        ++events_since_check_ >= invariant_check_interval_) {
+        events_since_check_ = 0;
+        checkInvariant();
+    }
+
+    return true;
+}
+
+bool AccountBalanceBook::applyEntry(uint32_t account_id, bool is_debit,
+                                    int64_t amount, uint64_t sequence) {
+    if (account_id >= records_.size()) {
+        records_.resize(account_id + 1);
+    }
+    AccountRecord& rec = records_[account_id];
+
+    std::atomic<int64_t>& global = is_debit ? total_debits_ : total_credits_;
+    int64_t& side_total = is_debit ? rec.debit_total : rec.credit_total;
+
+    int64_t new_side, new_balance, new_global;
+    if (__builtin_add_overflow(side_total, amount, &new_side) ||
+        __builtin_add_overflow(rec.balance, is_debit ? amount : -amount, &new_balance) ||
+        __builtin_add_overflow(global.load(std::memory_order_relaxed), amount, &new_global)) {
+        stats_.overflow_errors++;
+        return false;
+    }
+
+    side_total = new_side;
+    rec.balance = new_balance;
+    rec.entry_count++;
+    rec.last_sequence = sequence;
+
+    // Single writer: plain read-modify-write published with a relaxed store
+    global.store(new_global, std::memory_order_relaxed);
+
+    if (track_dirty_) {
+        markDirty(account_id);
+    }
+    stats_.entries_applied++;
+    return true;
+}
+
+void AccountBalanceBook::restoreAccount(std::string_view account, const AccountRecord& record) {
+    uint32_t account_id = accounts_.getOrAssign(account);
+    if (account_id >= records_.size()) {
+        records_.resize(account_id + 1);
+    }
+    AccountRecord& rec = records_[account_id];
+    total_debits_.store(totalDebits() - rec.debit_total + record.debit_total, std::memory_order_relaxed);
+    total_credits_.store(totalCredits() - rec.credit_total + record.credit_total, std::memory_order_relaxed);
+    rec = record;
+}
+
+void AccountBalanceBook::clearDirty() {
+    for (uint32_t account_id : dirty_ids_) {
+        dirty_flags_[account_id] = 0;
+    }
+    dirty_ids_.clear();
+}
+
+bool AccountBalanceBook::checkInvariant() {
+    stats_.invariant_checks++;
+
+    int64_t debits = totalDebits();
+    int64_t credits = totalCredits();
+
+    // Each balance fits in 64 bits, their sum need not
+    WideAmount balance_sum = 0;
+    for (const AccountRecord& rec : records_) {
+        balance_sum += rec.balance;
+    }
+
+    if (debits != credits || balance_sum != static_cast<WideAmount>(debits) - credits) {
+        stats_.invariant_violations++;
+        std::cerr << "Balance book invariant violated: debits="
+                  << FixedPoint::format(debits) << ", credits="
+                  << FixedPoint::format(credits) << ", balance sum="
+                  << FixedPoint::formatWide(balance_sum) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void AccountBalanceBook::printSummary(std::ostream& out) const {
+    out << "\n=== Balance Book Summary ===" << std::endl;
+    out << "Accounts:           " << records_.size() << std::endl;
+    out << "Events applied:     " << stats_.events_applied << std::endl;
+    out << "Entries applied:    " << stats_.entries_applied << std::endl;
+    out << "Malformed events:   " << stats_.malformed_events << std::endl;
+    out << "Overflow errors:    " << stats_.overflow_errors << std::endl;
+    out << "Total debits:       " << FixedPoint::format(totalDebits()) << std::endl;
+    out << "Total credits:      " << FixedPoint::format(totalCredits()) << std::endl;
+    out << "Invariant checks:   " << stats_.invariant_checks
+        << " (" << stats_.invariant_violations << " violations)" << std::endl;
+    out << "============================" << std::endl;
+}
+
+}  // namespace trading_ledger
@@ -0,0 +1,210 @@
+#include "AllocationProfiler.h"
+#include <execinfo.h>
+#include <cxxabi.h>
+#include <sys/mman.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace trading_ledger {
+
+const char* pipelineStageName(PipelineStage stage) {
+    switch (stage) {
+        case PipelineStage::READER: return "reader";
+        case PipelineStage::PARSER: return "parser";
+        case PipelineStage::VALIDATOR: return "validator";
+        case PipelineStage::BALANCE_BOOK: return "balance_book";
+        case PipelineStage::OUTPUT: return "output";
+        default: return "unknown";
+    }
+}
+
+namespace {
+
+// Frames belonging to the profiler and operator new itself
+constexpr int SKIP_FRAMES = 3;
+
+// "binary(_ZN3foo3barEv+0x1a) [0x...]" -> "foo::bar()+0x1a"
+std::string demangleFrame(const char* symbol) {
+    const char* open = std::strchr(symbol, '(');
+    const char* plus = open ? std::strchr(open, '+') : nullptr;
+    if (open == nullptr || plus == nullptr || plus == open + 1) {
+        return symbol;
+    }
+
+    std::string mangled(open + 1, plus);
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+    if (status != 0 || demangled == nullptr) {
+        return symbol;
+    }
+
+    const char* close = std::strchr(plus, ')');
+    std::string result = std::string(demangled) +
+                         std::string(plus, close ? close : plus + std::strlen(plus));
+    std::free(demangled);
+    return result;
+}
+
+}  // namespace
+
+bool AllocationProfiler::enable(size_t interval_bytes) {
+    if (interval_bytes == 0) {
+        disable();
+        return true;
+    }
+
+    if (samples_ == nullptr) {
+        // mmap, not operator new: the buffer must not feed the hook itself
+        void* mem = mmap(nullptr, sizeof(Sample) * MAX_SAMPLES, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) {
+            return false;
+        }
+        Sample* samples = static_cast<Sample*>(mem);
+        for (size_t i = 0; i < MAX_SAMPLES; ++i) {
+            new (&samples[i]) Sample();
+        }
+        samples_ = samples;
+    }
+
+    interval_bytes_.store(interval_bytes, std::memory_order_release);
+    return true;
+}
+
+void AllocationProfiler::disable() {
+    interval_bytes_.store(0, std::memory_order_release);
+}
+
+size_t AllocationProfiler::samplesRecorded() {
+    return std::min(next_slot_.load(std::memory_order_relaxed), MAX_SAMPLES);
+}
+
+void AllocationProfiler::recordSample(size_t size) {
+    size_t interval = interval_bytes_.load(std::memory_order_relaxed);
+
+    // Weight = bytes since the previous sample on this thread
+    uint64_t weight = static_cast<uint64_t>(
+        static_cast<int64_t>(interval) - bytes_until_sample_);
+    bytes_until_sample_ = static_cast<int64_t>(interval);
+
+    // backtrace() may allocate on first use (loads libgcc): don't recurse
+    if (in_profiler_ || samples_ == nullptr || interval == 0) {
+        return;
+    }
+    in_profiler_ = true;
+
+    size_t slot = next_slot_.fetch_add(1, std::memory_order_relaxed);
+    if (slot >= MAX_SAMPLES) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        in_profiler_ = false;
+        return;
+    }
+
+    Sample& sample = samples_[slot];
+    void* frames[MAX_FRAMES + SKIP_FRAMES];
+    int depth = backtrace(frames, MAX_FRAMES + SKIP_FRAMES);
+    int kept = std::max(0, depth - SKIP_FRAMES);
+    std::memcpy(sample.frames, frames + (depth - kept), sizeof(void*) * kept);
+
+    sample.depth = static_cast<uint8_t>(kept);
+    sample.stage = current_stage_;
+    sample.size = size;
+    sample.weight = weight;
+    sample.ready.store(true, std::memory_order_release);
+
+    in_profiler_ = false;
+}
+
+void AllocationProfiler::reset() {
+    if (samples_ != nullptr) {
+        size_t used = samplesRecorded();
+        for (size_t i = 0; i < used; ++i) {
+            samples_[i].ready.store(false, std::memory_order_relaxed);
+        }
+    }
+    next_slot_.store(0, std::memory_order_release);
+    dropped_.store(0, std::memory_order_relaxed);
+}
+
+void AllocationProfiler::report(std::ostream& out, size_t top_n) {
+    // Report allocates: keep it out of its own samples
+    bool was_in_profiler = in_profiler_;
+    in_profiler_ = true;
+
+    struct Site {
+        PipelineStage stage;
+        std::vector<void*> frames;
+        uint64_t bytes = 0;
+        uint64_t samples = 0;
+    };
+
+    std::map<std::pair<PipelineStage, std::vector<void*>>, Site> sites;
+    uint64_t stage_bytes[static_cast<size_t>(PipelineStage::COUNT)] = {};
+    uint64_t total_bytes = 0;
+
+    size_t used = samplesRecorded();
+    for (size_t i = 0; i < used; ++i) {
+        const Sample& sample = samples_[i];
+        if (!sample.ready.load(std::memory_order_acquire)) {
+            continue;
+        }
+
+        std::vector<void*> frames(sample.frames, sample.frames + sample.depth);
+        Site& site = sites[{sample.stage, frames}];
+        site.stage = sample.stage;
+        site.frames = std::move(frames);
+        site.bytes += sample.weight;
+        site.samples++;
+
+        size_t stage_index = static_cast<size_t>(sample.stage);
+        if (stage_index < static_cast<size_t>(PipelineStage::COUNT)) {
+            stage_bytes[stage_index] += sample.weight;
+        }
+        total_bytes += sample.weight;
+    }
+
+    out << "\n=== Allocation Profile (" << used << " samples, "
+        << samplesDropped() << " dropped, interval "
+        << interval_bytes_.load(std::memory_order_relaxed) << " bytes) ===" << std::endl;
+
+    out << "By stage (estimated bytes):" << std::endl;
+    for (size_t s = 0; s < static_cast<size_t>(PipelineStage::COUNT); ++s) {
+        if (stage_bytes[s] == 0) {
+            continue;
+        }
+        out << "  " << std::left << std::setw(14) << pipelineStageName(static_cast<PipelineStage>(s))
+            << std::right << std::setw(14) << stage_bytes[s] << " ("
+            << std::fixed << std::setprecision(1)
+            << (100.0 * stage_bytes[s] / std::max<uint64_t>(total_bytes, 1)) << "%)" << std::endl;
+    }
+
+    std::vector<const Site*> ranked;
+    for (const auto& [key, site] : sites) {
+        ranked.push_back(&site);
+    }
+    std::sort(ranked.begin(), ranked.end(),
+              [](const Site* a, const Site* b) { return a->bytes > b->bytes; });
+
+    out << "Top allocation sites:" << std::endl;
+    for (size_t i = 0; i < ranked.size() && i < top_n; ++i) {
+        const Site& site = *ranked[i];
+        out << "#" << (i + 1) << " [" << pipelineStageName(site.stage) << "] ~"
+            << site.bytes << " bytes (" << site.samples << " samples)" << std::endl;
+
+        char** symbols = backtrace_symbols(site.frames.data(), static_cast<int>(site.frames.size()));
+        for (size_t f = 0; f < site.frames.size(); ++f) {
+            out << "    " << (symbols ? demangleFrame(symbols[f]) : "?") << std::endl;
+        }
+        std::free(symbols);
+    }
+
+    in_profiler_ = was_in_profiler;
+}
+
+}  // namespace trading_ledger
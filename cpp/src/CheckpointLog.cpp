@@ -0,0 +1,430 @@
+#include "CheckpointLog.h"
+#include "Elapsed.h"
+#include "EventParser.h"
+#include "StateRecord.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace trading_ledger {
+
+namespace {
+
+constexpr uint8_t TAG_UUID = 0;
+constexpr uint8_t TAG_INTERNED = 1;
+
+std::vector<uint8_t> fileHeader() {
+    RecordWriter header("checkpoint");
+    header.u32(CheckpointLog::MAGIC);
+    header.u32(CheckpointLog::VERSION);
+    header.u64(0);
+    return std::move(header.bytes());
+}
+
+void writeAll(int fd, const uint8_t* data, size_t size, uint64_t offset, const std::string& path) {
+    while (size > 0) {
+        ssize_t written = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to write checkpoint " + path +
+                                     " (error: " + std::string(strerror(errno)) + ")");
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+}
+
+// Closes the descriptor on every path out of a write
+struct FileGuard {
+    int fd;
+    ~FileGuard() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+};
+
+}  // namespace
+
+CheckpointLog::CheckpointLog(std::string path, DoubleEntryValidator& validator,
+                             AccountBalanceBook& balances, PositionBook& positions, Config config)
+    : path_(std::move(path)), validator_(validator), balances_(balances),
+      positions_(positions), config_(config) {}
+
+uint64_t CheckpointLog::recover() {
+    std::vector<uint8_t> data;
+    if (!path_.empty()) {
+        std::ifstream file(path_, std::ios::binary);
+        if (file) {
+            data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+    }
+
+    if (!data.empty()) {
+        valid_end_ = replay(data.data(), data.size(), path_);
+        stats_.log_bytes = valid_end_;
+    }
+    file_end_ = valid_end_;   // The writer starts with the first checkpoint
+    enableTracking();
+    return sequence_;
+}
+
+uint64_t CheckpointLog::restoreImage(const uint8_t* data, size_t size) {
+    if (replay(data, size, "state image") != size || stats_.records_recovered != 1) {
+        throw std::runtime_error("Corrupt state image");
+    }
+    // The file on disk may be behind the image: rewrite it on the next checkpoint
+    compact_pending_ = true;
+    enableTracking();
+    return sequence_;
+}
+
+std::vector<uint8_t> CheckpointLog::image(uint64_t sequence) const {
+    std::vector<uint8_t> bytes = fileHeader();
+    std::vector<uint8_t> record = encode(KIND_FULL, sequence);
+    bytes.insert(bytes.end(), record.begin(), record.end());
+    return bytes;
+}
+
+size_t CheckpointLog::replay(const uint8_t* data, size_t size, const std::string& source) {
+    if (size < HEADER_SIZE || EventParser::readUint32LE(data) != MAGIC ||
+        EventParser::readUint32LE(data + 4) != VERSION) {
+        throw std::runtime_error("Not a checkpoint log: " + source);
+    }
+
+    size_t offset = HEADER_SIZE;
+    while (offset + 4 <= size) {
+        uint32_t length = EventParser::readUint32LE(data + offset);
+        if (length < 9 || offset + 8 + length > size) {
+            break;
+        }
+        const uint8_t* body = data + offset + 4;
+        if (EventParser::readUint32LE(body + length) != EventParser::calculateCRC32(body, length)) {
+            break;  // Torn append
+        }
+        if (body[0] == KIND_FULL) {
+            stats_.full_bytes = offset + 8 + length;
+        }
+        applyRecord(body, length);
+        stats_.records_recovered++;
+        offset += 8 + length;
+    }
+    return offset;
+}
+
+void CheckpointLog::enableTracking() {
+    // Without a file there are no deltas to write
+    if (!path_.empty()) {
+        validator_.setDirtyTracking(true);
+        balances_.setDirtyTracking(true);
+        positions_.setDirtyTracking(true);
+    }
+    recovered_ = true;
+}
+
+void CheckpointLog::applyRecord(const uint8_t* body, size_t length) {
+    RecordReader in(body, length, "checkpoint");
+    in.u8();  // Kind: every record is an upsert
+    sequence_ = in.u64();
+
+    uint32_t trades = in.u32();
+    validator_.reserveTrades(validator_.tradeCount() + trades);
+    for (uint32_t i = 0; i < trades; ++i) {
+        if (in.u8() == TAG_UUID) {
+            TradeKey key;
+            key.hi = in.u64();
+            key.lo = in.u64();
+            validator_.restoreCreatedTrade(key);
+        } else {
+            validator_.restoreCreatedTrade(in.name());
+        }
+    }
+
+    uint32_t accounts = in.u32();
+    for (uint32_t i = 0; i < accounts; ++i) {
+        readAccountRecord(in, balances_);
+    }
+
+    uint32_t positions = in.u32();
+    for (uint32_t i = 0; i < positions; ++i) {
+        readPositionRecord(in, positions_);
+    }
+}
+
+std::vector<uint8_t> CheckpointLog::encode(uint8_t kind, uint64_t sequence) const {
+    RecordWriter body("checkpoint");
+    body.u8(kind);
+    body.u64(sequence);
+
+    auto trade = [&](const TradeKey& key) {
+        if (key.isInterned()) {
+            body.u8(TAG_INTERNED);
+            body.name(validator_.internedTradeId(key));
+        } else {
+            body.u8(TAG_UUID);
+            body.u64(key.hi);
+            body.u64(key.lo);
+        }
+    };
+    size_t count_at = body.size();
+    body.u32(0);
+    uint32_t trades = 0;
+    if (kind == KIND_FULL) {
+        validator_.forEachCreatedTrade([&](const TradeKey& key) {
+            trade(key);
+            trades++;
+        });
+    } else {
+        for (const TradeKey& key : validator_.dirtyTrades()) {
+            trade(key);
+            trades++;
+        }
+    }
+    body.patchU32(count_at, trades);
+
+    auto account = [&](uint32_t account_id) { writeAccountRecord(body, balances_, account_id); };
+    if (kind == KIND_FULL) {
+        body.u32(static_cast<uint32_t>(balances_.accountCount()));
+        for (uint32_t id = 0; id < balances_.accountCount(); ++id) {
+            account(id);
+        }
+    } else {
+        body.u32(static_cast<uint32_t>(balances_.dirtyAccounts().size()));
+        for (uint32_t id : balances_.dirtyAccounts()) {
+            account(id);
+        }
+    }
+
+    auto position = [&](const std::string& account_name, const std::string& symbol,
+                        const PositionBook::Position& p) {
+        writePositionRecord(body, account_name, symbol, p);
+    };
+    if (kind == KIND_FULL) {
+        body.u32(static_cast<uint32_t>(positions_.size()));
+        positions_.forEach(position);
+    } else {
+        body.u32(static_cast<uint32_t>(positions_.dirtyCount()));
+        positions_.forEachDirty(position);
+    }
+
+    std::vector<uint8_t>& bytes = body.bytes();
+    RecordWriter record("checkpoint");
+    record.u32(static_cast<uint32_t>(bytes.size()));
+    record.bytes().insert(record.bytes().end(), bytes.begin(), bytes.end());
+    record.u32(EventParser::calculateCRC32(bytes.data(), bytes.size()));
+    return std::move(record.bytes());
+}
+
+void CheckpointLog::checkpoint(uint64_t sequence) {
+    if (!recovered_ || path_.empty()) {
+        throw std::runtime_error("Checkpoint log " + path_ + ": recover() must run first");
+    }
+    {
+        std::unique_lock<std::mutex> lock(write_mutex_);
+        throwIfFailed(lock);
+    }
+    if (compact_pending_) {
+        stats_.checkpoints++;
+        compact(sequence);
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint8_t> record = encode(KIND_DELTA, sequence);
+
+    stats_.last_trades = validator_.dirtyTrades().size();
+    stats_.last_accounts = balances_.dirtyAccounts().size();
+    stats_.last_positions = positions_.dirtyCount();
+    clearDirty();
+
+    if (valid_end_ == 0) {
+        valid_end_ = HEADER_SIZE;
+    }
+    valid_end_ += record.size();
+    sequence_ = sequence;
+    stats_.checkpoints++;
+    stats_.last_bytes = record.size();
+    stats_.log_bytes = valid_end_;
+    enqueue(std::move(record), false, sequence);
+    stats_.last_seconds = secondsSince(start);
+
+    double limit = static_cast<double>(stats_.full_bytes) * config_.compact_ratio;
+    if (stats_.log_bytes >= config_.min_compact_bytes && static_cast<double>(stats_.log_bytes) > limit) {
+        compact(sequence);
+    }
+}
+
+void CheckpointLog::compact(uint64_t sequence) {
+    if (!recovered_ || path_.empty()) {
+        throw std::runtime_error("Checkpoint log " + path_ + ": recover() must run first");
+    }
+    std::vector<uint8_t> bytes = image(sequence);
+
+    clearDirty();
+    compact_pending_ = false;
+    valid_end_ = bytes.size();
+    sequence_ = sequence;
+    stats_.compactions++;
+    stats_.log_bytes = valid_end_;
+    stats_.full_bytes = valid_end_;
+    enqueue(std::move(bytes), true, sequence);
+}
+
+void CheckpointLog::flush() {
+    std::unique_lock<std::mutex> lock(write_mutex_);
+    write_cv_.wait(lock, [this] {
+        return !writing_ && queued_image_.empty() && queued_records_.empty();
+    });
+    throwIfFailed(lock);
+}
+
+uint64_t CheckpointLog::durableSequence() const {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    return durable_sequence_;
+}
+
+CheckpointLog::~CheckpointLog() {
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        stopping_ = true;   // The writer drains the queue first
+    }
+    write_cv_.notify_all();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+void CheckpointLog::enqueue(std::vector<uint8_t> bytes, bool full, uint64_t sequence) {
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        if (full) {
+            queued_image_ = std::move(bytes);
+            queued_records_.clear();   // Covered by the image
+        } else {
+            queued_records_.insert(queued_records_.end(), bytes.begin(), bytes.end());
+        }
+        queued_sequence_ = sequence;
+        if (!writer_.joinable()) {
+            writer_ = std::thread(&CheckpointLog::writerLoop, this);
+        }
+    }
+    write_cv_.notify_all();
+}
+
+void CheckpointLog::throwIfFailed(std::unique_lock<std::mutex>& lock) {
+    if (write_error_.empty()) {
+        return;
+    }
+    std::string error = std::move(write_error_);
+    write_error_.clear();
+    lock.unlock();
+    compact_pending_ = true;   // Records were lost: the next checkpoint writes everything
+    throw std::runtime_error(error);
+}
+
+void CheckpointLog::writerLoop() {
+    std::unique_lock<std::mutex> lock(write_mutex_);
+    while (true) {
+        write_cv_.wait(lock, [this] {
+            return stopping_ || !queued_image_.empty() || !queued_records_.empty();
+        });
+        if (!write_error_.empty()) {
+            queued_records_.clear();   // Would follow a hole; only an image is safe
+        }
+        if (queued_image_.empty() && queued_records_.empty()) {
+            if (stopping_) {
+                return;
+            }
+            write_cv_.notify_all();
+            continue;
+        }
+        std::vector<uint8_t> image_bytes = std::move(queued_image_);
+        std::vector<uint8_t> records = std::move(queued_records_);
+        queued_image_.clear();
+        queued_records_.clear();
+        uint64_t sequence = queued_sequence_;
+        writing_ = true;
+        lock.unlock();
+
+        std::string error;
+        try {
+            if (!image_bytes.empty()) {
+                writeImage(image_bytes);
+            }
+            if (!records.empty()) {
+                appendRecords(records);
+            }
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+
+        lock.lock();
+        writing_ = false;
+        if (error.empty()) {
+            durable_sequence_ = sequence;
+        } else {
+            // Later deltas are dropped until the owner has seen the error
+            // and queued a full image
+            write_error_ = std::move(error);
+        }
+        write_cv_.notify_all();
+    }
+}
+
+void CheckpointLog::writeImage(const std::vector<uint8_t>& bytes) {
+    std::string temp_path = path_ + ".tmp";
+    {
+        FileGuard file{::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)};
+        if (file.fd < 0) {
+            throw std::runtime_error("Failed to create " + temp_path +
+                                     " (error: " + std::string(strerror(errno)) + ")");
+        }
+        writeAll(file.fd, bytes.data(), bytes.size(), 0, temp_path);
+        if (config_.sync && ::fdatasync(file.fd) != 0) {
+            throw std::runtime_error("Failed to sync " + temp_path);
+        }
+    }
+    if (std::rename(temp_path.c_str(), path_.c_str()) != 0) {
+        throw std::runtime_error("Failed to rename checkpoint to " + path_ +
+                                 " (error: " + std::string(strerror(errno)) + ")");
+    }
+    file_end_ = bytes.size();
+}
+
+void CheckpointLog::appendRecords(const std::vector<uint8_t>& bytes) {
+    FileGuard file{::open(path_.c_str(), O_WRONLY | O_CREAT, 0644)};
+    if (file.fd < 0) {
+        throw std::runtime_error("Failed to open checkpoint log: " + path_ +
+                                 " (error: " + std::string(strerror(errno)) + ")");
+    }
+    if (file_end_ == 0) {
+        std::vector<uint8_t> header = fileHeader();
+        writeAll(file.fd, header.data(), header.size(), 0, path_);
+        file_end_ = HEADER_SIZE;
+    }
+    // Drops a torn tail left by a crash (no-op otherwise)
+    if (::ftruncate(file.fd, static_cast<off_t>(file_end_)) != 0) {
+        throw std::runtime_error("Failed to truncate checkpoint log: " + path_);
+    }
+    writeAll(file.fd, bytes.data(), bytes.size(), file_end_, path_);
+    if (config_.sync && ::fdatasync(file.fd) != 0) {
+        throw std::runtime_error("Failed to sync checkpoint log: " + path_);
+    }
+    file_end_ += bytes.size();
+}
+
+void CheckpointLog::clearDirty() {
+    validator_.clearDirty();
+    balances_.clearDirty();
+    positions_.clearDirty();
+}
+
+}  // namespace trading_ledger
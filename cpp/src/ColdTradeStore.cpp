@@ -0,0 +1,340 @@
+#include "ColdTradeStore.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace trading_ledger {
+
+namespace {
+
+constexpr size_t KEY_BYTES = 16;
+constexpr size_t INITIAL_INDEX_SLOTS = 1024;
+constexpr int RAW_DEFLATE = -15;   // Window bits: no zlib header or checksum per block
+
+void storeKey(uint8_t* out, const TradeKey& key) {
+    std::memcpy(out, &key.hi, 8);
+    std::memcpy(out + 8, &key.lo, 8);
+}
+
+bool keyMatches(const uint8_t* record, const TradeKey& key) {
+    uint64_t hi;
+    uint64_t lo;
+    std::memcpy(&hi, record, 8);
+    std::memcpy(&lo, record + 8, 8);
+    return hi == key.hi && lo == key.lo;
+}
+
+}  // namespace
+
+ColdTradeStore::ColdTradeStore(std::string path, size_t value_size)
+    : path_(std::move(path)), value_size_(value_size), record_size_(KEY_BYTES + value_size) {
+    openFile(file_, path_);
+    // Streams are set up once: initializing one per block costs more than
+    // inflating the block
+    if (deflateInit2(&deflater_, Z_BEST_SPEED, Z_DEFLATED, RAW_DEFLATE, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        closeFile(file_);
+        throw std::runtime_error("Failed to initialize cold tier compressor");
+    }
+    if (inflateInit2(&inflater_, RAW_DEFLATE) != Z_OK) {
+        deflateEnd(&deflater_);
+        closeFile(file_);
+        throw std::runtime_error("Failed to initialize cold tier decompressor");
+    }
+    index_.assign(INITIAL_INDEX_SLOTS, 0);
+    index_mask_ = INITIAL_INDEX_SLOTS - 1;
+    pending_.reserve(BLOCK_RECORDS * record_size_);
+    scratch_.resize(BLOCK_RECORDS * record_size_);
+    deflated_.resize(deflateBound(&deflater_, static_cast<uLong>(BLOCK_RECORDS * record_size_)));
+}
+
+ColdTradeStore::~ColdTradeStore() {
+    deflateEnd(&deflater_);
+    inflateEnd(&inflater_);
+    closeFile(file_);
+    ::unlink(path_.c_str());
+}
+
+void ColdTradeStore::openFile(File& file, const std::string& path) {
+    file.fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (file.fd < 0) {
+        throw std::runtime_error("Failed to create cold tier file: " + path + ": " + std::strerror(errno));
+    }
+}
+
+void ColdTradeStore::closeFile(File& file) {
+    for (uint8_t* chunk : file.chunks) {
+        munmap(chunk, CHUNK_BYTES);
+    }
+    file.chunks.clear();
+    if (file.fd >= 0) {
+        ::close(file.fd);
+        file.fd = -1;
+    }
+}
+
+uint32_t ColdTradeStore::tagOf(const TradeKey& key) {
+    // High half of the hash: the hot table probes by the low bits
+    uint32_t tag = static_cast<uint32_t>(static_cast<uint64_t>(TradeKeyHash{}(key)) >> 32);
+    return tag != 0 ? tag : 1;
+}
+
+void ColdTradeStore::put(const TradeKey& key, const void* value) {
+    if (dead_ >= COMPACT_MIN_DEAD && dead_ * 2 > file_.records) {
+        compact();
+    }
+    size_t at = pending_.size();
+    pending_.resize(at + record_size_);
+    storeKey(pending_.data() + at, key);
+    std::memcpy(pending_.data() + at + KEY_BYTES, value, value_size_);
+
+    indexInsert(static_cast<uint64_t>(tagOf(key)) << 32 | file_.blocks.size());
+    live_++;
+    spilled_++;
+    if (pending_.size() == BLOCK_RECORDS * record_size_) {
+        flushBlock();
+    }
+}
+
+bool ColdTradeStore::take(const TradeKey& key, void* value) {
+    uint64_t tag = tagOf(key);
+    for (size_t slot = tag & index_mask_; index_[slot] != 0; slot = (slot + 1) & index_mask_) {
+        if (index_[slot] >> 32 != tag) {
+            continue;
+        }
+        size_t block = static_cast<uint32_t>(index_[slot]);
+
+        if (block == file_.blocks.size()) {
+            // Pending: swap-remove, so unwritten blocks hold only live records
+            for (size_t at = 0; at < pending_.size(); at += record_size_) {
+                if (keyMatches(pending_.data() + at, key)) {
+                    std::memcpy(value, pending_.data() + at + KEY_BYTES, value_size_);
+                    size_t last = pending_.size() - record_size_;
+                    std::memmove(pending_.data() + at, pending_.data() + last, record_size_);
+                    pending_.resize(last);
+                    indexErase(slot);
+                    live_--;
+                    promoted_++;
+                    return true;
+                }
+            }
+        } else {
+            Block& ref = file_.blocks[block];
+            const uint8_t* records = readBlock(file_, ref);
+            block_reads_++;
+            for (uint32_t r = 0; r < ref.records; ++r) {
+                const uint8_t* record = records + r * record_size_;
+                if ((ref.taken >> r & 1) == 0 && keyMatches(record, key)) {
+                    std::memcpy(value, record + KEY_BYTES, value_size_);
+                    ref.taken |= uint64_t{1} << r;
+                    indexErase(slot);
+                    live_--;
+                    dead_++;
+                    promoted_++;
+                    return true;
+                }
+            }
+        }
+        false_matches_++;
+    }
+    return false;
+}
+
+void ColdTradeStore::forEach(const std::function<void(const TradeKey&, const void*)>& fn) const {
+    auto visit = [&fn, this](const uint8_t* record) {
+        TradeKey key;
+        std::memcpy(&key.hi, record, 8);
+        std::memcpy(&key.lo, record + 8, 8);
+        fn(key, record + KEY_BYTES);
+    };
+    for (const Block& block : file_.blocks) {
+        const uint8_t* records = readBlock(file_, block);
+        for (uint32_t r = 0; r < block.records; ++r) {
+            if ((block.taken >> r & 1) == 0) {
+                visit(records + r * record_size_);
+            }
+        }
+    }
+    for (size_t at = 0; at < pending_.size(); at += record_size_) {
+        visit(pending_.data() + at);
+    }
+}
+
+ColdTradeStore::Stats ColdTradeStore::stats() const {
+    Stats stats;
+    stats.records = live_;
+    stats.spilled = spilled_;
+    stats.promoted = promoted_;
+    stats.block_reads = block_reads_;
+    stats.false_matches = false_matches_;
+    stats.dead_records = dead_;
+    stats.compactions = compactions_;
+    stats.file_bytes = file_.bytes;
+    stats.index_bytes = index_.size() * sizeof(uint64_t) + file_.blocks.size() * sizeof(Block);
+    return stats;
+}
+
+void ColdTradeStore::indexInsert(uint64_t entry) {
+    if ((live_ + 1) * 4 > index_.size() * 3) {
+        std::vector<uint64_t> old(index_.size() * 2, 0);
+        old.swap(index_);
+        index_mask_ = index_.size() - 1;
+        for (uint64_t moved : old) {
+            if (moved != 0) {
+                indexPlace(moved);
+            }
+        }
+    }
+    indexPlace(entry);
+}
+
+void ColdTradeStore::indexPlace(uint64_t entry) {
+    size_t slot = (entry >> 32) & index_mask_;
+    while (index_[slot] != 0) {
+        slot = (slot + 1) & index_mask_;
+    }
+    index_[slot] = entry;
+}
+
+void ColdTradeStore::indexErase(size_t hole) {
+    // Backward shift, as in TradeKeyTable
+    for (size_t next = (hole + 1) & index_mask_; index_[next] != 0; next = (next + 1) & index_mask_) {
+        size_t home = (index_[next] >> 32) & index_mask_;
+        if (((next - home) & index_mask_) >= ((next - hole) & index_mask_)) {
+            index_[hole] = index_[next];
+            hole = next;
+        }
+    }
+    index_[hole] = 0;
+}
+
+void ColdTradeStore::flushBlock() {
+    writeBlock(file_);
+    pending_.clear();
+}
+
+void ColdTradeStore::writeBlock(File& file) {
+    deflateReset(&deflater_);
+    deflater_.next_in = pending_.data();
+    deflater_.avail_in = static_cast<uInt>(pending_.size());
+    deflater_.next_out = deflated_.data();
+    deflater_.avail_out = static_cast<uInt>(deflated_.size());
+    if (deflate(&deflater_, Z_FINISH) != Z_STREAM_END) {
+        throw std::runtime_error("Failed to compress cold tier block");
+    }
+    size_t bytes = deflated_.size() - deflater_.avail_out;
+
+    // Start a new mapping window rather than straddle two
+    uint64_t offset = file.bytes;
+    if (offset % CHUNK_BYTES + bytes > CHUNK_BYTES) {
+        offset += CHUNK_BYTES - offset % CHUNK_BYTES;
+    }
+    for (size_t done = 0; done < bytes;) {
+        ssize_t n = ::pwrite(file.fd, deflated_.data() + done, bytes - done, static_cast<off_t>(offset + done));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            throw std::runtime_error("Failed to write cold tier file: " + path_ + ": " + std::strerror(errno));
+        }
+        done += static_cast<size_t>(n);
+    }
+    file.bytes = offset + bytes;
+
+    // Map windows ahead of EOF; only written bytes are ever read
+    while (file.chunks.size() <= offset / CHUNK_BYTES) {
+        void* chunk = mmap(nullptr, CHUNK_BYTES, PROT_READ, MAP_SHARED, file.fd,
+                           static_cast<off_t>(file.chunks.size() * CHUNK_BYTES));
+        if (chunk == MAP_FAILED) {
+            throw std::runtime_error("Failed to map cold tier file: " + path_ + ": " + std::strerror(errno));
+        }
+        madvise(chunk, CHUNK_BYTES, MADV_RANDOM);   // One block per lookup: no readahead
+        file.chunks.push_back(static_cast<uint8_t*>(chunk));
+    }
+
+    Block block;
+    block.offset = offset;
+    block.bytes = static_cast<uint32_t>(bytes);
+    block.records = static_cast<uint32_t>(pending_.size() / record_size_);
+    file.blocks.push_back(block);
+    file.records += block.records;
+}
+
+void ColdTradeStore::compact() {
+    // Live records are repacked in order into a file beside the old one;
+    // nothing changes until it is complete
+    std::string temp_path = path_ + ".compact";
+    File fresh;
+    std::vector<uint8_t> held = std::move(pending_);
+    pending_.clear();
+    pending_.reserve(BLOCK_RECORDS * record_size_);
+    std::vector<uint64_t> entries;
+    entries.reserve(live_);
+
+    auto add = [&](const uint8_t* record) {
+        TradeKey key;
+        std::memcpy(&key.hi, record, 8);
+        std::memcpy(&key.lo, record + 8, 8);
+        pending_.insert(pending_.end(), record, record + record_size_);
+        entries.push_back(static_cast<uint64_t>(tagOf(key)) << 32 | fresh.blocks.size());
+        if (pending_.size() == BLOCK_RECORDS * record_size_) {
+            writeBlock(fresh);
+            pending_.clear();
+        }
+    };
+    try {
+        openFile(fresh, temp_path);
+        for (const Block& block : file_.blocks) {
+            if (static_cast<uint32_t>(std::popcount(block.taken)) == block.records) {
+                continue;   // Nothing live: not even inflated
+            }
+            const uint8_t* records = readBlock(file_, block);
+            for (uint32_t r = 0; r < block.records; ++r) {
+                if ((block.taken >> r & 1) == 0) {
+                    add(records + r * record_size_);
+                }
+            }
+        }
+        for (size_t at = 0; at < held.size(); at += record_size_) {
+            add(held.data() + at);
+        }
+        if (std::rename(temp_path.c_str(), path_.c_str()) != 0) {
+            throw std::runtime_error("Failed to replace cold tier file: " + path_ + ": " + std::strerror(errno));
+        }
+    } catch (...) {
+        closeFile(fresh);
+        ::unlink(temp_path.c_str());
+        pending_ = std::move(held);
+        throw;
+    }
+
+    closeFile(file_);
+    file_ = std::move(fresh);
+    std::fill(index_.begin(), index_.end(), 0);
+    for (uint64_t entry : entries) {
+        indexPlace(entry);
+    }
+    dead_ = 0;
+    compactions_++;
+}
+
+const uint8_t* ColdTradeStore::readBlock(const File& file, const Block& block) const {
+    const uint8_t* source = file.chunks[block.offset / CHUNK_BYTES] + block.offset % CHUNK_BYTES;
+    inflateReset(&inflater_);
+    inflater_.next_in = const_cast<uint8_t*>(source);
+    inflater_.avail_in = block.bytes;
+    inflater_.next_out = scratch_.data();
+    inflater_.avail_out = static_cast<uInt>(scratch_.size());
+    if (::inflate(&inflater_, Z_FINISH) != Z_STREAM_END ||
+        scratch_.size() - inflater_.avail_out != block.records * record_size_) {
+        throw std::runtime_error("Corrupt cold tier block in " + path_);
+    }
+    return scratch_.data();
+}
+
+}  // namespace trading_ledger
@@ -0,0 +1,611 @@
+#include "ConsumerCore.h"
+#include "AllocationProfiler.h"
+#include "EventLogTailer.h"
+#include "Instrumentation.h"
+#include <unistd.h>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace trading_ledger {
+
+namespace {
+
+int64_t wallClockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Open the log, or continue on the predecessor's descriptor and offset
+void openReader(EventLogReader& reader, UpgradeHandoff& upgrade) {
+    if (upgrade.takeover != nullptr) {
+        reader.adopt(upgrade.takeover->releaseLogFd(), upgrade.takeover->logOffset());
+    } else {
+        reader.open();
+    }
+}
+
+// Pop whatever is queued, up to one validation batch
+size_t popBatch(EventRing& ring, std::array<Event, DoubleEntryValidator::MAX_BATCH>& batch) {
+    size_t count = 0;
+    while (count < batch.size() && ring.try_pop(batch[count])) {
+        count++;
+    }
+    return count;
+}
+
+// Per-event cost EWMA (weight 1/8) of one timed batch
+uint64_t updateCost(uint64_t cost_ns, std::chrono::steady_clock::time_point start, size_t count) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    int64_t sample = elapsed / static_cast<int64_t>(count);
+    return static_cast<uint64_t>(static_cast<int64_t>(cost_ns) + (sample - static_cast<int64_t>(cost_ns)) / 8);
+}
+
+// Worker, between batches: park while the reader serves a request
+void parkIfPaused(OffloadHandoff& handoff) {
+    using Pause = OffloadHandoff::Pause;
+    Pause state;
+    while ((state = handoff.pause.load(std::memory_order_acquire)) != Pause::RUNNING) {
+        if (state == Pause::REQUESTED) {
+            handoff.pause.store(Pause::PAUSED, std::memory_order_release);
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
+    }
+}
+
+// Reader, while the worker owns the core: serve requests with the worker
+// parked at a batch boundary
+void serveOffloaded(ConsumerCore& core, EventRing& ring, OffloadHandoff& handoff) {
+    using Pause = OffloadHandoff::Pause;
+    handoff.pause.store(Pause::REQUESTED, std::memory_order_release);
+    ring.wake();
+    // A worker that failed or gave the core back does not park
+    while (handoff.pause.load(std::memory_order_acquire) != Pause::PAUSED &&
+           handoff.worker_owns.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
+    }
+    core.serviceRequests();
+    handoff.pause.store(Pause::RUNNING, std::memory_order_release);
+}
+
+}  // namespace
+
+void UpgradeHandoff::readerStopped(const EventLogReader* reader, uint64_t offset) {
+    stopped_for_handoff = reader != nullptr && handingOff();
+    if (stopped_for_handoff) {
+        log_fd = dup(reader->fd());
+    }
+    resume_offset = offset;
+    paused_ns = wallClockNs();
+    reader_stopped.store(true, std::memory_order_release);
+}
+
+bool UpgradeHandoff::resumeAfterHandoff() {
+    if (!stopped_for_handoff) {
+        return false;
+    }
+    Outcome result;
+    while ((result = outcome.load(std::memory_order_acquire)) == Outcome::PENDING &&
+           running.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    if (result != Outcome::ROLLED_BACK) {
+        return false;
+    }
+    outcome.store(Outcome::PENDING, std::memory_order_relaxed);
+    return true;
+}
+
+void UpgradeHandoff::rollBack() {
+    if (log_fd >= 0) {
+        close(log_fd);
+        log_fd = -1;
+    }
+    reader_stopped.store(false, std::memory_order_relaxed);
+    server->rearm();
+    outcome.store(Outcome::ROLLED_BACK, std::memory_order_release);
+}
+
+ConsumerCore::ConsumerCore(Config config,
+                           PipelineMetrics& metrics,
+                           LatencyHistogram& latency_histogram,
+                           VerdictLogWriter* verdict_log,
+                           ProgressWatermark* watermark,
+                           ContinuousQueryEngine& queries,
+                           EventTap& tap,
+                           CommandHandoff& control,
+                           UpgradeHandoff& upgrade)
+    : config_(std::move(config)),
+      metrics_(metrics),
+      latency_histogram_(latency_histogram),
+      latency_{latency_histogram, {}},
+      verdict_log_(verdict_log),
+      watermark_(watermark),
+      queries_(queries),
+      tap_(tap),
+      control_(control),
+      upgrade_(upgrade),
+      persist_(!config_.checkpoint_path.empty()) {
+    if (!config_.cold_state_path.empty()) {
+        validator_.enableColdTier(config_.cold_state_path, config_.hot_trades);
+    }
+
+    // The checkpoint codec also carries state across a binary upgrade
+    // (without a checkpoint path it writes no file)
+    if (persist_ || upgrade.server != nullptr || upgrade.takeover != nullptr) {
+        checkpoints_ = std::make_unique<CheckpointLog>(config_.checkpoint_path, validator_,
+                                                       balance_book_, positions_);
+    }
+
+    // Takeover: load the predecessor's image; the predecessor exits on
+    // the acknowledgement
+    if (upgrade.takeover != nullptr) {
+        StateTakeover& takeover = *upgrade.takeover;
+        size_t bytes = takeover.imageSize();
+        resume_sequence_ = checkpoints_->restoreImage(takeover.image(), bytes);
+        last_sequence_ = resume_sequence_;
+        log_offset_ = takeover.logOffset();
+        takeover.acknowledge(std::chrono::seconds(10));
+        std::cout << "Takeover: restored through sequence " << resume_sequence_ << " ("
+                  << bytes << " bytes, " << validator_.tradeCount() << " trades, "
+                  << balance_book_.accountCount() << " accounts, " << positions_.size()
+                  << " positions), resuming at log offset " << takeover.logOffset() << ", "
+                  << (wallClockNs() - takeover.pausedNs()) / 1000 << " us after the "
+                  << "predecessor stopped reading" << std::endl;
+    } else if (persist_) {
+        // Incremental checkpoints: restore, then skip events already covered
+        resume_sequence_ = checkpoints_->recover();
+        last_sequence_ = resume_sequence_;
+        std::cout << "Checkpoint: restored through sequence " << resume_sequence_ << " ("
+                  << checkpoints_->stats().records_recovered << " records, "
+                  << validator_.tradeCount() << " trades, " << balance_book_.accountCount()
+                  << " accounts, " << positions_.size() << " positions)" << std::endl;
+    }
+
+    // Postings index: every frame read is offered to it, and frames it
+    // already holds are skipped, so a restart catches up from the log
+    if (!config_.postings_path.empty()) {
+        postings_ = std::make_unique<PostingsLogIndex>();
+        postings_->load(config_.postings_path);
+        if (postings_->scannedOffset() < log_offset_) {
+            // Taken over past frames the saved index does not hold
+            std::cerr << "Postings index " << config_.postings_path << " stops at offset "
+                      << postings_->scannedOffset() << ", before the takeover offset "
+                      << log_offset_ << ": disabled (rebuild with ledger_postings update)"
+                      << std::endl;
+            postings_.reset();
+        } else {
+            std::cout << "Postings index: " << config_.postings_path << " ("
+                      << postings_->framesScanned() << " frames, " << postings_->postingCount()
+                      << " postings)" << std::endl;
+        }
+    }
+}
+
+void ConsumerCore::serviceRequests() {
+    if (metrics_.interval_latency.requested()) {
+        metrics_.interval_latency.publish(latency_.interval);
+    }
+    if (control_.pending()) {
+        control_.serve();
+    }
+}
+
+void ConsumerCore::process(Event* events, size_t count) {
+    size_t kept = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (postings_) {
+            postings_->add(events[i].view(), log_offset_);
+        }
+        log_offset_ += events[i].totalSize();   // Events are contiguous in the log
+        if (events[i].sequence_num <= resume_sequence_) {
+            continue;   // Already in the restored checkpoint
+        }
+        batch_[kept] = &events[i];
+        views_[kept++] = events[i].view();
+    }
+    {
+        ValidationShare share{latency_, kept};
+        BasicScopedTimer<INSTRUMENTATION_LEVEL, ValidationShare> timer(share);
+        validator_.processBatch(views_.data(), kept, verdicts_.data());
+    }
+
+    for (size_t i = 0; i < kept; ++i) {
+        Event& event = *batch_[i];
+        Verdict verdict = verdicts_[i];
+        {
+            // Per-event latency, including its share of the batch
+            // validation (TIMINGS builds only)
+            BasicScopedTimer<INSTRUMENTATION_LEVEL, Latency> timer(latency_);
+
+            if (event.event_type == EventType::LEDGER_ENTRIES_GENERATED) {
+                AllocationProfiler::ScopedStage stage(PipelineStage::BALANCE_BOOK);
+                balance_book_.applyEvent(event);
+            }
+            if (checkpoints_ && event.event_type == EventType::TRADE_CREATED) {
+                positions_.applyEvent(event);
+            }
+            queries_.onEvent(event);
+            tap_.offer(views_[i], verdict);   // One branch while disarmed
+            metrics_.events_processed.add();
+            if (verdict.code == VerdictCode::FAILED) {
+                metrics_.validation_failures.add();
+            }
+            Trace::log("Consumer: seq=", event.sequence_num,
+                       " type=", static_cast<int>(event.event_type),
+                       " verdict=", static_cast<int>(verdict.code));
+
+            // Hand verdict to the async writer (never blocks on I/O)
+            if (verdict_log_ != nullptr) {
+                AllocationProfiler::ScopedStage stage(PipelineStage::OUTPUT);
+                VerdictRecord record;
+                record.sequence_num = event.sequence_num;
+                record.timestamp_ns = wallClockNs();
+                record.code = verdict.code;
+                record.rule = verdict.rule;
+                verdict_log_->submit(record);
+            }
+        }
+
+        // Delta checkpoint: cost follows what changed since the last one
+        if (checkpoints_) {
+            last_sequence_ = event.sequence_num;
+            if (persist_ && ++since_checkpoint_ >= config_.checkpoint_interval) {
+                checkpoints_->checkpoint(last_sequence_);
+                since_checkpoint_ = 0;
+            }
+        }
+
+        // Print periodic latency summary every 10,000 events
+        if constexpr (ScopedTimer::enabled()) {
+            if (latency_histogram_.count() >= 10000) {
+                latency_histogram_.printSummary();
+                latency_histogram_.clear();  // Reset for next window
+            }
+        }
+    }
+
+    // Progress for writers and monitors: one cache line per batch
+    if (watermark_ != nullptr && count > 0) {
+        const Event& last = events[count - 1];
+        watermark_->publish(last.sequence_num, log_offset_, last.timestamp_ns,
+                            static_cast<uint64_t>(wallClockNs()));
+    }
+}
+
+bool ConsumerCore::handOff(uint64_t log_offset, int log_fd, int64_t paused_ns) {
+    try {
+        // The successor appends to the same verdict log after ours
+        if (verdict_log_ != nullptr) {
+            verdict_log_->flush();
+        }
+        if (persist_) {
+            if (since_checkpoint_ > 0) {
+                checkpoints_->checkpoint(last_sequence_);
+                since_checkpoint_ = 0;
+            }
+            checkpoints_->flush();   // The successor rewrites the same file
+        }
+        savePostings();   // The successor loads it after the handoff
+        auto start = std::chrono::steady_clock::now();
+        std::vector<uint8_t> image = checkpoints_->image(last_sequence_);
+        upgrade_.server->send({last_sequence_, log_offset, log_fd, paused_ns}, image,
+                              std::chrono::seconds(10));
+        std::cout << "Handoff: state through sequence " << last_sequence_ << " ("
+                  << image.size() << " bytes) taken over at log offset " << log_offset
+                  << " in " << std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::steady_clock::now() - start).count()
+                  << " us" << std::endl;
+        if (!queries_.empty() || tap_.armed()) {
+            std::cout << "Handoff: " << queries_.size() << " continuous queries"
+                      << (tap_.armed() ? " and the tap" : "")
+                      << " not carried over (re-register them on the successor)" << std::endl;
+        }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Handoff failed, resuming: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+void ConsumerCore::finish() {
+    if (persist_) {
+        try {
+            if (since_checkpoint_ > 0) {
+                checkpoints_->checkpoint(last_sequence_);
+            }
+            checkpoints_->flush();
+        } catch (const std::exception& e) {
+            std::cerr << "Checkpoint: final write failed: " << e.what() << std::endl;
+        }
+        const CheckpointLog::Stats& stats = checkpoints_->stats();
+        std::cout << "Checkpoint: " << stats.checkpoints << " written, " << stats.compactions
+                  << " compactions, log " << stats.log_bytes << " bytes (full image "
+                  << stats.full_bytes << "), through sequence " << checkpoints_->durableSequence()
+                  << std::endl;
+    }
+    if (postings_) {
+        savePostings();
+        std::cout << "Postings index: " << postings_->framesScanned() << " frames, "
+                  << postings_->postingCount() << " postings in " << postings_->compressedBytes()
+                  << " bytes" << std::endl;
+    }
+
+    // Print final summaries
+    std::cout << "\n=== Final Statistics ===" << std::endl;
+    validator_.printSummary();
+    if (balance_book_.accountCount() > 0) {
+        balance_book_.checkInvariant();
+        balance_book_.printSummary();
+    }
+    if (latency_histogram_.count() > 0) {
+        latency_histogram_.printSummary();
+    }
+    if (!queries_.empty()) {
+        std::cout << "\n=== Continuous Queries ===" << std::endl;
+        queries_.writeList(std::cout);
+    }
+}
+
+void ConsumerCore::savePostings() {
+    if (postings_) {
+        try {
+            postings_->save(config_.postings_path);
+        } catch (const std::exception& e) {
+            std::cerr << "Postings index not saved: " << e.what() << std::endl;
+        }
+    }
+}
+
+void readIntoRing(const std::string& log_path, EventRing& ring, PipelineMetrics& metrics,
+                  UpgradeHandoff& upgrade) {
+    try {
+        EventLogReader reader(log_path);
+        openReader(reader, upgrade);
+        size_t pushed_end = reader.offset();   // End of the last event in the ring
+
+        EventLogTailer tailer(log_path);
+        tailer.init();
+
+        std::cout << "Producer: Using "
+                  << (tailer.isUsingInotify() ? "inotify (Linux)" : "polling (fallback)")
+                  << " for tail-following" << std::endl;
+
+        AllocationProfiler::setStage(PipelineStage::READER);
+
+        // Read until stopped; a rolled-back handoff resumes where it stopped
+        while (true) {
+            while (!upgrade.stopping()) {
+                Event event;
+
+                // Try to read next event
+                bool has_event;
+                {
+                    AllocationProfiler::ScopedStage stage(PipelineStage::PARSER);
+                    has_event = reader.readNext(event);
+                }
+
+                if (has_event) {
+                    // Push to ring buffer (spin if full)
+                    bool pushed = true;
+                    while (!ring.try_push(std::move(event))) {
+                        if (upgrade.stopping()) {
+                            pushed = false;   // Left for the successor, if any
+                            break;
+                        }
+                        std::this_thread::yield();
+                    }
+                    if (!pushed) {
+                        break;
+                    }
+                    pushed_end = reader.offset();
+
+                    metrics.events_read.add();
+                } else {
+                    // EOF reached, wait for file to grow
+                    if (!reader.remapIfGrown()) {
+                        // File hasn't grown, wait for modification
+                        tailer.waitForModification(100);  // 100ms timeout
+                        reader.remapIfGrown();  // Try again
+                    }
+                }
+            }
+
+            upgrade.readerStopped(&reader, pushed_end);
+            if (!upgrade.resumeAfterHandoff()) {
+                break;
+            }
+            reader.seek(pushed_end);   // Re-read the event that was not pushed
+        }
+        std::cout << "Producer: Shutting down" << std::endl;
+    } catch (...) {
+        // The consumer waits for the reader's position before a handoff
+        if (!upgrade.reader_stopped.load(std::memory_order_relaxed)) {
+            upgrade.readerStopped(nullptr, 0);
+        }
+        throw;
+    }
+}
+
+void consumeRing(EventRing& ring, ConsumerCore& core, UpgradeHandoff& upgrade) {
+    std::array<Event, DoubleEntryValidator::MAX_BATCH> batch;
+
+    while (true) {
+        while (!upgrade.stopping() || !ring.empty()) {
+            core.serviceRequests();
+            size_t count = popBatch(ring, batch);
+            if (count == 0) {
+                // Buffer empty: sleep until the producer signals (timeout
+                // bounds shutdown latency)
+                ring.wait(100);
+                continue;
+            }
+            core.process(batch.data(), count);
+        }
+        if (!upgrade.handingOff()) {
+            break;
+        }
+
+        // The producer may push once more after the ring looked empty
+        while (!upgrade.reader_stopped.load(std::memory_order_acquire)) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        for (size_t count; (count = popBatch(ring, batch)) > 0;) {
+            core.process(batch.data(), count);
+        }
+        if (core.handOff(upgrade.resume_offset, upgrade.log_fd, upgrade.paused_ns)) {
+            upgrade.outcome.store(UpgradeHandoff::Outcome::HANDED_OFF, std::memory_order_release);
+            break;
+        }
+        upgrade.rollBack();   // The producer resumes at resume_offset
+    }
+}
+
+void offloadWorker(EventRing& ring, OffloadHandoff& handoff, std::atomic<bool>& running) {
+    std::array<Event, DoubleEntryValidator::MAX_BATCH> batch;
+    uint64_t cost_ns = 0;
+    AllocationProfiler::setStage(PipelineStage::VALIDATOR);
+
+    while (!handoff.exit.load(std::memory_order_acquire)) {
+        if (!handoff.worker_owns.load(std::memory_order_acquire)) {
+            ring.wait(100);
+            continue;
+        }
+        parkIfPaused(handoff);
+        try {
+            size_t count = popBatch(ring, batch);
+            if (count > 0) {
+                auto start = std::chrono::steady_clock::now();
+                handoff.core->process(batch.data(), count);
+                cost_ns = updateCost(cost_ns, start, count);
+                handoff.worker_cost_ns.store(cost_ns, std::memory_order_relaxed);
+                continue;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Offload worker error: " << e.what() << std::endl;
+            running.store(false, std::memory_order_release);
+            handoff.worker_owns.store(false, std::memory_order_release);
+            return;
+        }
+        // Pushes happen before reclaim is raised: re-check the ring after it
+        if (handoff.reclaim.load(std::memory_order_acquire) && ring.empty()) {
+            handoff.reclaim.store(false, std::memory_order_relaxed);
+            handoff.worker_owns.store(false, std::memory_order_release);
+            continue;
+        }
+        ring.wait(100);
+    }
+}
+
+RunToCompletionStats runToCompletion(const std::string& log_path, ConsumerCore& core, EventRing& ring,
+                                     OffloadHandoff& handoff, PipelineMetrics& metrics,
+                                     UpgradeHandoff& upgrade, uint64_t offload_budget_ns) {
+    handoff.core = &core;
+
+    EventLogReader reader(log_path);
+    openReader(reader, upgrade);
+    EventLogTailer tailer(log_path);
+    tailer.init();
+
+    std::array<Event, DoubleEntryValidator::MAX_BATCH> batch;
+    uint64_t cost_ns = 0;
+    bool offloaded = false;
+    RunToCompletionStats stats;
+
+    // Wait for the worker to drain the ring and hand the core back
+    auto takeBack = [&] {
+        handoff.reclaim.store(true, std::memory_order_release);
+        ring.wake();
+        while (handoff.worker_owns.load(std::memory_order_acquire)) {
+            if (core.requestsPending()) {
+                serveOffloaded(core, ring, handoff);
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        offloaded = false;
+    };
+
+    // Requests are served here whoever owns the core
+    auto serveRequests = [&] {
+        if (!offloaded) {
+            core.serviceRequests();
+        } else if (core.requestsPending()) {
+            serveOffloaded(core, ring, handoff);
+        }
+    };
+
+    // The core must not be destroyed while the worker holds it
+    try {
+        while (true) {
+            if (upgrade.stopping()) {
+                if (offloaded) {
+                    takeBack();
+                }
+                // Everything read has been processed inline or by the worker
+                if (!upgrade.handingOff() ||
+                    core.handOff(reader.offset(), reader.fd(), wallClockNs())) {
+                    break;
+                }
+                upgrade.rollBack();   // Keep reading where we stopped
+                continue;
+            }
+            serveRequests();
+            if (offloaded &&
+                handoff.worker_cost_ns.load(std::memory_order_relaxed) < offload_budget_ns / 2) {
+                takeBack();
+                cost_ns = handoff.worker_cost_ns.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            size_t count = 0;
+            {
+                AllocationProfiler::ScopedStage stage(PipelineStage::PARSER);
+                while (count < batch.size() && reader.readNext(batch[count])) {
+                    count++;
+                }
+            }
+            if (count == 0) {
+                // EOF reached, wait for file to grow
+                if (!reader.remapIfGrown()) {
+                    tailer.waitForModification(100);
+                    reader.remapIfGrown();
+                }
+                continue;
+            }
+            metrics.events_read.add(count);
+
+            if (offloaded) {
+                for (size_t i = 0; i < count; ++i) {
+                    while (!ring.try_push(std::move(batch[i]))) {
+                        serveRequests();   // Worker drains until reclaimed
+                        std::this_thread::yield();
+                    }
+                }
+                stats.events_offloaded += count;
+                continue;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            core.process(batch.data(), count);
+            if (offload_budget_ns > 0) {
+                cost_ns = updateCost(cost_ns, start, count);
+                if (cost_ns > offload_budget_ns) {
+                    handoff.worker_cost_ns.store(cost_ns, std::memory_order_relaxed);
+                    handoff.worker_owns.store(true, std::memory_order_release);
+                    offloaded = true;
+                    stats.offloads++;
+                }
+            }
+        }
+    } catch (...) {
+        if (offloaded) {
+            takeBack();
+        }
+        throw;
+    }
+    return stats;
+}
+
+}  // namespace trading_ledger
@@ -0,0 +1,474 @@
+#include "ContinuousQuery.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+namespace trading_ledger {
+
+namespace {
+
+std::string lower(std::string_view text) {
+    std::string out(text);
+    for (char& c : out) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return out;
+}
+
+std::vector<std::string> split(std::string_view text, char separator) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find(separator, start);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        if (end > start) {
+            parts.emplace_back(text.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    return parts;
+}
+
+bool parseField(std::string_view name, TradeField& out) {
+    static const std::pair<std::string_view, TradeField> FIELDS[] = {
+        {"trade_id", TradeField::TRADE_ID},   {"account_id", TradeField::ACCOUNT_ID},
+        {"symbol", TradeField::SYMBOL},       {"side", TradeField::SIDE},
+        {"quantity", TradeField::QUANTITY},   {"price", TradeField::PRICE},
+        {"notional", TradeField::NOTIONAL},
+    };
+    for (const auto& [field_name, field] : FIELDS) {
+        if (name == field_name) {
+            out = field;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isNumeric(TradeField field) {
+    return field == TradeField::QUANTITY || field == TradeField::PRICE ||
+           field == TradeField::NOTIONAL;
+}
+
+std::string_view textOf(const DecodedTrade& trade, TradeField field) {
+    switch (field) {
+        case TradeField::TRADE_ID: return trade.trade_id;
+        case TradeField::ACCOUNT_ID: return trade.account_id;
+        case TradeField::SYMBOL: return trade.symbol;
+        case TradeField::SIDE: return trade.side;
+        default: return {};
+    }
+}
+
+WideAmount numberOf(const DecodedTrade& trade, TradeField field) {
+    switch (field) {
+        case TradeField::QUANTITY: return trade.quantity;
+        case TradeField::PRICE: return trade.price;
+        case TradeField::NOTIONAL: return trade.notional;
+        default: return 0;
+    }
+}
+
+template<typename T>
+bool compare(const T& lhs, CompareOp op, const T& rhs) {
+    switch (op) {
+        case CompareOp::EQ: return lhs == rhs;
+        case CompareOp::NE: return lhs != rhs;
+        case CompareOp::LT: return lhs < rhs;
+        case CompareOp::LE: return lhs <= rhs;
+        case CompareOp::GT: return lhs > rhs;
+        case CompareOp::GE: return lhs >= rhs;
+    }
+    return false;
+}
+
+const char* aggregateName(AggregateKind kind) {
+    switch (kind) {
+        case AggregateKind::COUNT: return "count";
+        case AggregateKind::SUM: return "sum";
+        case AggregateKind::NET: return "net";
+        case AggregateKind::MIN: return "min";
+        case AggregateKind::MAX: return "max";
+        case AggregateKind::AVG: return "avg";
+    }
+    return "?";
+}
+
+const char* fieldName(TradeField field) {
+    switch (field) {
+        case TradeField::TRADE_ID: return "trade_id";
+        case TradeField::ACCOUNT_ID: return "account_id";
+        case TradeField::SYMBOL: return "symbol";
+        case TradeField::SIDE: return "side";
+        case TradeField::QUANTITY: return "quantity";
+        case TradeField::PRICE: return "price";
+        case TradeField::NOTIONAL: return "notional";
+    }
+    return "?";
+}
+
+}  // namespace
+
+bool QueryPredicate::matches(const DecodedTrade& trade) const {
+    if (isNumeric(field)) {
+        return compare(numberOf(trade, field), op, number);
+    }
+    return compare(textOf(trade, field), op, std::string_view(text));
+}
+
+ContinuousQuery::ContinuousQuery(std::string name, std::string text, size_t max_groups)
+    : name_(std::move(name)), text_(std::move(text)), max_groups_(max_groups) {
+    parse();
+}
+
+void ContinuousQuery::parse() {
+    std::istringstream tokens(text_);
+    std::string token;
+    enum class Clause { SELECT, WHERE, BY } clause = Clause::SELECT;
+    std::string select;
+    bool expect_condition = false;
+
+    while (tokens >> token) {
+        std::string keyword = lower(token);
+        if (keyword == "where" && clause == Clause::SELECT) {
+            clause = Clause::WHERE;
+            expect_condition = true;
+            continue;
+        }
+        if (keyword == "by" && clause != Clause::BY && !expect_condition) {
+            clause = Clause::BY;
+            continue;
+        }
+
+        if (clause == Clause::SELECT) {
+            select += token;
+        } else if (clause == Clause::WHERE) {
+            if (!expect_condition) {
+                if (keyword != "and") {
+                    throw std::invalid_argument("expected 'and' or 'by' before: " + token);
+                }
+                expect_condition = true;
+                continue;
+            }
+            size_t op_pos = token.find_first_of("!=<>");
+            if (op_pos == std::string::npos || op_pos == 0) {
+                throw std::invalid_argument("bad condition: " + token);
+            }
+            QueryPredicate predicate;
+            if (!parseField(token.substr(0, op_pos), predicate.field)) {
+                throw std::invalid_argument("unknown field: " + token.substr(0, op_pos));
+            }
+            std::string_view rest = std::string_view(token).substr(op_pos);
+            size_t op_length = 2;
+            if (rest.starts_with("!=")) {
+                predicate.op = CompareOp::NE;
+            } else if (rest.starts_with("<=")) {
+                predicate.op = CompareOp::LE;
+            } else if (rest.starts_with(">=")) {
+                predicate.op = CompareOp::GE;
+            } else {
+                op_length = 1;
+                predicate.op = rest[0] == '=' ? CompareOp::EQ
+                             : rest[0] == '<' ? CompareOp::LT
+                             : rest[0] == '>' ? CompareOp::GT : CompareOp::EQ;
+                if (rest[0] == '!') {
+                    throw std::invalid_argument("bad operator in: " + token);
+                }
+            }
+            std::string_view operand = rest.substr(op_length);
+            if (isNumeric(predicate.field)) {
+                int64_t value = 0;
+                if (!FixedPoint::parse(operand, value)) {
+                    throw std::invalid_argument("bad number in: " + token);
+                }
+                predicate.number = value;
+            } else {
+                if (predicate.op != CompareOp::EQ && predicate.op != CompareOp::NE) {
+                    throw std::invalid_argument("string fields support = and != only: " + token);
+                }
+                predicate.text = std::string(operand);
+            }
+            if (predicates_.size() == MAX_PREDICATES) {
+                throw std::invalid_argument("too many conditions (max " +
+                                            std::to_string(MAX_PREDICATES) + ")");
+            }
+            predicates_.push_back(std::move(predicate));
+            expect_condition = false;
+        } else {
+            for (const std::string& name : split(token, ',')) {
+                TradeField field;
+                if (!parseField(name, field)) {
+                    throw std::invalid_argument("unknown group field: " + name);
+                }
+                if (group_by_.size() == MAX_GROUP_FIELDS) {
+                    throw std::invalid_argument("too many group fields (max " +
+                                                std::to_string(MAX_GROUP_FIELDS) + ")");
+                }
+                group_by_.push_back(field);
+            }
+        }
+    }
+    if (expect_condition) {
+        throw std::invalid_argument("missing condition after 'where'/'and'");
+    }
+    if (clause == Clause::BY && group_by_.empty()) {
+        throw std::invalid_argument("missing fields after 'by'");
+    }
+
+    static const std::pair<std::string_view, AggregateKind> KINDS[] = {
+        {"sum", AggregateKind::SUM}, {"net", AggregateKind::NET}, {"min", AggregateKind::MIN},
+        {"max", AggregateKind::MAX}, {"avg", AggregateKind::AVG},
+    };
+    for (const std::string& item : split(select, ',')) {
+        std::string spec = lower(item);
+        QueryAggregate aggregate;
+        if (spec == "count") {
+            aggregate.kind = AggregateKind::COUNT;
+        } else {
+            size_t open = spec.find('(');
+            bool known = false;
+            for (const auto& [kind_name, kind] : KINDS) {
+                if (open != std::string::npos && spec.substr(0, open) == kind_name) {
+                    aggregate.kind = kind;
+                    known = true;
+                }
+            }
+            if (!known || spec.back() != ')' ||
+                !parseField(spec.substr(open + 1, spec.size() - open - 2), aggregate.field) ||
+                !isNumeric(aggregate.field)) {
+                throw std::invalid_argument("bad aggregate: " + item);
+            }
+        }
+        if (aggregates_.size() == MAX_AGGREGATES) {
+            throw std::invalid_argument("too many aggregates (max " +
+                                        std::to_string(MAX_AGGREGATES) + ")");
+        }
+        aggregates_.push_back(aggregate);
+    }
+    if (aggregates_.empty()) {
+        throw std::invalid_argument("query needs at least one aggregate");
+    }
+}
+
+void ContinuousQuery::onTrade(const DecodedTrade& trade) {
+    cost_.evaluated++;
+    for (const QueryPredicate& predicate : predicates_) {
+        if (!predicate.matches(trade)) {
+            return;
+        }
+    }
+    cost_.matched++;
+
+    key_buffer_.clear();
+    for (size_t i = 0; i < group_by_.size(); ++i) {
+        if (i > 0) {
+            key_buffer_ += '|';
+        }
+        TradeField field = group_by_[i];
+        if (isNumeric(field)) {
+            key_buffer_ += FixedPoint::formatWide(numberOf(trade, field));
+        } else {
+            key_buffer_ += textOf(trade, field);
+        }
+    }
+
+    auto it = groups_.find(std::string_view(key_buffer_));
+    if (it == groups_.end()) {
+        if (groups_.size() >= max_groups_) {
+            cost_.overflow++;
+            return;
+        }
+        GroupState state;
+        state.aggregates.resize(aggregates_.size());
+        it = groups_.emplace(key_buffer_, std::move(state)).first;
+    }
+
+    GroupState& group = it->second;
+    bool first = group.count == 0;
+    group.count++;
+    for (size_t i = 0; i < aggregates_.size(); ++i) {
+        const QueryAggregate& aggregate = aggregates_[i];
+        if (aggregate.kind == AggregateKind::COUNT) {
+            continue;
+        }
+        AggregateState& state = group.aggregates[i];
+        WideAmount value = numberOf(trade, aggregate.field);
+        state.sum += aggregate.kind == AggregateKind::NET ? value * trade.direction : value;
+        if (first || value < state.min) {
+            state.min = value;
+        }
+        if (first || value > state.max) {
+            state.max = value;
+        }
+    }
+}
+
+void ContinuousQuery::onTradeTimed(const DecodedTrade& trade) {
+    auto start = std::chrono::steady_clock::now();
+    onTrade(trade);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    cost_.timed++;
+    cost_.timed_ns += static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+std::string ContinuousQuery::formatAggregate(const GroupState& group, size_t index) const {
+    const AggregateState& state = group.aggregates[index];
+    switch (aggregates_[index].kind) {
+        case AggregateKind::COUNT: return std::to_string(group.count);
+        case AggregateKind::SUM:
+        case AggregateKind::NET: return FixedPoint::formatWide(state.sum);
+        case AggregateKind::MIN: return FixedPoint::formatWide(state.min);
+        case AggregateKind::MAX: return FixedPoint::formatWide(state.max);
+        case AggregateKind::AVG:
+            return FixedPoint::formatWide(state.sum / static_cast<WideAmount>(group.count));
+    }
+    return "";
+}
+
+std::string ContinuousQuery::value(const std::string& group, size_t aggregate) const {
+    auto it = groups_.find(group);
+    if (it == groups_.end() || aggregate >= aggregates_.size()) {
+        return "";
+    }
+    return formatAggregate(it->second, aggregate);
+}
+
+void ContinuousQuery::writeResult(std::ostream& out) const {
+    std::vector<const std::string*> keys;
+    keys.reserve(groups_.size());
+    for (const auto& [key, group] : groups_) {
+        keys.push_back(&key);
+    }
+    std::sort(keys.begin(), keys.end(),
+              [](const std::string* a, const std::string* b) { return *a < *b; });
+
+    std::string header;
+    for (size_t i = 0; i < group_by_.size(); ++i) {
+        header += (i > 0 ? "|" : "");
+        header += fieldName(group_by_[i]);
+    }
+    for (const std::string* key : keys) {
+        const GroupState& group = groups_.find(*key)->second;
+        if (!group_by_.empty()) {
+            out << header << "=" << *key;
+        } else {
+            out << "*";
+        }
+        for (size_t i = 0; i < aggregates_.size(); ++i) {
+            out << " " << aggregateName(aggregates_[i].kind);
+            if (aggregates_[i].kind != AggregateKind::COUNT) {
+                out << "(" << fieldName(aggregates_[i].field) << ")";
+            }
+            out << "=" << formatAggregate(group, i);
+        }
+        out << "\n";
+    }
+}
+
+void ContinuousQueryEngine::add(const std::string& name, const std::string& text) {
+    if (find(name) != nullptr) {
+        throw std::invalid_argument("query already registered: " + name);
+    }
+    if (queries_.size() >= MAX_QUERIES) {
+        throw std::invalid_argument("too many queries (max " + std::to_string(MAX_QUERIES) + ")");
+    }
+    queries_.push_back(std::make_unique<ContinuousQuery>(name, text, max_groups_));
+}
+
+bool ContinuousQueryEngine::remove(const std::string& name) {
+    auto it = std::find_if(queries_.begin(), queries_.end(),
+                           [&](const auto& query) { return query->name() == name; });
+    if (it == queries_.end()) {
+        return false;
+    }
+    queries_.erase(it);
+    return true;
+}
+
+const ContinuousQuery* ContinuousQueryEngine::find(const std::string& name) const {
+    for (const auto& query : queries_) {
+        if (query->name() == name) {
+            return query.get();
+        }
+    }
+    return nullptr;
+}
+
+void ContinuousQueryEngine::onEvent(const EventView& event) {
+    if (queries_.empty() || event.event_type != EventType::TRADE_CREATED) {
+        return;
+    }
+    DecodedTrade trade;
+    if (!DecodedTrade::decode(event.payload, trade)) {
+        undecodable_++;
+        return;
+    }
+    if (++trades_seen_ % TIMING_SAMPLE == 0) {
+        for (auto& query : queries_) {
+            query->onTradeTimed(trade);
+        }
+    } else {
+        for (auto& query : queries_) {
+            query->onTrade(trade);
+        }
+    }
+}
+
+void ContinuousQueryEngine::writeList(std::ostream& out) const {
+    for (const auto& query : queries_) {
+        const ContinuousQuery::Cost& cost = query->cost();
+        out << query->name() << ": " << query->text()
+            << " | groups=" << query->groupCount()
+            << " evaluated=" << cost.evaluated
+            << " matched=" << cost.matched
+            << " overflow=" << cost.overflow
+            << " ns/event=" << static_cast<uint64_t>(cost.nanosPerEvent()) << "\n";
+    }
+}
+
+std::string ContinuousQueryEngine::handle(const std::string& request) {
+    std::istringstream in(request);
+    std::string command;
+    std::string name;
+    in >> command >> name;
+    command = lower(command);
+
+    std::ostringstream out;
+    if (command == "list") {
+        writeList(out);
+        if (undecodable_ > 0) {
+            out << "undecodable trades: " << undecodable_ << "\n";
+        }
+        return out.str();
+    }
+    if (name.empty()) {
+        throw std::invalid_argument("usage: ADD NAME QUERY | DROP NAME | GET NAME | LIST");
+    }
+    if (command == "add") {
+        std::string text;
+        std::getline(in >> std::ws, text);
+        add(name, text);
+        return "registered " + name + "\n";
+    }
+    if (command == "drop") {
+        if (!remove(name)) {
+            throw std::invalid_argument("no such query: " + name);
+        }
+        return "dropped " + name + "\n";
+    }
+    if (command == "get") {
+        const ContinuousQuery* query = find(name);
+        if (query == nullptr) {
+            throw std::invalid_argument("no such query: " + name);
+        }
+        query->writeResult(out);
+        return out.str();
+    }
+    throw std::invalid_argument("unknown query command: " + command);
+}
+
+}  // namespace trading_ledger
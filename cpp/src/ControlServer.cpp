@@ -0,0 +1,250 @@
+#include "ControlServer.h"
+#include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace trading_ledger {
+
+std::string CommandHandoff::execute(Task task, std::chrono::milliseconds timeout) {
+    std::lock_guard<std::mutex> serial(execute_mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    task_ = std::move(task);
+    taken_ = false;
+    done_ = false;
+    result_.clear();
+    error_ = nullptr;
+    pending_.store(true, std::memory_order_seq_cst);
+    lock.unlock();
+
+    if (wake_) {
+        wake_();
+    }
+
+    lock.lock();
+    if (!done_cv_.wait_for(lock, timeout, [this] { return taken_; })) {
+        // Never picked up: withdraw it so it cannot run after we return
+        task_ = nullptr;
+        pending_.store(false, std::memory_order_relaxed);
+        throw std::runtime_error("consumer did not respond");
+    }
+    done_cv_.wait(lock, [this] { return done_; });
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+    return std::move(result_);
+}
+
+void CommandHandoff::serve() {
+    Task task;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!task_) {
+            return;
+        }
+        task = std::move(task_);
+        task_ = nullptr;
+        taken_ = true;
+        pending_.store(false, std::memory_order_relaxed);
+    }
+    done_cv_.notify_all();
+
+    std::string result;
+    std::exception_ptr error;
+    try {
+        result = task();
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result_ = std::move(result);
+        error_ = error;
+        done_ = true;
+    }
+    done_cv_.notify_all();
+}
+
+ControlServer::ControlServer(std::string socket_path, Handler handler)
+    : socket_path_(std::move(socket_path)), handler_(std::move(handler)) {}
+
+ControlServer::~ControlServer() {
+    stop();
+}
+
+void ControlServer::start() {
+    sockaddr_un addr{};
+    if (socket_path_.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("Control socket path too long: " + socket_path_);
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, socket_path_.c_str(), socket_path_.size() + 1);
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error("Failed to create control socket (error: " +
+                                 std::string(strerror(errno)) + ")");
+    }
+    ::unlink(socket_path_.c_str());  // Stale socket from a previous run
+    struct stat st;
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd_, static_cast<int>(MAX_CLIENTS)) != 0 ||
+        ::stat(socket_path_.c_str(), &st) != 0) {
+        std::string error = strerror(errno);
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        throw std::runtime_error("Failed to bind control socket: " + socket_path_ +
+                                 " (error: " + error + ")");
+    }
+    socket_inode_ = st.st_ino;
+
+    stop_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (stop_fd_ < 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        throw std::runtime_error("Failed to create eventfd (error: " +
+                                 std::string(strerror(errno)) + ")");
+    }
+
+    thread_ = std::thread(&ControlServer::run, this);
+}
+
+void ControlServer::stop() {
+    if (thread_.joinable()) {
+        uint64_t one = 1;
+        while (write(stop_fd_, &one, sizeof(one)) < 0 && errno == EINTR) {}
+        thread_.join();
+    }
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        // After an upgrade the path may already be the successor's socket
+        struct stat st;
+        if (::stat(socket_path_.c_str(), &st) == 0 && st.st_ino == socket_inode_) {
+            ::unlink(socket_path_.c_str());
+        }
+    }
+    if (stop_fd_ >= 0) {
+        ::close(stop_fd_);
+        stop_fd_ = -1;
+    }
+}
+
+std::string ControlServer::respond(const std::string& request) {
+    std::string response;
+    try {
+        response = handler_(request);
+        if (!response.empty() && response.back() != '\n') {
+            response += '\n';
+        }
+        response += "OK\n";
+    } catch (const std::exception& e) {
+        response = std::string("ERR ") + e.what() + "\n";
+    }
+    return response;
+}
+
+void ControlServer::run() {
+    struct Client {
+        int fd;
+        std::string buffer;
+    };
+    std::vector<Client> clients;
+    std::vector<pollfd> fds;
+
+    auto closeClient = [&](size_t index) {
+        ::close(clients[index].fd);
+        clients.erase(clients.begin() + static_cast<std::ptrdiff_t>(index));
+    };
+
+    while (true) {
+        fds.clear();
+        fds.push_back({stop_fd_, POLLIN, 0});
+        fds.push_back({listen_fd_, POLLIN, 0});
+        for (const Client& client : clients) {
+            fds.push_back({client.fd, POLLIN, 0});
+        }
+
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[0].revents != 0) {
+            break;
+        }
+
+        // Clients first (indices into fds are stable until we accept)
+        for (size_t i = clients.size(); i-- > 0;) {
+            if (fds[i + 2].revents == 0) {
+                continue;
+            }
+            char chunk[1024];
+            ssize_t n = read(clients[i].fd, chunk, sizeof(chunk));
+            if (n <= 0) {
+                closeClient(i);
+                continue;
+            }
+            std::string& buffer = clients[i].buffer;
+            buffer.append(chunk, static_cast<size_t>(n));
+
+            bool alive = true;
+            size_t newline;
+            while (alive && (newline = buffer.find('\n')) != std::string::npos) {
+                std::string request = buffer.substr(0, newline);
+                buffer.erase(0, newline + 1);
+                if (!request.empty() && request.back() == '\r') {
+                    request.pop_back();
+                }
+                if (request.empty()) {
+                    continue;
+                }
+                std::string response = respond(request);
+                size_t sent = 0;
+                while (sent < response.size()) {
+                    ssize_t w = send(clients[i].fd, response.data() + sent,
+                                     response.size() - sent, MSG_NOSIGNAL);
+                    if (w < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    if (w <= 0) {
+                        alive = false;
+                        break;
+                    }
+                    sent += static_cast<size_t>(w);
+                }
+            }
+            if (!alive || buffer.size() > MAX_REQUEST_LENGTH) {
+                closeClient(i);
+            }
+        }
+
+        if (fds[1].revents & POLLIN) {
+            int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd >= 0) {
+                if (clients.size() >= MAX_CLIENTS) {
+                    ::close(fd);
+                } else {
+                    // A client that stops reading cannot stall the server
+                    timeval send_timeout{1, 0};
+                    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout));
+                    clients.push_back({fd, {}});
+                }
+            }
+        }
+    }
+
+    for (const Client& client : clients) {
+        ::close(client.fd);
+    }
+}
+
+}  // namespace trading_ledger
@@ -1,85 +1,203 @@
 #include "DoubleEntryValidator.h"
+#include "JsonFields.h"
+#include "FixedPoint.h"
+#include "Instrumentation.h"
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 
 namespace trading_ledger {
 
-void DoubleEntryValidator::processEvent(const Event& event) {
+Verdict DoubleEntryValidator::processEvent(const EventView& event) {
     stats_.events_processed++;
 
     switch (event.event_type) {
         case EventType::TRADE_CREATED:
-            validateTradeCreated(event);
-            break;
+            return validateTradeCreated(event);
 
         case EventType::LEDGER_ENTRIES_GENERATED:
             // Future: validate ledger entries
-            break;
+            return Verdict::skipped();
 
         case EventType::POSITION_UPDATED:
             // Future: validate position updates
-            break;
+            return Verdict::skipped();
 
         default:
             // Unknown event type - skip
-            break;
+            return Verdict::skipped();
     }
 }
 
-void DoubleEntryValidator::validateTradeCreated(const Event& event) {
+void DoubleEntryValidator::processBatch(const EventView* events, size_t count, Verdict* verdicts) {
+    TradeKey keys[MAX_BATCH];
+    size_t pending[MAX_BATCH];
+    TradeState* states[MAX_BATCH];
+
+    for (size_t base = 0; base < count; base += MAX_BATCH) {
+        size_t n = std::min(MAX_BATCH, count - base);
+
+        // Pass 1: stateless checks; collect keys of trades that need state
+        size_t lookups = 0;
+        for (size_t i = base; i < base + n; ++i) {
+            if (events[i].event_type != EventType::TRADE_CREATED || !config_.detect_duplicates) {
+                verdicts[i] = processEvent(events[i]);
+                continue;
+            }
+            stats_.events_processed++;
+            std::string_view trade_id;
+            verdicts[i] = checkTradePayload(events[i], trade_id);
+            if (verdicts[i].code == VerdictCode::PASSED) {
+                keys[lookups] = interner_.resolve(trade_id);
+                pending[lookups++] = i;
+            }
+        }
+
+        // Pass 2: one prefetched lookup for the whole batch
+        trade_states_.upsertBatch(keys, lookups, states);
+
+        // Pass 3: state transitions in event order (duplicates within the
+        // batch resolve to the same state)
+        for (size_t j = 0; j < lookups; ++j) {
+            verdicts[pending[j]] = commitTrade(events[pending[j]], keys[j], *states[j]);
+        }
+    }
+}
+
+Verdict DoubleEntryValidator::validateTradeCreated(const EventView& event) {
+    std::string_view trade_id;
+    Verdict verdict = checkTradePayload(event, trade_id);
+    if (verdict.code == VerdictCode::FAILED) {
+        return verdict;
+    }
+
+    // Duplicate detection: each trade_id may be created only once
+    if (!config_.detect_duplicates) {
+        return acceptTrade(event);
+    }
+    TradeKey key = interner_.resolve(trade_id);
+    return commitTrade(event, key, trade_states_.upsert(key));
+}
+
+Verdict DoubleEntryValidator::checkTradePayload(const EventView& event, std::string_view& trade_id) {
     // For MVP, we just count trades
     // In a full implementation, we would:
     // 1. Parse JSON payload to extract trade details
     // 2. Calculate expected debit/credit amounts
     // 3. Validate that they sum to zero
 
-    // Extract trade_id for logging
-    std::string trade_id = extractTradeId(event.payload);
-
     // For now, just validate that the event has a payload
     if (event.payload.empty()) {
         stats_.validation_errors++;
-        std::cerr << "Validation error: Trade event with empty payload at sequence "
-                  << event.sequence_num << std::endl;
-        return;
+        if (logging_) {
+            std::cerr << "Validation error: Trade event with empty payload at sequence "
+                      << event.sequence_num << std::endl;
+        }
+        return Verdict::failed(ValidationRule::EMPTY_PAYLOAD);
     }
 
     // Simple validation: check JSON has expected fields
-    bool has_trade_id = event.payload.find("\"trade_id\"") != std::string::npos;
-    bool has_symbol = event.payload.find("\"symbol\"") != std::string::npos;
-    bool has_quantity = event.payload.find("\"quantity\"") != std::string::npos;
+    bool has_trade_id = event.payload.find("\"trade_id\"") != std::string_view::npos;
+    bool has_symbol = event.payload.find("\"symbol\"") != std::string_view::npos;
+    bool has_quantity = event.payload.find("\"quantity\"") != std::string_view::npos;
 
     if (!has_trade_id || !has_symbol || !has_quantity) {
         stats_.validation_errors++;
-        std::cerr << "Validation error: Trade event missing required fields at sequence "
-                  << event.sequence_num << std::endl;
-        return;
+        if (logging_) {
+            std::cerr << "Validation error: Trade event missing required fields at sequence "
+                      << event.sequence_num << std::endl;
+        }
+        return Verdict::failed(ValidationRule::MISSING_FIELDS);
+    }
+
+    // A trade without a usable id cannot be told apart from any other one:
+    // rejected here so it never shares duplicate state with them
+    auto id = JsonFields::findString(event.payload, "trade_id");
+    if (!id || id->empty()) {
+        stats_.validation_errors++;
+        if (logging_) {
+            std::cerr << "Validation error: Trade event with invalid trade_id at sequence "
+                      << event.sequence_num << std::endl;
+        }
+        return Verdict::failed(ValidationRule::INVALID_TRADE_ID);
+    }
+    trade_id = *id;
+    return Verdict::passed();
+}
+
+Verdict DoubleEntryValidator::commitTrade(const EventView& event, const TradeKey& key, TradeState& state) {
+    if (state.created) {
+        stats_.validation_errors++;
+        stats_.duplicate_trades++;
+        if (logging_) {
+            std::cerr << "Validation error: Duplicate trade at sequence "
+                      << event.sequence_num << std::endl;
+        }
+        return Verdict::failed(ValidationRule::DUPLICATE_TRADE);
+    }
+    // Recorded before the limits: a trade rejected by them keeps its id, so a
+    // resubmission is still flagged as a duplicate
+    state.created = true;
+    if (track_dirty_) {
+        dirty_trades_.push_back(key);
+    }
+    return acceptTrade(event);
+}
+
+Verdict DoubleEntryValidator::acceptTrade(const EventView& event) {
+    Verdict limits = checkLimits(event);
+    if (limits.code == VerdictCode::FAILED) {
+        stats_.validation_errors++;
+        if (logging_) {
+            std::cerr << "Validation error: " << validationRuleName(limits.rule)
+                      << " at sequence " << event.sequence_num << std::endl;
+        }
+        return limits;
     }
 
     // Validation passed
     stats_.trades_validated++;
 
-    // Log every 1000 trades
-    if (stats_.trades_validated % 1000 == 0) {
-        std::cout << "Validated " << stats_.trades_validated << " trades" << std::endl;
+    // Log every 1000 trades (progress lines are a COUNTERS-level probe)
+    if constexpr (instrumentationAtLeast(InstrumentationLevel::COUNTERS)) {
+        if (logging_ && stats_.trades_validated % 1000 == 0) {
+            std::cout << "Validated " << stats_.trades_validated << " trades" << std::endl;
+        }
     }
+
+    return Verdict::passed();
 }
 
-std::string DoubleEntryValidator::extractTradeId(const std::string& json_payload) const {
-    // Simple extraction: find "trade_id":"value"
-    const std::string key = "\"trade_id\":\"";
-    size_t pos = json_payload.find(key);
-    if (pos == std::string::npos) {
-        return "unknown";
+Verdict DoubleEntryValidator::checkLimits(const EventView& event) const {
+    if (config_.max_quantity == 0 && config_.max_notional == 0) {
+        return Verdict::passed();
     }
 
-    pos += key.length();
-    size_t end_pos = json_payload.find("\"", pos);
-    if (end_pos == std::string::npos) {
-        return "unknown";
+    int64_t quantity = 0;
+    auto quantity_text = JsonFields::findNumber(event.payload, "quantity");
+    if (!quantity_text || !FixedPoint::parse(*quantity_text, quantity)) {
+        return Verdict::failed(ValidationRule::MISSING_FIELDS);
+    }
+    // Bounded on both sides: a negative quantity is not a way around the limit
+    if (config_.max_quantity != 0 &&
+        (quantity > config_.max_quantity || quantity < -config_.max_quantity)) {
+        return Verdict::failed(ValidationRule::QUANTITY_LIMIT);
     }
 
-    return json_payload.substr(pos, end_pos - pos);
+    if (config_.max_notional != 0) {
+        int64_t price = 0;
+        auto price_text = JsonFields::findNumber(event.payload, "price");
+        if (!price_text || !FixedPoint::parse(*price_text, price)) {
+            return Verdict::failed(ValidationRule::MISSING_FIELDS);
+        }
+        // Both operands are scaled by 1e8: the raw product needs 128 bits
+        WideAmount notional = static_cast<WideAmount>(quantity < 0 ? -quantity : quantity) *
+                               (price < 0 ? -price : price) / FixedPoint::SCALE;
+        if (notional > config_.max_notional) {
+            return Verdict::failed(ValidationRule::NOTIONAL_LIMIT);
+        }
+    }
+    return Verdict::passed();
 }
 
 void DoubleEntryValidator::printSummary(std::ostream& out) const {
@@ -87,6 +205,14 @@ void DoubleEntryValidator::printSummary(std::ostream& out) const {
     out << "Events processed:   " << stats_.events_processed << std::endl;
     out << "Trades validated:   " << stats_.trades_validated << std::endl;
     out << "Validation errors:  " << stats_.validation_errors << std::endl;
+    out << "Duplicate trades:   " << stats_.duplicate_trades << std::endl;
+    if (trade_states_.tiered()) {
+        TradeTierStats tiers = trade_states_.stats();
+        out << "Trade state:        " << tiers.hot << " hot (limit " << tiers.hot_limit << "), "
+            << tiers.cold.records << " cold in " << tiers.cold.file_bytes / 1024 << " KiB (index "
+            << tiers.cold.index_bytes / 1024 << " KiB), " << tiers.cold.promoted << " promoted, "
+            << tiers.cold.compactions << " compactions" << std::endl;
+    }
 
     if (stats_.validation_errors == 0) {
         out << "Status: ✓ All validations passed" << std::endl;
@@ -32,17 +32,40 @@ void EventLogReader::open() {
         throw std::runtime_error("Failed to open file: " + log_path_ +
                                  " (error: " + std::string(strerror(errno)) + ")");
     }
+    map();
+    offset_ = FileHeader::SIZE;
+}
+
+void EventLogReader::adopt(int fd, size_t offset) {
+    fd_ = fd;
+    map();
+    if (offset < FileHeader::SIZE || offset > file_size_) {
+        throw std::runtime_error("Handed-off offset " + std::to_string(offset) +
+                                 " outside " + log_path_);
+    }
+    offset_ = offset;
+}
 
+void EventLogReader::seek(size_t offset) {
+    if (offset < FileHeader::SIZE || offset > file_size_) {
+        throw std::runtime_error("Seek offset " + std::to_string(offset) + " outside " + log_path_);
+    }
+    offset_ = offset;
+}
+
+void EventLogReader::map() {
     // Get file size
     struct stat st;
     if (fstat(fd_, &st) != 0) {
         close(fd_);
+        fd_ = -1;
         throw std::runtime_error("Failed to stat file: " + log_path_);
     }
     file_size_ = st.st_size;
 
     if (file_size_ < FileHeader::SIZE) {
         close(fd_);
+        fd_ = -1;
         throw std::runtime_error("File too small: " + log_path_);
     }
 
@@ -53,6 +76,7 @@ void EventLogReader::open() {
 
     if (mapped_data_ == MAP_FAILED) {
         close(fd_);
+        fd_ = -1;
         throw std::runtime_error("Failed to mmap file: " + log_path_);
     }
 
@@ -64,7 +88,6 @@ void EventLogReader::open() {
 
     // Parse and validate file header
     file_header_ = EventParser::parseFileHeader(mapped_data_, FileHeader::SIZE);
-    offset_ = FileHeader::SIZE;
     is_open_ = true;
 }
 
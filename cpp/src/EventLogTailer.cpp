@@ -3,6 +3,7 @@
 #include <thread>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <cerrno>
 
 #ifdef __linux__
 #include <sys/select.h>
@@ -82,11 +83,7 @@ bool EventLogTailer::waitForModification(int timeout_ms) {
     }
 
     // Drain inotify event queue
-    char buffer[4096];
-    ssize_t len = read(inotify_fd_, buffer, sizeof(buffer));
-    if (len < 0 && errno != EAGAIN) {
-        throw std::runtime_error("Failed to read inotify events");
-    }
+    drain();
 
     return true;  // File was modified
 
@@ -124,6 +121,31 @@ bool EventLogTailer::waitForModification(int timeout_ms) {
 #endif
 }
 
+bool EventLogTailer::drain() {
+#ifdef __linux__
+    bool drained = false;
+    char buffer[4096];
+    ssize_t len;
+    while ((len = read(inotify_fd_, buffer, sizeof(buffer))) != 0) {
+        if (len > 0) {
+            drained = true;
+        } else if (errno == EAGAIN) {
+            break;
+        } else if (errno != EINTR) {
+            throw std::runtime_error("Failed to read inotify events");
+        }
+    }
+    return drained;
+#else
+    size_t current_size = getFileSize();
+    if (current_size > last_known_size_) {
+        last_known_size_ = current_size;
+        return true;
+    }
+    return false;
+#endif
+}
+
 size_t EventLogTailer::getFileSize() const {
     struct stat st;
     if (stat(log_path_.c_str(), &st) != 0) {
@@ -55,13 +55,25 @@ FileHeader EventParser::parseFileHeader(const uint8_t* data, size_t length) {
 }
 
 Event EventParser::parse(const uint8_t* data, size_t length) {
+    EventView view = parseView(data, length);
+
+    Event event;
+    event.sequence_num = view.sequence_num;
+    event.timestamp_ns = view.timestamp_ns;
+    event.event_type = view.event_type;
+    event.payload.assign(view.payload.data(), view.payload.size());
+    event.crc32 = view.crc32;
+    return event;
+}
+
+EventView EventParser::parseView(const uint8_t* data, size_t length) {
     // Minimum size: 28 bytes (header) + 4 bytes (CRC)
     if (length < 28) {
         throw ParseException("Insufficient data for event record");
     }
 
     // Read header fields (24 bytes)
-    Event event;
+    EventView event;
     event.sequence_num = readUint64LE(data);
     event.timestamp_ns = readUint64LE(data + 8);
     event.event_type = static_cast<EventType>(data[16]);
@@ -69,7 +81,7 @@ Event EventParser::parse(const uint8_t* data, size_t length) {
     uint32_t payload_length = readUint32LE(data + 20);
 
     // Validate total length
-    size_t expected_total = 28 + payload_length;
+    size_t expected_total = 28 + static_cast<size_t>(payload_length);
     if (length < expected_total) {
         std::ostringstream oss;
         oss << "Insufficient data: expected " << expected_total
@@ -77,8 +89,8 @@ Event EventParser::parse(const uint8_t* data, size_t length) {
         throw ParseException(oss.str());
     }
 
-    // Read payload
-    event.payload.assign(reinterpret_cast<const char*>(data + 24), payload_length);
+    // Payload view (no copy)
+    event.payload = std::string_view(reinterpret_cast<const char*>(data + 24), payload_length);
 
     // Read CRC32 (last 4 bytes)
     uint32_t stored_crc = readUint32LE(data + 24 + payload_length);
@@ -0,0 +1,316 @@
+#include "EventTap.h"
+#include "CommandLine.h"
+#include "JsonFields.h"
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace trading_ledger {
+
+namespace {
+
+const char* eventTypeName(EventType type) {
+    switch (type) {
+        case EventType::TRADE_CREATED: return "TRADE_CREATED";
+        case EventType::LEDGER_ENTRIES_GENERATED: return "LEDGER_ENTRIES_GENERATED";
+        case EventType::POSITION_UPDATED: return "POSITION_UPDATED";
+    }
+    return "UNKNOWN";
+}
+
+const char* verdictName(const Verdict& verdict) {
+    switch (verdict.code) {
+        case VerdictCode::PASSED: return "PASSED";
+        case VerdictCode::FAILED: return validationRuleName(verdict.rule);
+        case VerdictCode::SKIPPED: return "SKIPPED";
+    }
+    return "UNKNOWN";
+}
+
+int openDestination(const std::string& destination) {
+    static constexpr std::string_view UNIX_PREFIX = "unix:";
+    if (destination.compare(0, UNIX_PREFIX.size(), UNIX_PREFIX) != 0) {
+        int fd = ::open(destination.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open tap file " + destination +
+                                     " (error: " + std::string(strerror(errno)) + ")");
+        }
+        return fd;
+    }
+
+    std::string path = destination.substr(UNIX_PREFIX.size());
+    sockaddr_un address{};
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Bad tap socket path: " + destination);
+    }
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create tap socket (error: " + std::string(strerror(errno)) + ")");
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Failed to connect tap socket " + path + " (error: " +
+                                 std::string(strerror(error)) + ")");
+    }
+    return fd;
+}
+
+}  // namespace
+
+TapFilter TapFilter::parse(const std::vector<std::string>& tokens) {
+    TapFilter filter;
+    for (const std::string& token : tokens) {
+        size_t eq = token.find('=');
+        if (eq == std::string::npos) {
+            throw std::invalid_argument("expected key=value, got '" + token + "'");
+        }
+        std::string key = token.substr(0, eq);
+        std::string value = token.substr(eq + 1);
+
+        if (key == "type") {
+            if (value == "TRADE_CREATED") {
+                filter.type = EventType::TRADE_CREATED;
+            } else if (value == "LEDGER_ENTRIES_GENERATED") {
+                filter.type = EventType::LEDGER_ENTRIES_GENERATED;
+            } else if (value == "POSITION_UPDATED") {
+                filter.type = EventType::POSITION_UPDATED;
+            } else {
+                filter.type = static_cast<EventType>(CommandLine::parse<uint8_t>(key, value));
+            }
+        } else if (key == "seq") {
+            size_t dash = value.find('-');
+            if (dash == std::string::npos) {
+                filter.min_sequence = filter.max_sequence = CommandLine::parse<uint64_t>(key, value);
+            } else {
+                std::string from = value.substr(0, dash);
+                std::string to = value.substr(dash + 1);
+                filter.min_sequence = from.empty() ? 0 : CommandLine::parse<uint64_t>(key, from);
+                filter.max_sequence = to.empty() ? UINT64_MAX : CommandLine::parse<uint64_t>(key, to);
+            }
+            if (filter.min_sequence > filter.max_sequence) {
+                throw std::invalid_argument("empty sequence range: " + value);
+            }
+        } else if (key == "trade") {
+            if (value.empty()) {
+                throw std::invalid_argument("empty trade id");
+            }
+            filter.trade_id = value;
+        } else if (key == "verdict") {
+            if (value != "FAILED") {
+                throw std::invalid_argument("verdict filter supports FAILED only");
+            }
+            filter.failed_only = true;
+        } else if (key == "sample") {
+            filter.sample_every = CommandLine::parse<uint64_t>(key, value, 1);
+        } else {
+            throw std::invalid_argument("unknown tap filter '" + key +
+                                        "' (type, seq, trade, verdict, sample)");
+        }
+    }
+    return filter;
+}
+
+bool TapFilter::matches(const EventView& event, const Verdict& verdict) const {
+    if (event.sequence_num < min_sequence || event.sequence_num > max_sequence) {
+        return false;
+    }
+    if (type && event.event_type != *type) {
+        return false;
+    }
+    if (failed_only && verdict.code != VerdictCode::FAILED) {
+        return false;
+    }
+    if (!trade_id.empty()) {
+        auto id = JsonFields::findString(event.payload, "trade_id");
+        if (!id || *id != trade_id) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string TapFilter::describe() const {
+    std::string text;
+    if (type) {
+        text += std::string(" type=") + eventTypeName(*type);
+    }
+    if (min_sequence != 0 || max_sequence != UINT64_MAX) {
+        text += " seq=" + (min_sequence ? std::to_string(min_sequence) : "") + "-" +
+                (max_sequence != UINT64_MAX ? std::to_string(max_sequence) : "");
+    }
+    if (!trade_id.empty()) {
+        text += " trade=" + trade_id;
+    }
+    if (failed_only) {
+        text += " verdict=FAILED";
+    }
+    if (sample_every != 1) {
+        text += " sample=" + std::to_string(sample_every);
+    }
+    return text.empty() ? "all" : text.substr(1);
+}
+
+EventTap::~EventTap() {
+    armed_ = false;
+    stop();
+}
+
+void EventTap::start(const std::string& destination) {
+    if (running()) {
+        throw std::runtime_error("tap already running to " + destination_);
+    }
+    int fd = openDestination(destination);
+    fd_ = fd;
+    destination_ = destination;
+    matched_.store(0, std::memory_order_relaxed);
+    queued_.store(0, std::memory_order_relaxed);
+    dropped_.store(0, std::memory_order_relaxed);
+    written_.store(0, std::memory_order_relaxed);
+    discarded_.store(0, std::memory_order_relaxed);
+    error_.clear();
+    failed_.store(false, std::memory_order_relaxed);
+    if (!ring_) {
+        ring_ = std::make_unique<Ring>();
+    }
+    draining_.store(true, std::memory_order_release);
+    drainer_ = std::thread(&EventTap::drainLoop, this);
+}
+
+void EventTap::stop() {
+    if (!running()) {
+        return;
+    }
+    draining_.store(false, std::memory_order_release);
+    ring_->wake();
+    drainer_.join();
+    ::close(fd_);
+    fd_ = -1;
+}
+
+void EventTap::arm(const TapFilter& filter) {
+    if (!running()) {
+        throw std::runtime_error("tap not started");
+    }
+    filter_ = filter;
+    sample_counter_ = 0;
+    armed_ = true;
+}
+
+EventTap::Stats EventTap::stats() const {
+    Stats stats;
+    stats.matched = matched_.load(std::memory_order_relaxed);
+    stats.queued = queued_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.written = written_.load(std::memory_order_relaxed);
+    stats.discarded = discarded_.load(std::memory_order_relaxed);
+    if (failed_.load(std::memory_order_acquire)) {
+        stats.error = error_;
+    }
+    return stats;
+}
+
+void EventTap::capture(const EventView& event, const Verdict& verdict) {
+    if (failed_.load(std::memory_order_relaxed)) {
+        armed_ = false;   // Output is gone: back to the one-branch path
+        return;
+    }
+    if (!filter_.matches(event, verdict)) {
+        return;
+    }
+    // Single writer: relaxed load + store instead of a locked increment
+    matched_.store(matched_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (sample_counter_++ % filter_.sample_every != 0) {
+        return;
+    }
+
+    TapRecord record;
+    record.sequence = event.sequence_num;
+    record.timestamp_ns = event.timestamp_ns;
+    record.type = event.event_type;
+    record.verdict = verdict;
+    record.payload_length = static_cast<uint32_t>(event.payload.size());
+    std::memcpy(record.payload, event.payload.data(),
+                std::min(event.payload.size(), TapRecord::MAX_PAYLOAD));
+
+    if (ring_->try_push(record)) {
+        queued_.store(queued_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    } else {
+        dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
+
+void EventTap::drainLoop() {
+    TapRecord record;
+    std::string line;
+    for (;;) {
+        // Read the flag before popping so records queued before stop() are
+        // still written
+        bool keep_running = draining_.load(std::memory_order_acquire);
+        if (ring_->try_pop(record)) {
+            if (failed_.load(std::memory_order_relaxed)) {
+                discarded_.store(discarded_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                continue;
+            }
+            if (!writeRecord(record, line)) {
+                // A dead reader (closed socket, full disk) stops the output
+                // only; the consumer disarms on its next offer
+                error_ = "Failed to write tap " + destination_ + " (error: " +
+                         std::string(strerror(errno)) + ")";
+                discarded_.store(discarded_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                failed_.store(true, std::memory_order_release);
+            }
+            continue;
+        }
+        if (!keep_running) {
+            break;
+        }
+        ring_->wait(100);
+    }
+}
+
+bool EventTap::writeRecord(const TapRecord& record, std::string& line) {
+    line.clear();
+    line += std::to_string(record.sequence);
+    line += ' ';
+    line += std::to_string(record.timestamp_ns);
+    line += ' ';
+    line += eventTypeName(record.type);
+    line += ' ';
+    line += verdictName(record.verdict);
+    line += ' ';
+    size_t length = std::min<size_t>(record.payload_length, TapRecord::MAX_PAYLOAD);
+    line.append(record.payload, length);
+    if (length < record.payload_length) {
+        line += "...(" + std::to_string(record.payload_length) + " bytes)";
+    }
+    line += '\n';
+
+    const char* data = line.data();
+    size_t remaining = line.size();
+    while (remaining > 0) {
+        ssize_t written = ::send(fd_, data, remaining, MSG_NOSIGNAL);
+        if (written < 0 && errno == ENOTSOCK) {
+            written = ::write(fd_, data, remaining);
+        }
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    written_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+}  // namespace trading_ledger
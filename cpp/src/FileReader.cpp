@@ -2,6 +2,7 @@
 #include "EventParser.h"
 #include <stdexcept>
 #include <vector>
+#include <cstring>
 
 namespace trading_ledger {
 
@@ -0,0 +1,224 @@
+#include "FlightRecorder.h"
+#include "ByteOrder.h"
+#include "EventParser.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace trading_ledger {
+
+namespace {
+
+// CRC covers everything but the trailing 4 bytes
+constexpr size_t CRC_OFFSET = MetricSnapshot::SIZE - 4;
+
+FlightRecorderHeader decodeHeader(const uint8_t* data) {
+    FlightRecorderHeader header;
+    header.magic = EventParser::readUint32LE(data);
+    header.version = EventParser::readUint32LE(data + 4);
+    header.record_size = EventParser::readUint32LE(data + 8);
+    header.slot_count = EventParser::readUint32LE(data + 12);
+    return header;
+}
+
+}  // namespace
+
+FlightRecorder::FlightRecorder(const std::string& path, size_t slot_count)
+    : path_(path)
+    , slot_count_(slot_count > 0 ? slot_count : DEFAULT_SLOT_COUNT)
+    , fd_(-1)
+    , mapped_(nullptr)
+    , mapped_size_(0)
+    , next_index_(1) {}
+
+FlightRecorder::~FlightRecorder() {
+    close();
+}
+
+void FlightRecorder::open() {
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open flight recorder: " + path_ +
+                                 " (error: " + std::string(strerror(errno)) + ")");
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+        close();
+        throw std::runtime_error("Failed to stat flight recorder: " + path_);
+    }
+
+    bool is_new = st.st_size == 0;
+    if (is_new) {
+        // Allocate the whole file up front: record() never extends it
+        mapped_size_ = FlightRecorderHeader::SIZE + slot_count_ * MetricSnapshot::SIZE;
+        if (ftruncate(fd_, static_cast<off_t>(mapped_size_)) != 0) {
+            close();
+            throw std::runtime_error("Failed to size flight recorder: " + path_ +
+                                     " (error: " + std::string(strerror(errno)) + ")");
+        }
+    } else {
+        mapped_size_ = static_cast<size_t>(st.st_size);
+        if (mapped_size_ < FlightRecorderHeader::SIZE) {
+            close();
+            throw std::runtime_error("Not a flight recorder file: " + path_);
+        }
+    }
+
+    void* mapped = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapped == MAP_FAILED) {
+        close();
+        throw std::runtime_error("Failed to mmap flight recorder: " + path_);
+    }
+    mapped_ = static_cast<uint8_t*>(mapped);
+
+    if (is_new) {
+        std::memset(mapped_, 0, FlightRecorderHeader::SIZE);
+        writeUint32LE(mapped_, FlightRecorderHeader::EXPECTED_MAGIC);
+        writeUint32LE(mapped_ + 4, FlightRecorderHeader::EXPECTED_VERSION);
+        writeUint32LE(mapped_ + 8, static_cast<uint32_t>(MetricSnapshot::SIZE));
+        writeUint32LE(mapped_ + 12, static_cast<uint32_t>(slot_count_));
+        next_index_ = 1;
+        return;
+    }
+
+    FlightRecorderHeader header = decodeHeader(mapped_);
+    if (!header.isValid() ||
+        mapped_size_ < FlightRecorderHeader::SIZE + header.slot_count * MetricSnapshot::SIZE) {
+        close();
+        throw std::runtime_error("Not a flight recorder file: " + path_);
+    }
+    slot_count_ = header.slot_count;
+
+    // Continue after the newest valid record
+    next_index_ = 1;
+    MetricSnapshot snapshot;
+    for (size_t slot = 0; slot < slot_count_; ++slot) {
+        const uint8_t* frame = mapped_ + FlightRecorderHeader::SIZE + slot * MetricSnapshot::SIZE;
+        if (decode(frame, snapshot) && snapshot.index >= next_index_) {
+            next_index_ = snapshot.index + 1;
+        }
+    }
+}
+
+void FlightRecorder::record(MetricSnapshot snapshot) {
+    if (mapped_ == nullptr) {
+        return;
+    }
+    snapshot.index = next_index_++;
+
+    uint8_t frame[MetricSnapshot::SIZE];
+    encode(snapshot, frame);
+
+    size_t slot = (snapshot.index - 1) % slot_count_;
+    std::memcpy(mapped_ + FlightRecorderHeader::SIZE + slot * MetricSnapshot::SIZE,
+                frame, sizeof(frame));
+}
+
+void FlightRecorder::close() {
+    if (mapped_ != nullptr) {
+        munmap(mapped_, mapped_size_);
+        mapped_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void FlightRecorder::encode(const MetricSnapshot& snapshot, uint8_t* out) {
+    std::memset(out, 0, MetricSnapshot::SIZE);
+    writeUint64LE(out, snapshot.index);
+    writeUint64LE(out + 8, snapshot.timestamp_ns);
+    writeUint64LE(out + 16, snapshot.events_read);
+    writeUint64LE(out + 24, snapshot.events_processed);
+    writeUint64LE(out + 32, snapshot.validation_failures);
+    writeUint64LE(out + 40, snapshot.verdicts_dropped);
+    writeUint32LE(out + 48, snapshot.ring_occupancy);
+    writeUint32LE(out + 52, snapshot.ring_capacity);
+    writeUint64LE(out + 56, snapshot.lag_events);
+    writeUint64LE(out + 64, snapshot.interval_count);
+    writeUint64LE(out + 72, static_cast<uint64_t>(snapshot.p50_ns));
+    writeUint64LE(out + 80, static_cast<uint64_t>(snapshot.p99_ns));
+    writeUint64LE(out + 88, static_cast<uint64_t>(snapshot.p999_ns));
+    writeUint64LE(out + 96, static_cast<uint64_t>(snapshot.max_ns));
+    writeUint32LE(out + CRC_OFFSET, EventParser::calculateCRC32(out, CRC_OFFSET));
+}
+
+bool FlightRecorder::decode(const uint8_t* data, MetricSnapshot& snapshot) {
+    snapshot.index = EventParser::readUint64LE(data);
+    if (snapshot.index == 0) {
+        return false;  // Never written
+    }
+    if (EventParser::readUint32LE(data + CRC_OFFSET) != EventParser::calculateCRC32(data, CRC_OFFSET)) {
+        return false;  // Torn or corrupted
+    }
+    snapshot.timestamp_ns = EventParser::readUint64LE(data + 8);
+    snapshot.events_read = EventParser::readUint64LE(data + 16);
+    snapshot.events_processed = EventParser::readUint64LE(data + 24);
+    snapshot.validation_failures = EventParser::readUint64LE(data + 32);
+    snapshot.verdicts_dropped = EventParser::readUint64LE(data + 40);
+    snapshot.ring_occupancy = EventParser::readUint32LE(data + 48);
+    snapshot.ring_capacity = EventParser::readUint32LE(data + 52);
+    snapshot.lag_events = EventParser::readUint64LE(data + 56);
+    snapshot.interval_count = EventParser::readUint64LE(data + 64);
+    snapshot.p50_ns = static_cast<int64_t>(EventParser::readUint64LE(data + 72));
+    snapshot.p99_ns = static_cast<int64_t>(EventParser::readUint64LE(data + 80));
+    snapshot.p999_ns = static_cast<int64_t>(EventParser::readUint64LE(data + 88));
+    snapshot.max_ns = static_cast<int64_t>(EventParser::readUint64LE(data + 96));
+    return true;
+}
+
+std::vector<MetricSnapshot> readFlightRecorder(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open flight recorder: " + path +
+                                 " (error: " + std::string(strerror(errno)) + ")");
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < FlightRecorderHeader::SIZE) {
+        ::close(fd);
+        throw std::runtime_error("Not a flight recorder file: " + path);
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Failed to mmap flight recorder: " + path);
+    }
+    const uint8_t* data = static_cast<const uint8_t*>(mapped);
+
+    FlightRecorderHeader header = decodeHeader(data);
+    if (!header.isValid() ||
+        size < FlightRecorderHeader::SIZE + header.slot_count * MetricSnapshot::SIZE) {
+        munmap(mapped, size);
+        throw std::runtime_error("Not a flight recorder file: " + path);
+    }
+
+    std::vector<MetricSnapshot> snapshots;
+    MetricSnapshot snapshot;
+    for (size_t slot = 0; slot < header.slot_count; ++slot) {
+        // Copy the frame first: the writer may be overwriting it concurrently,
+        // and the CRC must be checked on the same bytes that are decoded
+        uint8_t frame[MetricSnapshot::SIZE];
+        std::memcpy(frame, data + FlightRecorderHeader::SIZE + slot * MetricSnapshot::SIZE,
+                    sizeof(frame));
+        if (FlightRecorder::decode(frame, snapshot)) {
+            snapshots.push_back(snapshot);
+        }
+    }
+    munmap(mapped, size);
+
+    std::sort(snapshots.begin(), snapshots.end(),
+              [](const MetricSnapshot& a, const MetricSnapshot& b) { return a.index < b.index; });
+    return snapshots;
+}
+
+}  // namespace trading_ledger
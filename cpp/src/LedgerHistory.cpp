@@ -0,0 +1,291 @@
+#include "LedgerHistory.h"
+#include "Elapsed.h"
+#include "EventParser.h"
+#include "MappedLog.h"
+#include "StateRecord.h"
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace trading_ledger {
+
+namespace {
+
+// Frame size at offset, or 0 if the frame is incomplete
+size_t frameSize(const uint8_t* data, size_t size, size_t offset) {
+    if (offset + 28 > size) {
+        return 0;
+    }
+    size_t total = 28 + static_cast<size_t>(EventParser::readUint32LE(data + offset + 20));
+    return offset + total <= size ? total : 0;
+}
+
+// Index for this log: the saved one if it still matches, else rebuilt
+SparseLogIndex loadIndex(const std::string& path, size_t stride, const MappedLog& log,
+                         size_t* added = nullptr) {
+    SparseLogIndex index(stride);
+    bool usable = index.load(path) && index.scannedOffset() <= log.size();
+    if (usable && !index.entries().empty()) {
+        const IndexEntry& last = index.entries().back();
+        usable = frameSize(log.data(), log.size(), last.offset) != 0 &&
+                 EventParser::readUint64LE(log.data() + last.offset) == last.sequence;
+    }
+    if (!usable) {
+        index = SparseLogIndex(stride);  // Log replaced or index damaged
+    }
+    size_t count = index.extend(log.data(), log.size());
+    if (added != nullptr) {
+        *added = count;
+    }
+    return index;
+}
+
+// Offset of the first event after a snapshot
+size_t resumeOffset(const SparseLogIndex& index, const MappedLog& log, uint64_t sequence) {
+    uint64_t offset = index.locate(log.data(), log.size(), sequence);
+    if (offset == 0) {
+        throw std::runtime_error("Snapshot at sequence " + std::to_string(sequence) +
+                                 " is not in this log (stale snapshot file?)");
+    }
+    return offset + frameSize(log.data(), log.size(), offset);
+}
+
+}  // namespace
+
+void LedgerState::apply(const EventView& event) {
+    if (event.event_type == EventType::TRADE_CREATED) {
+        positions.applyEvent(event);
+    } else if (event.event_type == EventType::LEDGER_ENTRIES_GENERATED) {
+        balances.applyEvent(event);
+    }
+    sequence = event.sequence_num;
+    timestamp_ns = event.timestamp_ns;
+    events_applied++;
+}
+
+void SnapshotStore::open() {
+    catalog_.clear();
+    valid_end_ = 0;
+
+    std::ifstream file(path_, std::ios::binary);
+    if (!file) {
+        return;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.empty()) {
+        return;
+    }
+    if (data.size() < HEADER_SIZE || EventParser::readUint32LE(data.data()) != MAGIC ||
+        EventParser::readUint32LE(data.data() + 4) != VERSION) {
+        throw std::runtime_error("Not a snapshot file: " + path_);
+    }
+
+    size_t offset = HEADER_SIZE;
+    while (offset + 4 <= data.size()) {
+        uint32_t length = EventParser::readUint32LE(data.data() + offset);
+        if (length < 24 || offset + 8 + length > data.size()) {
+            break;
+        }
+        const uint8_t* body = data.data() + offset + 4;
+        if (EventParser::readUint32LE(body + length) != EventParser::calculateCRC32(body, length)) {
+            break;  // Torn append
+        }
+        catalog_.push_back({EventParser::readUint64LE(body), EventParser::readUint64LE(body + 8),
+                            offset, length});
+        offset += 8 + length;
+    }
+    valid_end_ = offset;
+}
+
+void SnapshotStore::append(const LedgerState& state) {
+    RecordWriter body("snapshot");
+    body.u64(state.sequence);
+    body.u64(state.timestamp_ns);
+    body.u64(state.events_applied);
+
+    const AccountBalanceBook& balances = state.balances;
+    body.u32(static_cast<uint32_t>(balances.accountCount()));
+    for (uint32_t id = 0; id < balances.accountCount(); ++id) {
+        writeAccountRecord(body, balances, id);
+    }
+
+    body.u32(static_cast<uint32_t>(state.positions.size()));
+    state.positions.forEach([&](const std::string& account, const std::string& symbol,
+                                const PositionBook::Position& position) {
+        writePositionRecord(body, account, symbol, position);
+    });
+
+    std::vector<uint8_t>& bytes = body.bytes();
+    uint32_t length = static_cast<uint32_t>(bytes.size());
+    RecordWriter record("snapshot");
+    record.u32(length);
+    record.bytes().insert(record.bytes().end(), bytes.begin(), bytes.end());
+    record.u32(EventParser::calculateCRC32(bytes.data(), bytes.size()));
+
+    std::fstream file(path_, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file || valid_end_ == 0) {
+        RecordWriter header("snapshot");
+        header.u32(MAGIC);
+        header.u32(VERSION);
+        header.u64(0);
+        file.close();
+        file.open(path_, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(header.bytes().data()), HEADER_SIZE);
+        valid_end_ = HEADER_SIZE;
+    } else if (::truncate(path_.c_str(), static_cast<off_t>(valid_end_)) != 0) {
+        throw std::runtime_error("Failed to truncate torn snapshot in " + path_);
+    }
+
+    uint64_t record_offset = valid_end_;
+    file.seekp(static_cast<std::streamoff>(record_offset));
+    file.write(reinterpret_cast<const char*>(record.bytes().data()),
+               static_cast<std::streamsize>(record.bytes().size()));
+    file.flush();
+    if (!file) {
+        throw std::runtime_error("Failed to append snapshot to " + path_);
+    }
+
+    catalog_.push_back({state.sequence, state.timestamp_ns, record_offset, length});
+    valid_end_ = record_offset + 8 + length;
+}
+
+std::unique_ptr<LedgerState> SnapshotStore::load(const SnapshotInfo& info) const {
+    std::ifstream file(path_, std::ios::binary);
+    std::vector<uint8_t> data(info.length + 4);
+    file.seekg(static_cast<std::streamoff>(info.file_offset + 4));
+    file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!file) {
+        throw std::runtime_error("Failed to read snapshot from " + path_);
+    }
+    if (EventParser::readUint32LE(data.data() + info.length) !=
+        EventParser::calculateCRC32(data.data(), info.length)) {
+        throw CorruptedEventException("snapshot at sequence " + std::to_string(info.sequence));
+    }
+
+    auto state = std::make_unique<LedgerState>();
+    RecordReader in(data.data(), info.length, "snapshot");
+    state->sequence = in.u64();
+    state->timestamp_ns = in.u64();
+    state->events_applied = in.u64();
+
+    uint32_t accounts = in.u32();
+    for (uint32_t i = 0; i < accounts; ++i) {
+        readAccountRecord(in, state->balances);
+    }
+
+    uint32_t positions = in.u32();
+    for (uint32_t i = 0; i < positions; ++i) {
+        readPositionRecord(in, state->positions);
+    }
+    return state;
+}
+
+const SnapshotInfo* SnapshotStore::floorBySequence(uint64_t sequence) const {
+    auto it = std::upper_bound(catalog_.begin(), catalog_.end(), sequence,
+                               [](uint64_t value, const SnapshotInfo& s) { return value < s.sequence; });
+    return it == catalog_.begin() ? nullptr : &*std::prev(it);
+}
+
+const SnapshotInfo* SnapshotStore::floorByTimestamp(uint64_t timestamp_ns) const {
+    auto it = std::upper_bound(catalog_.begin(), catalog_.end(), timestamp_ns,
+                               [](uint64_t value, const SnapshotInfo& s) { return value < s.timestamp_ns; });
+    return it == catalog_.begin() ? nullptr : &*std::prev(it);
+}
+
+LedgerHistory::LedgerHistory(std::string log_path, Config config)
+    : log_path_(std::move(log_path)), config_(config) {
+    if (config_.snapshot_interval == 0) {
+        config_.snapshot_interval = DEFAULT_SNAPSHOT_INTERVAL;
+    }
+}
+
+LedgerHistory::UpdateStats LedgerHistory::update() {
+    auto start = std::chrono::steady_clock::now();
+    UpdateStats stats;
+    MappedLog log(log_path_);
+    SparseLogIndex index = loadIndex(indexPath(), config_.index_stride, log, &stats.index_entries_added);
+    index.save(indexPath());
+
+    SnapshotStore store(snapshotPath());
+    store.open();
+
+    std::unique_ptr<LedgerState> state;
+    size_t offset = FileHeader::SIZE;
+    if (store.catalog().empty()) {
+        state = std::make_unique<LedgerState>();
+    } else {
+        const SnapshotInfo& last = store.catalog().back();
+        state = store.load(last);
+        offset = resumeOffset(index, log, last.sequence);
+    }
+
+    size_t since_snapshot = 0;
+    size_t total;
+    while ((total = frameSize(log.data(), log.size(), offset)) != 0) {
+        state->apply(EventParser::parseView(log.data() + offset, total));
+        offset += total;
+        stats.events_replayed++;
+        if (++since_snapshot == config_.snapshot_interval) {
+            store.append(*state);
+            stats.snapshots_written++;
+            since_snapshot = 0;
+        }
+    }
+
+    stats.seconds = secondsSince(start);
+    return stats;
+}
+
+std::unique_ptr<LedgerState> LedgerHistory::asOfSequence(uint64_t sequence, QueryStats* stats) {
+    return asOf(false, sequence, stats);
+}
+
+std::unique_ptr<LedgerState> LedgerHistory::asOfTime(uint64_t timestamp_ns, QueryStats* stats) {
+    return asOf(true, timestamp_ns, stats);
+}
+
+std::unique_ptr<LedgerState> LedgerHistory::asOf(bool by_time, uint64_t target, QueryStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    QueryStats local;
+    MappedLog log(log_path_);
+
+    SnapshotStore store(snapshotPath());
+    store.open();
+    const SnapshotInfo* snapshot = by_time ? store.floorByTimestamp(target)
+                                           : store.floorBySequence(target);
+
+    std::unique_ptr<LedgerState> state;
+    size_t offset = FileHeader::SIZE;
+    if (snapshot == nullptr) {
+        state = std::make_unique<LedgerState>();
+    } else {
+        // The index is only needed to find where the snapshot sits
+        SparseLogIndex index = loadIndex(indexPath(), config_.index_stride, log);
+        state = store.load(*snapshot);
+        offset = resumeOffset(index, log, snapshot->sequence);
+        local.snapshot_sequence = snapshot->sequence;
+    }
+
+    size_t total;
+    while ((total = frameSize(log.data(), log.size(), offset)) != 0) {
+        const uint8_t* frame = log.data() + offset;
+        uint64_t key = EventParser::readUint64LE(frame + (by_time ? 8 : 0));
+        if (key > target) {
+            break;
+        }
+        state->apply(EventParser::parseView(frame, total));
+        offset += total;
+        local.events_replayed++;
+    }
+
+    local.seconds = secondsSince(start);
+    if (stats != nullptr) {
+        *stats = local;
+    }
+    return state;
+}
+
+}  // namespace trading_ledger
@@ -0,0 +1,55 @@
+#include "MappedLog.h"
+#include "Event.h"
+#include "EventParser.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace trading_ledger {
+
+MappedLog::MappedLog(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file: " + path +
+                                 " (error: " + std::string(strerror(errno)) + ")");
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to stat file: " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ < FileHeader::SIZE) {
+        ::close(fd);
+        throw std::runtime_error("File too small: " + path);
+    }
+    void* mapped = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Failed to mmap file: " + path);
+    }
+    data_ = static_cast<const uint8_t*>(mapped);
+
+    try {
+        EventParser::parseFileHeader(data_, size_);
+    } catch (...) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+        throw;
+    }
+}
+
+MappedLog::~MappedLog() {
+    munmap(const_cast<uint8_t*>(data_), size_);
+}
+
+void MappedLog::willNeed() const {
+#ifdef __linux__
+    madvise(const_cast<uint8_t*>(data_), size_, MADV_WILLNEED);
+#endif
+}
+
+}  // namespace trading_ledger
@@ -0,0 +1,351 @@
+#include "MultiLedgerProcessor.h"
+#include "AccountBalanceBook.h"
+#include "DoubleEntryValidator.h"
+#include "EventLogReader.h"
+#include "EventLogTailer.h"
+#include "NotifyingRingBuffer.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+
+namespace trading_ledger {
+
+struct MultiLedgerProcessor::Tenant {
+    std::string name;
+
+    // I/O thread only
+    EventLogReader reader;
+    EventLogTailer tailer;
+    std::optional<Event> pending;  // Read but not yet pushed (ring was full)
+    bool failed = false;
+    bool parked = false;           // Armed on the ring's space fd
+
+    // Heap-allocated: one ring per ledger would not fit on any stack
+    std::unique_ptr<NotifyingRingBuffer<Event, RING_SIZE>> ring;
+
+    // Owned by whichever worker holds the tenant (at most one at a time)
+    DoubleEntryValidator validator;
+    AccountBalanceBook balance_book;
+
+    // True while queued or being processed
+    alignas(64) std::atomic<bool> scheduled{false};
+
+    // Stats: events_read/failed written by the I/O thread, the rest by the
+    // worker holding the tenant
+    alignas(64) std::atomic<uint64_t> events_read{0};
+    std::atomic<bool> read_failed{false};
+    std::atomic<uint64_t> full_waits{0};
+    alignas(64) std::atomic<uint64_t> events_processed{0};
+    std::atomic<uint64_t> validation_failures{0};
+    std::atomic<uint64_t> turns{0};
+
+    Tenant(const std::string& tenant_name, const std::string& log_path)
+        : name(tenant_name)
+        , reader(log_path)
+        , tailer(log_path)
+        , ring(std::make_unique<NotifyingRingBuffer<Event, RING_SIZE>>()) {}
+};
+
+MultiLedgerProcessor::MultiLedgerProcessor(Config config)
+    : config_(config)
+    , running_(false)
+    , wake_fd_(-1)
+    , workers_stopping_(false) {
+    if (config_.worker_count == 0) {
+        config_.worker_count = 1;
+    }
+    if (config_.quantum == 0) {
+        config_.quantum = DEFAULT_QUANTUM;
+    }
+}
+
+MultiLedgerProcessor::~MultiLedgerProcessor() {
+    stop();
+}
+
+size_t MultiLedgerProcessor::addLedger(const std::string& name, const std::string& log_path) {
+    if (running_.load(std::memory_order_acquire)) {
+        throw std::runtime_error("Cannot add ledger while running: " + name);
+    }
+    auto tenant = std::make_unique<Tenant>(name, log_path);
+    tenant->reader.open();
+    tenant->tailer.init();
+    // Each ledger reports its own verdicts through stats; keep the shared
+    // stdout/stderr free of per-ledger progress lines
+    tenant->validator.setLogging(false);
+    tenants_.push_back(std::move(tenant));
+    return tenants_.size() - 1;
+}
+
+void MultiLedgerProcessor::start() {
+    if (running_.load(std::memory_order_acquire)) {
+        return;
+    }
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        throw std::runtime_error("Failed to create eventfd (error: " +
+                                 std::string(strerror(errno)) + ")");
+    }
+
+    workers_stopping_ = false;
+    running_.store(true, std::memory_order_release);
+    io_thread_ = std::thread(&MultiLedgerProcessor::ioLoop, this);
+    for (size_t i = 0; i < config_.worker_count; ++i) {
+        workers_.emplace_back(&MultiLedgerProcessor::workerLoop, this);
+    }
+}
+
+void MultiLedgerProcessor::stop() {
+    if (!io_thread_.joinable()) {
+        return;
+    }
+
+    // 1. Stop reading
+    running_.store(false, std::memory_order_release);
+    uint64_t one = 1;
+    while (write(wake_fd_, &one, sizeof(one)) < 0 && errno == EINTR) {}
+    io_thread_.join();
+
+    // 2. Workers exit once the run queue is empty, i.e. every ring is drained
+    //    (a tenant with queued events is always in the queue or running)
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        workers_stopping_ = true;
+    }
+    queue_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+
+    close(wake_fd_);
+    wake_fd_ = -1;
+}
+
+void MultiLedgerProcessor::ioLoop() {
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        std::cerr << "Multi-ledger I/O: epoll_create1 failed: " << strerror(errno) << std::endl;
+        return;
+    }
+
+    // data.u64: tenant index (SPACE set for its ring's space fd), or
+    // UINT64_MAX for the wake fd
+    constexpr uint64_t SPACE = uint64_t{1} << 62;
+    struct epoll_event registration{};
+    registration.events = EPOLLIN;
+    registration.data.u64 = UINT64_MAX;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd_, &registration);
+    for (size_t i = 0; i < tenants_.size(); ++i) {
+        int fd = tenants_[i]->tailer.fd();
+        if (fd >= 0) {
+            registration.data.u64 = i;
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &registration);
+        }
+        registration.data.u64 = i | SPACE;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, tenants_[i]->ring->spaceFd(), &registration);
+    }
+
+    constexpr int MAX_EVENTS = 64;
+    struct epoll_event ready[MAX_EVENTS];
+
+    while (running_.load(std::memory_order_acquire)) {
+        bool more = false;
+        for (auto& tenant : tenants_) {
+            more |= pump(*tenant);
+        }
+
+        // Capped with room left: come straight back; otherwise sleep until
+        // a log changes or a parked ring frees a slot (timeout covers the
+        // polling tailer fallback)
+        int n = epoll_wait(epoll_fd, ready, MAX_EVENTS, more ? 0 : 100);
+        for (int i = 0; i < n; ++i) {
+            uint64_t data = ready[i].data.u64;
+            if (data == UINT64_MAX) {
+                uint64_t count;
+                while (read(wake_fd_, &count, sizeof(count)) < 0 && errno == EINTR) {}
+            } else if (data & SPACE) {
+                Tenant& tenant = *tenants_[data & ~SPACE];
+                tenant.ring->finishSpaceWait();
+                tenant.parked = false;
+            } else {
+                tenants_[data]->tailer.drain();
+            }
+        }
+    }
+
+    close(epoll_fd);
+    for (auto& tenant : tenants_) {
+        flushPending(*tenant);
+    }
+}
+
+void MultiLedgerProcessor::flushPending(Tenant& tenant) {
+    if (tenant.parked) {
+        tenant.ring->finishSpaceWait();
+        tenant.parked = false;
+    }
+    if (tenant.failed || !tenant.pending) {
+        return;
+    }
+    // Workers are still running (stop() joins them after this thread)
+    while (!tenant.ring->try_push(std::move(*tenant.pending))) {
+        tenant.ring->waitForSpace(100);
+    }
+    tenant.pending.reset();
+    schedule(tenant);
+}
+
+bool MultiLedgerProcessor::pump(Tenant& tenant) {
+    if (tenant.failed || tenant.parked) {
+        return false;
+    }
+
+    // Cap per pass so one busy log cannot monopolize the I/O thread
+    const size_t max_reads = config_.quantum * 4;
+    size_t pushed = 0;
+    size_t read = 0;
+    bool more = false;
+
+    try {
+        while (true) {
+            if (!tenant.pending) {
+                Event event;
+                if (!tenant.reader.readNext(event)) {
+                    if (tenant.reader.remapIfGrown()) {
+                        continue;
+                    }
+                    break;
+                }
+                tenant.pending = std::move(event);
+                read++;
+            }
+            if (pushed >= max_reads) {
+                more = true;
+                break;
+            }
+            if (!tenant.ring->try_push(std::move(*tenant.pending))) {
+                // Park until the worker frees a slot, unless it just did
+                tenant.parked = tenant.ring->prepareSpaceWait();
+                more = !tenant.parked;
+                if (tenant.parked) {
+                    tenant.full_waits.store(tenant.full_waits.load(std::memory_order_relaxed) + 1,
+                                            std::memory_order_relaxed);
+                }
+                break;
+            }
+            tenant.pending.reset();
+            pushed++;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Ledger " << tenant.name << ": " << e.what()
+                  << " - ledger stopped" << std::endl;
+        tenant.failed = true;
+        tenant.read_failed.store(true, std::memory_order_relaxed);
+    }
+
+    if (read > 0) {
+        tenant.events_read.store(tenant.events_read.load(std::memory_order_relaxed) + read,
+                                 std::memory_order_relaxed);
+    }
+    if (pushed > 0) {
+        schedule(tenant);
+    }
+    return more;
+}
+
+void MultiLedgerProcessor::schedule(Tenant& tenant) {
+    // Pairs with the fence in runTurn(): either this sees scheduled == false,
+    // or the worker sees the events just pushed - never neither
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (tenant.scheduled.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        run_queue_.push_back(&tenant);
+    }
+    queue_cv_.notify_one();
+}
+
+void MultiLedgerProcessor::workerLoop() {
+    while (true) {
+        Tenant* tenant;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return !run_queue_.empty() || workers_stopping_; });
+            if (run_queue_.empty()) {
+                return;
+            }
+            tenant = run_queue_.front();
+            run_queue_.pop_front();
+        }
+        runTurn(*tenant);
+    }
+}
+
+void MultiLedgerProcessor::runTurn(Tenant& tenant) {
+    uint64_t processed = 0;
+    uint64_t failures = 0;
+    Event event;
+
+    while (processed < config_.quantum && tenant.ring->try_pop(event)) {
+        Verdict verdict = tenant.validator.processEvent(event);
+        if (verdict.code == VerdictCode::FAILED) {
+            failures++;
+        }
+        if (event.event_type == EventType::LEDGER_ENTRIES_GENERATED) {
+            tenant.balance_book.applyEvent(event);
+        }
+        processed++;
+    }
+
+    // Publish stats once per turn, not per event
+    tenant.events_processed.store(
+        tenant.events_processed.load(std::memory_order_relaxed) + processed, std::memory_order_relaxed);
+    tenant.validation_failures.store(
+        tenant.validation_failures.load(std::memory_order_relaxed) + failures, std::memory_order_relaxed);
+    tenant.turns.store(tenant.turns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    // Release the tenant, then re-check: events pushed meanwhile are either
+    // seen here or by the I/O thread's schedule()
+    tenant.scheduled.store(false, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!tenant.ring->empty()) {
+        schedule(tenant);  // Back of the queue: round-robin across tenants
+    }
+}
+
+std::vector<MultiLedgerProcessor::TenantStats> MultiLedgerProcessor::stats() const {
+    std::vector<TenantStats> result;
+    result.reserve(tenants_.size());
+    for (const auto& tenant : tenants_) {
+        TenantStats s;
+        s.name = tenant->name;
+        s.events_read = tenant->events_read.load(std::memory_order_relaxed);
+        s.events_processed = tenant->events_processed.load(std::memory_order_relaxed);
+        s.validation_failures = tenant->validation_failures.load(std::memory_order_relaxed);
+        s.turns = tenant->turns.load(std::memory_order_relaxed);
+        s.full_waits = tenant->full_waits.load(std::memory_order_relaxed);
+        s.backlog = tenant->ring->size();
+        s.failed = tenant->read_failed.load(std::memory_order_relaxed);
+        result.push_back(std::move(s));
+    }
+    return result;
+}
+
+void MultiLedgerProcessor::printSummary(std::ostream& out) const {
+    for (const auto& tenant : tenants_) {
+        out << "\n=== Ledger: " << tenant->name << " ===" << std::endl;
+        tenant->validator.printSummary(out);
+        if (tenant->balance_book.accountCount() > 0) {
+            tenant->balance_book.printSummary(out);
+        }
+    }
+}
+
+}  // namespace trading_ledger
@@ -0,0 +1,739 @@
+#include "Pipeline.h"
+#include "AccountBalanceBook.h"
+#include "DoubleEntryValidator.h"
+#include "EventLogReader.h"
+#include "EventLogTailer.h"
+#include "JsonFields.h"
+#include "NotifyingRingBuffer.h"
+#include "PositionBook.h"
+#include "RingBuffer.h"
+#include <pthread.h>
+#include <sched.h>
+#include <poll.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace trading_ledger {
+
+/**
+ * One SPSC edge ring: NotifyingRingBuffer when the reader sleeps on it,
+ * a plain RingBuffer otherwise (no fence per push)
+ */
+struct Pipeline::Ring {
+    std::unique_ptr<RingBuffer<Event, DYNAMIC_RING_SIZE>> plain;
+    std::unique_ptr<NotifyingRingBuffer<Event, DYNAMIC_RING_SIZE>> notifying;
+
+    Ring(size_t size, WaitStrategy wait) {
+        if (wait == WaitStrategy::NOTIFY) {
+            notifying = std::make_unique<NotifyingRingBuffer<Event, DYNAMIC_RING_SIZE>>(size);
+        } else {
+            plain = std::make_unique<RingBuffer<Event, DYNAMIC_RING_SIZE>>(size);
+        }
+    }
+
+    bool try_push(Event&& event) {
+        return notifying ? notifying->try_push(std::move(event)) : plain->try_push(std::move(event));
+    }
+    bool try_pop(Event& event) { return notifying ? notifying->try_pop(event) : plain->try_pop(event); }
+    bool empty() const { return notifying ? notifying->empty() : plain->empty(); }
+    size_t size() const { return notifying ? notifying->size() : plain->size(); }
+    size_t capacity() const { return notifying ? notifying->capacity() : plain->capacity(); }
+    void wake() {
+        if (notifying) {
+            notifying->wake();
+        }
+    }
+};
+
+/**
+ * Rings from every upstream worker to every downstream worker
+ */
+struct Pipeline::Edge {
+    Node* to = nullptr;
+    size_t to_workers = 1;
+    std::vector<std::unique_ptr<Ring>> rings;   // [from_worker * to_workers + to_worker]
+
+    Ring& ring(size_t from_worker, size_t to_worker) {
+        return *rings[from_worker * to_workers + to_worker];
+    }
+};
+
+struct Pipeline::Worker {
+    Node* node = nullptr;
+    size_t index = 0;
+    std::vector<Ring*> inputs;
+    std::thread thread;
+    size_t next_input = 0;        // Round-robin start
+
+    std::unique_ptr<DoubleEntryValidator> validator;
+    std::unique_ptr<AccountBalanceBook> balances;
+    std::unique_ptr<PositionBook> positions;
+    bool failed = false;
+
+    // Single writer: relaxed load + store, read by monitors
+    std::atomic<uint64_t> events{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> busy_ns{0};     // Elastic stages: time processing, emit() excluded
+
+    // Inside an emit to an elastic stage (seq_cst: Dekker pair with paused)
+    std::atomic<bool> emitting{false};
+
+    void count(std::atomic<uint64_t>& counter, uint64_t n = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * Elastic validate stage: per-shard state, ownership map and barrier
+ */
+struct Pipeline::Elastic {
+    std::vector<std::unique_ptr<DoubleEntryValidator>> validators;   // One per virtual shard
+
+    // Shard -> owning worker; written only while the stage is quiescent
+    std::array<size_t, VIRTUAL_SHARDS> owner{};
+    std::atomic<size_t> active{0};
+
+    // Barrier: paused gates upstream emits; park (set once upstream is
+    // quiet) makes active workers stop once their inputs are empty
+    std::atomic<bool> paused{false};
+    std::atomic<bool> park{false};
+    std::atomic<size_t> parked{0};
+    std::mutex mutex;
+    std::condition_variable resumed;
+
+    std::atomic<uint64_t> rebalances{0};
+    std::thread scaler;
+};
+
+struct Pipeline::Node {
+    const NodeConfig* config = nullptr;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<Node*> upstream;
+    std::vector<Edge*> outputs;
+    std::atomic<size_t> running_workers{0};
+    std::unique_ptr<Elastic> elastic;
+
+    mutable std::mutex error_mutex;
+    std::string error;
+};
+
+namespace {
+
+// Scaler thresholds (fractions of one worker's time)
+constexpr double SCALE_UP_UTILIZATION = 0.85;
+constexpr double SCALE_DOWN_UTILIZATION = 0.5;
+constexpr unsigned SCALE_COOLDOWN_INTERVALS = 5;   // Let measurements settle after a change
+
+size_t shardOf(const Event& event, NodeKind kind, size_t shards) {
+    if (shards == 1) {
+        return 0;
+    }
+    std::optional<std::string_view> key;
+    if (kind == NodeKind::VALIDATE) {
+        key = JsonFields::findString(event.payload, "trade_id");
+    } else if (kind == NodeKind::POSITIONS) {
+        key = JsonFields::findString(event.payload, "account_id");
+    } else {
+        return event.sequence_num % shards;
+    }
+    return key ? std::hash<std::string_view>{}(*key) % shards : 0;
+}
+
+void pinToCpu(const NodeConfig& node, size_t worker) {
+    if (node.cpus.empty()) {
+        return;
+    }
+    int cpu = node.cpus[worker % node.cpus.size()];
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        std::cerr << "Pipeline: cannot pin " << node.name << "[" << worker << "] to cpu " << cpu
+                  << " (" << std::strerror(rc) << "), running unpinned" << std::endl;
+    }
+}
+
+}  // namespace
+
+Pipeline::Pipeline(TopologyConfig config, std::string log_path)
+    : config_(std::move(config)), log_path_(std::move(log_path)) {
+    config_.validate();
+
+    for (const NodeConfig& node_config : config_.nodes) {
+        auto node = std::make_unique<Node>();
+        node->config = &node_config;
+        size_t workers = node_config.kind == NodeKind::SOURCE ? 1 : node_config.parallelism;
+        for (size_t i = 0; i < workers; ++i) {
+            auto worker = std::make_unique<Worker>();
+            worker->node = node.get();
+            worker->index = i;
+            node->workers.push_back(std::move(worker));
+        }
+        if (node_config.elastic()) {
+            node->elastic = std::make_unique<Elastic>();
+        }
+        nodes_.push_back(std::move(node));
+    }
+
+    auto byName = [this](const std::string& name) -> Node* {
+        for (auto& node : nodes_) {
+            if (node->config->name == name) {
+                return node.get();
+            }
+        }
+        return nullptr;
+    };
+
+    // One ring per (upstream worker, downstream worker) pair, sized and typed
+    // by the downstream stage (elastic stages: for every potential worker)
+    for (auto& node : nodes_) {
+        for (const std::string& input : node->config->inputs) {
+            Node* from = byName(input);
+            auto edge = std::make_unique<Edge>();
+            edge->to = node.get();
+            edge->to_workers = node->workers.size();
+            for (size_t f = 0; f < from->workers.size(); ++f) {
+                for (size_t t = 0; t < node->workers.size(); ++t) {
+                    edge->rings.push_back(std::make_unique<Ring>(node->config->ring_size, node->config->wait));
+                    node->workers[t]->inputs.push_back(edge->rings.back().get());
+                }
+            }
+            node->upstream.push_back(from);
+            from->outputs.push_back(edge.get());
+            edges_.push_back(std::move(edge));
+        }
+    }
+}
+
+Pipeline::~Pipeline() {
+    stop();
+    join();
+}
+
+void Pipeline::start() {
+    if (started_) {
+        throw std::runtime_error("Pipeline already started");
+    }
+    started_ = true;
+
+    // State first, so a failure leaves no thread behind
+    for (auto& node : nodes_) {
+        if (node->elastic) {
+            Elastic& elastic = *node->elastic;
+            for (size_t s = 0; s < VIRTUAL_SHARDS; ++s) {
+                elastic.validators.push_back(std::make_unique<DoubleEntryValidator>());
+                elastic.validators.back()->setLogging(false);
+            }
+            size_t active = node->config->min_parallelism;
+            for (size_t s = 0; s < VIRTUAL_SHARDS; ++s) {
+                elastic.owner[s] = s % active;
+            }
+            elastic.active.store(active, std::memory_order_relaxed);
+        }
+        for (auto& worker : node->workers) {
+            switch (node->config->kind) {
+                case NodeKind::VALIDATE:
+                    if (!node->elastic) {
+                        worker->validator = std::make_unique<DoubleEntryValidator>();
+                        worker->validator->setLogging(false);
+                    }
+                    break;
+                case NodeKind::BALANCES:
+                    worker->balances = std::make_unique<AccountBalanceBook>();
+                    break;
+                case NodeKind::POSITIONS:
+                    worker->positions = std::make_unique<PositionBook>();
+                    break;
+                case NodeKind::SOURCE:
+                case NodeKind::SINK:
+                    break;
+            }
+        }
+        node->running_workers.store(node->workers.size(), std::memory_order_relaxed);
+        live_workers_.fetch_add(node->workers.size(), std::memory_order_relaxed);
+    }
+
+    for (auto& node : nodes_) {
+        for (auto& worker : node->workers) {
+            Worker* w = worker.get();
+            if (node->config->kind == NodeKind::SOURCE) {
+                w->thread = std::thread([this, w] { runSource(*w); });
+            } else {
+                w->thread = std::thread([this, w] { runStage(*w); });
+            }
+        }
+        if (node->elastic) {
+            Node* n = node.get();
+            node->elastic->scaler = std::thread([this, n] { runScaler(*n); });
+        }
+    }
+}
+
+void Pipeline::stop() {
+    running_.store(false, std::memory_order_release);
+}
+
+void Pipeline::join() {
+    for (auto& node : nodes_) {
+        for (auto& worker : node->workers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+        if (node->elastic && node->elastic->scaler.joinable()) {
+            node->elastic->scaler.join();
+        }
+    }
+}
+
+bool Pipeline::finished() const {
+    return started_ && live_workers_.load(std::memory_order_acquire) == 0;
+}
+
+void Pipeline::runSource(Worker& worker) {
+    const NodeConfig& config = *worker.node->config;
+    pinToCpu(config, worker.index);
+    try {
+        std::string path = config.path.empty() ? log_path_ : config.path;
+        EventLogReader reader(path);
+        reader.open();
+        EventLogTailer tailer(path);
+        if (config.follow) {
+            tailer.init();
+        }
+
+        while (running_.load(std::memory_order_acquire)) {
+            Event event;
+            if (reader.readNext(event)) {
+                emit(worker, std::move(event));
+                worker.count(worker.events);
+            } else if (!config.follow) {
+                break;
+            } else if (!reader.remapIfGrown()) {
+                tailer.waitForModification(100);
+                reader.remapIfGrown();
+            }
+        }
+    } catch (const std::exception& e) {
+        std::lock_guard<std::mutex> lock(worker.node->error_mutex);
+        if (worker.node->error.empty()) {
+            worker.node->error = e.what();
+        }
+    }
+    workerExited(worker);
+}
+
+void Pipeline::runStage(Worker& worker) {
+    pinToCpu(*worker.node->config, worker.index);
+    Elastic* elastic = worker.node->elastic.get();
+    size_t idle_rounds = 0;
+    Event event;
+
+    for (;;) {
+        // Retired elastic worker: its inputs were drained at the barrier and
+        // nothing routes to it until it is active again
+        if (elastic != nullptr && worker.index >= elastic->active.load(std::memory_order_acquire)) {
+            if (upstreamDone(*worker.node)) {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(elastic->mutex);
+            elastic->resumed.wait_for(lock, std::chrono::milliseconds(100), [&] {
+                return worker.index < elastic->active.load(std::memory_order_acquire);
+            });
+            continue;
+        }
+
+        bool got = false;
+        size_t inputs = worker.inputs.size();
+        for (size_t i = 0; i < inputs && !got; ++i) {
+            got = worker.inputs[(worker.next_input + i) % inputs]->try_pop(event);
+        }
+        if (got) {
+            worker.next_input = (worker.next_input + 1) % inputs;
+            idle_rounds = 0;
+            process(worker, event);
+            continue;
+        }
+
+        if (elastic != nullptr && parkIfPaused(worker)) {
+            continue;
+        }
+
+        // Upstream gone (acquire) and inputs still empty: nothing can arrive
+        if (upstreamDone(*worker.node)) {
+            bool drained = std::all_of(worker.inputs.begin(), worker.inputs.end(),
+                                       [](const Ring* ring) { return ring->empty(); });
+            if (drained) {
+                break;
+            }
+            continue;
+        }
+        waitForInput(worker, idle_rounds++);
+    }
+    workerExited(worker);
+}
+
+void Pipeline::process(Worker& worker, Event& event) {
+    if (worker.failed) {
+        return;   // Keep draining so upstream never blocks
+    }
+    try {
+        // Elastic stages meter their own work only: time blocked in emit()
+        // on a slow downstream stage is not load that another worker relieves
+        bool metered = worker.node->elastic != nullptr;
+        std::chrono::steady_clock::time_point start;
+        if (metered) {
+            start = std::chrono::steady_clock::now();
+        }
+        switch (worker.node->config->kind) {
+            case NodeKind::VALIDATE: {
+                // Elastic: the shard's validator, owned by this worker until the next barrier
+                DoubleEntryValidator& validator =
+                    worker.node->elastic
+                        ? *worker.node->elastic->validators[shardOf(event, NodeKind::VALIDATE, VIRTUAL_SHARDS)]
+                        : *worker.validator;
+                if (validator.processEvent(event).code == VerdictCode::FAILED) {
+                    worker.count(worker.failures);
+                }
+                break;
+            }
+            case NodeKind::BALANCES:
+                worker.balances->applyEvent(event);
+                break;
+            case NodeKind::POSITIONS:
+                worker.positions->applyEvent(event);
+                break;
+            case NodeKind::SOURCE:
+            case NodeKind::SINK:
+                break;
+        }
+        if (metered) {
+            worker.count(worker.busy_ns, static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count()));
+        }
+        worker.count(worker.events);
+        emit(worker, std::move(event));
+    } catch (const std::exception& e) {
+        worker.failed = true;
+        {
+            std::lock_guard<std::mutex> lock(worker.node->error_mutex);
+            if (worker.node->error.empty()) {
+                worker.node->error = e.what();
+            }
+        }
+        stop();
+    }
+}
+
+void Pipeline::emit(Worker& worker, Event&& event) {
+    const std::vector<Edge*>& outputs = worker.node->outputs;
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        Edge& edge = *outputs[i];
+        Node& to = *edge.to;
+        size_t target;
+        if (to.elastic) {
+            enterElastic(worker, to);
+            target = to.elastic->owner[shardOf(event, to.config->kind, VIRTUAL_SHARDS)];
+        } else {
+            target = shardOf(event, to.config->kind, edge.to_workers);
+        }
+        Ring& ring = edge.ring(worker.index, target);
+
+        // Fan-out copies; the last edge takes the event itself
+        Event item = i + 1 < outputs.size() ? event : std::move(event);
+        while (!ring.try_push(std::move(item))) {
+            std::this_thread::yield();   // Downstream always drains until we exit
+        }
+        if (to.elastic) {
+            worker.emitting.store(false, std::memory_order_release);
+        }
+    }
+}
+
+void Pipeline::enterElastic(Worker& worker, Node& target) {
+    Elastic& elastic = *target.elastic;
+    for (;;) {
+        worker.emitting.store(true, std::memory_order_seq_cst);
+        if (!elastic.paused.load(std::memory_order_seq_cst)) {
+            return;   // The barrier waits for emitting to clear
+        }
+        worker.emitting.store(false, std::memory_order_release);
+        std::unique_lock<std::mutex> lock(elastic.mutex);
+        elastic.resumed.wait(lock, [&] { return !elastic.paused.load(std::memory_order_acquire); });
+    }
+}
+
+bool Pipeline::parkIfPaused(Worker& worker) {
+    Elastic& elastic = *worker.node->elastic;
+    if (!elastic.park.load(std::memory_order_acquire)) {
+        return false;
+    }
+    // Upstream is quiet, so empty inputs stay empty until the resume
+    bool drained = std::all_of(worker.inputs.begin(), worker.inputs.end(),
+                               [](const Ring* ring) { return ring->empty(); });
+    if (!drained) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(elastic.mutex);
+    elastic.parked.fetch_add(1, std::memory_order_release);   // Publishes this worker's shard state
+    elastic.resumed.wait(lock, [&] { return !elastic.park.load(std::memory_order_acquire); });
+    elastic.parked.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool Pipeline::rebalance(Node& node, size_t active) {
+    Elastic& elastic = *node.elastic;
+
+    // 1. Stop upstream emits into this stage
+    elastic.paused.store(true, std::memory_order_seq_cst);
+    for (const Node* upstream : node.upstream) {
+        for (const auto& worker : upstream->workers) {
+            while (worker->emitting.load(std::memory_order_seq_cst)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // 2. Active workers drain their inputs and park
+    elastic.park.store(true, std::memory_order_release);
+    for (const auto& worker : node.workers) {
+        for (Ring* ring : worker->inputs) {
+            ring->wake();
+        }
+    }
+    size_t current = elastic.active.load(std::memory_order_relaxed);
+    bool quiescent = true;
+    while (elastic.parked.load(std::memory_order_acquire) < current) {
+        // A worker exits instead of parking only once upstream is done
+        if (node.running_workers.load(std::memory_order_acquire) < node.workers.size()) {
+            quiescent = false;
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    // 3. Reassign shards, then resume (the mutex publishes the new map)
+    {
+        std::lock_guard<std::mutex> lock(elastic.mutex);
+        if (quiescent) {
+            for (size_t s = 0; s < VIRTUAL_SHARDS; ++s) {
+                elastic.owner[s] = s % active;
+            }
+            elastic.active.store(active, std::memory_order_release);
+            elastic.rebalances.fetch_add(1, std::memory_order_relaxed);
+        }
+        elastic.park.store(false, std::memory_order_release);
+        elastic.paused.store(false, std::memory_order_seq_cst);
+    }
+    elastic.resumed.notify_all();
+    return quiescent;
+}
+
+void Pipeline::runScaler(Node& node) {
+    Elastic& elastic = *node.elastic;
+    const NodeConfig& config = *node.config;
+    const double slo_ns = static_cast<double>(config.slo_us) * 1000.0;
+    const double interval_ns = SCALE_INTERVAL_MS * 1e6;
+    uint64_t last_busy = 0;
+    uint64_t last_events = 0;
+    unsigned cooldown = 0;
+
+    while (!upstreamDone(node)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(SCALE_INTERVAL_MS));
+
+        uint64_t busy = 0;
+        uint64_t events = 0;
+        size_t lag = 0;
+        for (const auto& worker : node.workers) {
+            busy += worker->busy_ns.load(std::memory_order_relaxed);
+            events += worker->events.load(std::memory_order_relaxed);
+            for (const Ring* ring : worker->inputs) {
+                lag += ring->size();
+            }
+        }
+        double busy_delta = static_cast<double>(busy - last_busy);
+        uint64_t events_delta = events - last_events;
+        last_busy = busy;
+        last_events = events;
+        if (cooldown > 0) {
+            cooldown--;
+            continue;
+        }
+
+        // Queueing delay of the backlog at the measured service time
+        size_t active = elastic.active.load(std::memory_order_relaxed);
+        double service_ns = events_delta > 0 ? busy_delta / static_cast<double>(events_delta) : 0.0;
+        double delay_ns = static_cast<double>(lag) * service_ns / static_cast<double>(active);
+        double utilization = busy_delta / (interval_ns * static_cast<double>(active));
+
+        size_t target = active;
+        if ((delay_ns > slo_ns || utilization > SCALE_UP_UTILIZATION) && active < config.parallelism) {
+            target = active + 1;
+        } else if (active > config.min_parallelism && delay_ns < slo_ns / 4 &&
+                   utilization * static_cast<double>(active) / static_cast<double>(active - 1) <
+                       SCALE_DOWN_UTILIZATION) {
+            target = active - 1;
+        }
+        if (target != active && rebalance(node, target)) {
+            cooldown = SCALE_COOLDOWN_INTERVALS;
+        }
+    }
+}
+
+bool Pipeline::upstreamDone(const Node& node) const {
+    return std::all_of(node.upstream.begin(), node.upstream.end(), [](const Node* upstream) {
+        return upstream->running_workers.load(std::memory_order_acquire) == 0;
+    });
+}
+
+void Pipeline::waitForInput(Worker& worker, size_t idle_rounds) {
+    switch (worker.node->config->wait) {
+        case WaitStrategy::SPIN:
+            break;
+        case WaitStrategy::YIELD:
+            std::this_thread::yield();
+            break;
+        case WaitStrategy::SLEEP:
+            std::this_thread::sleep_for(std::chrono::microseconds(1u << std::min<size_t>(idle_rounds, 10)));
+            break;
+        case WaitStrategy::NOTIFY: {
+            // Arm every input; sleep only if all are still empty
+            std::vector<pollfd> fds;
+            fds.reserve(worker.inputs.size());
+            bool sleep = true;
+            for (Ring* ring : worker.inputs) {
+                if (!ring->notifying->prepareWait()) {
+                    sleep = false;
+                    break;
+                }
+                fds.push_back({ring->notifying->fd(), POLLIN, 0});
+            }
+            if (sleep) {
+                // Timeout bounds shutdown latency if a wake-up is missed
+                poll(fds.data(), fds.size(), 100);
+            }
+            for (Ring* ring : worker.inputs) {
+                ring->notifying->finishWait();
+            }
+            break;
+        }
+    }
+}
+
+void Pipeline::workerExited(Worker& worker) {
+    Node& node = *worker.node;
+    node.running_workers.fetch_sub(1, std::memory_order_acq_rel);
+
+    // Rouse sleeping downstream workers so they notice the end of input
+    for (Edge* edge : node.outputs) {
+        for (size_t t = 0; t < edge->to_workers; ++t) {
+            edge->ring(worker.index, t).wake();
+        }
+    }
+    live_workers_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+std::vector<Pipeline::NodeStats> Pipeline::stats() const {
+    std::vector<NodeStats> result;
+    for (const auto& node : nodes_) {
+        NodeStats stats;
+        stats.name = node->config->name;
+        stats.kind = node->config->kind;
+        stats.workers = node->workers.size();
+        stats.active_workers = node->elastic ? node->elastic->active.load(std::memory_order_relaxed)
+                                             : node->workers.size();
+        stats.rebalances = node->elastic ? node->elastic->rebalances.load(std::memory_order_relaxed) : 0;
+        for (const auto& worker : node->workers) {
+            stats.events += worker->events.load(std::memory_order_relaxed);
+            stats.failures += worker->failures.load(std::memory_order_relaxed);
+            for (const Ring* ring : worker->inputs) {
+                stats.queued += ring->size();
+                stats.capacity += ring->capacity();
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(node->error_mutex);
+            stats.error = node->error;
+        }
+        result.push_back(std::move(stats));
+    }
+    return result;
+}
+
+void Pipeline::report(std::ostream& out) const {
+    out << "\n=== Pipeline ===" << std::endl;
+    for (const auto& node : nodes_) {
+        const NodeConfig& config = *node->config;
+        uint64_t events = 0;
+        for (const auto& worker : node->workers) {
+            events += worker->events.load(std::memory_order_relaxed);
+        }
+        out << config.name << " (" << nodeKindName(config.kind) << " x" << node->workers.size()
+            << "): " << events << " events" << std::endl;
+        std::string error;
+        {
+            std::lock_guard<std::mutex> lock(node->error_mutex);
+            error = node->error;
+        }
+        if (!error.empty()) {
+            out << "  error: " << error << std::endl;
+        }
+        if (node->elastic) {
+            out << "  elastic: " << node->elastic->active.load(std::memory_order_relaxed)
+                << " active (min " << config.min_parallelism << "), "
+                << node->elastic->rebalances.load(std::memory_order_relaxed) << " rebalances" << std::endl;
+        }
+
+        if (config.kind == NodeKind::VALIDATE) {
+            DoubleEntryValidator::Stats total;
+            auto add = [&total](const DoubleEntryValidator& validator) {
+                DoubleEntryValidator::Stats stats = validator.getStats();
+                total.trades_validated += stats.trades_validated;
+                total.validation_errors += stats.validation_errors;
+                total.duplicate_trades += stats.duplicate_trades;
+            };
+            if (node->elastic) {
+                for (const auto& validator : node->elastic->validators) {
+                    add(*validator);
+                }
+            } else {
+                for (const auto& worker : node->workers) {
+                    add(*worker->validator);
+                }
+            }
+            out << "  trades validated: " << total.trades_validated
+                << ", errors: " << total.validation_errors
+                << ", duplicates: " << total.duplicate_trades << std::endl;
+        } else if (config.kind == NodeKind::BALANCES) {
+            // One book per worker (validate() allows one today; an event spans accounts)
+            for (const auto& worker : node->workers) {
+                AccountBalanceBook& book = *worker->balances;
+                if (book.accountCount() == 0) {
+                    continue;
+                }
+                if (node->workers.size() > 1) {
+                    out << "  worker " << worker->index << ":" << std::endl;
+                }
+                book.checkInvariant();
+                book.printSummary(out);
+            }
+        } else if (config.kind == NodeKind::POSITIONS) {
+            size_t positions = 0;
+            for (const auto& worker : node->workers) {
+                positions += worker->positions->size();
+            }
+            out << "  positions: " << positions << std::endl;
+        }
+    }
+}
+
+}  // namespace trading_ledger
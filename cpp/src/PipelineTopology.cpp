@@ -0,0 +1,292 @@
+#include "PipelineTopology.h"
+#include "CommandLine.h"
+#include <sched.h>
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace trading_ledger {
+
+namespace {
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream in(text);
+    for (std::string item; std::getline(in, item, ',');) {
+        if (item.empty()) {
+            throw std::invalid_argument("empty item in list '" + text + "'");
+        }
+        items.push_back(item);
+    }
+    return items;
+}
+
+WaitStrategy parseWait(const std::string& text) {
+    if (text == "spin") return WaitStrategy::SPIN;
+    if (text == "yield") return WaitStrategy::YIELD;
+    if (text == "sleep") return WaitStrategy::SLEEP;
+    if (text == "notify") return WaitStrategy::NOTIFY;
+    throw std::invalid_argument("unknown wait strategy '" + text + "' (spin, yield, sleep, notify)");
+}
+
+NodeKind parseKind(const std::string& text) {
+    if (text == "validate") return NodeKind::VALIDATE;
+    if (text == "balances") return NodeKind::BALANCES;
+    if (text == "positions") return NodeKind::POSITIONS;
+    if (text == "sink") return NodeKind::SINK;
+    throw std::invalid_argument("unknown stage kind '" + text + "' (validate, balances, positions, sink)");
+}
+
+std::string lowercase(const char* text) {
+    std::string result(text);
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return result;
+}
+
+}  // namespace
+
+const char* waitStrategyName(WaitStrategy wait) {
+    switch (wait) {
+        case WaitStrategy::SPIN: return "SPIN";
+        case WaitStrategy::YIELD: return "YIELD";
+        case WaitStrategy::SLEEP: return "SLEEP";
+        case WaitStrategy::NOTIFY: return "NOTIFY";
+    }
+    return "UNKNOWN";
+}
+
+const char* nodeKindName(NodeKind kind) {
+    switch (kind) {
+        case NodeKind::SOURCE: return "SOURCE";
+        case NodeKind::VALIDATE: return "VALIDATE";
+        case NodeKind::BALANCES: return "BALANCES";
+        case NodeKind::POSITIONS: return "POSITIONS";
+        case NodeKind::SINK: return "SINK";
+    }
+    return "UNKNOWN";
+}
+
+TopologyConfig TopologyConfig::parse(std::istream& in) {
+    TopologyConfig config;
+    int line_number = 0;
+    for (std::string line; std::getline(in, line);) {
+        line_number++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream words(line);
+        std::string directive;
+        if (!(words >> directive)) {
+            continue;
+        }
+
+        try {
+            if (directive == "monitor") {
+                for (std::string option; words >> option;) {
+                    if (option.rfind("interval=", 0) != 0) {
+                        throw std::invalid_argument("unknown monitor option '" + option + "'");
+                    }
+                    config.monitor_interval_seconds =
+                        CommandLine::parse<unsigned>("interval", option.substr(9));
+                }
+                continue;
+            }
+            if (directive != "source" && directive != "stage") {
+                throw std::invalid_argument("unknown directive '" + directive +
+                                            "' (source, stage, monitor)");
+            }
+
+            NodeConfig node;
+            if (!(words >> node.name) || node.name.find('=') != std::string::npos) {
+                throw std::invalid_argument(directive + " needs a name");
+            }
+            bool is_source = directive == "source";
+            bool has_kind = false;
+            if (is_source) {
+                node.kind = NodeKind::SOURCE;
+            }
+
+            for (std::string option; words >> option;) {
+                size_t eq = option.find('=');
+                if (eq == std::string::npos) {
+                    throw std::invalid_argument("expected key=value, got '" + option + "'");
+                }
+                std::string key = option.substr(0, eq);
+                std::string value = option.substr(eq + 1);
+                if (key == "cpu") {
+                    for (const std::string& cpu : splitList(value)) {
+                        node.cpus.push_back(CommandLine::parse<int>(key, cpu, 0, CPU_SETSIZE - 1));
+                    }
+                } else if (is_source && key == "path") {
+                    node.path = value;
+                } else if (is_source && key == "follow") {
+                    if (value != "yes" && value != "no") {
+                        throw std::invalid_argument("follow must be yes or no");
+                    }
+                    node.follow = value == "yes";
+                } else if (!is_source && key == "kind") {
+                    node.kind = parseKind(value);
+                    has_kind = true;
+                } else if (!is_source && key == "input") {
+                    node.inputs = splitList(value);
+                } else if (!is_source && key == "parallelism") {
+                    node.parallelism = CommandLine::parse<size_t>(key, value);
+                } else if (!is_source && key == "min") {
+                    node.min_parallelism = CommandLine::parse<size_t>(key, value);
+                } else if (!is_source && key == "slo") {
+                    node.slo_us = CommandLine::parse<uint64_t>(key, value);
+                } else if (!is_source && key == "ring") {
+                    node.ring_size = CommandLine::parse<size_t>(key, value);
+                } else if (!is_source && key == "wait") {
+                    node.wait = parseWait(value);
+                } else {
+                    throw std::invalid_argument("unknown " + directive + " option '" + key + "'");
+                }
+            }
+            if (!is_source && !has_kind) {
+                throw std::invalid_argument("stage " + node.name + " needs kind=");
+            }
+
+            // Checked here so the error carries the line number
+            if (config.find(node.name) != nullptr) {
+                throw std::invalid_argument("duplicate node name '" + node.name + "'");
+            }
+            for (const std::string& input : node.inputs) {
+                if (config.find(input) == nullptr) {
+                    throw std::invalid_argument("input '" + input + "' of " + node.name +
+                                                " is not declared above it");
+                }
+            }
+            config.nodes.push_back(std::move(node));
+        } catch (const std::invalid_argument& e) {
+            throw std::invalid_argument("line " + std::to_string(line_number) + ": " + e.what());
+        }
+    }
+    config.validate();
+    return config;
+}
+
+TopologyConfig TopologyConfig::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Failed to open topology file: " + path);
+    }
+    return parse(file);
+}
+
+TopologyConfig TopologyConfig::defaultTopology() {
+    std::istringstream text(
+        "source events\n"
+        "stage validate kind=validate input=events ring=4096 wait=notify\n"
+        "stage balances kind=balances input=validate ring=4096 wait=notify\n");
+    return parse(text);
+}
+
+void TopologyConfig::validate() const {
+    size_t sources = 0;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const NodeConfig& node = nodes[i];
+        if (node.kind == NodeKind::SOURCE) {
+            sources++;
+            if (!node.inputs.empty()) {
+                throw std::invalid_argument("source " + node.name + " cannot have inputs");
+            }
+            continue;
+        }
+        if (node.inputs.empty()) {
+            throw std::invalid_argument("stage " + node.name + " needs input=");
+        }
+        for (const std::string& input : node.inputs) {
+            auto upstream = std::find_if(nodes.begin(), nodes.begin() + static_cast<long>(i),
+                                         [&](const NodeConfig& n) { return n.name == input; });
+            if (upstream == nodes.begin() + static_cast<long>(i)) {
+                throw std::invalid_argument("input '" + input + "' of " + node.name +
+                                            " is not declared above it");
+            }
+        }
+        if (node.parallelism == 0 || node.parallelism > 64) {
+            throw std::invalid_argument("stage " + node.name + ": parallelism must be 1..64");
+        }
+        if (node.min_parallelism > node.parallelism) {
+            throw std::invalid_argument("stage " + node.name + ": min must not exceed parallelism");
+        }
+        if (node.elastic() && node.kind != NodeKind::VALIDATE) {
+            throw std::invalid_argument("stage " + node.name + ": only validate stages can be elastic");
+        }
+        if (node.elastic() && node.slo_us == 0) {
+            throw std::invalid_argument("stage " + node.name + ": slo must be positive");
+        }
+        if (node.kind == NodeKind::BALANCES && node.parallelism != 1) {
+            throw std::invalid_argument("stage " + node.name +
+                                        ": balances cannot be sharded (an event spans accounts)");
+        }
+        if (node.ring_size < 2 || (node.ring_size & (node.ring_size - 1)) != 0 ||
+            node.ring_size > (size_t{1} << 24)) {
+            throw std::invalid_argument("stage " + node.name + ": ring must be a power of 2 in [2, 2^24]");
+        }
+    }
+    if (sources == 0) {
+        throw std::invalid_argument("topology needs a source");
+    }
+    for (const NodeConfig& node : nodes) {
+        if (std::count_if(nodes.begin(), nodes.end(),
+                          [&](const NodeConfig& n) { return n.name == node.name; }) != 1) {
+            throw std::invalid_argument("duplicate node name '" + node.name + "'");
+        }
+    }
+}
+
+const NodeConfig* TopologyConfig::find(const std::string& name) const {
+    for (const NodeConfig& node : nodes) {
+        if (node.name == name) {
+            return &node;
+        }
+    }
+    return nullptr;
+}
+
+void TopologyConfig::write(std::ostream& out) const {
+    auto cpuList = [](const std::vector<int>& cpus) {
+        std::string text;
+        for (int cpu : cpus) {
+            if (!text.empty()) {
+                text.push_back(',');
+            }
+            text.append(std::to_string(cpu));
+        }
+        return text;
+    };
+    for (const NodeConfig& node : nodes) {
+        if (node.kind == NodeKind::SOURCE) {
+            out << "source " << node.name;
+            if (!node.path.empty()) {
+                out << " path=" << node.path;
+            }
+            if (!node.follow) {
+                out << " follow=no";
+            }
+        } else {
+            std::string inputs;
+            for (const std::string& input : node.inputs) {
+                if (!inputs.empty()) {
+                    inputs.push_back(',');
+                }
+                inputs.append(input);
+            }
+            out << "stage " << node.name << " kind=" << lowercase(nodeKindName(node.kind))
+                << " input=" << inputs << " parallelism=" << node.parallelism
+                << " ring=" << node.ring_size << " wait=" << lowercase(waitStrategyName(node.wait));
+            if (node.elastic()) {
+                out << " min=" << node.min_parallelism << " slo=" << node.slo_us;
+            }
+        }
+        if (!node.cpus.empty()) {
+            out << " cpu=" << cpuList(node.cpus);
+        }
+        out << "\n";
+    }
+    out << "monitor interval=" << monitor_interval_seconds << "\n";
+}
+
+}  // namespace trading_ledger
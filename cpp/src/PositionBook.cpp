@@ -0,0 +1,56 @@
+#include "PositionBook.h"
+#include "DecodedTrade.h"
+
+namespace trading_ledger {
+
+bool PositionBook::applyEvent(const EventView& event) {
+    if (event.event_type != EventType::TRADE_CREATED) {
+        return false;
+    }
+    DecodedTrade trade;
+    if (!DecodedTrade::decode(event.payload, trade) || trade.direction == 0) {
+        malformed_trades_++;
+        return false;
+    }
+
+    auto& entry = *positions_.try_emplace(key(accounts_.getOrAssign(trade.account_id),
+                                              symbols_.getOrAssign(trade.symbol))).first;
+    Position& position = entry.second.position;
+    if (trade.direction > 0) {
+        position.buy_quantity += trade.quantity;
+        position.net_quantity += trade.quantity;
+    } else {
+        position.sell_quantity += trade.quantity;
+        position.net_quantity -= trade.quantity;
+    }
+    position.trade_count++;
+
+    if (track_dirty_ && !entry.second.dirty) {
+        entry.second.dirty = true;
+        dirty_.push_back(&entry);
+    }
+    return true;
+}
+
+void PositionBook::restore(std::string_view account, std::string_view symbol, const Position& position) {
+    positions_[key(accounts_.getOrAssign(account), symbols_.getOrAssign(symbol))].position = position;
+}
+
+void PositionBook::clearDirty() {
+    for (auto* entry : dirty_) {
+        entry->second.dirty = false;
+    }
+    dirty_.clear();
+}
+
+const PositionBook::Position* PositionBook::find(std::string_view account, std::string_view symbol) const {
+    uint32_t account_id = accounts_.find(account);
+    uint32_t symbol_id = symbols_.find(symbol);
+    if (account_id == DenseIdMap::INVALID_ID || symbol_id == DenseIdMap::INVALID_ID) {
+        return nullptr;
+    }
+    auto it = positions_.find(key(account_id, symbol_id));
+    return it != positions_.end() ? &it->second.position : nullptr;
+}
+
+}  // namespace trading_ledger
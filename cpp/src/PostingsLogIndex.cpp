@@ -0,0 +1,458 @@
+#include "PostingsLogIndex.h"
+#include "ByteOrder.h"
+#include "EventParser.h"
+#include "JsonFields.h"
+#include "LedgerEntryDecoder.h"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace trading_ledger {
+
+namespace {
+
+constexpr size_t HEADER_SIZE = 48;
+constexpr size_t BLOCK_HEADER_SIZE = 17;
+constexpr size_t LANE_VALUES = PostingsLogIndex::BLOCK / PostingsLogIndex::LANES;
+
+size_t blockWords(uint8_t width) {
+    return width == PostingsLogIndex::UNPACKED ? 2 * PostingsLogIndex::BLOCK
+                                               : PostingsLogIndex::LANES * width;
+}
+
+// Delta i goes to lane i % LANES; each lane is its own bit stream, and word
+// w of lane j is stored at w * LANES + j
+void packDeltas(const uint64_t* deltas, uint8_t width, uint32_t* out) {
+    if (width == PostingsLogIndex::UNPACKED) {
+        for (size_t i = 0; i < PostingsLogIndex::BLOCK; ++i) {
+            out[2 * i] = static_cast<uint32_t>(deltas[i]);
+            out[2 * i + 1] = static_cast<uint32_t>(deltas[i] >> 32);
+        }
+        return;
+    }
+    for (size_t k = 0; k < LANE_VALUES; ++k) {
+        size_t bit = k * width;
+        uint32_t* lo = out + (bit / 32) * PostingsLogIndex::LANES;
+        size_t shift = bit % 32;
+        for (size_t j = 0; j < PostingsLogIndex::LANES; ++j) {
+            auto value = static_cast<uint32_t>(deltas[k * PostingsLogIndex::LANES + j]);
+            lo[j] |= value << shift;
+            if (shift + width > 32) {
+                lo[j + PostingsLogIndex::LANES] |= value >> (32 - shift);
+            }
+        }
+    }
+}
+
+void unpackDeltas(const uint32_t* in, uint8_t width, uint32_t* deltas) {
+    uint32_t mask = width >= 32 ? UINT32_MAX : (1u << width) - 1;
+    for (size_t k = 0; k < LANE_VALUES; ++k) {
+        size_t bit = k * width;
+        const uint32_t* lo = in + (bit / 32) * PostingsLogIndex::LANES;
+        size_t shift = bit % 32;
+        uint32_t* out = deltas + k * PostingsLogIndex::LANES;
+        // Same operation on LANES adjacent words: one vector op per line
+        if (shift + width > 32) {
+            for (size_t j = 0; j < PostingsLogIndex::LANES; ++j) {
+                out[j] = ((lo[j] >> shift) | (lo[j + PostingsLogIndex::LANES] << (32 - shift))) & mask;
+            }
+        } else {
+            for (size_t j = 0; j < PostingsLogIndex::LANES; ++j) {
+                out[j] = (lo[j] >> shift) & mask;
+            }
+        }
+    }
+}
+
+// Bounds-checked little-endian reads over a loaded file
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    bool has(size_t bytes) const { return size_ - pos_ >= bytes; }
+    const uint8_t* take(size_t bytes) {
+        const uint8_t* p = data_ + pos_;
+        pos_ += bytes;
+        return p;
+    }
+    uint64_t u64() { return EventParser::readUint64LE(take(8)); }
+    uint32_t u32() { return EventParser::readUint32LE(take(4)); }
+    uint16_t u16() { return EventParser::readUint16LE(take(2)); }
+    uint8_t u8() { return *take(1); }
+    size_t position() const { return pos_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+}  // namespace
+
+/**
+ * Walks one posting list in order, unpacking a block only when it is
+ * entered; seek() skips blocks whose last offset is below the target
+ */
+class PostingsLogIndex::Cursor {
+public:
+    explicit Cursor(const PostingList& list) : list_(list) { load(0); }
+
+    bool done() const { return pos_ >= size_; }
+    uint64_t value() const { return values_[pos_]; }
+
+    void next() {
+        if (++pos_ == size_ && block_ < list_.blocks.size()) {
+            load(block_ + 1);
+        }
+    }
+
+    // Move to the first offset >= target
+    void seek(uint64_t target) {
+        if (done() || value() >= target) {
+            return;
+        }
+        const std::vector<Block>& blocks = list_.blocks;
+        if (block_ < blocks.size() && blocks[block_].last < target) {
+            auto it = std::lower_bound(blocks.begin() + static_cast<std::ptrdiff_t>(block_) + 1,
+                                       blocks.end(), target,
+                                       [](const Block& b, uint64_t value) { return b.last < value; });
+            load(static_cast<size_t>(it - blocks.begin()));
+        }
+        pos_ = static_cast<size_t>(std::lower_bound(values_ + pos_, values_ + size_, target) - values_);
+    }
+
+private:
+    void load(size_t block) {
+        block_ = block;
+        pos_ = 0;
+        if (block < list_.blocks.size()) {
+            list_.unpack(block, buffer_);
+            values_ = buffer_;
+            size_ = BLOCK;
+        } else {
+            values_ = list_.tail.data();
+            size_ = list_.tail.size();
+        }
+    }
+
+    const PostingList& list_;
+    size_t block_ = 0;
+    const uint64_t* values_ = nullptr;
+    size_t size_ = 0;
+    size_t pos_ = 0;
+    uint64_t buffer_[BLOCK];
+};
+
+void PostingsLogIndex::PostingList::add(uint64_t offset) {
+    tail.push_back(offset);
+    count++;
+    if (tail.size() == BLOCK) {
+        seal();
+    }
+}
+
+void PostingsLogIndex::PostingList::seal() {
+    uint64_t deltas[BLOCK];
+    uint64_t widest = 0;
+    deltas[0] = 0;   // The skip header holds the first offset
+    for (size_t i = 1; i < BLOCK; ++i) {
+        deltas[i] = tail[i] - tail[i - 1];
+        widest = std::max(widest, deltas[i]);
+    }
+    uint8_t width = widest > UINT32_MAX ? UNPACKED : static_cast<uint8_t>(std::bit_width(widest));
+
+    blocks.push_back({tail.front(), tail.back(), words.size(), width});
+    words.resize(words.size() + blockWords(width), 0);
+    packDeltas(deltas, width, words.data() + blocks.back().word_offset);
+    tail.clear();
+}
+
+void PostingsLogIndex::PostingList::unpack(size_t block, uint64_t* out) const {
+    const Block& b = blocks[block];
+    const uint32_t* in = words.data() + b.word_offset;
+    if (b.width == UNPACKED) {
+        out[0] = b.first;
+        for (size_t i = 1; i < BLOCK; ++i) {
+            out[i] = out[i - 1] + (in[2 * i] | static_cast<uint64_t>(in[2 * i + 1]) << 32);
+        }
+        return;
+    }
+    uint32_t deltas[BLOCK] = {};
+    if (b.width > 0) {
+        unpackDeltas(in, b.width, deltas);
+    }
+    out[0] = b.first;
+    for (size_t i = 1; i < BLOCK; ++i) {
+        out[i] = out[i - 1] + deltas[i];
+    }
+}
+
+PostingsLogIndex::PostingsLogIndex() : scanned_offset_(FileHeader::SIZE) {}
+
+size_t PostingsLogIndex::extend(const uint8_t* data, size_t size) {
+    size_t indexed = 0;
+    size_t offset = scanned_offset_;
+    while (offset + 28 <= size) {
+        uint32_t length = EventParser::readUint32LE(data + offset + 20);
+        if (offset + 28 + length > size) {
+            break;  // Trailing frame still being written
+        }
+        EventView event{EventParser::readUint64LE(data + offset),
+                        EventParser::readUint64LE(data + offset + 8),
+                        static_cast<EventType>(data[offset + 16]),
+                        std::string_view(reinterpret_cast<const char*>(data + offset + 24), length),
+                        0};
+        add(event, offset);
+        indexed++;
+        offset += event.totalSize();
+    }
+    return indexed;
+}
+
+bool PostingsLogIndex::add(const EventView& event, uint64_t offset) {
+    if (offset < scanned_offset_) {
+        return false;
+    }
+    if (event.event_type == EventType::TRADE_CREATED) {
+        if (auto account = JsonFields::findString(event.payload, "account_id")) {
+            post(Field::ACCOUNT, *account, offset);
+        }
+        if (auto symbol = JsonFields::findString(event.payload, "symbol")) {
+            post(Field::SYMBOL, *symbol, offset);
+        }
+    } else if (event.event_type == EventType::LEDGER_ENTRIES_GENERATED) {
+        LedgerEntryDecoder::forEachEntry(event.payload, [&](const LedgerEntryRecord& entry) {
+            post(Field::ACCOUNT, entry.account_id, offset);
+        });
+    }
+    scanned_offset_ = offset + event.totalSize();
+    frames_scanned_++;
+    last_offset_ = offset;
+    last_sequence_ = event.sequence_num;
+    return true;
+}
+
+void PostingsLogIndex::post(Field field, std::string_view name, uint64_t offset) {
+    DenseIdMap& ids = field == Field::ACCOUNT ? accounts_ : symbols_;
+    std::vector<PostingList>& lists = field == Field::ACCOUNT ? account_lists_ : symbol_lists_;
+    uint32_t id = ids.getOrAssign(name);
+    if (id == lists.size()) {
+        lists.emplace_back();
+    }
+    PostingList& list = lists[id];
+    uint64_t last = !list.tail.empty() ? list.tail.back()
+                                       : (list.blocks.empty() ? 0 : list.blocks.back().last);
+    if (list.count > 0 && last == offset) {
+        return;   // Both sides of a transfer in one account
+    }
+    list.add(offset);
+    posting_count_++;
+}
+
+const PostingsLogIndex::PostingList* PostingsLogIndex::find(Field field, std::string_view name) const {
+    uint32_t id = names(field).find(name);
+    if (id == DenseIdMap::INVALID_ID) {
+        return nullptr;
+    }
+    return field == Field::ACCOUNT ? &account_lists_[id] : &symbol_lists_[id];
+}
+
+std::vector<uint64_t> PostingsLogIndex::postings(Field field, std::string_view name) const {
+    std::vector<uint64_t> out;
+    const PostingList* list = find(field, name);
+    if (list == nullptr) {
+        return out;
+    }
+    out.resize(list->count);
+    for (size_t b = 0; b < list->blocks.size(); ++b) {
+        list->unpack(b, out.data() + b * BLOCK);
+    }
+    std::copy(list->tail.begin(), list->tail.end(), out.begin() + static_cast<std::ptrdiff_t>(list->blocks.size() * BLOCK));
+    return out;
+}
+
+std::vector<uint64_t> PostingsLogIndex::intersect(std::string_view account, std::string_view symbol) const {
+    std::vector<uint64_t> out;
+    const PostingList* a = find(Field::ACCOUNT, account);
+    const PostingList* b = find(Field::SYMBOL, symbol);
+    if (a == nullptr || b == nullptr) {
+        return out;
+    }
+    // The shorter list leads; the other only unpacks blocks it lands in
+    Cursor lead(a->count <= b->count ? *a : *b);
+    Cursor other(a->count <= b->count ? *b : *a);
+    while (!lead.done()) {
+        uint64_t offset = lead.value();
+        other.seek(offset);
+        if (other.done()) {
+            break;
+        }
+        if (other.value() == offset) {
+            out.push_back(offset);
+            lead.next();
+        } else {
+            lead.seek(other.value());
+        }
+    }
+    return out;
+}
+
+size_t PostingsLogIndex::compressedBytes() const {
+    size_t bytes = 0;
+    for (const auto* lists : {&account_lists_, &symbol_lists_}) {
+        for (const PostingList& list : *lists) {
+            bytes += list.blocks.size() * BLOCK_HEADER_SIZE + list.words.size() * 4 + list.tail.size() * 8;
+        }
+    }
+    return bytes;
+}
+
+void PostingsLogIndex::clear() {
+    accounts_ = DenseIdMap();
+    symbols_ = DenseIdMap();
+    account_lists_.clear();
+    symbol_lists_.clear();
+    posting_count_ = 0;
+    scanned_offset_ = FileHeader::SIZE;
+    frames_scanned_ = 0;
+    last_offset_ = 0;
+    last_sequence_ = 0;
+}
+
+void PostingsLogIndex::save(const std::string& path) const {
+    std::vector<uint8_t> out;
+    out.reserve(HEADER_SIZE + compressedBytes() + 4);
+    appendUint32LE(out, MAGIC);
+    appendUint32LE(out, VERSION);
+    appendUint64LE(out, scanned_offset_);
+    appendUint64LE(out, frames_scanned_);
+    appendUint64LE(out, last_offset_);
+    appendUint64LE(out, last_sequence_);
+    appendUint32LE(out, static_cast<uint32_t>(accounts_.size()));
+    appendUint32LE(out, static_cast<uint32_t>(symbols_.size()));
+    for (Field field : {Field::ACCOUNT, Field::SYMBOL}) {
+        const DenseIdMap& ids = names(field);
+        const std::vector<PostingList>& lists = field == Field::ACCOUNT ? account_lists_ : symbol_lists_;
+        for (uint32_t id = 0; id < ids.size(); ++id) {
+            const std::string& name = ids.name(id);
+            const PostingList& list = lists[id];
+            out.push_back(static_cast<uint8_t>(name.size() & 0xFF));
+            out.push_back(static_cast<uint8_t>((name.size() >> 8) & 0xFF));
+            out.insert(out.end(), name.begin(), name.end());
+            appendUint32LE(out, static_cast<uint32_t>(list.count));
+            for (const Block& block : list.blocks) {
+                appendUint64LE(out, block.first);
+                appendUint64LE(out, block.last);
+                out.push_back(block.width);
+                for (size_t w = 0; w < blockWords(block.width); ++w) {
+                    appendUint32LE(out, list.words[block.word_offset + w]);
+                }
+            }
+            for (uint64_t offset : list.tail) {
+                appendUint64LE(out, offset);
+            }
+        }
+    }
+    appendUint32LE(out, EventParser::calculateCRC32(out.data(), out.size()));
+
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+        if (!file) {
+            throw std::runtime_error("Failed to write postings index: " + temp_path);
+        }
+    }
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Failed to rename postings index to " + path +
+                                 " (error: " + std::string(strerror(errno)) + ")");
+    }
+}
+
+bool PostingsLogIndex::load(const std::string& path) {
+    clear();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < HEADER_SIZE + 4 ||
+        EventParser::readUint32LE(data.data()) != MAGIC ||
+        EventParser::readUint32LE(data.data() + 4) != VERSION ||
+        EventParser::readUint32LE(data.data() + data.size() - 4) !=
+            EventParser::calculateCRC32(data.data(), data.size() - 4)) {
+        return false;
+    }
+
+    Reader in(data.data(), data.size() - 4);
+    in.take(8);
+    uint64_t scanned_offset = in.u64();
+    uint64_t frames_scanned = in.u64();
+    uint64_t last_offset = in.u64();
+    uint64_t last_sequence = in.u64();
+    uint32_t counts[2] = {in.u32(), in.u32()};
+
+    for (Field field : {Field::ACCOUNT, Field::SYMBOL}) {
+        DenseIdMap& ids = field == Field::ACCOUNT ? accounts_ : symbols_;
+        std::vector<PostingList>& lists = field == Field::ACCOUNT ? account_lists_ : symbol_lists_;
+        for (uint32_t n = 0; n < counts[static_cast<size_t>(field)]; ++n) {
+            if (!in.has(2)) {
+                clear();
+                return false;
+            }
+            uint16_t length = in.u16();
+            if (!in.has(length + 4u)) {
+                clear();
+                return false;
+            }
+            std::string_view name(reinterpret_cast<const char*>(in.take(length)), length);
+            if (ids.getOrAssign(name) != lists.size()) {
+                clear();
+                return false;   // Duplicate name
+            }
+            PostingList& list = lists.emplace_back();
+            list.count = in.u32();
+            for (size_t b = 0; b < list.count / BLOCK; ++b) {
+                if (!in.has(BLOCK_HEADER_SIZE)) {
+                    clear();
+                    return false;
+                }
+                Block block{in.u64(), in.u64(), list.words.size(), in.u8()};
+                if ((block.width > 32 && block.width != UNPACKED) || !in.has(blockWords(block.width) * 4)) {
+                    clear();
+                    return false;
+                }
+                list.blocks.push_back(block);
+                for (size_t w = 0; w < blockWords(block.width); ++w) {
+                    list.words.push_back(in.u32());
+                }
+            }
+            size_t tail = list.count % BLOCK;
+            if (!in.has(tail * 8)) {
+                clear();
+                return false;
+            }
+            for (size_t i = 0; i < tail; ++i) {
+                list.tail.push_back(in.u64());
+            }
+            posting_count_ += list.count;
+        }
+    }
+    if (in.position() != data.size() - 4) {
+        clear();
+        return false;
+    }
+    scanned_offset_ = scanned_offset;
+    frames_scanned_ = frames_scanned;
+    last_offset_ = last_offset;
+    last_sequence_ = last_sequence;
+    return true;
+}
+
+}  // namespace trading_ledger
@@ -0,0 +1,117 @@
+#include "ProgressWatermark.h"
+#include "ByteOrder.h"
+#include "EventParser.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace trading_ledger {
+
+ProgressWatermark::ProgressWatermark(std::string path) : path_(std::move(path)) {}
+
+ProgressWatermark::~ProgressWatermark() {
+    close();
+}
+
+void ProgressWatermark::open() {
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open watermark: " + path_ +
+                                 " (error: " + std::string(strerror(errno)) + ")");
+    }
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+        close();
+        throw std::runtime_error("Failed to stat watermark: " + path_);
+    }
+    bool reopened = static_cast<size_t>(st.st_size) == FILE_SIZE;
+    if (!reopened && ftruncate(fd_, static_cast<off_t>(FILE_SIZE)) != 0) {
+        close();
+        throw std::runtime_error("Failed to size watermark: " + path_ +
+                                 " (error: " + std::string(strerror(errno)) + ")");
+    }
+
+    void* mapped = mmap(nullptr, FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapped == MAP_FAILED) {
+        close();
+        throw std::runtime_error("Failed to mmap watermark: " + path_);
+    }
+    mapped_ = static_cast<uint8_t*>(mapped);
+    line_ = reinterpret_cast<Line*>(mapped_ + LINE);
+
+    // A file of another kind (or size) starts from zero progress
+    if (!reopened || EventParser::readUint32LE(mapped_) != MAGIC ||
+        EventParser::readUint32LE(mapped_ + 4) != VERSION) {
+        std::memset(mapped_, 0, FILE_SIZE);
+    }
+    uint64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    writeUint32LE(mapped_ + 8, static_cast<uint32_t>(getpid()));
+    writeUint64LE(mapped_ + 16, now);
+    writeUint32LE(mapped_ + 4, VERSION);
+    writeUint32LE(mapped_, MAGIC);
+}
+
+void ProgressWatermark::close() {
+    if (mapped_ != nullptr) {
+        munmap(mapped_, FILE_SIZE);
+        mapped_ = nullptr;
+        line_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+WatermarkReader::WatermarkReader(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open watermark: " + path +
+                                 " (error: " + std::string(strerror(errno)) + ")");
+    }
+    struct stat st;
+    void* mapped = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == ProgressWatermark::FILE_SIZE) {
+        mapped = mmap(nullptr, ProgressWatermark::FILE_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);   // The mapping keeps the file
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Not a watermark file: " + path);
+    }
+    mapped_ = static_cast<const uint8_t*>(mapped);
+    if (EventParser::readUint32LE(mapped_) != ProgressWatermark::MAGIC ||
+        EventParser::readUint32LE(mapped_ + 4) != ProgressWatermark::VERSION) {
+        munmap(const_cast<uint8_t*>(mapped_), ProgressWatermark::FILE_SIZE);
+        throw std::runtime_error("Not a watermark file: " + path);
+    }
+    line_ = reinterpret_cast<const ProgressWatermark::Line*>(mapped_ + ProgressWatermark::LINE);
+}
+
+WatermarkReader::~WatermarkReader() {
+    munmap(const_cast<uint8_t*>(mapped_), ProgressWatermark::FILE_SIZE);
+}
+
+WatermarkProgress WatermarkReader::read() const {
+    WatermarkProgress progress;
+    progress.sequence = line_->sequence.load(std::memory_order_acquire);
+    progress.offset = line_->offset.load(std::memory_order_relaxed);
+    progress.event_timestamp_ns = line_->event_timestamp_ns.load(std::memory_order_relaxed);
+    progress.published_ns = line_->published_ns.load(std::memory_order_relaxed);
+    return progress;
+}
+
+uint32_t WatermarkReader::pid() const {
+    return EventParser::readUint32LE(mapped_ + 8);
+}
+
+uint64_t WatermarkReader::startedNs() const {
+    return EventParser::readUint64LE(mapped_ + 16);
+}
+
+}  // namespace trading_ledger
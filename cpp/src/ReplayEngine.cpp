@@ -0,0 +1,202 @@
+#include "ReplayEngine.h"
+#include "Elapsed.h"
+#include "EventParser.h"
+#include "FixedPoint.h"
+#include "MappedLog.h"
+#include "NotifyingRingBuffer.h"
+#include <chrono>
+#include <exception>
+#include <sstream>
+#include <thread>
+
+namespace trading_ledger {
+
+namespace {
+
+// Batches in flight per consumer before the scan waits
+constexpr size_t CONSUMER_RING_SIZE = 64;
+
+using BatchPtr = std::shared_ptr<const ReplayBatch>;
+using BatchRing = NotifyingRingBuffer<BatchPtr, CONSUMER_RING_SIZE>;
+
+// Frame without CRC verification (Config::verify_crc = false)
+EventView viewUnchecked(const uint8_t* data, size_t payload_length) {
+    EventView event;
+    event.sequence_num = EventParser::readUint64LE(data);
+    event.timestamp_ns = EventParser::readUint64LE(data + 8);
+    event.event_type = static_cast<EventType>(data[16]);
+    event.payload = std::string_view(reinterpret_cast<const char*>(data + 24), payload_length);
+    event.crc32 = EventParser::readUint32LE(data + 24 + payload_length);
+    return event;
+}
+
+// Consumer thread: drain its ring until the end-of-stream marker (nullptr)
+void consumeBatches(ReplayConsumer& consumer, BatchRing& ring,
+                    ReplayEngine::ConsumerStats& stats) {
+    BatchPtr batch;
+    while (true) {
+        if (!ring.try_pop(batch)) {
+            ring.wait(-1);
+            continue;
+        }
+        if (!batch) {
+            return;
+        }
+        if (!stats.error.empty()) {
+            continue;  // Failed earlier: discard so the scan never blocks on us
+        }
+        auto start = std::chrono::steady_clock::now();
+        try {
+            consumer.onBatch(*batch);
+        } catch (const std::exception& e) {
+            stats.error = e.what();
+        } catch (...) {
+            stats.error = "unknown exception";
+        }
+        stats.busy_seconds += secondsSince(start);
+        stats.batches++;
+    }
+}
+
+}  // namespace
+
+ValidatorReplayConsumer::ValidatorReplayConsumer(std::string name,
+                                                 DoubleEntryValidator::Config config)
+    : ReplayConsumer(std::move(name)), validator_(config) {
+    validator_.setLogging(false);
+}
+
+void ValidatorReplayConsumer::onBatch(const ReplayBatch& batch) {
+    for (const EventView& event : batch) {
+        Verdict verdict = validator_.processEvent(event);
+        verdicts_[static_cast<size_t>(verdict.code)]++;
+        rules_[static_cast<size_t>(verdict.rule)]++;
+    }
+}
+
+void ValidatorReplayConsumer::report(std::ostream& out) const {
+    const DoubleEntryValidator::Config& config = validator_.config();
+    out << "[" << name() << "] validator"
+        << " max_quantity=" << (config.max_quantity ? FixedPoint::format(config.max_quantity) : "off")
+        << " max_notional=" << (config.max_notional ? FixedPoint::format(config.max_notional) : "off")
+        << " duplicates=" << (config.detect_duplicates ? "on" : "off") << "\n";
+    out << "  Passed:  " << verdictCount(VerdictCode::PASSED) << "\n";
+    out << "  Failed:  " << verdictCount(VerdictCode::FAILED) << "\n";
+    out << "  Skipped: " << verdictCount(VerdictCode::SKIPPED) << "\n";
+    for (size_t rule = 1; rule < rules_.size(); ++rule) {
+        if (rules_[rule] > 0) {
+            out << "    " << validationRuleName(static_cast<ValidationRule>(rule))
+                << ": " << rules_[rule] << "\n";
+        }
+    }
+}
+
+BalanceBookReplayConsumer::BalanceBookReplayConsumer(std::string name,
+                                                     size_t invariant_check_interval)
+    : ReplayConsumer(std::move(name)), book_(invariant_check_interval) {}
+
+void BalanceBookReplayConsumer::onBatch(const ReplayBatch& batch) {
+    for (const EventView& event : batch) {
+        book_.applyEvent(event);
+    }
+}
+
+void BalanceBookReplayConsumer::report(std::ostream& out) const {
+    AccountBalanceBook::Stats stats = book_.getStats();
+    out << "[" << name() << "] balance book\n"
+        << "  Events applied:  " << stats.events_applied << "\n"
+        << "  Accounts:        " << book_.accountCount() << "\n"
+        << "  Total debits:    " << FixedPoint::format(book_.totalDebits()) << "\n"
+        << "  Total credits:   " << FixedPoint::format(book_.totalCredits()) << "\n"
+        << "  Malformed:       " << stats.malformed_events << "\n";
+}
+
+ReplayEngine::ReplayEngine(Config config) : config_(config) {
+    if (config_.batch_size == 0) {
+        config_.batch_size = DEFAULT_BATCH_SIZE;
+    }
+}
+
+void ReplayEngine::addConsumer(std::unique_ptr<ReplayConsumer> consumer) {
+    consumers_.push_back(std::move(consumer));
+}
+
+ReplayEngine::Stats ReplayEngine::run(const std::string& log_path) {
+    auto run_start = std::chrono::steady_clock::now();
+    Stats stats;
+    MappedLog log(log_path);
+    log.willNeed();
+
+    const size_t count = consumers_.size();
+    std::vector<std::unique_ptr<BatchRing>> rings;
+    stats.consumers.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        rings.push_back(std::make_unique<BatchRing>());
+        stats.consumers[i].name = consumers_[i]->name();
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < count; ++i) {
+        threads.emplace_back(consumeBatches, std::ref(*consumers_[i]),
+                             std::ref(*rings[i]), std::ref(stats.consumers[i]));
+    }
+
+    auto broadcast = [&](const BatchPtr& batch) {
+        for (auto& ring : rings) {
+            while (!ring->try_push(batch)) {
+                ring->waitForSpace(-1);  // Slowest consumer is a full ring behind
+            }
+        }
+    };
+
+    std::exception_ptr scan_error;
+    try {
+        const uint8_t* data = log.data();
+        size_t offset = FileHeader::SIZE;
+        double scan_seconds = 0;
+        while (offset < log.size()) {
+            auto start = std::chrono::steady_clock::now();
+            auto batch = std::make_shared<ReplayBatch>();
+            batch->reserve(config_.batch_size);
+            while (batch->size() < config_.batch_size && offset < log.size()) {
+                size_t payload_length = offset + 28 <= log.size()
+                                            ? EventParser::readUint32LE(data + offset + 20)
+                                            : 0;
+                if (offset + 28 + payload_length > log.size()) {
+                    std::ostringstream oss;
+                    oss << "frame at offset " << offset << " needs " << 28 + payload_length
+                        << " bytes, " << log.size() - offset << " left";
+                    throw TruncatedLogException(oss.str());
+                }
+                batch->push_back(config_.verify_crc
+                                     ? EventParser::parseView(data + offset, log.size() - offset)
+                                     : viewUnchecked(data + offset, payload_length));
+                offset += 28 + payload_length;
+            }
+            scan_seconds += secondsSince(start);
+            if (batch->empty()) {
+                break;
+            }
+            stats.events += batch->size();
+            stats.batches++;
+            broadcast(std::move(batch));
+        }
+        stats.scan_seconds = scan_seconds;
+    } catch (...) {
+        scan_error = std::current_exception();
+    }
+
+    // End of stream; the mapping must outlive every consumer
+    broadcast(nullptr);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (scan_error) {
+        std::rethrow_exception(scan_error);
+    }
+
+    stats.total_seconds = secondsSince(run_start);
+    return stats;
+}
+
+}  // namespace trading_ledger
@@ -0,0 +1,277 @@
+#include "SettlementNetting.h"
+#include "Elapsed.h"
+#include "EventParser.h"
+#include "FixedPoint.h"
+#include "JsonFields.h"
+#include "MappedLog.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace trading_ledger {
+
+namespace {
+
+// Position key: account (32 bits) | symbol (24 bits) | currency (8 bits)
+constexpr uint32_t MAX_SYMBOLS = 1u << 24;
+constexpr uint32_t MAX_CURRENCIES = 1u << 8;
+
+uint64_t packKey(uint32_t account, uint32_t symbol, uint32_t currency) {
+    return (static_cast<uint64_t>(account) << 32) |
+           (static_cast<uint64_t>(symbol) << 8) | currency;
+}
+
+}  // namespace
+
+SettlementNetting::SettlementNetting(Config config) : config_(std::move(config)) {
+    if (config_.thread_count == 0) {
+        config_.thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (config_.batch_size == 0) {
+        config_.batch_size = DEFAULT_BATCH_SIZE;
+    }
+}
+
+std::vector<SettlementObligation> SettlementNetting::run(const std::string& log_path) {
+    stats_ = Stats{};
+    MappedLog log(log_path);
+    const uint8_t* data = log.data();
+    log.willNeed();
+
+    // Phase 1: header hop
+    auto start = std::chrono::steady_clock::now();
+    std::vector<size_t> frame_offsets;
+    size_t offset = FileHeader::SIZE;
+    while (offset < log.size()) {
+        size_t total = offset + 28 <= log.size()
+                           ? 28 + static_cast<size_t>(EventParser::readUint32LE(data + offset + 20))
+                           : 28;
+        if (offset + total > log.size()) {
+            std::ostringstream oss;
+            oss << "frame at offset " << offset << " needs " << total << " bytes, "
+                << log.size() - offset << " left";
+            if (!config_.allow_truncated_tail) {
+                throw TruncatedLogException(oss.str());
+            }
+            stats_.truncated_bytes = log.size() - offset;
+            stats_.truncated_offset = offset;
+            break;
+        }
+        frame_offsets.push_back(offset);
+        offset += total;
+    }
+    stats_.events_scanned = frame_offsets.size();
+    stats_.hop_seconds = secondsSince(start);
+
+    // Phase 2: decode + net, one contiguous range per thread
+    start = std::chrono::steady_clock::now();
+    size_t thread_count = std::min(config_.thread_count,
+                                   std::max<size_t>(1, frame_offsets.size() / config_.batch_size));
+    std::vector<Partial> partials(thread_count);
+    std::vector<std::exception_ptr> errors(thread_count);
+    std::vector<std::thread> threads;
+    size_t per_thread = (frame_offsets.size() + thread_count - 1) / thread_count;
+
+    for (size_t t = 0; t < thread_count; ++t) {
+        size_t begin = std::min(frame_offsets.size(), t * per_thread);
+        size_t end = std::min(frame_offsets.size(), begin + per_thread);
+        threads.emplace_back([&, t, begin, end] {
+            try {
+                netRange(data, frame_offsets, begin, end, partials[t]);
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    stats_.threads = thread_count;
+    stats_.net_seconds = secondsSince(start);
+
+    // Phase 3: merge partials by name
+    start = std::chrono::steady_clock::now();
+    DenseIdMap accounts;
+    DenseIdMap symbols;
+    DenseIdMap currencies;
+    std::unordered_map<uint64_t, NetPosition> merged;
+
+    for (const Partial& partial : partials) {
+        stats_.trades_netted += partial.trades_netted;
+        stats_.trades_skipped += partial.trades_skipped;
+
+        // Local -> global id translation, built once per partial
+        std::vector<uint32_t> account_ids(partial.accounts.size());
+        for (uint32_t id = 0; id < account_ids.size(); ++id) {
+            account_ids[id] = accounts.getOrAssign(partial.accounts.name(id));
+        }
+        std::vector<uint32_t> symbol_ids(partial.symbols.size());
+        for (uint32_t id = 0; id < symbol_ids.size(); ++id) {
+            symbol_ids[id] = symbols.getOrAssign(partial.symbols.name(id));
+        }
+        std::vector<uint32_t> currency_ids(partial.currencies.size());
+        for (uint32_t id = 0; id < currency_ids.size(); ++id) {
+            currency_ids[id] = currencies.getOrAssign(partial.currencies.name(id));
+        }
+
+        for (const auto& [key, position] : partial.positions) {
+            uint64_t global = packKey(account_ids[key >> 32],
+                                      symbol_ids[(key >> 8) & (MAX_SYMBOLS - 1)],
+                                      currency_ids[key & (MAX_CURRENCIES - 1)]);
+            merged[global].merge(position);
+        }
+    }
+
+    std::vector<SettlementObligation> obligations;
+    obligations.reserve(merged.size());
+    for (const auto& [key, position] : merged) {
+        SettlementObligation obligation;
+        obligation.account_id = accounts.name(static_cast<uint32_t>(key >> 32));
+        obligation.symbol = symbols.name(static_cast<uint32_t>((key >> 8) & (MAX_SYMBOLS - 1)));
+        obligation.currency = currencies.name(static_cast<uint32_t>(key & (MAX_CURRENCIES - 1)));
+        obligation.position = position;
+        obligations.push_back(std::move(obligation));
+    }
+    std::sort(obligations.begin(), obligations.end(),
+              [](const SettlementObligation& a, const SettlementObligation& b) {
+                  if (a.account_id != b.account_id) return a.account_id < b.account_id;
+                  if (a.symbol != b.symbol) return a.symbol < b.symbol;
+                  return a.currency < b.currency;
+              });
+    stats_.positions = obligations.size();
+    stats_.merge_seconds = secondsSince(start);
+
+    return obligations;
+}
+
+void SettlementNetting::netRange(const uint8_t* data, const std::vector<size_t>& offsets,
+                                 size_t begin, size_t end, Partial& partial) const {
+    TradeColumns columns;
+    columns.account.reserve(config_.batch_size);
+    columns.symbol.reserve(config_.batch_size);
+    columns.currency.reserve(config_.batch_size);
+    columns.quantity.reserve(config_.batch_size);
+    columns.price.reserve(config_.batch_size);
+
+    for (size_t i = begin; i < end; ++i) {
+        const uint8_t* frame = data + offsets[i];
+        uint32_t payload_length = EventParser::readUint32LE(frame + 20);
+
+        if (config_.verify_crc) {
+            uint32_t stored = EventParser::readUint32LE(frame + 24 + payload_length);
+            uint32_t calculated = EventParser::calculateCRC32(frame, 24 + payload_length);
+            if (stored != calculated) {
+                std::ostringstream oss;
+                oss << "sequence " << EventParser::readUint64LE(frame) << " at offset " << offsets[i];
+                throw CorruptedEventException(oss.str());
+            }
+        }
+        if (static_cast<EventType>(frame[16]) != EventType::TRADE_CREATED) {
+            continue;
+        }
+
+        std::string_view payload(reinterpret_cast<const char*>(frame + 24), payload_length);
+        auto account = JsonFields::findString(payload, "account_id");
+        auto symbol = JsonFields::findString(payload, "symbol");
+        auto side = JsonFields::findString(payload, "side");
+        auto quantity_text = JsonFields::findNumber(payload, "quantity");
+        auto price_text = JsonFields::findNumber(payload, "price");
+        auto currency = JsonFields::findString(payload, "currency");
+
+        int64_t quantity = 0;
+        int64_t price = 0;
+        if (!account || !symbol || !side || !quantity_text || !price_text ||
+            (*side != "BUY" && *side != "SELL") ||
+            !FixedPoint::parse(*quantity_text, quantity) || !FixedPoint::parse(*price_text, price)) {
+            partial.trades_skipped++;
+            continue;
+        }
+
+        uint32_t symbol_id = partial.symbols.getOrAssign(*symbol);
+        uint32_t currency_id = partial.currencies.getOrAssign(
+            currency ? *currency : std::string_view(config_.default_currency));
+        if (symbol_id >= MAX_SYMBOLS || currency_id >= MAX_CURRENCIES) {
+            throw std::runtime_error("Settlement netting: too many distinct symbols or currencies");
+        }
+
+        columns.account.push_back(partial.accounts.getOrAssign(*account));
+        columns.symbol.push_back(symbol_id);
+        columns.currency.push_back(currency_id);
+        columns.quantity.push_back(*side == "BUY" ? quantity : -quantity);
+        columns.price.push_back(price);
+
+        if (columns.size() == config_.batch_size) {
+            aggregate(columns, partial);
+            columns.clear();
+        }
+    }
+    aggregate(columns, partial);
+}
+
+void SettlementNetting::aggregate(const TradeColumns& columns, Partial& partial) {
+    const size_t n = columns.size();
+    for (size_t i = 0; i < n; ++i) {
+        NetPosition& position =
+            partial.positions[packKey(columns.account[i], columns.symbol[i], columns.currency[i])];
+
+        int64_t quantity = columns.quantity[i];
+        // Notional at 1e-8 scale: (qty * price) / SCALE, widened to avoid overflow
+        WideAmount notional = static_cast<WideAmount>(quantity) * columns.price[i] / FixedPoint::SCALE;
+
+        position.net_quantity += quantity;
+        position.net_cash -= notional;  // Buyer pays, seller receives
+        if (quantity >= 0) {
+            position.buy_quantity += quantity;
+        } else {
+            position.sell_quantity -= quantity;
+        }
+        position.trade_count++;
+    }
+    partial.trades_netted += n;
+}
+
+void SettlementNetting::writeCsv(const std::vector<SettlementObligation>& obligations, std::ostream& out) {
+    out << "account_id,symbol,currency,net_quantity,net_cash,buy_quantity,sell_quantity,trade_count\n";
+    for (const auto& o : obligations) {
+        out << o.account_id << ',' << o.symbol << ',' << o.currency << ','
+            << FixedPoint::format(o.position.net_quantity) << ','
+            << formatAmount(o.position.net_cash) << ','
+            << FixedPoint::format(o.position.buy_quantity) << ','
+            << FixedPoint::format(o.position.sell_quantity) << ','
+            << o.position.trade_count << '\n';
+    }
+}
+
+void SettlementNetting::writeFile(const std::vector<SettlementObligation>& obligations,
+                                  const std::string& path) {
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Failed to open settlement file: " + temp_path);
+        }
+        writeCsv(obligations, out);
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Failed to write settlement file: " + temp_path);
+        }
+    }
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Failed to rename settlement file to " + path +
+                                 " (error: " + std::string(strerror(errno)) + ")");
+    }
+}
+
+}  // namespace trading_ledger
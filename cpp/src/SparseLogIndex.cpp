@@ -0,0 +1,140 @@
+#include "SparseLogIndex.h"
+#include "ByteOrder.h"
+#include "Event.h"
+#include "EventParser.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace trading_ledger {
+
+namespace {
+
+constexpr size_t HEADER_SIZE = 32;
+
+}  // namespace
+
+SparseLogIndex::SparseLogIndex(size_t stride)
+    : stride_(stride == 0 ? DEFAULT_STRIDE : stride), scanned_offset_(FileHeader::SIZE) {}
+
+size_t SparseLogIndex::extend(const uint8_t* data, size_t size) {
+    size_t added = 0;
+    size_t offset = scanned_offset_;
+    while (offset + 28 <= size) {
+        size_t total = 28 + static_cast<size_t>(EventParser::readUint32LE(data + offset + 20));
+        if (offset + total > size) {
+            break;  // Trailing frame still being written
+        }
+        if (frames_scanned_ % stride_ == 0) {
+            entries_.push_back({EventParser::readUint64LE(data + offset),
+                                EventParser::readUint64LE(data + offset + 8), offset});
+            added++;
+        }
+        frames_scanned_++;
+        offset += total;
+    }
+    scanned_offset_ = offset;
+    return added;
+}
+
+const IndexEntry* SparseLogIndex::floorBySequence(uint64_t sequence) const {
+    auto it = std::upper_bound(entries_.begin(), entries_.end(), sequence,
+                               [](uint64_t value, const IndexEntry& e) { return value < e.sequence; });
+    return it == entries_.begin() ? nullptr : &*std::prev(it);
+}
+
+const IndexEntry* SparseLogIndex::floorByTimestamp(uint64_t timestamp_ns) const {
+    auto it = std::upper_bound(entries_.begin(), entries_.end(), timestamp_ns,
+                               [](uint64_t value, const IndexEntry& e) { return value < e.timestamp_ns; });
+    return it == entries_.begin() ? nullptr : &*std::prev(it);
+}
+
+uint64_t SparseLogIndex::locate(const uint8_t* data, size_t size, uint64_t sequence) const {
+    const IndexEntry* floor = floorBySequence(sequence);
+    if (floor == nullptr) {
+        return 0;
+    }
+    size_t offset = floor->offset;
+    size_t end = std::min<size_t>(size, scanned_offset_);
+    while (offset + 28 <= end) {
+        uint64_t current = EventParser::readUint64LE(data + offset);
+        if (current == sequence) {
+            return offset;
+        }
+        if (current > sequence) {
+            return 0;  // Gap in the sequence
+        }
+        offset += 28 + static_cast<size_t>(EventParser::readUint32LE(data + offset + 20));
+    }
+    return 0;
+}
+
+void SparseLogIndex::save(const std::string& path) const {
+    std::vector<uint8_t> out;
+    out.reserve(HEADER_SIZE + entries_.size() * IndexEntry::SIZE + 4);
+    appendUint32LE(out, MAGIC);
+    appendUint32LE(out, VERSION);
+    appendUint32LE(out, static_cast<uint32_t>(stride_));
+    appendUint32LE(out, static_cast<uint32_t>(entries_.size()));
+    appendUint64LE(out, scanned_offset_);
+    appendUint64LE(out, frames_scanned_);
+    for (const IndexEntry& entry : entries_) {
+        appendUint64LE(out, entry.sequence);
+        appendUint64LE(out, entry.timestamp_ns);
+        appendUint64LE(out, entry.offset);
+    }
+    appendUint32LE(out, EventParser::calculateCRC32(out.data(), out.size()));
+
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+        if (!file) {
+            throw std::runtime_error("Failed to write index: " + temp_path);
+        }
+    }
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Failed to rename index to " + path +
+                                 " (error: " + std::string(strerror(errno)) + ")");
+    }
+}
+
+bool SparseLogIndex::load(const std::string& path) {
+    entries_.clear();
+    scanned_offset_ = FileHeader::SIZE;
+    frames_scanned_ = 0;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < HEADER_SIZE + 4 ||
+        EventParser::readUint32LE(data.data()) != MAGIC ||
+        EventParser::readUint32LE(data.data() + 4) != VERSION ||
+        EventParser::readUint32LE(data.data() + 8) != stride_) {
+        return false;
+    }
+    size_t count = EventParser::readUint32LE(data.data() + 12);
+    if (data.size() != HEADER_SIZE + count * IndexEntry::SIZE + 4 ||
+        EventParser::readUint32LE(data.data() + data.size() - 4) !=
+            EventParser::calculateCRC32(data.data(), data.size() - 4)) {
+        return false;
+    }
+
+    entries_.reserve(count);
+    const uint8_t* p = data.data() + HEADER_SIZE;
+    for (size_t i = 0; i < count; ++i, p += IndexEntry::SIZE) {
+        entries_.push_back({EventParser::readUint64LE(p), EventParser::readUint64LE(p + 8),
+                            EventParser::readUint64LE(p + 16)});
+    }
+    scanned_offset_ = EventParser::readUint64LE(data.data() + 16);
+    frames_scanned_ = EventParser::readUint64LE(data.data() + 24);
+    return true;
+}
+
+}  // namespace trading_ledger
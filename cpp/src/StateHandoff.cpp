@@ -0,0 +1,368 @@
+#include "StateHandoff.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace trading_ledger {
+
+namespace {
+
+constexpr char REQUEST[] = "TAKEOVER\n";
+constexpr size_t REQUEST_LENGTH = sizeof(REQUEST) - 1;
+constexpr char ACK[] = "OK\n";
+constexpr size_t ACK_LENGTH = sizeof(ACK) - 1;
+constexpr char CONFIRM[] = "GO\n";
+constexpr size_t CONFIRM_LENGTH = sizeof(CONFIRM) - 1;
+
+sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("Handoff socket path too long: " + path);
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return addr;
+}
+
+std::string errorText() {
+    return " (error: " + std::string(strerror(errno)) + ")";
+}
+
+// Wait until fd is readable; false on timeout
+bool waitReadable(int fd, std::chrono::milliseconds timeout) {
+    pollfd pfd{fd, POLLIN, 0};
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        int rc = poll(&pfd, 1, static_cast<int>(std::max<int64_t>(0, left.count())));
+        if (rc > 0) {
+            return true;
+        }
+        if (rc == 0 || errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+// Read exactly `length` bytes and compare them with `expected`; false on
+// timeout, EOF or a mismatch
+bool readToken(int fd, const char* expected, size_t length, std::chrono::milliseconds timeout) {
+    char token[16];
+    size_t got = 0;
+    while (got < length && waitReadable(fd, timeout)) {
+        ssize_t n = read(fd, token + got, length - got);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        got += static_cast<size_t>(n);
+    }
+    return got == length && std::memcmp(token, expected, length) == 0;
+}
+
+bool writeAll(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = ::send(fd, bytes, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        bytes += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+}  // namespace
+
+StateHandoffServer::StateHandoffServer(std::string socket_path, std::function<void()> on_request)
+    : socket_path_(std::move(socket_path)), on_request_(std::move(on_request)) {}
+
+StateHandoffServer::~StateHandoffServer() {
+    stop();
+}
+
+void StateHandoffServer::start() {
+    sockaddr_un addr = socketAddress(socket_path_);
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error("Failed to create handoff socket" + errorText());
+    }
+    // Stale socket from a previous run, or the predecessor's we took over from
+    ::unlink(socket_path_.c_str());
+    struct stat st;
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd_, 1) != 0 || ::stat(socket_path_.c_str(), &st) != 0) {
+        std::string error = errorText();
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        throw std::runtime_error("Failed to bind handoff socket: " + socket_path_ + error);
+    }
+    socket_inode_ = st.st_ino;
+
+    stop_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (stop_fd_ < 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        throw std::runtime_error("Failed to create eventfd" + errorText());
+    }
+    thread_ = std::thread(&StateHandoffServer::run, this);
+}
+
+void StateHandoffServer::stop() {
+    if (thread_.joinable()) {
+        uint64_t one = 1;
+        while (write(stop_fd_, &one, sizeof(one)) < 0 && errno == EINTR) {}
+        thread_.join();
+    }
+    if (client_fd_ >= 0) {
+        ::close(client_fd_);   // Unserved successor sees EOF
+        client_fd_ = -1;
+    }
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        struct stat st;
+        if (::stat(socket_path_.c_str(), &st) == 0 && st.st_ino == socket_inode_) {
+            ::unlink(socket_path_.c_str());
+        }
+    }
+    if (stop_fd_ >= 0) {
+        ::close(stop_fd_);
+        stop_fd_ = -1;
+    }
+}
+
+void StateHandoffServer::run() {
+    while (true) {
+        pollfd fds[2] = {{stop_fd_, POLLIN, 0}, {listen_fd_, POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        if (fds[0].revents != 0) {
+            return;
+        }
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+
+        // A client that connects and says nothing cannot hold the listener
+        if (!readToken(fd, REQUEST, REQUEST_LENGTH, std::chrono::seconds(1))) {
+            ::close(fd);
+            continue;
+        }
+
+        client_fd_ = fd;
+        requested_.store(true, std::memory_order_release);
+        if (on_request_) {
+            on_request_();
+        }
+        return;
+    }
+}
+
+void StateHandoffServer::send(const HandoffState& state, const std::vector<uint8_t>& image,
+                              std::chrono::milliseconds ack_timeout) {
+    if (!requested()) {
+        throw std::runtime_error("No successor waiting on " + socket_path_);
+    }
+    if (state.log_fd < 0) {
+        throw std::runtime_error("Event log position unavailable for handoff");
+    }
+
+    // Sealed, so the successor maps an image nobody can change under it
+    int state_fd = memfd_create("trading-ledger-state", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (state_fd < 0) {
+        throw std::runtime_error("Failed to create state memfd" + errorText());
+    }
+    struct FdGuard {
+        int fd;
+        ~FdGuard() { ::close(fd); }
+    } guard{state_fd};
+    for (size_t done = 0; done < image.size();) {
+        ssize_t n = ::write(state_fd, image.data() + done, image.size() - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            throw std::runtime_error("Failed to write state memfd" + errorText());
+        }
+        done += static_cast<size_t>(n);
+    }
+    if (fcntl(state_fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0) {
+        throw std::runtime_error("Failed to seal state memfd" + errorText());
+    }
+
+    HandoffHeader header;
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.sequence = state.sequence;
+    header.log_offset = state.log_offset;
+    header.state_bytes = image.size();
+    header.paused_ns = state.paused_ns;
+
+    int fds[2] = {state.log_fd, state_fd};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))] = {};
+    iovec iov{&header, sizeof(header)};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    std::memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    ssize_t sent;
+    while ((sent = sendmsg(client_fd_, &msg, MSG_NOSIGNAL)) < 0 && errno == EINTR) {}
+    if (sent != static_cast<ssize_t>(sizeof(header))) {
+        throw std::runtime_error("Failed to send state to successor on " + socket_path_ + errorText());
+    }
+
+    if (!readToken(client_fd_, ACK, ACK_LENGTH, ack_timeout)) {
+        throw std::runtime_error("Successor did not acknowledge the state on " + socket_path_);
+    }
+    // Past this point the successor owns the log
+    if (!writeAll(client_fd_, CONFIRM, CONFIRM_LENGTH)) {
+        throw std::runtime_error("Failed to confirm the handoff on " + socket_path_ + errorText());
+    }
+}
+
+void StateHandoffServer::rearm() {
+    if (thread_.joinable()) {
+        thread_.join();   // Returned after accepting the request
+    }
+    if (client_fd_ >= 0) {
+        ::close(client_fd_);
+        client_fd_ = -1;
+    }
+    requested_.store(false, std::memory_order_release);
+    if (listen_fd_ >= 0) {
+        thread_ = std::thread(&StateHandoffServer::run, this);
+    }
+}
+
+StateTakeover::StateTakeover(const std::string& socket_path, std::chrono::milliseconds timeout) {
+    sockaddr_un addr = socketAddress(socket_path);
+    socket_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (socket_fd_ < 0) {
+        throw std::runtime_error("Failed to create handoff socket" + errorText());
+    }
+    try {
+        if (connect(socket_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            throw std::runtime_error("Failed to connect to " + socket_path + errorText());
+        }
+        if (!writeAll(socket_fd_, REQUEST, REQUEST_LENGTH)) {
+            throw std::runtime_error("Failed to request takeover on " + socket_path + errorText());
+        }
+        // The predecessor drains its pipeline before it answers
+        if (!waitReadable(socket_fd_, timeout)) {
+            throw std::runtime_error("No state from " + socket_path + " within " +
+                                     std::to_string(timeout.count()) + " ms");
+        }
+
+        alignas(cmsghdr) char control[CMSG_SPACE(2 * sizeof(int))] = {};
+        iovec iov{&header_, sizeof(header_)};
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        ssize_t got;
+        while ((got = recvmsg(socket_fd_, &msg, MSG_CMSG_CLOEXEC)) < 0 && errno == EINTR) {}
+
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        if (cmsg != nullptr && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+            cmsg->cmsg_len == CMSG_LEN(2 * sizeof(int))) {
+            int fds[2];
+            std::memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+            log_fd_ = fds[0];
+            state_fd_ = fds[1];
+        }
+        if (got != static_cast<ssize_t>(sizeof(header_)) || log_fd_ < 0 || state_fd_ < 0 ||
+            (msg.msg_flags & MSG_CTRUNC) != 0) {
+            throw std::runtime_error("Predecessor on " + socket_path + " closed without handing off");
+        }
+        if (header_.magic != StateHandoffServer::MAGIC || header_.version != StateHandoffServer::VERSION ||
+            header_.state_bytes == 0) {
+            throw std::runtime_error("Malformed handoff message on " + socket_path);
+        }
+
+        void* mapped = mmap(nullptr, header_.state_bytes, PROT_READ, MAP_PRIVATE, state_fd_, 0);
+        if (mapped == MAP_FAILED) {
+            throw std::runtime_error("Failed to map handed-off state" + errorText());
+        }
+        image_ = static_cast<const uint8_t*>(mapped);
+    } catch (...) {
+        close();
+        throw;
+    }
+}
+
+StateTakeover::~StateTakeover() {
+    close();
+}
+
+int StateTakeover::releaseLogFd() {
+    int fd = log_fd_;
+    log_fd_ = -1;
+    return fd;
+}
+
+void StateTakeover::acknowledge(std::chrono::milliseconds timeout) {
+    if (socket_fd_ < 0) {
+        return;
+    }
+    if (!writeAll(socket_fd_, ACK, ACK_LENGTH)) {
+        throw std::runtime_error("Failed to acknowledge takeover" + errorText());
+    }
+    if (!readToken(socket_fd_, CONFIRM, CONFIRM_LENGTH, timeout)) {
+        throw std::runtime_error("Predecessor did not confirm the takeover (rolled back)");
+    }
+    // The log descriptor stays until released: the reader may not have it yet
+    unmap();
+    for (int* fd : {&socket_fd_, &state_fd_}) {
+        ::close(*fd);
+        *fd = -1;
+    }
+}
+
+void StateTakeover::unmap() {
+    if (image_ != nullptr) {
+        munmap(const_cast<uint8_t*>(image_), header_.state_bytes);
+        image_ = nullptr;
+    }
+}
+
+void StateTakeover::close() {
+    unmap();
+    for (int* fd : {&socket_fd_, &log_fd_, &state_fd_}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+}  // namespace trading_ledger
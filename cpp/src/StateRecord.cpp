@@ -0,0 +1,47 @@
+#include "StateRecord.h"
+
+namespace trading_ledger {
+
+void writeAccountRecord(RecordWriter& out, const AccountBalanceBook& balances, uint32_t account_id) {
+    const AccountBalanceBook::AccountRecord* rec = balances.record(account_id);
+    out.name(balances.accountName(account_id));
+    out.i64(rec->debit_total);
+    out.i64(rec->credit_total);
+    out.i64(rec->balance);
+    out.u64(rec->entry_count);
+    out.u64(rec->last_sequence);
+}
+
+void readAccountRecord(RecordReader& in, AccountBalanceBook& balances) {
+    std::string_view account = in.name();
+    AccountBalanceBook::AccountRecord record;
+    record.debit_total = in.i64();
+    record.credit_total = in.i64();
+    record.balance = in.i64();
+    record.entry_count = in.u64();
+    record.last_sequence = in.u64();
+    balances.restoreAccount(account, record);
+}
+
+void writePositionRecord(RecordWriter& out, std::string_view account, std::string_view symbol,
+                         const PositionBook::Position& position) {
+    out.name(account);
+    out.name(symbol);
+    out.i64(position.net_quantity);
+    out.i64(position.buy_quantity);
+    out.i64(position.sell_quantity);
+    out.u64(position.trade_count);
+}
+
+void readPositionRecord(RecordReader& in, PositionBook& positions) {
+    std::string_view account = in.name();
+    std::string_view symbol = in.name();
+    PositionBook::Position position;
+    position.net_quantity = in.i64();
+    position.buy_quantity = in.i64();
+    position.sell_quantity = in.i64();
+    position.trade_count = in.u64();
+    positions.restore(account, symbol, position);
+}
+
+}  // namespace trading_ledger
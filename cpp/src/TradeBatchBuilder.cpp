@@ -0,0 +1,331 @@
+#include "TradeBatchBuilder.h"
+#include "DecodedTrade.h"
+#include "JsonFields.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace trading_ledger {
+
+namespace {
+
+constexpr size_t ALIGNMENT = 64;   // Arrow's recommended buffer alignment
+
+// Growable 64-byte aligned byte buffer; ownership moves to the export
+class AlignedBuffer {
+public:
+    AlignedBuffer() = default;
+    ~AlignedBuffer() { std::free(data_); }
+
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    void reserve(size_t capacity) {
+        if (capacity <= capacity_) {
+            return;
+        }
+        capacity = (capacity + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        void* grown = nullptr;
+        if (posix_memalign(&grown, ALIGNMENT, capacity) != 0) {
+            throw std::bad_alloc();
+        }
+        if (size_ > 0) {
+            std::memcpy(grown, data_, size_);
+        }
+        std::free(data_);
+        data_ = static_cast<uint8_t*>(grown);
+        capacity_ = capacity;
+    }
+
+    void append(const void* bytes, size_t count) {
+        if (size_ + count > capacity_) {
+            reserve(std::max(size_ + count, capacity_ * 2));
+        }
+        if (count > 0) {
+            std::memcpy(data_ + size_, bytes, count);
+        }
+        size_ += count;
+    }
+
+    template<typename T>
+    void push(T value) {
+        append(&value, sizeof(T));
+    }
+
+    // Validity bit for row (the bitmap grows a byte at a time)
+    void setBit(size_t row, bool valid) {
+        if (row % 8 == 0) {
+            push<uint8_t>(0);
+        }
+        if (valid) {
+            data_[row / 8] |= static_cast<uint8_t>(1u << (row % 8));
+        }
+    }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+
+using Buffer = std::shared_ptr<AlignedBuffer>;
+
+// decimal128 is 16 bytes, little-endian two's complement
+void pushDecimal(AlignedBuffer& column, WideAmount value) {
+    uint64_t words[2] = {static_cast<uint64_t>(value), static_cast<uint64_t>(value >> 64)};
+    column.append(words, sizeof(words));
+}
+
+void pushString(AlignedBuffer& offsets, AlignedBuffer& data, std::string_view text) {
+    data.append(text.data(), text.size());
+    if (data.size() > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        throw std::length_error("Trade batch string column exceeds 2 GiB");
+    }
+    offsets.push<int32_t>(static_cast<int32_t>(data.size()));
+}
+
+struct ColumnSpec {
+    const char* name;
+    const char* format;
+    bool nullable;
+};
+
+constexpr ColumnSpec SPECS[TradeBatchBuilder::COLUMNS] = {
+    {"sequence_num", "L", false},
+    {"timestamp_ns", "tsn:", false},
+    {"trade_id", "u", true},
+    {"account_id", "u", true},
+    {"symbol", "u", true},
+    {"side", "u", true},
+    {"direction", "c", true},
+    {"quantity", "d:18,8", true},
+    {"price", "d:18,8", true},
+    {"notional", "d:38,8", true},
+};
+
+// private_data of one exported column
+struct ExportedColumn {
+    std::vector<Buffer> owned;
+    const void* buffers[3] = {nullptr, nullptr, nullptr};
+};
+
+// private_data of the exported struct array
+struct ExportedBatch {
+    ArrowArray columns[TradeBatchBuilder::COLUMNS];
+    ArrowArray* children[TradeBatchBuilder::COLUMNS];
+    const void* buffers[1] = {nullptr};   // No struct-level nulls
+};
+
+struct ExportedSchema {
+    ArrowSchema columns[TradeBatchBuilder::COLUMNS];
+    ArrowSchema* children[TradeBatchBuilder::COLUMNS];
+};
+
+void releaseColumn(ArrowArray* array) {
+    delete static_cast<ExportedColumn*>(array->private_data);
+    array->release = nullptr;
+}
+
+void releaseBatch(ArrowArray* array) {
+    auto* batch = static_cast<ExportedBatch*>(array->private_data);
+    for (ArrowArray* child : batch->children) {
+        if (child->release != nullptr) {   // Not moved out by the consumer
+            child->release(child);
+        }
+    }
+    delete batch;
+    array->release = nullptr;
+}
+
+void releaseColumnSchema(ArrowSchema* schema) {
+    schema->release = nullptr;   // Strings are static
+}
+
+void releaseSchema(ArrowSchema* schema) {
+    auto* exported = static_cast<ExportedSchema*>(schema->private_data);
+    for (ArrowSchema* child : exported->children) {
+        if (child->release != nullptr) {
+            child->release(child);
+        }
+    }
+    delete exported;
+    schema->release = nullptr;
+}
+
+}  // namespace
+
+struct TradeBatchBuilder::Columns {
+    size_t rows = 0;
+    size_t trade_id_nulls = 0;
+    size_t malformed = 0;
+
+    Buffer sequence = std::make_shared<AlignedBuffer>();
+    Buffer timestamp = std::make_shared<AlignedBuffer>();
+    Buffer trade_id_valid = std::make_shared<AlignedBuffer>();
+    Buffer decoded_valid = std::make_shared<AlignedBuffer>();   // Shared by the decoded columns
+    Buffer offsets[4];   // trade_id, account_id, symbol, side
+    Buffer strings[4];
+    Buffer direction = std::make_shared<AlignedBuffer>();
+    Buffer quantity = std::make_shared<AlignedBuffer>();
+    Buffer price = std::make_shared<AlignedBuffer>();
+    Buffer notional = std::make_shared<AlignedBuffer>();
+
+    explicit Columns(size_t expected_rows) {
+        sequence->reserve(expected_rows * 8);
+        timestamp->reserve(expected_rows * 8);
+        trade_id_valid->reserve(expected_rows / 8 + 1);
+        decoded_valid->reserve(expected_rows / 8 + 1);
+        for (size_t i = 0; i < 4; ++i) {
+            offsets[i] = std::make_shared<AlignedBuffer>();
+            offsets[i]->reserve((expected_rows + 1) * 4);
+            offsets[i]->push<int32_t>(0);
+            strings[i] = std::make_shared<AlignedBuffer>();
+            strings[i]->reserve(expected_rows * 16);
+        }
+        direction->reserve(expected_rows);
+        quantity->reserve(expected_rows * 16);
+        price->reserve(expected_rows * 16);
+        notional->reserve(expected_rows * 16);
+    }
+};
+
+TradeBatchBuilder::TradeBatchBuilder(size_t expected_rows)
+    : columns_(std::make_unique<Columns>(expected_rows)), expected_rows_(expected_rows) {}
+
+TradeBatchBuilder::~TradeBatchBuilder() = default;
+
+bool TradeBatchBuilder::append(const EventView& event) {
+    if (event.event_type != EventType::TRADE_CREATED) {
+        return false;
+    }
+    Columns& c = *columns_;
+    size_t row = c.rows++;
+    c.sequence->push<uint64_t>(event.sequence_num);
+    c.timestamp->push<int64_t>(static_cast<int64_t>(event.timestamp_ns));
+
+    DecodedTrade trade;
+    bool decoded = DecodedTrade::decode(event.payload, trade);
+    std::optional<std::string_view> trade_id;
+    if (decoded) {
+        if (!trade.trade_id.empty()) {
+            trade_id = trade.trade_id;
+        }
+    } else {
+        trade_id = JsonFields::findString(event.payload, "trade_id");
+        trade = DecodedTrade{};   // decode() may have filled some fields
+        c.malformed++;
+    }
+
+    c.trade_id_valid->setBit(row, trade_id.has_value());
+    c.trade_id_nulls += trade_id ? 0 : 1;
+    pushString(*c.offsets[0], *c.strings[0], trade_id.value_or(std::string_view{}));
+
+    // Null rows still take their slot in every fixed-width column
+    c.decoded_valid->setBit(row, decoded);
+    pushString(*c.offsets[1], *c.strings[1], trade.account_id);
+    pushString(*c.offsets[2], *c.strings[2], trade.symbol);
+    pushString(*c.offsets[3], *c.strings[3], trade.side);
+    c.direction->push<int8_t>(static_cast<int8_t>(trade.direction));
+    pushDecimal(*c.quantity, trade.quantity);
+    pushDecimal(*c.price, trade.price);
+    pushDecimal(*c.notional, trade.notional);
+    return true;
+}
+
+void TradeBatchBuilder::append(const EventView* events, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        append(events[i]);
+    }
+}
+
+size_t TradeBatchBuilder::rows() const {
+    return columns_->rows;
+}
+
+size_t TradeBatchBuilder::malformed() const {
+    return columns_->malformed;
+}
+
+void TradeBatchBuilder::finish(ArrowArray* array, ArrowSchema* schema) {
+    std::unique_ptr<Columns> done = std::exchange(columns_, std::make_unique<Columns>(expected_rows_));
+    auto batch = std::make_unique<ExportedBatch>();
+    auto length = static_cast<int64_t>(done->rows);
+
+    auto column = [&](size_t index, int64_t null_count, std::initializer_list<Buffer> buffers) {
+        auto exported = std::make_unique<ExportedColumn>();
+        size_t n = 0;
+        for (const Buffer& buffer : buffers) {
+            exported->buffers[n++] = buffer ? buffer->data() : nullptr;
+            if (buffer) {
+                exported->owned.push_back(buffer);
+            }
+        }
+        ArrowArray& out = batch->columns[index];
+        out = ArrowArray{};
+        out.length = length;
+        out.null_count = null_count;
+        out.n_buffers = static_cast<int64_t>(n);
+        out.buffers = exported->buffers;
+        out.release = releaseColumn;
+        out.private_data = exported.release();
+        batch->children[index] = &out;
+    };
+
+    auto decoded_nulls = static_cast<int64_t>(done->malformed);
+    // A column without nulls may omit its bitmap
+    Buffer decoded_valid = decoded_nulls > 0 ? done->decoded_valid : nullptr;
+    Buffer trade_id_valid = done->trade_id_nulls > 0 ? done->trade_id_valid : nullptr;
+    column(0, 0, {nullptr, done->sequence});
+    column(1, 0, {nullptr, done->timestamp});
+    column(2, static_cast<int64_t>(done->trade_id_nulls), {trade_id_valid, done->offsets[0], done->strings[0]});
+    for (size_t i = 1; i < 4; ++i) {
+        column(2 + i, decoded_nulls, {decoded_valid, done->offsets[i], done->strings[i]});
+    }
+    column(6, decoded_nulls, {decoded_valid, done->direction});
+    column(7, decoded_nulls, {decoded_valid, done->quantity});
+    column(8, decoded_nulls, {decoded_valid, done->price});
+    column(9, decoded_nulls, {decoded_valid, done->notional});
+
+    *array = ArrowArray{};
+    array->length = length;
+    array->n_buffers = 1;
+    array->n_children = static_cast<int64_t>(COLUMNS);
+    array->buffers = batch->buffers;
+    array->children = batch->children;
+    array->release = releaseBatch;
+    array->private_data = batch.release();
+
+    exportSchema(schema);
+}
+
+void TradeBatchBuilder::exportSchema(ArrowSchema* schema) {
+    auto exported = std::make_unique<ExportedSchema>();
+    for (size_t i = 0; i < COLUMNS; ++i) {
+        ArrowSchema& child = exported->columns[i];
+        child = ArrowSchema{};
+        child.format = SPECS[i].format;
+        child.name = SPECS[i].name;
+        child.flags = SPECS[i].nullable ? ARROW_FLAG_NULLABLE : 0;
+        child.release = releaseColumnSchema;
+        exported->children[i] = &child;
+    }
+    *schema = ArrowSchema{};
+    schema->format = "+s";
+    schema->name = "";
+    schema->n_children = static_cast<int64_t>(COLUMNS);
+    schema->children = exported->children;
+    schema->release = releaseSchema;
+    schema->private_data = exported.release();
+}
+
+}  // namespace trading_ledger
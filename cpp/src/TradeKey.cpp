@@ -0,0 +1,182 @@
+#include "TradeKey.h"
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace trading_ledger {
+
+namespace {
+
+// Dash positions in the canonical 8-4-4-4-12 layout
+constexpr size_t UUID_LENGTH = 36;
+
+inline uint64_t loadBigEndian64(const uint8_t* bytes) {
+    uint64_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return __builtin_bswap64(value);
+}
+
+inline void storeBigEndian64(uint64_t value, uint8_t* bytes) {
+    value = __builtin_bswap64(value);
+    std::memcpy(bytes, &value, sizeof(value));
+}
+
+#if defined(__SSE2__)
+
+// Convert 16 ASCII hex digits to 16 nibble values.
+// Returns false if any byte is not [0-9a-fA-F].
+inline bool hexToNibbles(__m128i chars, __m128i& nibbles) {
+    const __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+
+    // Signed compares are fine: bytes >= 0x80 are negative and fail both ranges
+    const __m128i is_digit = _mm_and_si128(
+        _mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)),
+        _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+    const __m128i is_alpha = _mm_and_si128(
+        _mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+        _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+
+    if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha)) != 0xFFFF) {
+        return false;
+    }
+
+    const __m128i digit_values = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    const __m128i alpha_values = _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10));
+    nibbles = _mm_or_si128(_mm_and_si128(is_digit, digit_values),
+                           _mm_andnot_si128(is_digit, alpha_values));
+    return true;
+}
+
+// Combine adjacent nibble pairs (high nibble first) into 16-bit lanes 0..255
+inline __m128i combineNibblePairs(__m128i nibbles) {
+    const __m128i high = _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4);
+    const __m128i low = _mm_srli_epi16(nibbles, 8);
+    return _mm_or_si128(high, low);
+}
+
+inline bool decodeHex32(const char* hex, uint8_t* bytes) {
+    __m128i n0, n1;
+    if (!hexToNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex)), n0) ||
+        !hexToNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 16)), n1)) {
+        return false;
+    }
+    const __m128i packed = _mm_packus_epi16(combineNibblePairs(n0), combineNibblePairs(n1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), packed);
+    return true;
+}
+
+#else
+
+inline int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c = static_cast<char>(c | 0x20);
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+inline bool decodeHex32(const char* hex, uint8_t* bytes) {
+    for (size_t i = 0; i < 16; ++i) {
+        int high = hexValue(hex[2 * i]);
+        int low = hexValue(hex[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        bytes[i] = static_cast<uint8_t>((high << 4) | low);
+    }
+    return true;
+}
+
+#endif
+
+}  // namespace
+
+bool TradeKey::fromUuid(std::string_view text, TradeKey& out) {
+    if (text.size() != UUID_LENGTH ||
+        text[8] != '-' || text[13] != '-' || text[18] != '-' || text[23] != '-') {
+        return false;
+    }
+
+    // Gather the 32 hex digits contiguously, then decode them in one pass
+    char hex[32];
+    std::memcpy(hex, text.data(), 8);
+    std::memcpy(hex + 8, text.data() + 9, 4);
+    std::memcpy(hex + 12, text.data() + 14, 4);
+    std::memcpy(hex + 16, text.data() + 19, 4);
+    std::memcpy(hex + 20, text.data() + 24, 12);
+
+    uint8_t bytes[16];
+    if (!decodeHex32(hex, bytes)) {
+        return false;
+    }
+
+    TradeKey key;
+    key.hi = loadBigEndian64(bytes);
+    key.lo = loadBigEndian64(bytes + 8);
+
+    // Reserved variant collides with the interned encoding
+    if ((key.lo & INTERNED_MASK) == INTERNED_TAG) {
+        return false;
+    }
+
+    out = key;
+    return true;
+}
+
+std::string TradeKey::toUuidString() const {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+
+    uint8_t bytes[16];
+    storeBigEndian64(hi, bytes);
+    storeBigEndian64(lo, bytes + 8);
+
+    std::string out;
+    out.reserve(UUID_LENGTH);
+    for (size_t i = 0; i < 16; ++i) {
+        if (i == 4 || i == 6 || i == 8 || i == 10) {
+            out.push_back('-');
+        }
+        out.push_back(DIGITS[bytes[i] >> 4]);
+        out.push_back(DIGITS[bytes[i] & 0x0F]);
+    }
+    return out;
+}
+
+TradeKey TradeKeyInterner::resolve(std::string_view trade_id) {
+    TradeKey key;
+    if (TradeKey::fromUuid(trade_id, key)) {
+        return key;
+    }
+    return intern(trade_id);
+}
+
+TradeKey TradeKeyInterner::intern(std::string_view trade_id) {
+    auto it = ids_.find(trade_id);
+    uint64_t index;
+    if (it != ids_.end()) {
+        index = it->second;
+    } else {
+        index = names_.size();
+        const std::string& stored = names_.emplace_back(trade_id);
+        ids_.emplace(std::string_view(stored), index);
+    }
+
+    TradeKey key;
+    key.hi = 0;
+    key.lo = TradeKey::INTERNED_TAG | index;
+    return key;
+}
+
+std::string_view TradeKeyInterner::lookup(const TradeKey& key) const {
+    if (!key.isInterned()) {
+        return {};
+    }
+    uint64_t index = key.lo & ~TradeKey::INTERNED_MASK;
+    if (index >= names_.size()) {
+        return {};
+    }
+    return names_[index];
+}
+
+}  // namespace trading_ledger
@@ -0,0 +1,138 @@
+#include "VerdictLogReader.h"
+#include "EventParser.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sstream>
+#include <stdexcept>
+#include <cstring>
+
+namespace trading_ledger {
+
+VerdictLogReader::VerdictLogReader(const std::string& log_path)
+    : log_path_(log_path)
+    , fd_(-1)
+    , mapped_data_(nullptr)
+    , file_size_(0)
+    , offset_(0)
+    , is_open_(false) {}
+
+VerdictLogReader::~VerdictLogReader() {
+    if (mapped_data_ != nullptr && mapped_data_ != MAP_FAILED) {
+        munmap(mapped_data_, file_size_);
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+void VerdictLogReader::open() {
+    fd_ = ::open(log_path_.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open file: " + log_path_ +
+                                 " (error: " + std::string(strerror(errno)) + ")");
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+        throw std::runtime_error("Failed to stat file: " + log_path_);
+    }
+    file_size_ = st.st_size;
+
+    if (file_size_ < VerdictFileHeader::SIZE) {
+        throw std::runtime_error("File too small: " + log_path_);
+    }
+
+    mapped_data_ = static_cast<uint8_t*>(
+        mmap(nullptr, file_size_, PROT_READ, MAP_SHARED, fd_, 0)
+    );
+    if (mapped_data_ == MAP_FAILED) {
+        mapped_data_ = nullptr;
+        throw std::runtime_error("Failed to mmap file: " + log_path_);
+    }
+
+#ifdef __linux__
+    madvise(mapped_data_, file_size_, MADV_SEQUENTIAL);
+#endif
+
+    VerdictFileHeader header;
+    header.magic = EventParser::readUint32LE(mapped_data_);
+    header.version = EventParser::readUint32LE(mapped_data_ + 4);
+    header.reserved = EventParser::readUint64LE(mapped_data_ + 8);
+    if (!header.isValid()) {
+        std::ostringstream oss;
+        oss << "Invalid verdict log header: magic=0x" << std::hex << header.magic
+            << ", version=" << std::dec << header.version;
+        throw ParseException(oss.str());
+    }
+
+    offset_ = VerdictFileHeader::SIZE;
+    is_open_ = true;
+}
+
+bool VerdictLogReader::readNext(VerdictRecord& record) {
+    if (!is_open_) {
+        throw std::runtime_error("Reader not open");
+    }
+
+    // Partial record at EOF: writer has not finished appending it
+    if (offset_ + VerdictRecord::SIZE > file_size_) {
+        return false;
+    }
+
+    const uint8_t* data = mapped_data_ + offset_;
+    uint32_t stored_crc = EventParser::readUint32LE(data + 20);
+    uint32_t calculated_crc = EventParser::calculateCRC32(data, 20);
+    if (stored_crc != calculated_crc) {
+        std::ostringstream oss;
+        oss << "verdict at offset " << offset_ << ": calculated=0x" << std::hex
+            << calculated_crc << ", stored=0x" << stored_crc;
+        throw CorruptedEventException(oss.str());
+    }
+
+    record.sequence_num = EventParser::readUint64LE(data);
+    record.timestamp_ns = EventParser::readUint64LE(data + 8);
+    record.code = static_cast<VerdictCode>(data[16]);
+    record.rule = static_cast<ValidationRule>(data[17]);
+
+    offset_ += VerdictRecord::SIZE;
+    return true;
+}
+
+bool VerdictLogReader::remapIfGrown() {
+    if (!is_open_) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+        return false;
+    }
+
+    size_t new_size = st.st_size;
+    if (new_size <= file_size_) {
+        return false;
+    }
+
+    if (munmap(mapped_data_, file_size_) != 0) {
+        throw std::runtime_error("Failed to unmap file");
+    }
+
+    file_size_ = new_size;
+    mapped_data_ = static_cast<uint8_t*>(
+        mmap(nullptr, file_size_, PROT_READ, MAP_SHARED, fd_, 0)
+    );
+    if (mapped_data_ == MAP_FAILED) {
+        mapped_data_ = nullptr;
+        throw std::runtime_error("Failed to remap file");
+    }
+
+#ifdef __linux__
+    madvise(mapped_data_, file_size_, MADV_SEQUENTIAL);
+#endif
+
+    return true;
+}
+
+}  // namespace trading_ledger
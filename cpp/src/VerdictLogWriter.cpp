@@ -0,0 +1,214 @@
+#include "VerdictLogWriter.h"
+#include "ByteOrder.h"
+#include "EventParser.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace trading_ledger {
+
+VerdictLogWriter::VerdictLogWriter(const std::string& log_path, size_t batch_size)
+    : log_path_(log_path)
+    , batch_size_(batch_size > 0 ? batch_size : DEFAULT_BATCH_SIZE)
+    , fd_(-1)
+    , ring_(std::make_unique<NotifyingRingBuffer<VerdictRecord, RING_SIZE>>())
+    , running_(false)
+    , failed_(false)
+    , written_(0)
+    , dropped_(0)
+    , stalls_(0) {}
+
+VerdictLogWriter::~VerdictLogWriter() {
+    close();
+}
+
+void VerdictLogWriter::open() {
+    fd_ = ::open(log_path_.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open verdict log: " + log_path_ +
+                                 " (error: " + std::string(strerror(errno)) + ")");
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+        ::close(fd_);
+        fd_ = -1;
+        throw std::runtime_error("Failed to stat verdict log: " + log_path_);
+    }
+
+    try {
+        if (st.st_size == 0) {
+            // New file: write header
+            uint8_t header[VerdictFileHeader::SIZE] = {0};
+            writeUint32LE(header, VerdictFileHeader::EXPECTED_MAGIC);
+            writeUint32LE(header + 4, VerdictFileHeader::EXPECTED_VERSION);
+            writeAll(header, sizeof(header));
+        } else {
+            recoverExisting(st.st_size);
+        }
+    } catch (...) {
+        ::close(fd_);
+        fd_ = -1;
+        throw;
+    }
+
+    failed_.store(false, std::memory_order_relaxed);
+    running_.store(true, std::memory_order_release);
+    writer_thread_ = std::thread(&VerdictLogWriter::writerLoop, this);
+}
+
+void VerdictLogWriter::recoverExisting(off_t size) {
+    uint8_t header[VerdictFileHeader::SIZE];
+    ssize_t n = pread(fd_, header, sizeof(header), 0);
+    if (n != static_cast<ssize_t>(sizeof(header)) ||
+        EventParser::readUint32LE(header) != VerdictFileHeader::EXPECTED_MAGIC ||
+        EventParser::readUint32LE(header + 4) != VerdictFileHeader::EXPECTED_VERSION) {
+        throw std::runtime_error("Not a verdict log (bad header): " + log_path_);
+    }
+
+    // A crash mid-append leaves a partial record; appending after it would
+    // misalign every later record
+    off_t records = (size - static_cast<off_t>(VerdictFileHeader::SIZE)) /
+                    static_cast<off_t>(VerdictRecord::SIZE);
+    off_t complete = static_cast<off_t>(VerdictFileHeader::SIZE) +
+                     records * static_cast<off_t>(VerdictRecord::SIZE);
+    if (complete != size) {
+        std::cerr << "Verdict log: dropping " << size - complete << " bytes of a partial record at the end of "
+                  << log_path_ << std::endl;
+        if (ftruncate(fd_, complete) != 0) {
+            throw std::runtime_error("Failed to truncate verdict log: " + log_path_ +
+                                     " (error: " + std::string(strerror(errno)) + ")");
+        }
+    }
+}
+
+bool VerdictLogWriter::submit(const VerdictRecord& record) {
+    submitted_++;
+    while (!ring_->try_push(record)) {
+        if (failed()) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        stalls_.fetch_add(1, std::memory_order_relaxed);
+        ring_->waitForSpace(10);   // Bounded: re-checks failed() if the writer died
+    }
+    if (failed()) {
+        discardQueued();   // Writer is gone: nobody else will count it
+        return false;
+    }
+    return true;
+}
+
+std::string VerdictLogWriter::error() const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    return error_;
+}
+
+void VerdictLogWriter::flush() {
+    while (writer_thread_.joinable() && !failed() &&
+           written_.load(std::memory_order_relaxed) + dropped_.load(std::memory_order_relaxed) < submitted_) {
+        ring_->wake();
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+void VerdictLogWriter::close() {
+    if (writer_thread_.joinable()) {
+        running_.store(false, std::memory_order_release);
+        ring_->wake();
+        writer_thread_.join();
+        discardQueued();   // Non-empty only if the writer failed
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void VerdictLogWriter::discardQueued() {
+    VerdictRecord record;
+    while (ring_->try_pop(record)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void VerdictLogWriter::encode(const VerdictRecord& record, uint8_t* out) {
+    writeUint64LE(out, record.sequence_num);
+    writeUint64LE(out + 8, record.timestamp_ns);
+    out[16] = static_cast<uint8_t>(record.code);
+    out[17] = static_cast<uint8_t>(record.rule);
+    out[18] = 0;
+    out[19] = 0;
+    writeUint32LE(out + 20, EventParser::calculateCRC32(out, 20));
+}
+
+void VerdictLogWriter::writerLoop() {
+    std::vector<uint8_t> batch;
+    batch.reserve(batch_size_ * VerdictRecord::SIZE);
+
+    try {
+        while (running_.load(std::memory_order_acquire)) {
+            if (drainOnce(batch) == 0) {
+                // Nothing queued: sleep until the producer pushes (or close())
+                ring_->wait(100);
+            }
+        }
+
+        // Final drain after stop was requested
+        while (drainOnce(batch) > 0) {}
+    } catch (const std::exception& e) {
+        {
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            error_ = e.what();
+        }
+        failed_.store(true, std::memory_order_release);
+        std::cerr << "Verdict log writer error: " << e.what()
+                  << " (further verdicts are dropped)" << std::endl;
+    }
+}
+
+size_t VerdictLogWriter::drainOnce(std::vector<uint8_t>& batch) {
+    batch.clear();
+
+    size_t count = 0;
+    VerdictRecord record;
+    while (count < batch_size_ && ring_->try_pop(record)) {
+        size_t pos = batch.size();
+        batch.resize(pos + VerdictRecord::SIZE);
+        encode(record, batch.data() + pos);
+        ++count;
+    }
+
+    if (count > 0) {
+        try {
+            writeAll(batch.data(), batch.size());
+        } catch (...) {
+            dropped_.fetch_add(count, std::memory_order_relaxed);   // Popped, never written
+            throw;
+        }
+        written_.fetch_add(count, std::memory_order_relaxed);
+    }
+    return count;
+}
+
+void VerdictLogWriter::writeAll(const uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = ::write(fd_, data, length);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to write verdict log: " + log_path_ +
+                                     " (error: " + std::string(strerror(errno)) + ")");
+        }
+        data += n;
+        length -= static_cast<size_t>(n);
+    }
+}
+
+}  // namespace trading_ledger
@@ -1,14 +1,29 @@
-#include "EventLogReader.h"
-#include "EventLogTailer.h"
-#include "RingBuffer.h"
-#include "DoubleEntryValidator.h"
+#include "ConsumerCore.h"
 #include "LatencyHistogram.h"
+#include "PipelineMetrics.h"
+#include "FlightRecorder.h"
+#include "VerdictLogWriter.h"
+#include "AllocationProfiler.h"
+#include "Instrumentation.h"
+#include "ContinuousQuery.h"
+#include "ControlServer.h"
+#include "EventTap.h"
+#include "StateHandoff.h"
+#include "ProgressWatermark.h"
+#include "CommandLine.h"
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
 #include <thread>
 #include <atomic>
 #include <iostream>
 #include <csignal>
 #include <cstring>
 #include <chrono>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
 
 using namespace trading_ledger;
 
@@ -23,47 +38,14 @@ void signalHandler(int signal) {
 }
 
 /**
- * Producer thread: reads events from log and pushes to ring buffer
+ * Two-thread pipeline, producer: reads events from log and pushes to ring buffer
  */
 void producerThread(const std::string& log_path,
-                    RingBuffer<Event, 4096>& buffer,
-                    std::atomic<size_t>& events_read) {
+                    EventRing& buffer,
+                    PipelineMetrics& metrics,
+                    UpgradeHandoff& upgrade) {
     try {
-        EventLogReader reader(log_path);
-        reader.open();
-
-        EventLogTailer tailer(log_path);
-        tailer.init();
-
-        std::cout << "Producer: Using "
-                  << (tailer.isUsingInotify() ? "inotify (Linux)" : "polling (fallback)")
-                  << " for tail-following" << std::endl;
-
-        while (g_running.load(std::memory_order_acquire)) {
-            Event event;
-
-            // Try to read next event
-            if (reader.readNext(event)) {
-                // Push to ring buffer (spin if full)
-                while (!buffer.try_push(std::move(event))) {
-                    if (!g_running.load(std::memory_order_acquire)) {
-                        return;
-                    }
-                    std::this_thread::yield();
-                }
-
-                events_read.fetch_add(1, std::memory_order_relaxed);
-            } else {
-                // EOF reached, wait for file to grow
-                if (!reader.remapIfGrown()) {
-                    // File hasn't grown, wait for modification
-                    tailer.waitForModification(100);  // 100ms timeout
-                    reader.remapIfGrown();  // Try again
-                }
-            }
-        }
-
-        std::cout << "Producer: Shutting down" << std::endl;
+        readIntoRing(log_path, buffer, metrics, upgrade);
     } catch (const std::exception& e) {
         std::cerr << "Producer error: " << e.what() << std::endl;
         g_running.store(false, std::memory_order_release);
@@ -71,119 +53,507 @@ void producerThread(const std::string& log_path,
 }
 
 /**
- * Consumer thread: pops events from buffer and validates
+ * Two-thread pipeline, consumer: pops events from buffer and validates
  */
-void consumerThread(RingBuffer<Event, 4096>& buffer,
-                    std::atomic<size_t>& events_processed,
-                    LatencyHistogram& latency_histogram) {
+void consumerThread(EventRing& buffer,
+                    const ConsumerCore::Config& config,
+                    PipelineMetrics& metrics,
+                    LatencyHistogram& latency_histogram,
+                    VerdictLogWriter* verdict_log,
+                    ProgressWatermark* watermark,
+                    ContinuousQueryEngine& queries,
+                    EventTap& tap,
+                    CommandHandoff& control,
+                    UpgradeHandoff& upgrade) {
     try {
-        DoubleEntryValidator validator;
-
-        while (g_running.load(std::memory_order_acquire) || !buffer.empty()) {
-            Event event;
-
-            if (buffer.try_pop(event)) {
-                // Measure processing latency
-                auto start = std::chrono::steady_clock::now();
-
-                // Process event
-                validator.processEvent(event);
-                events_processed.fetch_add(1, std::memory_order_relaxed);
+        AllocationProfiler::setStage(PipelineStage::VALIDATOR);
+        ConsumerCore core(config, metrics, latency_histogram, verdict_log, watermark, queries, tap,
+                          control, upgrade);
+        consumeRing(buffer, core, upgrade);
+        core.finish();
+        std::cout << "\nConsumer: Shutting down" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Consumer error: " << e.what() << std::endl;
+        g_running.store(false, std::memory_order_release);
+    }
+}
 
-                // Record latency
-                auto end = std::chrono::steady_clock::now();
-                auto latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
-                latency_histogram.record(latency_ns);
+/**
+ * Run-to-completion settings (--run-to-completion)
+ */
+struct RunToCompletionOptions {
+    bool enabled = false;
+    int cpu = -1;                      // Pin the thread to this CPU (-1 = unpinned)
+    uint64_t offload_budget_ns = 0;    // Offload above this per-event cost (0 = never)
+};
+
+void pinCurrentThread(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        std::cerr << "Run-to-completion: cannot pin to cpu " << cpu << " (" << std::strerror(rc)
+                  << "), running unpinned" << std::endl;
+    }
+}
 
-                // Print periodic latency summary every 10,000 events
-                if (events_processed.load(std::memory_order_relaxed) % 10000 == 0) {
-                    latency_histogram.printSummary();
-                    latency_histogram.clear();  // Reset for next window
-                }
-            } else {
-                // Buffer empty, yield
-                std::this_thread::yield();
-            }
+/**
+ * Run-to-completion thread: reads, parses, validates and records inline
+ * (see runToCompletion)
+ */
+void runToCompletionThread(const std::string& log_path,
+                           EventRing& buffer,
+                           OffloadHandoff& handoff,
+                           const ConsumerCore::Config& config,
+                           PipelineMetrics& metrics,
+                           LatencyHistogram& latency_histogram,
+                           VerdictLogWriter* verdict_log,
+                           ProgressWatermark* watermark,
+                           ContinuousQueryEngine& queries,
+                           EventTap& tap,
+                           CommandHandoff& control,
+                           const RunToCompletionOptions& options,
+                           UpgradeHandoff& upgrade) {
+    try {
+        if (options.cpu >= 0) {
+            pinCurrentThread(options.cpu);
         }
-
-        // Print final summaries
-        std::cout << "\n=== Final Statistics ===" << std::endl;
-        validator.printSummary();
-        if (latency_histogram.count() > 0) {
-            latency_histogram.printSummary();
+        AllocationProfiler::setStage(PipelineStage::VALIDATOR);
+        ConsumerCore core(config, metrics, latency_histogram, verdict_log, watermark, queries, tap,
+                          control, upgrade);
+        RunToCompletionStats stats = runToCompletion(log_path, core, buffer, handoff, metrics,
+                                                     upgrade, options.offload_budget_ns);
+        core.finish();
+        if (options.offload_budget_ns > 0) {
+            std::cout << "Run-to-completion: offloaded " << stats.offloads << " times, "
+                      << stats.events_offloaded << " events through the worker" << std::endl;
         }
-
-        std::cout << "\nConsumer: Shutting down" << std::endl;
+        std::cout << "\nRun-to-completion: Shutting down" << std::endl;
     } catch (const std::exception& e) {
-        std::cerr << "Consumer error: " << e.what() << std::endl;
+        std::cerr << "Run-to-completion error: " << e.what() << std::endl;
         g_running.store(false, std::memory_order_release);
     }
 }
 
+
 /**
- * Monitor thread: prints progress
+ * Monitor thread: samples metrics once per second into the flight recorder
+ * (if enabled) and prints progress every 5 seconds
  */
-void monitorThread(std::atomic<size_t>& events_read,
-                   std::atomic<size_t>& events_processed) {
+void monitorThread(PipelineMetrics& metrics,
+                   const EventRing& buffer,
+                   const VerdictLogWriter* verdict_log,
+                   FlightRecorder* recorder) {
+    constexpr int PRINT_EVERY_SECONDS = 5;
+
     size_t last_read = 0;
     size_t last_processed = 0;
+    int ticks = 0;
 
     while (g_running.load(std::memory_order_acquire)) {
-        std::this_thread::sleep_for(std::chrono::seconds(5));
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // Close the consumer's latency interval; a busy consumer serves this
+        // within one event, an idle one within its 100 ms wait
+        IntervalLatency interval;
+        bool have_interval = false;
+        if (recorder != nullptr) {
+            metrics.interval_latency.request();
+            for (int i = 0; i < 150 && !have_interval; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                have_interval = metrics.interval_latency.collect(interval);
+            }
+        }
+
+        size_t current_read = metrics.events_read.value();
+        size_t current_processed = metrics.events_processed.value();
+
+        if (recorder != nullptr) {
+            MetricSnapshot snapshot;
+            snapshot.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            snapshot.events_read = current_read;
+            snapshot.events_processed = current_processed;
+            snapshot.validation_failures = metrics.validation_failures.value();
+            snapshot.verdicts_dropped = verdict_log != nullptr ? verdict_log->dropped() : 0;
+            snapshot.ring_occupancy = static_cast<uint32_t>(buffer.size());
+            snapshot.ring_capacity = static_cast<uint32_t>(buffer.capacity());
+            snapshot.lag_events = current_read > current_processed ? current_read - current_processed : 0;
+
+            // Not served (consumer stalled): interval left empty
+            if (have_interval) {
+                snapshot.interval_count = interval.count;
+                snapshot.p50_ns = interval.p50_ns;
+                snapshot.p99_ns = interval.p99_ns;
+                snapshot.p999_ns = interval.p999_ns;
+                snapshot.max_ns = interval.max_ns;
+            }
+            recorder->record(snapshot);
+        }
 
-        size_t current_read = events_read.load(std::memory_order_relaxed);
-        size_t current_processed = events_processed.load(std::memory_order_relaxed);
+        if (++ticks % PRINT_EVERY_SECONDS == 0) {
+            size_t read_rate = (current_read - last_read) / PRINT_EVERY_SECONDS;
+            size_t process_rate = (current_processed - last_processed) / PRINT_EVERY_SECONDS;
 
-        size_t read_rate = (current_read - last_read) / 5;
-        size_t process_rate = (current_processed - last_processed) / 5;
+            std::cout << "Monitor: Read " << current_read << " events ("
+                      << read_rate << " events/sec), Processed " << current_processed
+                      << " (" << process_rate << " events/sec)" << std::endl;
 
-        std::cout << "Monitor: Read " << current_read << " events ("
-                  << read_rate << " events/sec), Processed " << current_processed
-                  << " (" << process_rate << " events/sec)" << std::endl;
+            last_read = current_read;
+            last_processed = current_processed;
+        }
+    }
+}
 
-        last_read = current_read;
-        last_processed = current_processed;
+/**
+ * Control socket TAP command (runs on the control server thread)
+ *
+ *   TAP ON <file | unix:socket> [type=..] [seq=A-B] [trade=ID] [verdict=FAILED] [sample=N]
+ *   TAP OFF
+ *   TAP STATUS
+ */
+std::string handleTap(std::istream& in, EventTap& tap, CommandHandoff& control) {
+    std::string action;
+    in >> action;
+    auto status = [&tap] {
+        EventTap::Stats stats = tap.stats();
+        std::ostringstream out;
+        out << "tap=" << (tap.running() ? tap.destination() : "off")
+            << " matched=" << stats.matched << " queued=" << stats.queued
+            << " dropped=" << stats.dropped << " written=" << stats.written;
+        if (!stats.error.empty()) {
+            out << " discarded=" << stats.discarded << " error=\"" << stats.error << "\"";
+        }
+        out << "\n";
+        return out.str();
+    };
+
+    if (action == "ON") {
+        std::string destination;
+        std::vector<std::string> tokens;
+        in >> destination;
+        for (std::string token; in >> token;) {
+            tokens.push_back(token);
+        }
+        if (destination.empty()) {
+            throw std::invalid_argument("usage: TAP ON <file | unix:socket> [filters]");
+        }
+        TapFilter filter = TapFilter::parse(tokens);
+        tap.start(destination);
+        try {
+            control.execute([&tap, filter] { tap.arm(filter); return std::string(); },
+                            std::chrono::seconds(1));
+        } catch (...) {
+            tap.stop();
+            throw;
+        }
+        return "tapping " + filter.describe() + " to " + destination + "\n";
+    }
+    if (action == "OFF") {
+        if (!tap.running()) {
+            return "tap=off\n";
+        }
+        control.execute([&tap] { tap.disarm(); return std::string(); }, std::chrono::seconds(1));
+        std::string result = status();
+        tap.stop();
+        return result;
+    }
+    if (action == "STATUS") {
+        return status();
     }
+    throw std::invalid_argument("usage: TAP ON|OFF|STATUS");
+}
+
+void usage(const char* program, std::ostream& out) {
+    out << "Usage: " << program << " [event-log] [options]\n"
+        << "  --verdict-log PATH          append binary verdicts (VerdictLogReader format)\n"
+        << "  --flight-recorder PATH      per-second metric history\n"
+        << "  --watermark PATH            shared-memory progress for writers and monitors\n"
+        << "  --control-socket PATH       runtime commands (ledger_ctl)\n"
+        << "  --checkpoint PATH           incremental state checkpoints\n"
+        << "  --checkpoint-interval N     events between checkpoints (100000)\n"
+        << "  --cold-state PATH           spill cold trade state to PATH\n"
+        << "  --hot-trades N              trades kept in memory with --cold-state (1048576)\n"
+        << "  --postings PATH             maintain the per-account/symbol index\n"
+        << "  --run-to-completion         read and process on one thread\n"
+        << "  --cpu N                     pin the run-to-completion thread\n"
+        << "  --offload-budget-ns N       offload work above this per-event cost\n"
+        << "  --handoff-socket PATH       serve state to a successor binary (continuous\n"
+        << "                              queries and the tap are not carried over)\n"
+        << "  --takeover PATH             take over state from a running predecessor\n"
+        << "  --alloc-profile BYTES       sample one allocation per BYTES\n"
+        << "  --help                      show this help" << std::endl;
 }
 
 int main(int argc, char** argv) {
     // Parse command line arguments
     std::string log_path = "../data/event_log.bin";  // Default path
+    std::string verdict_log_path;                     // Empty = disabled
+    size_t alloc_profile_interval = 0;                // 0 = disabled
+    std::string flight_recorder_path;                 // Empty = disabled
+    std::string watermark_path;                       // Empty = disabled
+    std::string control_socket_path;                  // Empty = disabled
+    ConsumerCore::Config core_config;                 // Empty paths = disabled
+    RunToCompletionOptions rtc_options;               // Two-thread pipeline by default
+    std::string handoff_socket_path;                  // Empty = no upgrades served
+    std::string takeover_path;                        // Empty = fresh start
 
-    if (argc > 1) {
-        log_path = argv[1];
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--help") {
+                usage(argv[0], std::cout);
+                return 0;
+            } else if (arg == "--verdict-log") {
+                verdict_log_path = CommandLine::value(argc, argv, i);
+            } else if (arg == "--flight-recorder") {
+                flight_recorder_path = CommandLine::value(argc, argv, i);
+            } else if (arg == "--watermark") {
+                watermark_path = CommandLine::value(argc, argv, i);
+            } else if (arg == "--control-socket") {
+                control_socket_path = CommandLine::value(argc, argv, i);
+            } else if (arg == "--checkpoint") {
+                core_config.checkpoint_path = CommandLine::value(argc, argv, i);
+            } else if (arg == "--checkpoint-interval") {
+                core_config.checkpoint_interval = CommandLine::number<size_t>(argc, argv, i, 1);
+            } else if (arg == "--cold-state") {
+                core_config.cold_state_path = CommandLine::value(argc, argv, i);
+            } else if (arg == "--postings") {
+                core_config.postings_path = CommandLine::value(argc, argv, i);
+            } else if (arg == "--hot-trades") {
+                core_config.hot_trades = CommandLine::number<size_t>(argc, argv, i, 1);
+            } else if (arg == "--run-to-completion") {
+                rtc_options.enabled = true;
+            } else if (arg == "--cpu") {
+                rtc_options.cpu = CommandLine::number<int>(argc, argv, i, 0, CPU_SETSIZE - 1);
+            } else if (arg == "--offload-budget-ns") {
+                rtc_options.offload_budget_ns = CommandLine::number<uint64_t>(argc, argv, i);
+            } else if (arg == "--handoff-socket") {
+                handoff_socket_path = CommandLine::value(argc, argv, i);
+            } else if (arg == "--takeover") {
+                takeover_path = CommandLine::value(argc, argv, i);
+            } else if (arg == "--alloc-profile") {
+                alloc_profile_interval = CommandLine::number<size_t>(argc, argv, i);
+            } else if (arg.rfind("--", 0) == 0) {
+                throw std::invalid_argument("unknown option " + arg);
+            } else {
+                log_path = arg;
+            }
+        }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << argv[0] << ": " << e.what() << "\n";
+        usage(argv[0], std::cerr);
+        return 2;
     }
 
     std::cout << "Event Processor Starting..." << std::endl;
     std::cout << "Log path: " << log_path << std::endl;
 
-    // Set up signal handlers
-    signal(SIGINT, signalHandler);
-    signal(SIGTERM, signalHandler);
+    if (alloc_profile_interval > 0) {
+#ifdef TRADING_LEDGER_ALLOC_PROFILING
+        AllocationProfiler::enable(alloc_profile_interval);
+        std::cout << "Allocation profiling: 1 sample per " << alloc_profile_interval
+                  << " bytes" << std::endl;
+#else
+        std::cerr << "--alloc-profile ignored: rebuild with "
+                     "-DTRADING_LEDGER_ALLOC_PROFILING=ON" << std::endl;
+#endif
+    }
 
     // Create ring buffer and latency histogram
-    RingBuffer<Event, 4096> buffer;
+    EventRing buffer;
     LatencyHistogram latency_histogram;
 
-    // Atomic counters
-    std::atomic<size_t> events_read{0};
-    std::atomic<size_t> events_processed{0};
+    // Progress counters (compiled out below COUNTERS level)
+    PipelineMetrics metrics;
+
+    // Continuous queries and the event tap filter live on the consumer; the
+    // control socket reaches them through the handoff
+    ContinuousQueryEngine queries;
+    EventTap tap;
+    CommandHandoff control([&buffer] { buffer.wake(); });
+
+    // Outputs, control sockets and the binary upgrade: a file or socket that
+    // cannot be opened stops the process before any thread starts
+    std::unique_ptr<VerdictLogWriter> verdict_log;
+    std::unique_ptr<ProgressWatermark> watermark;
+    std::unique_ptr<FlightRecorder> recorder;
+    std::unique_ptr<ControlServer> control_server;
+    UpgradeHandoff upgrade(g_running);
+    std::unique_ptr<StateTakeover> takeover;
+    std::unique_ptr<StateHandoffServer> handoff_server;
+    try {
+        // Optional binary verdict stream for downstream consumers
+        if (!verdict_log_path.empty()) {
+            verdict_log = std::make_unique<VerdictLogWriter>(verdict_log_path);
+            verdict_log->open();
+            std::cout << "Verdict log: " << verdict_log_path << std::endl;
+        }
+
+        // Optional shared-memory progress for writers and monitors (ledger_watermark)
+        if (!watermark_path.empty()) {
+            watermark = std::make_unique<ProgressWatermark>(watermark_path);
+            watermark->open();
+            std::cout << "Progress watermark: " << watermark_path << std::endl;
+        }
+
+        if (!core_config.cold_state_path.empty()) {
+            std::cout << "Cold trade state: " << core_config.cold_state_path << " (beyond "
+                      << core_config.hot_trades << " hot trades)" << std::endl;
+        }
 
-    // Start threads
-    std::thread producer(producerThread, log_path, std::ref(buffer), std::ref(events_read));
-    std::thread consumer(consumerThread, std::ref(buffer), std::ref(events_processed), std::ref(latency_histogram));
-    std::thread monitor(monitorThread, std::ref(events_read), std::ref(events_processed));
+        // Optional on-disk history of per-second metrics (flight_recorder_inspect)
+        if (!flight_recorder_path.empty()) {
+            if constexpr (ProbeCounter::enabled()) {
+                recorder = std::make_unique<FlightRecorder>(flight_recorder_path);
+                recorder->open();
+                std::cout << "Flight recorder: " << flight_recorder_path
+                          << " (" << recorder->slotCount() << " slots)" << std::endl;
+            } else {
+                std::cerr << "--flight-recorder ignored: instrumentation level NONE "
+                             "has no counters to record" << std::endl;
+            }
+        }
+
+        if (!control_socket_path.empty()) {
+            control_server = std::make_unique<ControlServer>(
+                control_socket_path, [&](const std::string& request) -> std::string {
+                    std::istringstream in(request);
+                    std::string command;
+                    in >> command;
+                    if (command == "PING") {
+                        return "";
+                    }
+                    if (command == "STATS") {
+                        std::ostringstream out;
+                        out << "events_read=" << metrics.events_read.value()
+                            << " events_processed=" << metrics.events_processed.value()
+                            << " validation_failures=" << metrics.validation_failures.value()
+                            << " ring=" << buffer.size() << "/" << buffer.capacity() << "\n";
+                        return out.str();
+                    }
+                    if (command == "QUERY") {
+                        std::string rest;
+                        std::getline(in >> std::ws, rest);
+                        return control.execute([&queries, rest] { return queries.handle(rest); },
+                                               std::chrono::seconds(1));
+                    }
+                    if (command == "TAP") {
+                        return handleTap(in, tap, control);
+                    }
+                    throw std::invalid_argument("unknown command (PING, STATS, QUERY, TAP)");
+                });
+            control_server->start();
+            std::cout << "Control socket: " << control_socket_path << std::endl;
+        }
+
+        // Binary upgrade: everything above is set up before the predecessor is
+        // asked to stop, so the gap covers only the state transfer
+        if (!takeover_path.empty()) {
+            try {
+                takeover = std::make_unique<StateTakeover>(takeover_path, std::chrono::seconds(30));
+            } catch (const std::exception& e) {
+                std::cerr << "Takeover failed: " << e.what() << std::endl;
+                return 1;
+            }
+            upgrade.takeover = takeover.get();
+        }
+        if (!handoff_socket_path.empty()) {
+            handoff_server = std::make_unique<StateHandoffServer>(handoff_socket_path, [&buffer] {
+                std::cout << "\nTakeover requested, handing off..." << std::endl;
+                buffer.wake();   // Stops the pipeline through UpgradeHandoff::stopping()
+            });
+            handoff_server->start();
+            upgrade.server = handoff_server.get();
+            std::cout << "Handoff socket: " << handoff_socket_path << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Set up signal handlers
+    signal(SIGINT, signalHandler);
+    signal(SIGTERM, signalHandler);
+
+    // Start threads: producer + consumer, or one run-to-completion thread
+    // (plus its offload worker when a budget is set)
+    std::thread producer;
+    std::thread consumer;
+    OffloadHandoff handoff;
+    if (rtc_options.enabled) {
+        std::cout << "Run-to-completion: one thread reads and processes inline";
+        if (rtc_options.cpu >= 0) {
+            std::cout << ", pinned to cpu " << rtc_options.cpu;
+        }
+        if (rtc_options.offload_budget_ns > 0) {
+            std::cout << ", offload above " << rtc_options.offload_budget_ns << " ns/event";
+        }
+        std::cout << std::endl;
+        producer = std::thread(runToCompletionThread, log_path, std::ref(buffer), std::ref(handoff),
+                               std::cref(core_config), std::ref(metrics), std::ref(latency_histogram),
+                               verdict_log.get(), watermark.get(), std::ref(queries), std::ref(tap),
+                               std::ref(control), std::cref(rtc_options), std::ref(upgrade));
+        if (rtc_options.offload_budget_ns > 0) {
+            consumer = std::thread(offloadWorker, std::ref(buffer), std::ref(handoff), std::ref(g_running));
+        }
+    } else {
+        producer = std::thread(producerThread, log_path, std::ref(buffer), std::ref(metrics),
+                               std::ref(upgrade));
+        consumer = std::thread(consumerThread, std::ref(buffer), std::cref(core_config),
+                               std::ref(metrics), std::ref(latency_histogram), verdict_log.get(),
+                               watermark.get(), std::ref(queries), std::ref(tap), std::ref(control),
+                               std::ref(upgrade));
+    }
+    std::thread monitor;
+    if constexpr (ProbeCounter::enabled()) {
+        monitor = std::thread(monitorThread, std::ref(metrics), std::cref(buffer),
+                              verdict_log.get(), recorder.get());
+    }
 
     // Wait for threads to complete
     producer.join();
-    consumer.join();
+    handoff.exit.store(true, std::memory_order_release);
+    buffer.wake();
+    if (consumer.joinable()) {
+        consumer.join();
+    }
 
     g_running.store(false, std::memory_order_release);
-    monitor.join();
+    if (monitor.joinable()) {
+        monitor.join();
+    }
+    if (control_server) {
+        control_server->stop();
+    }
+    if (handoff_server) {
+        handoff_server->stop();
+    }
+    if (upgrade.log_fd >= 0) {
+        close(upgrade.log_fd);
+    }
 
     std::cout << "\nEvent Processor Shutdown Complete" << std::endl;
-    std::cout << "Total events read: " << events_read.load() << std::endl;
-    std::cout << "Total events processed: " << events_processed.load() << std::endl;
+    if constexpr (ProbeCounter::enabled()) {
+        std::cout << "Total events read: " << metrics.events_read.value() << std::endl;
+        std::cout << "Total events processed: " << metrics.events_processed.value() << std::endl;
+    }
+
+    if (verdict_log) {
+        verdict_log->close();
+        std::cout << "Verdicts written: " << verdict_log->written()
+                  << " (dropped: " << verdict_log->dropped()
+                  << ", stalled submits: " << verdict_log->stalls() << ")" << std::endl;
+        if (verdict_log->failed()) {
+            std::cerr << "Verdict log failed: " << verdict_log->error() << std::endl;
+        }
+    }
+
+    if (AllocationProfiler::enabled()) {
+        AllocationProfiler::report();
+        AllocationProfiler::disable();
+    }
 
     return 0;
 }
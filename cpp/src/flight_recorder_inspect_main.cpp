@@ -0,0 +1,132 @@
+#include "FlightRecorder.h"
+#include "CommandLine.h"
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace trading_ledger;
+
+/**
+ * Print the contents of an event_processor flight recorder file
+ *
+ * Usage: flight_recorder_inspect <file> [--last N] [--csv]
+ *
+ * Rates are derived from consecutive snapshots; works on a live file and
+ * on the file left behind by a crashed process.
+ */
+
+namespace {
+
+std::string formatTime(uint64_t timestamp_ns) {
+    std::time_t seconds = static_cast<std::time_t>(timestamp_ns / 1000000000ULL);
+    std::tm tm{};
+    gmtime_r(&seconds, &tm);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    return buffer;
+}
+
+uint64_t ratePerSecond(const MetricSnapshot& current, const MetricSnapshot* previous,
+                       uint64_t MetricSnapshot::*counter) {
+    if (previous == nullptr || current.timestamp_ns <= previous->timestamp_ns ||
+        current.*counter < previous->*counter) {
+        return 0;
+    }
+    double seconds = static_cast<double>(current.timestamp_ns - previous->timestamp_ns) / 1e9;
+    return static_cast<uint64_t>(static_cast<double>(current.*counter - previous->*counter) / seconds);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string path;
+    size_t last = 0;  // 0 = all
+    bool csv = false;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--last" && i + 1 < argc) {
+                last = CommandLine::parse<size_t>(arg, argv[++i]);
+            } else if (arg == "--csv") {
+                csv = true;
+            } else {
+                path = arg;
+            }
+        }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << argv[0] << ": " << e.what() << std::endl;
+        return 2;
+    }
+
+    if (path.empty()) {
+        std::cerr << "Usage: " << argv[0] << " <flight-recorder-file> [--last N] [--csv]" << std::endl;
+        return 2;
+    }
+
+    std::vector<MetricSnapshot> snapshots;
+    try {
+        snapshots = readFlightRecorder(path);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    size_t first = (last > 0 && snapshots.size() > last) ? snapshots.size() - last : 0;
+
+    if (csv) {
+        std::printf("index,timestamp_ns,events_read,events_processed,read_rate,process_rate,"
+                    "validation_failures,verdicts_dropped,ring_occupancy,ring_capacity,lag_events,"
+                    "interval_count,p50_ns,p99_ns,p999_ns,max_ns\n");
+    } else {
+        std::printf("%-8s %-20s %12s %12s %10s %10s %8s %8s %8s %10s %10s %10s %10s\n",
+                    "index", "time (UTC)", "read", "processed", "read/s", "proc/s",
+                    "ring", "lag", "failed", "p50 (us)", "p99 (us)", "p99.9 (us)", "max (us)");
+    }
+
+    for (size_t i = first; i < snapshots.size(); ++i) {
+        const MetricSnapshot& s = snapshots[i];
+        // Rates only across adjacent records (a gap means the recorder restarted)
+        const MetricSnapshot* previous =
+            (i > 0 && snapshots[i - 1].index + 1 == s.index) ? &snapshots[i - 1] : nullptr;
+        uint64_t read_rate = ratePerSecond(s, previous, &MetricSnapshot::events_read);
+        uint64_t process_rate = ratePerSecond(s, previous, &MetricSnapshot::events_processed);
+
+        if (csv) {
+            std::printf("%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%u,%u,%llu,%llu,%lld,%lld,%lld,%lld\n",
+                        static_cast<unsigned long long>(s.index),
+                        static_cast<unsigned long long>(s.timestamp_ns),
+                        static_cast<unsigned long long>(s.events_read),
+                        static_cast<unsigned long long>(s.events_processed),
+                        static_cast<unsigned long long>(read_rate),
+                        static_cast<unsigned long long>(process_rate),
+                        static_cast<unsigned long long>(s.validation_failures),
+                        static_cast<unsigned long long>(s.verdicts_dropped),
+                        s.ring_occupancy, s.ring_capacity,
+                        static_cast<unsigned long long>(s.lag_events),
+                        static_cast<unsigned long long>(s.interval_count),
+                        static_cast<long long>(s.p50_ns), static_cast<long long>(s.p99_ns),
+                        static_cast<long long>(s.p999_ns), static_cast<long long>(s.max_ns));
+        } else {
+            std::printf("%-8llu %-20s %12llu %12llu %10llu %10llu %8u %8llu %8llu %10.1f %10.1f %10.1f %10.1f\n",
+                        static_cast<unsigned long long>(s.index),
+                        formatTime(s.timestamp_ns).c_str(),
+                        static_cast<unsigned long long>(s.events_read),
+                        static_cast<unsigned long long>(s.events_processed),
+                        static_cast<unsigned long long>(read_rate),
+                        static_cast<unsigned long long>(process_rate),
+                        s.ring_occupancy,
+                        static_cast<unsigned long long>(s.lag_events),
+                        static_cast<unsigned long long>(s.validation_failures),
+                        s.p50_ns / 1000.0, s.p99_ns / 1000.0,
+                        s.p999_ns / 1000.0, s.max_ns / 1000.0);
+        }
+    }
+
+    if (!csv) {
+        std::printf("%zu snapshot(s)\n", snapshots.size() - first);
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+/**
+ * Send one request to an event processor's control socket
+ *
+ * Usage: ledger_ctl <socket> <request...>
+ *   ledger_ctl /tmp/ledger.sock STATS
+ *   ledger_ctl /tmp/ledger.sock QUERY ADD nvda "sum(quantity) where symbol=NVDA by account_id"
+ *   ledger_ctl /tmp/ledger.sock QUERY GET nvda
+ *
+ * Prints the response body; exit status 1 on "ERR".
+ */
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <socket> <request...>" << std::endl;
+        return 2;
+    }
+
+    std::string request;
+    for (int i = 2; i < argc; ++i) {
+        request += (i > 2 ? " " : "");
+        request += argv[i];
+    }
+    request += '\n';
+
+    sockaddr_un addr{};
+    std::string path = argv[1];
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Socket path too long: " << path << std::endl;
+        return 2;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::cerr << "Failed to connect to " << path << ": " << strerror(errno) << std::endl;
+        return 1;
+    }
+    if (write(fd, request.data(), request.size()) != static_cast<ssize_t>(request.size())) {
+        std::cerr << "Failed to send request: " << strerror(errno) << std::endl;
+        close(fd);
+        return 1;
+    }
+
+    // Read lines until the status line ("OK" or "ERR ...")
+    std::string buffer;
+    char chunk[4096];
+    int status = 1;
+    bool finished = false;
+    while (!finished) {
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n <= 0) {
+            std::cerr << "Connection closed before a status line" << std::endl;
+            break;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+        size_t newline;
+        while ((newline = buffer.find('\n')) != std::string::npos) {
+            std::string line = buffer.substr(0, newline);
+            buffer.erase(0, newline + 1);
+            if (line == "OK") {
+                status = 0;
+                finished = true;
+                break;
+            }
+            if (line.rfind("ERR", 0) == 0) {
+                std::cerr << line << std::endl;
+                finished = true;
+                break;
+            }
+            std::cout << line << "\n";
+        }
+    }
+    std::cout << std::flush;
+    close(fd);
+    return status;
+}
@@ -0,0 +1,118 @@
+#include "Pipeline.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace trading_ledger;
+
+/**
+ * Config-driven pipeline runner
+ *
+ * Usage: ledger_pipeline [--topology FILE] [--print] <event-log>
+ *   Without --topology the event_processor shape is used (source ->
+ *   validate -> balances). --print writes the effective topology and exits.
+ */
+
+static std::atomic<bool> g_running{true};
+
+void signalHandler(int signal) {
+    if (signal == SIGINT || signal == SIGTERM) {
+        g_running.store(false, std::memory_order_release);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string topology_path;
+    std::string log_path;
+    bool print_only = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--topology" && i + 1 < argc) {
+            topology_path = argv[++i];
+        } else if (arg == "--print") {
+            print_only = true;
+        } else if (log_path.empty() && arg.rfind("--", 0) != 0) {
+            log_path = arg;
+        } else {
+            log_path.clear();
+            break;
+        }
+    }
+    if (log_path.empty() && !print_only) {
+        std::cerr << "Usage: " << argv[0] << " [--topology FILE] [--print] <event-log>" << std::endl;
+        return 2;
+    }
+
+    TopologyConfig topology;
+    try {
+        topology = topology_path.empty() ? TopologyConfig::defaultTopology()
+                                         : TopologyConfig::load(topology_path);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << topology_path << ": " << e.what() << std::endl;
+        return 1;
+    }
+    if (print_only) {
+        topology.write(std::cout);
+        return 0;
+    }
+
+    unsigned interval = topology.monitor_interval_seconds;
+    Pipeline pipeline(std::move(topology), log_path);
+    std::cout << "Pipeline: " << pipeline.config().nodes.size() << " nodes, log " << log_path << std::endl;
+
+    signal(SIGINT, signalHandler);
+    signal(SIGTERM, signalHandler);
+
+    auto start_time = std::chrono::steady_clock::now();
+    try {
+        pipeline.start();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Monitor: per-node progress and ring occupancy every interval
+    unsigned ticks = 0;
+    while (!pipeline.finished()) {
+        if (!g_running.load(std::memory_order_acquire)) {
+            pipeline.stop();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (interval == 0 || ++ticks % (interval * 10) != 0) {
+            continue;
+        }
+        for (const auto& s : pipeline.stats()) {
+            std::cout << "[Monitor] " << s.name << ": " << s.events << " events";
+            if (s.capacity > 0) {
+                std::cout << ", queued " << s.queued << "/" << s.capacity;
+            }
+            if (s.active_workers != s.workers) {
+                std::cout << ", workers " << s.active_workers << "/" << s.workers;
+            }
+            if (s.failures > 0) {
+                std::cout << ", " << s.failures << " failed";
+            }
+            std::cout << std::endl;
+        }
+    }
+    pipeline.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    uint64_t source_events = 0;
+    bool failed = false;
+    for (const auto& s : pipeline.stats()) {
+        if (s.kind == NodeKind::SOURCE) {
+            source_events += s.events;
+        }
+        failed = failed || !s.error.empty();
+    }
+    pipeline.report();
+    std::cout << "\n" << source_events << " events in " << seconds << " s ("
+              << static_cast<uint64_t>(source_events / std::max(seconds, 1e-9)) << " events/sec)" << std::endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,131 @@
+#include "PostingsLogIndex.h"
+#include "EventParser.h"
+#include "MappedLog.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using namespace trading_ledger;
+
+namespace {
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program << " <event-log> update [--index PATH]\n"
+              << "       " << program << " <event-log> history (--account ACCOUNT | --symbol SYMBOL)"
+              << " [--account ACCOUNT] [--symbol SYMBOL] [--index PATH] [--count]" << std::endl;
+}
+
+// The saved index if it still describes this log (it is then extended to
+// the end of the log), else one rebuilt from the start
+PostingsLogIndex loadIndex(const std::string& path, const MappedLog& log, size_t* indexed) {
+    PostingsLogIndex index;
+    bool usable = index.load(path) && index.scannedOffset() <= log.size();
+    if (usable && index.framesScanned() > 0) {
+        uint64_t last = index.lastOffset();
+        usable = last + 28 <= log.size() &&
+                 EventParser::readUint64LE(log.data() + last) == index.lastSequence();
+    }
+    if (!usable) {
+        index = PostingsLogIndex();   // Log replaced or index damaged
+    }
+    *indexed = index.extend(log.data(), log.size());
+    return index;
+}
+
+}  // namespace
+
+/**
+ * Per-account / per-symbol event history through the postings index
+ *
+ * "update" extends <log>.pidx (or --index) to the end of the log; so does
+ * every query, which also saves the index if it grew. "history" prints the
+ * events of an account, a symbol, or an account in a symbol (intersection),
+ * reading only those frames. event_processor --postings maintains the same
+ * file during ingestion.
+ */
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        usage(argv[0]);
+        return 2;
+    }
+    std::string log_path = argv[1];
+    std::string command = argv[2];
+    std::string index_path = log_path + ".pidx";
+    std::string account;
+    std::string symbol;
+    bool count_only = false;
+
+    if (command != "update" && command != "history") {
+        usage(argv[0]);
+        return 2;
+    }
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--index" && i + 1 < argc) {
+            index_path = argv[++i];
+        } else if (arg == "--account" && i + 1 < argc) {
+            account = argv[++i];
+        } else if (arg == "--symbol" && i + 1 < argc) {
+            symbol = argv[++i];
+        } else if (arg == "--count") {
+            count_only = true;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (command == "history" && account.empty() && symbol.empty()) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        MappedLog log(log_path);
+        size_t indexed = 0;
+        PostingsLogIndex index = loadIndex(index_path, log, &indexed);
+        if (indexed > 0) {
+            index.save(index_path);
+        }
+        double index_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        if (command == "update") {
+            std::cout << "Frames indexed:  +" << indexed << " (" << index.framesScanned() << " total)\n"
+                      << "Accounts:        " << index.keyCount(PostingsLogIndex::Field::ACCOUNT) << "\n"
+                      << "Symbols:         " << index.keyCount(PostingsLogIndex::Field::SYMBOL) << "\n"
+                      << "Postings:        " << index.postingCount() << " in "
+                      << index.compressedBytes() << " bytes\n"
+                      << "Time:            " << index_ms << " ms" << std::endl;
+            return 0;
+        }
+
+        start = std::chrono::steady_clock::now();
+        std::vector<uint64_t> offsets =
+            account.empty() ? index.postings(PostingsLogIndex::Field::SYMBOL, symbol)
+            : symbol.empty() ? index.postings(PostingsLogIndex::Field::ACCOUNT, account)
+                             : index.intersect(account, symbol);
+        size_t bytes_read = 0;
+        for (uint64_t offset : offsets) {
+            EventView event = EventParser::parseView(log.data() + offset, log.size() - offset);
+            bytes_read += event.totalSize();
+            if (!count_only) {
+                std::cout << event.sequence_num << " " << event.timestamp_ns << " "
+                          << static_cast<int>(event.event_type) << " " << event.payload << "\n";
+            }
+        }
+        if (count_only) {
+            std::cout << offsets.size() << "\n";
+        }
+        std::cout << std::flush;
+
+        std::cerr << offsets.size() << " events, " << bytes_read << " of " << log.size()
+                  << " log bytes read in "
+                  << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+                  << " ms (index: +" << indexed << " frames in " << index_ms << " ms)" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Postings query failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "ReplayEngine.h"
+#include "CommandLine.h"
+#include "FixedPoint.h"
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace trading_ledger;
+
+namespace {
+
+int64_t parseLimit(const std::string& text) {
+    int64_t value = 0;
+    if (!FixedPoint::parse(text, value) || value <= 0) {
+        throw std::invalid_argument("invalid limit: " + text);
+    }
+    return value;
+}
+
+// NAME[:max_quantity=X,max_notional=Y,no_duplicates]
+std::unique_ptr<ReplayConsumer> parseValidatorSpec(const std::string& spec) {
+    size_t colon = spec.find(':');
+    std::string name = spec.substr(0, colon);
+    DoubleEntryValidator::Config config;
+    if (colon != std::string::npos) {
+        std::istringstream options(spec.substr(colon + 1));
+        std::string option;
+        while (std::getline(options, option, ',')) {
+            size_t eq = option.find('=');
+            std::string key = option.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : option.substr(eq + 1);
+            if (key == "max_quantity") {
+                config.max_quantity = parseLimit(value);
+            } else if (key == "max_notional") {
+                config.max_notional = parseLimit(value);
+            } else if (key == "no_duplicates") {
+                config.detect_duplicates = false;
+            } else {
+                throw std::invalid_argument("unknown validator option: " + option);
+            }
+        }
+    }
+    if (name.empty()) {
+        throw std::invalid_argument("validator needs a name: " + spec);
+    }
+    return std::make_unique<ValidatorReplayConsumer>(name, config);
+}
+
+}  // namespace
+
+/**
+ * What-if replay of a historical event log: one scan, many configurations
+ *
+ * Usage: ledger_replay <event-log> [--batch N] [--no-verify]
+ *                      [--validator NAME[:max_quantity=X,max_notional=Y,no_duplicates]]...
+ *                      [--balance-book NAME]...
+ *
+ * Limits are decimal (e.g. max_notional=1000000). Without any configuration
+ * the log is replayed through one default validator.
+ */
+int main(int argc, char** argv) {
+    std::string log_path;
+    ReplayEngine::Config config;
+    std::vector<std::unique_ptr<ReplayConsumer>> consumers;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--batch" && i + 1 < argc) {
+                config.batch_size = CommandLine::parse<size_t>(arg, argv[++i], 1);
+            } else if (arg == "--no-verify") {
+                config.verify_crc = false;
+            } else if (arg == "--validator" && i + 1 < argc) {
+                consumers.push_back(parseValidatorSpec(argv[++i]));
+            } else if (arg == "--balance-book" && i + 1 < argc) {
+                consumers.push_back(std::make_unique<BalanceBookReplayConsumer>(argv[++i]));
+            } else {
+                log_path = arg;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Bad argument: " << e.what() << std::endl;
+        return 2;
+    }
+
+    if (log_path.empty()) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <event-log> [--batch N] [--no-verify]"
+                  << " [--validator NAME[:max_quantity=X,max_notional=Y,no_duplicates]]..."
+                  << " [--balance-book NAME]..." << std::endl;
+        return 2;
+    }
+
+    ReplayEngine engine(config);
+    if (consumers.empty()) {
+        consumers.push_back(std::make_unique<ValidatorReplayConsumer>(
+            "default", DoubleEntryValidator::Config{}));
+    }
+    for (auto& consumer : consumers) {
+        engine.addConsumer(std::move(consumer));
+    }
+
+    ReplayEngine::Stats stats;
+    try {
+        stats = engine.run(log_path);
+    } catch (const std::exception& e) {
+        std::cerr << "Replay failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    int status = 0;
+    for (size_t i = 0; i < engine.consumers().size(); ++i) {
+        const ReplayEngine::ConsumerStats& consumer_stats = stats.consumers[i];
+        if (!consumer_stats.error.empty()) {
+            std::cout << "[" << consumer_stats.name << "] FAILED: " << consumer_stats.error << "\n";
+            status = 1;
+            continue;
+        }
+        engine.consumers()[i]->report(std::cout);
+    }
+    std::cout << std::flush;
+
+    std::cerr << "Events:      " << stats.events << " in " << stats.batches << " batches\n"
+              << "Scan:        " << stats.scan_seconds * 1000 << " ms (once)\n";
+    for (const auto& consumer_stats : stats.consumers) {
+        std::cerr << "  " << consumer_stats.name << ": "
+                  << consumer_stats.busy_seconds * 1000 << " ms busy\n";
+    }
+    std::cerr << "Total:       " << stats.total_seconds * 1000 << " ms" << std::endl;
+    return status;
+}
@@ -0,0 +1,273 @@
+#include "trading_ledger_c.h"
+#include "DoubleEntryValidator.h"
+#include "EventParser.h"
+#include "LedgerEntryDecoder.h"
+#include "TradeBatchBuilder.h"
+#include <cstdio>
+#include <exception>
+#include <new>
+
+using namespace trading_ledger;
+
+// Opaque handle behind tl_validator*
+struct tl_validator {
+    DoubleEntryValidator validator;
+};
+
+namespace {
+
+// Frame overhead: 24-byte header + 4-byte CRC32
+constexpr size_t FRAME_OVERHEAD = 28;
+
+// Fixed buffer: recording an error must not allocate (or throw)
+thread_local char t_last_error[256] = "";
+
+tl_status fail(tl_status status, const char* message) {
+    std::snprintf(t_last_error, sizeof(t_last_error), "%s", message);
+    return status;
+}
+
+// Map any C++ exception to a status code (nothing may unwind into C)
+tl_status failFromException() {
+    try {
+        throw;
+    } catch (const CorruptedEventException& e) {
+        return fail(TL_ERR_CORRUPTED, e.what());
+    } catch (const ParseException& e) {
+        return fail(TL_ERR_TRUNCATED, e.what());
+    } catch (const std::bad_alloc&) {
+        return fail(TL_ERR_OUT_OF_MEMORY, "out of memory");
+    } catch (const std::exception& e) {
+        return fail(TL_ERR_INTERNAL, e.what());
+    } catch (...) {
+        return fail(TL_ERR_INTERNAL, "unknown error");
+    }
+}
+
+EventView toView(const tl_event& event) {
+    EventView view;
+    view.sequence_num = event.sequence_num;
+    view.timestamp_ns = event.timestamp_ns;
+    view.event_type = static_cast<EventType>(event.event_type);
+    view.payload = std::string_view(event.payload, event.payload_length);
+    view.crc32 = 0;
+    return view;
+}
+
+void toC(const EventView& view, tl_event* out) {
+    out->sequence_num = view.sequence_num;
+    out->timestamp_ns = view.timestamp_ns;
+    out->payload = view.payload.data();
+    out->payload_length = static_cast<uint32_t>(view.payload.size());
+    out->event_type = static_cast<uint8_t>(view.event_type);
+    out->reserved[0] = out->reserved[1] = out->reserved[2] = 0;
+}
+
+void toC(uint64_t sequence_num, const Verdict& verdict, tl_verdict* out) {
+    out->sequence_num = sequence_num;
+    out->code = static_cast<uint8_t>(verdict.code);
+    out->rule = static_cast<uint8_t>(verdict.rule);
+    for (uint8_t& byte : out->reserved) {
+        byte = 0;
+    }
+}
+
+// Length of the complete frame at data, or 0 if the buffer ends inside it
+size_t frameLength(const uint8_t* data, size_t length) {
+    if (length < FRAME_OVERHEAD) {
+        return 0;
+    }
+    size_t total = FRAME_OVERHEAD + EventParser::readUint32LE(data + 20);
+    return length < total ? 0 : total;
+}
+
+}  // namespace
+
+extern "C" {
+
+uint32_t tl_abi_version(void) {
+    return TL_ABI_VERSION;
+}
+
+const char* tl_status_string(tl_status status) {
+    switch (status) {
+        case TL_OK: return "ok";
+        case TL_ERR_INVALID_ARGUMENT: return "invalid argument";
+        case TL_ERR_TRUNCATED: return "truncated event";
+        case TL_ERR_CORRUPTED: return "corrupted event";
+        case TL_ERR_MALFORMED: return "malformed payload";
+        case TL_ERR_CAPACITY: return "output capacity exceeded";
+        case TL_ERR_OUT_OF_MEMORY: return "out of memory";
+        case TL_ERR_INTERNAL: return "internal error";
+        default: return "unknown status";
+    }
+}
+
+const char* tl_last_error(void) {
+    return t_last_error;
+}
+
+tl_status tl_parse_event(const uint8_t* data, size_t length,
+                         tl_event* out, size_t* consumed) {
+    if (data == nullptr || out == nullptr || consumed == nullptr) {
+        return fail(TL_ERR_INVALID_ARGUMENT, "null argument");
+    }
+    // Checked up front: a partial frame is expected at a buffer boundary
+    // and should not cost an exception
+    if (frameLength(data, length) == 0) {
+        return fail(TL_ERR_TRUNCATED, "buffer ends inside an event frame");
+    }
+    try {
+        EventView view = EventParser::parseView(data, length);
+        toC(view, out);
+        *consumed = view.totalSize();
+        return TL_OK;
+    } catch (...) {
+        return failFromException();
+    }
+}
+
+tl_status tl_decode_ledger_entries(const char* payload, size_t payload_length,
+                                   tl_ledger_entry* entries, size_t capacity,
+                                   size_t* count) {
+    if (payload == nullptr || count == nullptr || (entries == nullptr && capacity > 0)) {
+        return fail(TL_ERR_INVALID_ARGUMENT, "null argument");
+    }
+    size_t n = 0;
+    int decoded = LedgerEntryDecoder::forEachEntry(
+        std::string_view(payload, payload_length), [&](const LedgerEntryRecord& record) {
+            if (n < capacity) {
+                tl_ledger_entry& entry = entries[n];
+                entry.account_id = record.account_id.data();
+                entry.account_id_length = static_cast<uint32_t>(record.account_id.size());
+                entry.is_debit = record.is_debit ? 1 : 0;
+                entry.reserved[0] = entry.reserved[1] = entry.reserved[2] = 0;
+                entry.amount = record.amount;
+            }
+            n++;
+        });
+    if (decoded < 0) {
+        *count = 0;
+        return fail(TL_ERR_MALFORMED, "malformed ledger entries payload");
+    }
+    *count = n;
+    if (n > capacity) {
+        return fail(TL_ERR_CAPACITY, "more entries than output capacity");
+    }
+    return TL_OK;
+}
+
+tl_status tl_validator_create(tl_validator** out) {
+    if (out == nullptr) {
+        return fail(TL_ERR_INVALID_ARGUMENT, "null argument");
+    }
+    *out = nullptr;
+    try {
+        auto* validator = new tl_validator();
+        // Verdicts are returned to the caller; keep the host's stdout/stderr clean
+        validator->validator.setLogging(false);
+        *out = validator;
+        return TL_OK;
+    } catch (...) {
+        return failFromException();
+    }
+}
+
+tl_status tl_decode_trades_arrow(const tl_event* events, size_t count,
+                                 struct ArrowArray* array, struct ArrowSchema* schema) {
+    if (array == nullptr || schema == nullptr || (count > 0 && events == nullptr)) {
+        return fail(TL_ERR_INVALID_ARGUMENT, "null argument");
+    }
+    try {
+        TradeBatchBuilder builder(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (events[i].payload == nullptr && events[i].payload_length > 0) {
+                return fail(TL_ERR_INVALID_ARGUMENT, "null payload with non-zero length");
+            }
+            builder.append(toView(events[i]));
+        }
+        builder.finish(array, schema);
+        return TL_OK;
+    } catch (...) {
+        return failFromException();
+    }
+}
+
+void tl_validator_destroy(tl_validator* validator) {
+    delete validator;
+}
+
+tl_status tl_validate_event(tl_validator* validator, const tl_event* event,
+                            tl_verdict* verdict) {
+    return tl_validate_batch(validator, event, 1, verdict);
+}
+
+tl_status tl_validate_batch(tl_validator* validator, const tl_event* events,
+                            size_t count, tl_verdict* verdicts) {
+    if (validator == nullptr || (count > 0 && (events == nullptr || verdicts == nullptr))) {
+        return fail(TL_ERR_INVALID_ARGUMENT, "null argument");
+    }
+    // Checked up front: a bad event must not leave the batch half applied
+    for (size_t i = 0; i < count; ++i) {
+        if (events[i].payload == nullptr && events[i].payload_length > 0) {
+            return fail(TL_ERR_INVALID_ARGUMENT, "null payload with non-zero length");
+        }
+    }
+    try {
+        for (size_t i = 0; i < count; ++i) {
+            Verdict verdict = validator->validator.processEvent(toView(events[i]));
+            toC(events[i].sequence_num, verdict, &verdicts[i]);
+        }
+        return TL_OK;
+    } catch (...) {
+        return failFromException();
+    }
+}
+
+tl_status tl_validate_frames(tl_validator* validator,
+                             const uint8_t* data, size_t length,
+                             tl_verdict* verdicts, size_t capacity,
+                             size_t* verdict_count, size_t* bytes_consumed) {
+    if (validator == nullptr || verdict_count == nullptr || bytes_consumed == nullptr ||
+        (length > 0 && data == nullptr) || (capacity > 0 && verdicts == nullptr)) {
+        return fail(TL_ERR_INVALID_ARGUMENT, "null argument");
+    }
+    *verdict_count = 0;
+    *bytes_consumed = 0;
+
+    try {
+        size_t offset = 0;
+        size_t n = 0;
+        while (n < capacity) {
+            size_t frame = frameLength(data + offset, length - offset);
+            if (frame == 0) {
+                break;  // End of data or truncated trailing frame
+            }
+            EventView view = EventParser::parseView(data + offset, frame);
+            toC(view.sequence_num, validator->validator.processEvent(view), &verdicts[n]);
+            offset += frame;
+            n++;
+            *verdict_count = n;
+            *bytes_consumed = offset;
+        }
+        return TL_OK;
+    } catch (...) {
+        return failFromException();
+    }
+}
+
+tl_status tl_validator_get_stats(const tl_validator* validator,
+                                 tl_validator_stats* stats) {
+    if (validator == nullptr || stats == nullptr) {
+        return fail(TL_ERR_INVALID_ARGUMENT, "null argument");
+    }
+    DoubleEntryValidator::Stats s = validator->validator.getStats();
+    stats->events_processed = s.events_processed;
+    stats->trades_validated = s.trades_validated;
+    stats->validation_errors = s.validation_errors;
+    stats->duplicate_trades = s.duplicate_trades;
+    stats->tracked_trades = validator->validator.tradeCount();
+    return TL_OK;
+}
+
+}  // extern "C"
@@ -0,0 +1,91 @@
+#include "ProgressWatermark.h"
+#include "CommandLine.h"
+#include <sys/stat.h>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace trading_ledger;
+
+/**
+ * Print how far an event_processor has got (event_processor --watermark)
+ *
+ * Usage: ledger_watermark <watermark-file> [--log <event-log>] [--watch MS]
+ *
+ * With --log, also prints how many bytes of the log are still unconsumed.
+ * Reads the shared-memory watermark only: the processor is never asked.
+ */
+
+namespace {
+
+uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+double ageMs(uint64_t then_ns, uint64_t now_ns) {
+    return then_ns == 0 || then_ns > now_ns ? 0.0 : static_cast<double>(now_ns - then_ns) / 1e6;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string path;
+    std::string log_path;
+    int watch_ms = 0;   // 0 = print once
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--log" && i + 1 < argc) {
+                log_path = argv[++i];
+            } else if (arg == "--watch" && i + 1 < argc) {
+                watch_ms = CommandLine::parse<int>(arg, argv[++i], 0);
+            } else {
+                path = arg;
+            }
+        }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << argv[0] << ": " << e.what() << std::endl;
+        return 2;
+    }
+
+    if (path.empty()) {
+        std::cerr << "Usage: " << argv[0] << " <watermark-file> [--log <event-log>] [--watch MS]"
+                  << std::endl;
+        return 2;
+    }
+
+    try {
+        WatermarkReader reader(path);
+        std::printf("pid %u, publishing since %.1f s ago\n", reader.pid(),
+                    ageMs(reader.startedNs(), nowNs()) / 1000.0);
+        while (true) {
+            WatermarkProgress progress = reader.read();
+            uint64_t now = nowNs();
+            std::printf("sequence %llu  offset %llu  event age %.3f ms  updated %.3f ms ago",
+                        static_cast<unsigned long long>(progress.sequence),
+                        static_cast<unsigned long long>(progress.offset),
+                        ageMs(progress.event_timestamp_ns, now), ageMs(progress.published_ns, now));
+            struct stat st;
+            if (!log_path.empty() && stat(log_path.c_str(), &st) == 0) {
+                uint64_t size = static_cast<uint64_t>(st.st_size);
+                std::printf("  behind %llu bytes",
+                            static_cast<unsigned long long>(size > progress.offset ? size - progress.offset : 0));
+            }
+            std::printf("\n");
+            if (watch_ms <= 0) {
+                break;
+            }
+            std::fflush(stdout);
+            std::this_thread::sleep_for(std::chrono::milliseconds(watch_ms));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "ByteOrder.h"
+#include "Event.h"
+#include "EventParser.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace trading_ledger::test {
+
+/**
+ * Append one framed event (24-byte header, payload, CRC32) to a log image.
+ * Timestamps are sequence * 1000 so time targets are easy to reason about.
+ */
+inline void appendFrame(std::vector<uint8_t>& log, uint64_t seq, EventType type, const std::string& payload) {
+    size_t at = log.size();
+    log.reserve(at + 28 + payload.size());
+    appendUint64LE(log, seq);
+    appendUint64LE(log, seq * 1000);
+    appendUint32LE(log, static_cast<uint8_t>(type));   // Type byte, then 3 reserved
+    appendUint32LE(log, static_cast<uint32_t>(payload.size()));
+    log.insert(log.end(), payload.begin(), payload.end());
+    appendUint32LE(log, EventParser::calculateCRC32(log.data() + at, log.size() - at));
+}
+
+inline std::vector<uint8_t> frameEvent(uint64_t seq, EventType type, const std::string& payload) {
+    std::vector<uint8_t> frame;
+    appendFrame(frame, seq, type, payload);
+    return frame;
+}
+
+/**
+ * Create (or truncate) an event log holding just the 16-byte file header
+ */
+inline void createLog(const std::string& path) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    uint8_t header[16] = {0x44, 0x41, 0x52, 0x54, 0x01};  // "TRAD", version 1
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+}
+
+}  // namespace trading_ledger::test
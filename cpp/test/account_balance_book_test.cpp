@@ -0,0 +1,127 @@
+#include "AccountBalanceBook.h"
+#include "FixedPoint.h"
+#include <gtest/gtest.h>
+
+using namespace trading_ledger;
+
+namespace {
+
+Event makeLedgerEvent(uint64_t seq, const std::string& entries) {
+    Event event;
+    event.sequence_num = seq;
+    event.timestamp_ns = seq * 1000;
+    event.event_type = EventType::LEDGER_ENTRIES_GENERATED;
+    event.payload = R"({"trade_id":"t-)" + std::to_string(seq) + R"(","entries":[)" + entries + "]}";
+    return event;
+}
+
+std::string entry(const std::string& account, const std::string& type, const std::string& amount) {
+    return R"({"account_id":")" + account + R"(","entry_type":")" + type +
+           R"(","amount":)" + amount + "}";
+}
+
+}  // namespace
+
+TEST(FixedPointTest, ParseDecimals) {
+    int64_t value = 0;
+
+    ASSERT_TRUE(FixedPoint::parse("15000.5", value));
+    EXPECT_EQ(value, 1500050000000LL);
+
+    ASSERT_TRUE(FixedPoint::parse("-0.00000001", value));
+    EXPECT_EQ(value, -1);
+
+    ASSERT_TRUE(FixedPoint::parse("1E+2", value));
+    EXPECT_EQ(value, 100 * FixedPoint::SCALE);
+
+    ASSERT_TRUE(FixedPoint::parse("0.123456789", value));  // Truncated
+    EXPECT_EQ(value, 12345678);
+
+    EXPECT_FALSE(FixedPoint::parse("abc", value));
+    EXPECT_FALSE(FixedPoint::parse("12.3x", value));
+    EXPECT_FALSE(FixedPoint::parse("99999999999999999999", value));  // Overflow
+}
+
+TEST(FixedPointTest, Format) {
+    EXPECT_EQ(FixedPoint::format(1500050000000LL), "15000.50000000");
+    EXPECT_EQ(FixedPoint::format(-1), "-0.00000001");
+}
+
+TEST(AccountBalanceBookTest, AppliesBalancedEntries) {
+    AccountBalanceBook book;
+
+    ASSERT_TRUE(book.applyEvent(makeLedgerEvent(1,
+        entry("ACC1", "DEBIT", "150.25") + "," + entry("ACC2", "CREDIT", "150.25"))));
+
+    const auto* acc1 = book.find("ACC1");
+    const auto* acc2 = book.find("ACC2");
+    ASSERT_NE(acc1, nullptr);
+    ASSERT_NE(acc2, nullptr);
+
+    EXPECT_EQ(acc1->debit_total, 15025000000LL);
+    EXPECT_EQ(acc1->balance, 15025000000LL);
+    EXPECT_EQ(acc2->credit_total, 15025000000LL);
+    EXPECT_EQ(acc2->balance, -15025000000LL);
+    EXPECT_EQ(acc1->last_sequence, 1);
+
+    EXPECT_EQ(book.accountCount(), 2);
+    EXPECT_EQ(book.totalDebits(), book.totalCredits());
+    EXPECT_TRUE(book.checkInvariant());
+}
+
+TEST(AccountBalanceBookTest, RecordsAreCacheLineAligned) {
+    EXPECT_EQ(alignof(AccountBalanceBook::AccountRecord), 64);
+    EXPECT_EQ(sizeof(AccountBalanceBook::AccountRecord), 64);
+}
+
+TEST(AccountBalanceBookTest, RejectsMalformedEventAtomically) {
+    AccountBalanceBook book;
+
+    // Second entry has an unknown entry_type: nothing may be applied
+    EXPECT_FALSE(book.applyEvent(makeLedgerEvent(1,
+        entry("ACC1", "DEBIT", "10") + "," + entry("ACC2", "REFUND", "10"))));
+
+    EXPECT_EQ(book.accountCount(), 0);
+    EXPECT_EQ(book.getStats().malformed_events, 1);
+}
+
+TEST(AccountBalanceBookTest, RejectsOverflowOnLaterLegAtomically) {
+    AccountBalanceBook book;
+    AccountBalanceBook::AccountRecord near_limit;
+    near_limit.credit_total = INT64_MAX - 10;
+    near_limit.balance = -(INT64_MAX - 10);
+    book.restoreAccount("ACC2", near_limit);
+
+    // The debit leg fits; the credit leg would overflow ACC2: neither applies
+    EXPECT_FALSE(book.applyEvent(makeLedgerEvent(1,
+        entry("ACC1", "DEBIT", "10") + "," + entry("ACC2", "CREDIT", "10"))));
+
+    EXPECT_EQ(book.find("ACC1"), nullptr);
+    EXPECT_EQ(book.find("ACC2")->credit_total, INT64_MAX - 10);
+    EXPECT_EQ(book.totalDebits(), 0);
+    EXPECT_EQ(book.getStats().overflow_errors, 1);
+    EXPECT_EQ(book.getStats().entries_applied, 0);
+}
+
+TEST(AccountBalanceBookTest, PeriodicInvariantCheckDetectsImbalance) {
+    AccountBalanceBook book(2);  // Check every 2 events
+
+    book.applyEvent(makeLedgerEvent(1, entry("ACC1", "DEBIT", "10")));
+    book.applyEvent(makeLedgerEvent(2, entry("ACC1", "CREDIT", "5")));
+
+    auto stats = book.getStats();
+    EXPECT_EQ(stats.invariant_checks, 1);
+    EXPECT_EQ(stats.invariant_violations, 1);
+}
+
+TEST(AccountBalanceBookTest, IgnoresOtherEventTypes) {
+    AccountBalanceBook book;
+
+    Event event;
+    event.sequence_num = 1;
+    event.event_type = EventType::TRADE_CREATED;
+    event.payload = R"({"trade_id":"t-1"})";
+
+    EXPECT_FALSE(book.applyEvent(event));
+    EXPECT_EQ(book.getStats().events_applied, 0);
+}
@@ -0,0 +1,55 @@
+#include "AllocationProfiler.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace trading_ledger;
+
+class AllocationProfilerTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        AllocationProfiler::disable();
+        AllocationProfiler::reset();
+    }
+};
+
+TEST_F(AllocationProfilerTest, DisabledRecordsNothing) {
+    AllocationProfiler::reset();
+
+    for (int i = 0; i < 1000; ++i) {
+        AllocationProfiler::onAllocation(4096);
+    }
+
+    EXPECT_FALSE(AllocationProfiler::enabled());
+    EXPECT_EQ(AllocationProfiler::samplesRecorded(), 0);
+}
+
+TEST_F(AllocationProfilerTest, SamplesOncePerInterval) {
+    AllocationProfiler::reset();
+    ASSERT_TRUE(AllocationProfiler::enable(1024));
+
+    // 100 x 512 bytes = 50 KB -> ~50 samples at one per KB
+    for (int i = 0; i < 100; ++i) {
+        AllocationProfiler::onAllocation(512);
+    }
+
+    EXPECT_GE(AllocationProfiler::samplesRecorded(), 49);
+    EXPECT_LE(AllocationProfiler::samplesRecorded(), 51);
+}
+
+TEST_F(AllocationProfilerTest, AttributesSamplesToStage) {
+    AllocationProfiler::reset();
+    ASSERT_TRUE(AllocationProfiler::enable(64));
+
+    {
+        AllocationProfiler::ScopedStage stage(PipelineStage::PARSER);
+        EXPECT_EQ(AllocationProfiler::currentStage(), PipelineStage::PARSER);
+        AllocationProfiler::onAllocation(1024);
+    }
+    EXPECT_EQ(AllocationProfiler::currentStage(), PipelineStage::UNKNOWN);
+
+    std::ostringstream out;
+    AllocationProfiler::report(out);
+
+    EXPECT_NE(out.str().find("parser"), std::string::npos);
+    EXPECT_NE(out.str().find("Top allocation sites"), std::string::npos);
+}
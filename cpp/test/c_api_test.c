@@ -0,0 +1,314 @@
+/*
+ * C harness for the trading_ledger_c shared library
+ *
+ * Plain C (no C++ runtime on the caller side), linked against the .so the
+ * same way the writer would load it. Exit code 0 = all checks passed.
+ */
+#include "trading_ledger_c.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                        \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            fprintf(stderr, "%s:%d: check failed: %s (last error: %s)\n", \
+                    __FILE__, __LINE__, #cond, tl_last_error());           \
+            failures++;                                                    \
+        }                                                                  \
+    } while (0)
+
+static const char* TRADE_1 =
+    "{\"trade_id\":\"550e8400-e29b-41d4-a716-446655440000\","
+    "\"account_id\":\"ACC001\",\"symbol\":\"AAPL\",\"quantity\":100,"
+    "\"price\":150.25,\"side\":\"BUY\"}";
+static const char* TRADE_2 =
+    "{\"trade_id\":\"6ba7b810-9dad-11d1-80b4-00c04fd430c8\","
+    "\"account_id\":\"ACC002\",\"symbol\":\"MSFT\",\"quantity\":50,"
+    "\"price\":310.00,\"side\":\"SELL\"}";
+static const char* MISSING_SYMBOL =
+    "{\"trade_id\":\"7ba7b810-9dad-11d1-80b4-00c04fd430c8\",\"quantity\":1}";
+static const char* NUMERIC_TRADE_ID =
+    "{\"trade_id\":42,\"symbol\":\"AAPL\",\"quantity\":1}";
+static const char* LEDGER =
+    "{\"trade_id\":\"550e8400-e29b-41d4-a716-446655440000\",\"entries\":["
+    "{\"account_id\":\"ACC001\",\"entry_type\":\"DEBIT\",\"amount\":15025.00},"
+    "{\"account_id\":\"CASH\",\"entry_type\":\"CREDIT\",\"amount\":15025.00}]}";
+
+static void putLE(uint8_t* out, uint64_t value, int bytes) {
+    int i;
+    for (i = 0; i < bytes; ++i) {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+/* Frame one event in the event log format; returns the frame size */
+static size_t frame(uint8_t* out, uint64_t seq, uint8_t type, const char* payload) {
+    size_t len = strlen(payload);
+    uLong crc;
+
+    putLE(out, seq, 8);
+    putLE(out + 8, seq * 1000, 8);
+    out[16] = type;
+    out[17] = out[18] = out[19] = 0;
+    putLE(out + 20, len, 4);
+    memcpy(out + 24, payload, len);
+    crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, out, (uInt)(24 + len));
+    putLE(out + 24 + len, crc, 4);
+    return 28 + len;
+}
+
+static tl_event makeEvent(uint64_t seq, uint8_t type, const char* payload) {
+    tl_event event;
+    memset(&event, 0, sizeof(event));
+    event.sequence_num = seq;
+    event.timestamp_ns = seq * 1000;
+    event.event_type = type;
+    event.payload = payload;
+    event.payload_length = (uint32_t)strlen(payload);
+    return event;
+}
+
+static void testAbiLayout(void) {
+    CHECK(tl_abi_version() == TL_ABI_VERSION);
+    CHECK(sizeof(tl_event) == 32);
+    CHECK(sizeof(tl_verdict) == 16);
+    CHECK(sizeof(tl_ledger_entry) == 24);
+}
+
+static void testParseEvent(void) {
+    uint8_t buffer[512];
+    size_t size = frame(buffer, 7, TL_EVENT_TRADE_CREATED, TRADE_1);
+    tl_event event;
+    size_t consumed = 0;
+
+    CHECK(tl_parse_event(buffer, size, &event, &consumed) == TL_OK);
+    CHECK(consumed == size);
+    CHECK(event.sequence_num == 7);
+    CHECK(event.event_type == TL_EVENT_TRADE_CREATED);
+    CHECK(event.payload == (const char*)buffer + 24);  /* Zero-copy */
+    CHECK(event.payload_length == strlen(TRADE_1));
+
+    CHECK(tl_parse_event(buffer, size - 1, &event, &consumed) == TL_ERR_TRUNCATED);
+
+    buffer[30] ^= 0xFF;
+    CHECK(tl_parse_event(buffer, size, &event, &consumed) == TL_ERR_CORRUPTED);
+    CHECK(strlen(tl_last_error()) > 0);
+
+    CHECK(tl_parse_event(NULL, size, &event, &consumed) == TL_ERR_INVALID_ARGUMENT);
+}
+
+static void testDecodeLedgerEntries(void) {
+    tl_ledger_entry entries[4];
+    size_t count = 0;
+
+    CHECK(tl_decode_ledger_entries(LEDGER, strlen(LEDGER), entries, 4, &count) == TL_OK);
+    CHECK(count == 2);
+    CHECK(entries[0].account_id_length == 6);
+    CHECK(strncmp(entries[0].account_id, "ACC001", 6) == 0);
+    CHECK(entries[0].is_debit == 1);
+    CHECK(entries[0].amount == 15025LL * TL_AMOUNT_SCALE);
+    CHECK(entries[1].is_debit == 0);
+
+    /* Too small: count still reports what is needed */
+    CHECK(tl_decode_ledger_entries(LEDGER, strlen(LEDGER), entries, 1, &count) == TL_ERR_CAPACITY);
+    CHECK(count == 2);
+
+    CHECK(tl_decode_ledger_entries("{}", 2, entries, 4, &count) == TL_ERR_MALFORMED);
+}
+
+static void testValidateBatch(void) {
+    tl_validator* validator = NULL;
+    tl_event events[5];
+    tl_verdict verdicts[5];
+    tl_validator_stats stats;
+
+    CHECK(tl_validator_create(&validator) == TL_OK);
+    CHECK(validator != NULL);
+
+    events[0] = makeEvent(1, TL_EVENT_TRADE_CREATED, TRADE_1);
+    events[1] = makeEvent(2, TL_EVENT_TRADE_CREATED, TRADE_2);
+    events[2] = makeEvent(3, TL_EVENT_TRADE_CREATED, TRADE_1);  /* Duplicate */
+    events[3] = makeEvent(4, TL_EVENT_TRADE_CREATED, MISSING_SYMBOL);
+    events[4] = makeEvent(5, TL_EVENT_LEDGER_ENTRIES_GENERATED, LEDGER);
+
+    CHECK(tl_validate_batch(validator, events, 5, verdicts) == TL_OK);
+    CHECK(verdicts[0].code == TL_VERDICT_PASSED);
+    CHECK(verdicts[1].code == TL_VERDICT_PASSED);
+    CHECK(verdicts[2].code == TL_VERDICT_FAILED);
+    CHECK(verdicts[2].rule == TL_RULE_DUPLICATE_TRADE);
+    CHECK(verdicts[3].code == TL_VERDICT_FAILED);
+    CHECK(verdicts[3].rule == TL_RULE_MISSING_FIELDS);
+    CHECK(verdicts[4].code == TL_VERDICT_SKIPPED);
+    CHECK(verdicts[4].sequence_num == 5);
+
+    CHECK(tl_validator_get_stats(validator, &stats) == TL_OK);
+    CHECK(stats.events_processed == 5);
+    CHECK(stats.trades_validated == 2);
+    CHECK(stats.duplicate_trades == 1);
+    CHECK(stats.tracked_trades == 2);
+
+    CHECK(tl_validate_batch(NULL, events, 5, verdicts) == TL_ERR_INVALID_ARGUMENT);
+
+    tl_validator_destroy(validator);
+}
+
+static void testValidateBatchRejectsBeforeApplying(void) {
+    tl_validator* validator = NULL;
+    tl_event events[3];
+    tl_verdict verdicts[3];
+    tl_validator_stats stats;
+
+    CHECK(tl_validator_create(&validator) == TL_OK);
+
+    events[0] = makeEvent(1, TL_EVENT_TRADE_CREATED, TRADE_1);
+    events[1] = makeEvent(2, TL_EVENT_TRADE_CREATED, TRADE_2);
+    events[2] = makeEvent(3, TL_EVENT_TRADE_CREATED, TRADE_1);
+    events[2].payload = NULL;   /* Bad last event: nothing is applied */
+
+    CHECK(tl_validate_batch(validator, events, 3, verdicts) == TL_ERR_INVALID_ARGUMENT);
+    CHECK(tl_validator_get_stats(validator, &stats) == TL_OK);
+    CHECK(stats.events_processed == 0);
+    CHECK(stats.tracked_trades == 0);
+
+    /* The caller can fix the event and resubmit the whole batch */
+    events[2] = makeEvent(3, TL_EVENT_TRADE_CREATED, TRADE_1);
+    CHECK(tl_validate_batch(validator, events, 3, verdicts) == TL_OK);
+    CHECK(verdicts[0].code == TL_VERDICT_PASSED);
+    CHECK(verdicts[2].rule == TL_RULE_DUPLICATE_TRADE);
+
+    tl_validator_destroy(validator);
+}
+
+static void testInvalidTradeId(void) {
+    tl_validator* validator = NULL;
+    tl_event events[3];
+    tl_verdict verdicts[3];
+    tl_validator_stats stats;
+
+    CHECK(tl_validator_create(&validator) == TL_OK);
+
+    /* Neither id-less trade is taken for a duplicate of the other */
+    events[0] = makeEvent(1, TL_EVENT_TRADE_CREATED, NUMERIC_TRADE_ID);
+    events[1] = makeEvent(2, TL_EVENT_TRADE_CREATED, NUMERIC_TRADE_ID);
+    events[2] = makeEvent(3, TL_EVENT_TRADE_CREATED, TRADE_1);
+
+    CHECK(tl_validate_batch(validator, events, 3, verdicts) == TL_OK);
+    CHECK(verdicts[0].rule == TL_RULE_INVALID_TRADE_ID);
+    CHECK(verdicts[1].rule == TL_RULE_INVALID_TRADE_ID);
+    CHECK(verdicts[2].code == TL_VERDICT_PASSED);
+
+    CHECK(tl_validator_get_stats(validator, &stats) == TL_OK);
+    CHECK(stats.duplicate_trades == 0);
+    CHECK(stats.tracked_trades == 1);
+
+    tl_validator_destroy(validator);
+}
+
+static void testValidateFrames(void) {
+    tl_validator* validator = NULL;
+    uint8_t buffer[2048];
+    tl_verdict verdicts[8];
+    size_t size = 0;
+    size_t full = 0;
+    size_t count = 0;
+    size_t consumed = 0;
+
+    CHECK(tl_validator_create(&validator) == TL_OK);
+
+    size += frame(buffer + size, 1, TL_EVENT_TRADE_CREATED, TRADE_1);
+    size += frame(buffer + size, 2, TL_EVENT_LEDGER_ENTRIES_GENERATED, LEDGER);
+    full = size;
+    size += frame(buffer + size, 3, TL_EVENT_TRADE_CREATED, TRADE_2);
+
+    /* Trailing frame cut short: the complete frames are validated */
+    CHECK(tl_validate_frames(validator, buffer, size - 5, verdicts, 8, &count, &consumed) == TL_OK);
+    CHECK(count == 2);
+    CHECK(consumed == full);
+    CHECK(verdicts[0].code == TL_VERDICT_PASSED);
+    CHECK(verdicts[1].code == TL_VERDICT_SKIPPED);
+
+    /* Resume from where it stopped */
+    CHECK(tl_validate_frames(validator, buffer + consumed, size - consumed,
+                             verdicts, 8, &count, &consumed) == TL_OK);
+    CHECK(count == 1);
+    CHECK(verdicts[0].sequence_num == 3);
+    CHECK(verdicts[0].code == TL_VERDICT_PASSED);
+
+    /* Capacity limits the batch */
+    CHECK(tl_validate_frames(validator, buffer, size, verdicts, 1, &count, &consumed) == TL_OK);
+    CHECK(count == 1);
+    CHECK(verdicts[0].rule == TL_RULE_DUPLICATE_TRADE);
+
+    /* Corruption stops the batch after the good frames */
+    buffer[full + 30] ^= 0xFF;
+    CHECK(tl_validate_frames(validator, buffer, size, verdicts, 8, &count, &consumed) == TL_ERR_CORRUPTED);
+    CHECK(count == 2);
+    CHECK(consumed == full);
+
+    tl_validator_destroy(validator);
+}
+
+static void testDecodeTradesArrow(void) {
+    tl_event events[4];
+    struct ArrowArray array;
+    struct ArrowSchema schema;
+    const int32_t* offsets;
+    const char* symbols;
+    const uint8_t* valid;
+    const uint64_t* quantity;
+
+    events[0] = makeEvent(1, TL_EVENT_TRADE_CREATED, TRADE_1);
+    events[1] = makeEvent(2, TL_EVENT_LEDGER_ENTRIES_GENERATED, LEDGER);  /* Skipped */
+    events[2] = makeEvent(3, TL_EVENT_TRADE_CREATED, MISSING_SYMBOL);
+    events[3] = makeEvent(4, TL_EVENT_TRADE_CREATED, TRADE_2);
+
+    CHECK(tl_decode_trades_arrow(events, 4, &array, &schema) == TL_OK);
+    CHECK(strcmp(schema.format, "+s") == 0);
+    CHECK(schema.n_children == array.n_children);
+    CHECK(strcmp(schema.children[4]->name, "symbol") == 0);
+    CHECK(array.length == 3);
+
+    /* symbol: validity bitmap, int32 offsets, bytes */
+    CHECK(array.children[4]->null_count == 1);
+    valid = (const uint8_t*)array.children[4]->buffers[0];
+    offsets = (const int32_t*)array.children[4]->buffers[1];
+    symbols = (const char*)array.children[4]->buffers[2];
+    CHECK(valid[0] == 0x5);
+    CHECK(strncmp(symbols + offsets[0], "AAPL", 4) == 0);
+    CHECK(strncmp(symbols + offsets[2], "MSFT", (size_t)(offsets[3] - offsets[2])) == 0);
+
+    /* quantity: decimal128, low word first */
+    quantity = (const uint64_t*)array.children[7]->buffers[1];
+    CHECK(quantity[0] == 100ULL * TL_AMOUNT_SCALE);
+    CHECK(quantity[4] == 50ULL * TL_AMOUNT_SCALE);
+
+    array.release(&array);
+    schema.release(&schema);
+    CHECK(array.release == NULL);
+    CHECK(schema.release == NULL);
+
+    CHECK(tl_decode_trades_arrow(events, 4, NULL, &schema) == TL_ERR_INVALID_ARGUMENT);
+}
+
+int main(void) {
+    testAbiLayout();
+    testParseEvent();
+    testDecodeLedgerEntries();
+    testValidateBatch();
+    testValidateBatchRejectsBeforeApplying();
+    testInvalidTradeId();
+    testValidateFrames();
+    testDecodeTradesArrow();
+
+    if (failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All C API checks passed\n");
+    return 0;
+}
@@ -0,0 +1,288 @@
+#include "CheckpointLog.h"
+#include "FixedPoint.h"
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+
+using namespace trading_ledger;
+
+namespace {
+
+Event tradeEvent(uint64_t seq, const std::string& trade_id, const std::string& account, int quantity) {
+    Event event;
+    event.sequence_num = seq;
+    event.event_type = EventType::TRADE_CREATED;
+    event.payload = R"({"trade_id":")" + trade_id + R"(","account_id":")" + account +
+                    R"(","symbol":"AAPL","side":"BUY","quantity":)" + std::to_string(quantity) +
+                    R"(,"price":10})";
+    return event;
+}
+
+Event entriesEvent(uint64_t seq, const std::string& account, int amount) {
+    Event event;
+    event.sequence_num = seq;
+    event.event_type = EventType::LEDGER_ENTRIES_GENERATED;
+    event.payload = R"({"entries":[{"account_id":")" + account + R"(","entry_type":"DEBIT","amount":)" +
+                    std::to_string(amount) + R"(},{"account_id":"CASH","entry_type":"CREDIT","amount":)" +
+                    std::to_string(amount) + "}]}";
+    return event;
+}
+
+std::string uuid(int n) {
+    char text[37];
+    std::snprintf(text, sizeof(text), "00000000-0000-4000-8000-%012d", n);
+    return text;
+}
+
+// Consumer state as the event processor holds it
+struct State {
+    DoubleEntryValidator validator;
+    AccountBalanceBook balances{0};
+    PositionBook positions;
+
+    State() { validator.setLogging(false); }
+
+    void apply(const Event& event) {
+        validator.processEvent(event);
+        balances.applyEvent(event);
+        positions.applyEvent(event);
+    }
+};
+
+}  // namespace
+
+class CheckpointLogTest : public ::testing::Test {
+protected:
+    std::string path = "/tmp/test_checkpoint_log.ckpt";
+    uint64_t next_seq = 1;
+
+    void SetUp() override { std::remove(path.c_str()); }
+    void TearDown() override { std::remove(path.c_str()); }
+
+    CheckpointLog::Config config() {
+        CheckpointLog::Config config;
+        config.sync = false;
+        return config;
+    }
+
+    // Trade n on account ACC<n % accounts>, then its ledger entries
+    void applyTrades(State& state, int first, int count, int accounts) {
+        for (int n = first; n < first + count; ++n) {
+            std::string account = "ACC" + std::to_string(n % accounts);
+            state.apply(tradeEvent(next_seq++, uuid(n), account, n));
+            state.apply(entriesEvent(next_seq++, account, n));
+        }
+    }
+
+    static void expectSameState(const State& a, const State& b) {
+        EXPECT_EQ(a.validator.tradeCount(), b.validator.tradeCount());
+        EXPECT_EQ(a.balances.accountCount(), b.balances.accountCount());
+        EXPECT_EQ(a.balances.totalDebits(), b.balances.totalDebits());
+        EXPECT_EQ(a.positions.size(), b.positions.size());
+        for (uint32_t id = 0; id < a.balances.accountCount(); ++id) {
+            const std::string& name = a.balances.accountName(id);
+            const auto* other = b.balances.find(name);
+            ASSERT_NE(other, nullptr) << name;
+            EXPECT_EQ(a.balances.record(id)->balance, other->balance) << name;
+            EXPECT_EQ(a.balances.record(id)->entry_count, other->entry_count) << name;
+        }
+        a.positions.forEach([&](const std::string& account, const std::string& symbol,
+                                const PositionBook::Position& position) {
+            const auto* other = b.positions.find(account, symbol);
+            ASSERT_NE(other, nullptr) << account;
+            EXPECT_EQ(position.net_quantity, other->net_quantity) << account;
+            EXPECT_EQ(position.trade_count, other->trade_count) << account;
+        });
+    }
+};
+
+TEST_F(CheckpointLogTest, RecoverReplaysDeltas) {
+    State live;
+    CheckpointLog log(path, live.validator, live.balances, live.positions, config());
+    EXPECT_EQ(log.recover(), 0u);
+
+    applyTrades(live, 0, 50, 10);
+    log.checkpoint(next_seq - 1);
+    applyTrades(live, 50, 5, 10);
+    live.apply(tradeEvent(next_seq++, "plain-id", "ACC0", 1));   // Interned (non-UUID) id
+    log.checkpoint(next_seq - 1);
+    log.flush();
+    EXPECT_EQ(log.durableSequence(), next_seq - 1);
+
+    State restored;
+    CheckpointLog reopened(path, restored.validator, restored.balances, restored.positions, config());
+    EXPECT_EQ(reopened.recover(), next_seq - 1);
+    EXPECT_EQ(reopened.stats().records_recovered, 2u);
+    expectSameState(live, restored);
+
+    // Duplicate detection survives the restart, for both kinds of id
+    EXPECT_EQ(restored.validator.processEvent(tradeEvent(next_seq, uuid(7), "ACC7", 7)).rule,
+              ValidationRule::DUPLICATE_TRADE);
+    EXPECT_EQ(restored.validator.processEvent(tradeEvent(next_seq, "plain-id", "ACC0", 1)).rule,
+              ValidationRule::DUPLICATE_TRADE);
+}
+
+TEST_F(CheckpointLogTest, DeltaHoldsOnlyChangedEntries) {
+    State live;
+    CheckpointLog log(path, live.validator, live.balances, live.positions, config());
+    log.recover();
+
+    applyTrades(live, 0, 1000, 100);
+    log.checkpoint(next_seq - 1);
+    size_t first_bytes = log.stats().last_bytes;
+    EXPECT_EQ(log.stats().last_trades, 1000u);
+    EXPECT_EQ(log.stats().last_accounts, 101u);   // ACC0..ACC99 + CASH
+
+    applyTrades(live, 1000, 3, 100);              // Touches ACC0..ACC2
+    log.checkpoint(next_seq - 1);
+    EXPECT_EQ(log.stats().last_trades, 3u);
+    EXPECT_EQ(log.stats().last_accounts, 4u);
+    EXPECT_EQ(log.stats().last_positions, 3u);
+    EXPECT_LT(log.stats().last_bytes * 50, first_bytes);
+
+    log.checkpoint(next_seq - 1);                 // Nothing changed
+    EXPECT_EQ(log.stats().last_trades + log.stats().last_accounts + log.stats().last_positions, 0u);
+}
+
+TEST_F(CheckpointLogTest, CompactionRewritesFullImage) {
+    CheckpointLog::Config small = config();
+    small.min_compact_bytes = 0;
+    small.compact_ratio = 1.5;
+
+    State live;
+    CheckpointLog log(path, live.validator, live.balances, live.positions, small);
+    log.recover();
+    applyTrades(live, 0, 200, 20);
+    log.checkpoint(next_seq - 1);                 // No full image yet: compacts
+    EXPECT_EQ(log.stats().compactions, 1u);
+    uint64_t full_bytes = log.stats().full_bytes;
+
+    for (int round = 0; round < 40; ++round) {
+        applyTrades(live, 200 + round * 10, 10, 20);
+        log.checkpoint(next_seq - 1);
+        EXPECT_LE(log.stats().log_bytes, static_cast<uint64_t>(log.stats().full_bytes * 1.5) + 1);
+    }
+    EXPECT_GT(log.stats().compactions, 1u);
+    EXPECT_GT(log.stats().full_bytes, full_bytes);
+    log.flush();
+
+    State restored;
+    CheckpointLog reopened(path, restored.validator, restored.balances, restored.positions, small);
+    EXPECT_EQ(reopened.recover(), next_seq - 1);
+    expectSameState(live, restored);
+}
+
+TEST_F(CheckpointLogTest, TornTailIsIgnoredAndOverwritten) {
+    State live;
+    {
+        CheckpointLog log(path, live.validator, live.balances, live.positions, config());
+        log.recover();
+        applyTrades(live, 0, 10, 5);
+        log.checkpoint(next_seq - 1);
+    }
+    uint64_t checkpointed = next_seq - 1;
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        uint8_t partial[12] = {200, 0, 0, 0, 2, 1, 2, 3, 4, 5, 6, 7};
+        file.write(reinterpret_cast<const char*>(partial), sizeof(partial));
+    }
+
+    State restored;
+    CheckpointLog log(path, restored.validator, restored.balances, restored.positions, config());
+    EXPECT_EQ(log.recover(), checkpointed);
+    expectSameState(live, restored);
+
+    applyTrades(restored, 10, 5, 5);
+    log.checkpoint(next_seq - 1);
+    log.flush();
+
+    State again;
+    CheckpointLog reopened(path, again.validator, again.balances, again.positions, config());
+    EXPECT_EQ(reopened.recover(), next_seq - 1);
+    EXPECT_EQ(reopened.stats().records_recovered, 2u);
+    expectSameState(restored, again);
+}
+
+TEST_F(CheckpointLogTest, RejectsForeignFile) {
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "not a checkpoint log";
+    }
+    State state;
+    CheckpointLog log(path, state.validator, state.balances, state.positions, config());
+    EXPECT_THROW(log.recover(), std::runtime_error);
+    EXPECT_THROW(log.checkpoint(1), std::runtime_error);
+}
+
+TEST_F(CheckpointLogTest, ImageRestoresStateAndRewritesFile) {
+    State live;
+    CheckpointLog log(path, live.validator, live.balances, live.positions, config());
+    log.recover();
+    applyTrades(live, 0, 100, 10);
+    log.checkpoint(next_seq - 1);
+    log.flush();
+    applyTrades(live, 100, 20, 10);               // Not in the file
+    std::vector<uint8_t> image = log.image(next_seq - 1);
+
+    // Codec only: no file, no dirty tracking
+    State copy;
+    CheckpointLog codec("", copy.validator, copy.balances, copy.positions, config());
+    EXPECT_EQ(codec.restoreImage(image.data(), image.size()), next_seq - 1);
+    expectSameState(live, copy);
+    EXPECT_THROW(codec.checkpoint(next_seq - 1), std::runtime_error);
+
+    // With a file: the first checkpoint replaces the stale log with a full image
+    State successor;
+    CheckpointLog taken(path, successor.validator, successor.balances, successor.positions, config());
+    EXPECT_EQ(taken.restoreImage(image.data(), image.size()), next_seq - 1);
+    applyTrades(successor, 120, 5, 10);
+    taken.checkpoint(next_seq - 1);
+    EXPECT_EQ(taken.stats().compactions, 1u);
+    taken.flush();
+
+    State restored;
+    CheckpointLog reopened(path, restored.validator, restored.balances, restored.positions, config());
+    EXPECT_EQ(reopened.recover(), next_seq - 1);
+    EXPECT_EQ(reopened.stats().records_recovered, 1u);
+    expectSameState(successor, restored);
+
+    image.back() ^= 1;                            // CRC mismatch
+    State rejected;
+    CheckpointLog corrupt("", rejected.validator, rejected.balances, rejected.positions, config());
+    EXPECT_THROW(corrupt.restoreImage(image.data(), image.size()), std::runtime_error);
+}
+
+TEST_F(CheckpointLogTest, WriteFailureIsReportedThenRewritesFullImage) {
+    std::string dir = "/tmp/test_checkpoint_log_dir";
+    std::string nested = dir + "/log.ckpt";
+    std::remove(nested.c_str());
+    ::rmdir(dir.c_str());
+    ASSERT_EQ(::mkdir(dir.c_str(), 0755), 0);
+
+    State live;
+    CheckpointLog log(nested, live.validator, live.balances, live.positions, config());
+    log.recover();
+    ASSERT_EQ(::rmdir(dir.c_str()), 0);           // The writer cannot create the file
+
+    applyTrades(live, 0, 20, 4);
+    log.checkpoint(next_seq - 1);                 // Queued: returns before the write
+    EXPECT_THROW(log.flush(), std::runtime_error);
+    EXPECT_EQ(log.durableSequence(), 0u);
+
+    ASSERT_EQ(::mkdir(dir.c_str(), 0755), 0);
+    applyTrades(live, 20, 5, 4);
+    log.checkpoint(next_seq - 1);                 // Lost delta: full image instead
+    log.flush();
+    EXPECT_EQ(log.stats().compactions, 1u);
+
+    State restored;
+    CheckpointLog reopened(nested, restored.validator, restored.balances, restored.positions, config());
+    EXPECT_EQ(reopened.recover(), next_seq - 1);
+    EXPECT_EQ(reopened.stats().records_recovered, 1u);
+    expectSameState(live, restored);
+
+    std::remove(nested.c_str());
+    ::rmdir(dir.c_str());
+}
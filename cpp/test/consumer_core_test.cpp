@@ -0,0 +1,170 @@
+#include "ConsumerCore.h"
+#include "EventFrames.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace trading_ledger;
+using namespace trading_ledger::test;
+
+namespace {
+
+std::string threadName(std::thread::id id) {
+    std::ostringstream out;
+    out << id;
+    return out.str();
+}
+
+}  // namespace
+
+class ConsumerCoreTest : public ::testing::Test {
+protected:
+    std::string log_path = "/tmp/test_consumer_core_log.bin";
+    size_t log_size = FileHeader::SIZE;
+
+    std::atomic<bool> running{true};
+    UpgradeHandoff upgrade{running};
+    PipelineMetrics metrics;
+    LatencyHistogram latency_histogram;
+    ContinuousQueryEngine queries;
+    EventTap tap;
+    EventRing ring;
+    CommandHandoff control{[this] { ring.wake(); }};
+    OffloadHandoff handoff;
+
+    std::thread rtc;
+    std::thread worker;
+    RunToCompletionStats stats;
+
+    void SetUp() override {
+        createLog(log_path);
+        std::ofstream file(log_path, std::ios::binary | std::ios::app);
+        uint64_t seq = 1;
+        for (int i = 0; i < 2000; ++i) {
+            std::string id = "t-" + std::to_string(i);
+            std::string account = "ACC" + std::to_string(i % 5);
+            std::string trade = R"({"trade_id":")" + id + R"(","account_id":")" + account +
+                                R"(","symbol":"AAPL","side":"BUY","quantity":1,"price":10})";
+            std::string entries = R"({"trade_id":")" + id + R"(","entries":[{"account_id":")" + account +
+                                  R"(","entry_type":"DEBIT","amount":10},{"account_id":"CASH","entry_type":"CREDIT","amount":10}]})";
+            for (const auto& frame : {frameEvent(seq, EventType::TRADE_CREATED, trade),
+                                      frameEvent(seq + 1, EventType::LEDGER_ENTRIES_GENERATED, entries)}) {
+                file.write(reinterpret_cast<const char*>(frame.data()), frame.size());
+                log_size += frame.size();
+            }
+            seq += 2;
+        }
+    }
+
+    void TearDown() override {
+        stop();
+        std::remove(log_path.c_str());
+    }
+
+    void start(ConsumerCore& core, uint64_t offload_budget_ns) {
+        if (offload_budget_ns > 0) {
+            worker = std::thread(offloadWorker, std::ref(ring), std::ref(handoff), std::ref(running));
+        }
+        rtc = std::thread([this, &core, offload_budget_ns] {
+            stats = runToCompletion(log_path, core, ring, handoff, metrics, upgrade, offload_budget_ns);
+        });
+    }
+
+    // Run a command on whichever thread serves control requests
+    std::string execute(const CommandHandoff::Task& task) {
+        return control.execute(task, std::chrono::seconds(1));
+    }
+
+    // Poll the core's log offset through the control path until the whole
+    // log has been processed
+    void waitForLogEnd(ConsumerCore& core) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (execute([&core] { return std::to_string(core.logOffset()); }) ==
+                std::to_string(log_size)) {
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        FAIL() << "log not processed within 10 s";
+    }
+
+    void stop() {
+        running.store(false, std::memory_order_release);
+        if (rtc.joinable()) {
+            rtc.join();
+        }
+        handoff.exit.store(true, std::memory_order_release);
+        ring.wake();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    ConsumerCore::Config config() const { return {}; }
+};
+
+TEST_F(ConsumerCoreTest, RunToCompletionProcessesTheLog) {
+    ConsumerCore core(config(), metrics, latency_histogram, nullptr, nullptr, queries, tap, control,
+                      upgrade);
+    start(core, 0);
+    waitForLogEnd(core);
+    std::string served_on = execute([] { return threadName(std::this_thread::get_id()); });
+    EXPECT_EQ(served_on, threadName(rtc.get_id()));
+    stop();
+
+    EXPECT_EQ(stats.offloads, 0u);
+    EXPECT_EQ(core.validator().getStats().events_processed, 4000u);
+    EXPECT_EQ(core.validator().getStats().validation_errors, 0u);
+    EXPECT_EQ(core.balances().accountCount(), 6u);
+    EXPECT_EQ(core.balances().totalDebits(), core.balances().totalCredits());
+}
+
+TEST_F(ConsumerCoreTest, OffloadedRunMatchesInlineRun) {
+    // Any measured cost exceeds 1 ns: the worker takes over after the first
+    // batch and never gives the core back
+    ConsumerCore core(config(), metrics, latency_histogram, nullptr, nullptr, queries, tap, control,
+                      upgrade);
+    start(core, 1);
+    waitForLogEnd(core);
+    EXPECT_TRUE(handoff.worker_owns.load());
+    stop();
+
+    EXPECT_EQ(stats.offloads, 1u);
+    EXPECT_GT(stats.events_offloaded, 0u);
+    EXPECT_FALSE(handoff.worker_owns.load());   // Taken back on shutdown
+    EXPECT_EQ(core.validator().getStats().events_processed, 4000u);
+    EXPECT_EQ(core.validator().getStats().validation_errors, 0u);
+    EXPECT_EQ(core.balances().accountCount(), 6u);
+    EXPECT_EQ(core.balances().totalDebits(), core.balances().totalCredits());
+    EXPECT_EQ(core.logOffset(), log_size);
+}
+
+TEST_F(ConsumerCoreTest, OffloadedControlRunsOnTheReaderThread) {
+    ConsumerCore core(config(), metrics, latency_histogram, nullptr, nullptr, queries, tap, control,
+                      upgrade);
+    start(core, 1);
+    waitForLogEnd(core);
+    ASSERT_TRUE(handoff.worker_owns.load());
+
+    // The worker holds the core, yet commands are served by the reader with
+    // the worker parked, and the worker resumes afterwards
+    for (int i = 0; i < 5; ++i) {
+        std::string served_on = execute([this] {
+            EXPECT_NE(handoff.pause.load(), OffloadHandoff::Pause::RUNNING);
+            return threadName(std::this_thread::get_id());
+        });
+        EXPECT_EQ(served_on, threadName(rtc.get_id()));
+    }
+    // The reader releases the worker just after the result is returned
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (handoff.pause.load() != OffloadHandoff::Pause::RUNNING &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(handoff.pause.load(), OffloadHandoff::Pause::RUNNING);
+    EXPECT_TRUE(handoff.worker_owns.load());
+}
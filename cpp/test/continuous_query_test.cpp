@@ -0,0 +1,166 @@
+#include "ContinuousQuery.h"
+#include "ControlServer.h"
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+using namespace trading_ledger;
+
+namespace {
+
+Event makeTrade(const std::string& account, const std::string& symbol, const std::string& side,
+                const std::string& quantity, const std::string& price) {
+    Event event;
+    event.event_type = EventType::TRADE_CREATED;
+    event.payload = R"({"trade_id":"t","account_id":")" + account + R"(","symbol":")" + symbol +
+                    R"(","quantity":)" + quantity + R"(,"price":)" + price +
+                    R"(,"side":")" + side + "\"}";
+    return event;
+}
+
+// Send one request line and read until the status line
+std::string request(const std::string& path, const std::string& line) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return "connect failed";
+    }
+    std::string out = line + "\n";
+    EXPECT_EQ(write(fd, out.data(), out.size()), static_cast<ssize_t>(out.size()));
+
+    std::string response;
+    char chunk[256];
+    while (response.find("OK\n") == std::string::npos && response.find("ERR") == std::string::npos) {
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n <= 0) {
+            break;
+        }
+        response.append(chunk, static_cast<size_t>(n));
+    }
+    close(fd);
+    return response;
+}
+
+}  // namespace
+
+TEST(ContinuousQueryTest, FilterAndAggregate) {
+    ContinuousQueryEngine engine;
+    engine.add("nvda_buys", "sum(quantity),count where symbol=NVDA and account_id=ACC1 and side=BUY");
+    engine.add("net_by_symbol", "net(quantity), avg(price) by symbol");
+    engine.add("large", "count,max(notional) where notional>=1000");
+
+    engine.onEvent(makeTrade("ACC1", "NVDA", "BUY", "10", "100"));
+    engine.onEvent(makeTrade("ACC1", "NVDA", "SELL", "4", "110"));
+    engine.onEvent(makeTrade("ACC2", "NVDA", "BUY", "7", "90"));
+    engine.onEvent(makeTrade("ACC1", "AAPL", "BUY", "2.5", "10"));
+    engine.onEvent(makeTrade("ACC1", "NVDA", "BUY", "1", "100"));
+
+    const ContinuousQuery* buys = engine.find("nvda_buys");
+    ASSERT_NE(buys, nullptr);
+    EXPECT_EQ(buys->value("", 0), "11.00000000");
+    EXPECT_EQ(buys->value("", 1), "2");
+    EXPECT_EQ(buys->cost().evaluated, 5u);
+    EXPECT_EQ(buys->cost().matched, 2u);
+
+    const ContinuousQuery* net = engine.find("net_by_symbol");
+    EXPECT_EQ(net->value("NVDA", 0), "14.00000000");   // 10 - 4 + 7 + 1
+    EXPECT_EQ(net->value("NVDA", 1), "100.00000000");  // (100 + 110 + 90 + 100) / 4
+    EXPECT_EQ(net->value("AAPL", 0), "2.50000000");
+    EXPECT_EQ(net->groupCount(), 2u);
+
+    EXPECT_EQ(engine.find("large")->value("", 0), "1");
+    EXPECT_EQ(engine.find("large")->value("", 1), "1000.00000000");
+
+    // Non-trade events are not offered to queries
+    Event ledger;
+    ledger.event_type = EventType::LEDGER_ENTRIES_GENERATED;
+    ledger.payload = R"({"trade_id":"t","entries":[]})";
+    engine.onEvent(ledger);
+    EXPECT_EQ(buys->cost().evaluated, 5u);
+}
+
+TEST(ContinuousQueryTest, RejectsBadQueries) {
+    ContinuousQueryEngine engine;
+    EXPECT_THROW(engine.add("q", "where symbol=NVDA"), std::invalid_argument);
+    EXPECT_THROW(engine.add("q", "sum(symbol)"), std::invalid_argument);
+    EXPECT_THROW(engine.add("q", "count where colour=red"), std::invalid_argument);
+    EXPECT_THROW(engine.add("q", "count where symbol>NVDA"), std::invalid_argument);
+    EXPECT_THROW(engine.add("q", "count where quantity>abc"), std::invalid_argument);
+    EXPECT_THROW(engine.add("q", "count where"), std::invalid_argument);
+    EXPECT_THROW(engine.add("q", "count by"), std::invalid_argument);
+    engine.add("q", "count");
+    EXPECT_THROW(engine.add("q", "count"), std::invalid_argument);
+    EXPECT_TRUE(engine.remove("q"));
+    EXPECT_FALSE(engine.remove("q"));
+}
+
+TEST(ContinuousQueryTest, GroupLimitCountsOverflow) {
+    ContinuousQueryEngine engine(2);
+    engine.add("by_account", "count by account_id");
+    engine.onEvent(makeTrade("A", "X", "BUY", "1", "1"));
+    engine.onEvent(makeTrade("B", "X", "BUY", "1", "1"));
+    engine.onEvent(makeTrade("C", "X", "BUY", "1", "1"));
+    engine.onEvent(makeTrade("A", "X", "BUY", "1", "1"));
+
+    const ContinuousQuery* query = engine.find("by_account");
+    EXPECT_EQ(query->groupCount(), 2u);
+    EXPECT_EQ(query->cost().overflow, 1u);
+    EXPECT_EQ(query->value("A", 0), "2");
+}
+
+TEST(ControlServerTest, QueriesRoundTripThroughConsumerThread) {
+    const std::string path = "/tmp/test_control.sock";
+    ContinuousQueryEngine engine;
+    CommandHandoff handoff;
+    std::atomic<bool> running{true};
+
+    // Stand-in consumer: owns the engine, serves commands between events
+    std::thread consumer([&] {
+        int fed = 0;
+        while (running.load()) {
+            if (handoff.pending()) {
+                handoff.serve();
+            }
+            if (fed < 100) {
+                engine.onEvent(makeTrade("ACC1", "NVDA", "BUY", "1", "1"));
+                ++fed;
+            }
+            std::this_thread::yield();
+        }
+    });
+
+    ControlServer server(path, [&](const std::string& line) -> std::string {
+        if (line.rfind("QUERY ", 0) != 0) {
+            throw std::invalid_argument("unknown command");
+        }
+        std::string rest = line.substr(6);
+        return handoff.execute([&engine, rest] { return engine.handle(rest); },
+                               std::chrono::seconds(5));
+    });
+    server.start();
+
+    EXPECT_EQ(request(path, "QUERY ADD total sum(quantity) where symbol=NVDA"), "registered total\nOK\n");
+    EXPECT_EQ(request(path, "QUERY ADD total count"), "ERR query already registered: total\n");
+    EXPECT_EQ(request(path, "BOGUS"), "ERR unknown command\n");
+    EXPECT_NE(request(path, "QUERY LIST").find("total: sum(quantity) where symbol=NVDA"),
+              std::string::npos);
+    EXPECT_EQ(request(path, "QUERY GET total").rfind("* sum(quantity)=", 0), 0u);
+
+    running.store(false);
+    consumer.join();
+
+    // Consumer gone: the command times out instead of hanging
+    EXPECT_THROW(handoff.execute([] { return std::string(); }, std::chrono::milliseconds(20)),
+                 std::runtime_error);
+
+    server.stop();
+    EXPECT_NE(access(path.c_str(), F_OK), 0);
+}
@@ -2,6 +2,7 @@
 #include "EventLogTailer.h"
 #include "DoubleEntryValidator.h"
 #include <gtest/gtest.h>
+#include <fcntl.h>
 #include <fstream>
 #include <thread>
 #include <chrono>
@@ -128,6 +129,29 @@ TEST_F(EventLogReaderTest, RemapIfGrown) {
     EXPECT_EQ(event.sequence_num, 4);
 }
 
+TEST_F(EventLogReaderTest, AdoptContinuesAtHandedOffOffset) {
+    createTestLogFile();
+
+    size_t offset;
+    {
+        EventLogReader first(test_file_path);
+        first.open();
+        Event event;
+        ASSERT_TRUE(first.readNext(event));
+        offset = first.offset();
+    }
+
+    EventLogReader next("unused-path");
+    next.adopt(::open(test_file_path.c_str(), O_RDONLY), offset);
+    Event event;
+    ASSERT_TRUE(next.readNext(event));
+    EXPECT_EQ(event.sequence_num, 2u);
+    EXPECT_GE(next.fd(), 0);
+
+    EventLogReader outside(test_file_path);
+    EXPECT_THROW(outside.adopt(::open(test_file_path.c_str(), O_RDONLY), 1 << 20), std::runtime_error);
+}
+
 TEST_F(EventLogReaderTest, OpenNonExistentFile) {
     EventLogReader reader("/nonexistent/path/file.bin");
     EXPECT_THROW(reader.open(), std::runtime_error);
@@ -237,3 +261,23 @@ TEST(DoubleEntryValidatorTest, HandlesEmptyPayload) {
     auto stats = validator.getStats();
     EXPECT_EQ(stats.validation_errors, 1);
 }
+
+TEST(DoubleEntryValidatorTest, DetectsDuplicateTrade) {
+    DoubleEntryValidator validator;
+
+    Event event;
+    event.sequence_num = 1;
+    event.timestamp_ns = 1000000;
+    event.event_type = EventType::TRADE_CREATED;
+    event.payload = R"({"trade_id":"550e8400-e29b-41d4-a716-446655440000","symbol":"AAPL","quantity":100})";
+
+    validator.processEvent(event);
+    event.sequence_num = 2;
+    validator.processEvent(event);
+
+    auto stats = validator.getStats();
+    EXPECT_EQ(stats.trades_validated, 1);
+    EXPECT_EQ(stats.duplicate_trades, 1);
+    EXPECT_EQ(stats.validation_errors, 1);
+    EXPECT_EQ(validator.tradeCount(), 1);
+}
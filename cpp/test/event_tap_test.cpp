@@ -0,0 +1,200 @@
+#include "EventTap.h"
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+using namespace trading_ledger;
+
+namespace {
+
+Event trade(uint64_t seq, const std::string& trade_id) {
+    Event event;
+    event.sequence_num = seq;
+    event.timestamp_ns = seq * 10;
+    event.event_type = EventType::TRADE_CREATED;
+    event.payload = R"({"trade_id":")" + trade_id + R"(","symbol":"AAPL","quantity":1})";
+    return event;
+}
+
+std::vector<std::string> readLines(const std::string& path) {
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(file, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+}  // namespace
+
+TEST(TapFilterTest, ParsesAndMatches) {
+    TapFilter filter = TapFilter::parse({"type=TRADE_CREATED", "seq=10-20", "trade=t-7"});
+    EXPECT_EQ(filter.describe(), "type=TRADE_CREATED seq=10-20 trade=t-7");
+
+    Verdict passed = Verdict::passed();
+    EXPECT_TRUE(filter.matches(trade(15, "t-7").view(), passed));
+    EXPECT_FALSE(filter.matches(trade(15, "t-8").view(), passed));
+    EXPECT_FALSE(filter.matches(trade(21, "t-7").view(), passed));
+
+    Event ledger = trade(15, "t-7");
+    ledger.event_type = EventType::LEDGER_ENTRIES_GENERATED;
+    EXPECT_FALSE(filter.matches(ledger.view(), passed));
+
+    TapFilter failed = TapFilter::parse({"verdict=FAILED", "seq=100-"});
+    EXPECT_FALSE(failed.matches(trade(150, "x").view(), passed));
+    EXPECT_TRUE(failed.matches(trade(150, "x").view(), Verdict::failed(ValidationRule::DUPLICATE_TRADE)));
+    EXPECT_EQ(TapFilter::parse({}).describe(), "all");
+
+    EXPECT_THROW(TapFilter::parse({"color=red"}), std::invalid_argument);
+    EXPECT_THROW(TapFilter::parse({"seq=20-10"}), std::invalid_argument);
+    EXPECT_THROW(TapFilter::parse({"sample=0"}), std::invalid_argument);
+    EXPECT_THROW(TapFilter::parse({"type"}), std::invalid_argument);
+    EXPECT_THROW(TapFilter::parse({"type=256"}), std::invalid_argument);
+    try {
+        TapFilter::parse({"seq=99999999999999999999999"});
+        ADD_FAILURE() << "overflowing seq accepted";
+    } catch (const std::invalid_argument& e) {
+        EXPECT_EQ(std::string(e.what()).rfind("seq must be in [0, ", 0), 0u);
+    }
+}
+
+TEST(EventTapTest, WritesSampledMatchesToFile) {
+    std::string path = "/tmp/test_event_tap.txt";
+    std::remove(path.c_str());
+
+    EventTap tap;
+    for (uint64_t seq = 1; seq <= 5; ++seq) {
+        tap.offer(trade(seq, "t").view(), Verdict::passed());   // Disarmed: ignored
+    }
+    EXPECT_FALSE(tap.armed());
+    EXPECT_THROW(tap.arm(TapFilter{}), std::runtime_error);    // Not started
+
+    tap.start(path);
+    tap.arm(TapFilter::parse({"seq=100-", "sample=3"}));
+    for (uint64_t seq = 1; seq <= 120; ++seq) {
+        tap.offer(trade(seq, "t-" + std::to_string(seq)).view(), Verdict::passed());
+    }
+    tap.disarm();
+    tap.offer(trade(200, "late").view(), Verdict::passed());
+    tap.stop();
+
+    EventTap::Stats stats = tap.stats();
+    EXPECT_EQ(stats.matched, 21u);   // 100..120
+    EXPECT_EQ(stats.queued, 7u);     // 100, 103, .., 118
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(stats.written, 7u);
+
+    std::vector<std::string> lines = readLines(path);
+    ASSERT_EQ(lines.size(), 7u);
+    EXPECT_EQ(lines[0], R"(100 1000 TRADE_CREATED PASSED {"trade_id":"t-100","symbol":"AAPL","quantity":1})");
+    EXPECT_EQ(lines[6].substr(0, 4), "118 ");
+    std::remove(path.c_str());
+}
+
+TEST(EventTapTest, FullRingDropsInsteadOfBlocking) {
+    std::string path = "/tmp/test_event_tap_drop.txt";
+    std::remove(path.c_str());
+
+    // Payloads longer than MAX_PAYLOAD are truncated with a marker
+    EventTap tap;
+    tap.start(path);
+    tap.arm(TapFilter{});
+    Event big = trade(1, std::string(1000, 'x'));
+    for (size_t i = 0; i < 20 * EventTap::RING_SIZE; ++i) {
+        big.sequence_num = i + 1;
+        tap.offer(big.view(), Verdict::passed());
+    }
+    tap.disarm();
+    tap.stop();
+
+    EventTap::Stats stats = tap.stats();
+    EXPECT_EQ(stats.queued + stats.dropped, 20 * EventTap::RING_SIZE);
+    EXPECT_EQ(stats.written, stats.queued);
+    std::vector<std::string> lines = readLines(path);
+    ASSERT_FALSE(lines.empty());
+    EXPECT_NE(lines[0].find("...(" + std::to_string(big.payload.size()) + " bytes)"), std::string::npos);
+    std::remove(path.c_str());
+}
+
+TEST(EventTapTest, StreamsToUnixSocket) {
+    std::string path = "/tmp/test_event_tap.sock";
+    ::unlink(path.c_str());
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(listener, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    ASSERT_EQ(::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    ASSERT_EQ(::listen(listener, 1), 0);
+
+    EventTap tap;
+    tap.start("unix:" + path);
+    int reader = ::accept(listener, nullptr, nullptr);
+    ASSERT_GE(reader, 0);
+
+    tap.arm(TapFilter::parse({"trade=wanted"}));
+    tap.offer(trade(1, "other").view(), Verdict::passed());
+    tap.offer(trade(2, "wanted").view(), Verdict::failed(ValidationRule::DUPLICATE_TRADE));
+    tap.disarm();
+    tap.stop();
+
+    std::string received;
+    char buffer[512];
+    ssize_t n;
+    while ((n = ::read(reader, buffer, sizeof(buffer))) > 0) {
+        received.append(buffer, static_cast<size_t>(n));
+    }
+    EXPECT_EQ(received.rfind("2 20 TRADE_CREATED DUPLICATE_TRADE ", 0), 0u) << received;
+    EXPECT_EQ(std::count(received.begin(), received.end(), '\n'), 1);
+
+    ::close(reader);
+    ::close(listener);
+    ::unlink(path.c_str());
+    EXPECT_THROW(EventTap().start("unix:" + path), std::runtime_error);
+}
+
+TEST(EventTapTest, WriteFailureIsReportedAndDisarms) {
+    std::string path = "/tmp/test_event_tap_gone.sock";
+    ::unlink(path.c_str());
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(listener, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    ASSERT_EQ(::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    ASSERT_EQ(::listen(listener, 1), 0);
+
+    EventTap tap;
+    tap.start("unix:" + path);
+    ::close(::accept(listener, nullptr, nullptr));   // Reader goes away
+
+    tap.arm(TapFilter{});
+    tap.offer(trade(1, "t").view(), Verdict::passed());
+    for (int i = 0; i < 500 && tap.stats().error.empty(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_NE(tap.stats().error.find("Failed to write tap"), std::string::npos);
+
+    tap.offer(trade(2, "t").view(), Verdict::passed());   // Disarms instead of queueing
+    EXPECT_FALSE(tap.armed());
+    tap.offer(trade(3, "t").view(), Verdict::passed());
+    tap.stop();
+
+    EventTap::Stats stats = tap.stats();
+    EXPECT_EQ(stats.matched, 1u);
+    EXPECT_EQ(stats.queued, 1u);
+    EXPECT_EQ(stats.written, 0u);
+    EXPECT_EQ(stats.discarded, 1u);
+
+    ::close(listener);
+    ::unlink(path.c_str());
+}
@@ -0,0 +1,164 @@
+#include "FlightRecorder.h"
+#include "LogHistogram.h"
+#include "PipelineMetrics.h"
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+
+using namespace trading_ledger;
+
+class FlightRecorderTest : public ::testing::Test {
+protected:
+    std::string test_file_path = "/tmp/test_flight_recorder.bin";
+
+    void SetUp() override {
+        std::remove(test_file_path.c_str());
+    }
+
+    void TearDown() override {
+        std::remove(test_file_path.c_str());
+    }
+
+    static MetricSnapshot makeSnapshot(uint64_t n) {
+        MetricSnapshot snapshot;
+        snapshot.timestamp_ns = n * 1000000000ULL;
+        snapshot.events_read = n * 100;
+        snapshot.events_processed = n * 90;
+        snapshot.ring_occupancy = 10;
+        snapshot.ring_capacity = 4096;
+        snapshot.lag_events = n * 10;
+        snapshot.p99_ns = static_cast<int64_t>(n) * 1000;
+        return snapshot;
+    }
+};
+
+TEST_F(FlightRecorderTest, RecordAndReadBack) {
+    {
+        FlightRecorder recorder(test_file_path, 16);
+        recorder.open();
+        for (uint64_t n = 1; n <= 5; ++n) {
+            recorder.record(makeSnapshot(n));
+        }
+    }
+
+    auto snapshots = readFlightRecorder(test_file_path);
+    ASSERT_EQ(snapshots.size(), 5u);
+    EXPECT_EQ(snapshots[0].index, 1u);
+    EXPECT_EQ(snapshots[4].index, 5u);
+    EXPECT_EQ(snapshots[4].events_read, 500u);
+    EXPECT_EQ(snapshots[4].ring_capacity, 4096u);
+    EXPECT_EQ(snapshots[4].p99_ns, 5000);
+}
+
+TEST_F(FlightRecorderTest, WrapsAroundKeepingNewest) {
+    FlightRecorder recorder(test_file_path, 8);
+    recorder.open();
+    for (uint64_t n = 1; n <= 20; ++n) {
+        recorder.record(makeSnapshot(n));
+    }
+
+    // Readable while the recorder is still open
+    auto snapshots = readFlightRecorder(test_file_path);
+    ASSERT_EQ(snapshots.size(), 8u);
+    EXPECT_EQ(snapshots.front().index, 13u);
+    EXPECT_EQ(snapshots.back().index, 20u);
+    EXPECT_EQ(snapshots.back().events_read, 2000u);
+}
+
+TEST_F(FlightRecorderTest, ReopenContinuesAfterNewestRecord) {
+    {
+        FlightRecorder recorder(test_file_path, 8);
+        recorder.open();
+        for (uint64_t n = 1; n <= 10; ++n) {
+            recorder.record(makeSnapshot(n));
+        }
+    }
+
+    // Slot count comes from the existing file
+    FlightRecorder recorder(test_file_path, 1000);
+    recorder.open();
+    EXPECT_EQ(recorder.slotCount(), 8u);
+    EXPECT_EQ(recorder.nextIndex(), 11u);
+    recorder.record(makeSnapshot(11));
+
+    auto snapshots = readFlightRecorder(test_file_path);
+    ASSERT_EQ(snapshots.size(), 8u);
+    EXPECT_EQ(snapshots.back().index, 11u);
+}
+
+TEST_F(FlightRecorderTest, SkipsTornRecord) {
+    {
+        FlightRecorder recorder(test_file_path, 8);
+        recorder.open();
+        for (uint64_t n = 1; n <= 3; ++n) {
+            recorder.record(makeSnapshot(n));
+        }
+    }
+
+    // Simulate a crash in the middle of copying record 3 (slot 2)
+    int fd = open(test_file_path.c_str(), O_WRONLY);
+    ASSERT_GE(fd, 0);
+    uint8_t garbage[16] = {0xFF, 0xFF, 0xFF, 0xFF};
+    off_t offset = FlightRecorderHeader::SIZE + 2 * MetricSnapshot::SIZE + 40;
+    ASSERT_EQ(pwrite(fd, garbage, sizeof(garbage), offset), static_cast<ssize_t>(sizeof(garbage)));
+    close(fd);
+
+    auto snapshots = readFlightRecorder(test_file_path);
+    ASSERT_EQ(snapshots.size(), 2u);
+    EXPECT_EQ(snapshots.back().index, 2u);
+}
+
+TEST_F(FlightRecorderTest, RejectsForeignFile) {
+    FILE* file = std::fopen(test_file_path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    std::fputs("this is not a flight recorder file, just some text padding it out", file);
+    std::fclose(file);
+
+    EXPECT_THROW(readFlightRecorder(test_file_path), std::runtime_error);
+}
+
+TEST(LogHistogramTest, PercentilesWithinBucketPrecision) {
+    LogHistogram histogram;
+    for (int64_t v = 1; v <= 10000; ++v) {
+        histogram.record(v * 100);  // 100 ns .. 1 ms
+    }
+
+    EXPECT_EQ(histogram.count(), 10000u);
+    EXPECT_EQ(histogram.max(), 1000000);
+    EXPECT_NEAR(histogram.percentile(0.50), 500000, 500000 * 0.07);
+    EXPECT_NEAR(histogram.percentile(0.99), 990000, 990000 * 0.07);
+    EXPECT_LE(histogram.percentile(1.0), histogram.max());
+
+    histogram.clear();
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.percentile(0.99), 0);
+}
+
+TEST(LogHistogramTest, BucketBoundsAreContiguous) {
+    for (size_t i = 0; i + 1 < LogHistogram::BUCKET_COUNT; ++i) {
+        int64_t lower = LogHistogram::bucketLowerBound(i);
+        EXPECT_EQ(LogHistogram::bucketIndex(static_cast<uint64_t>(lower)), i);
+        EXPECT_EQ(LogHistogram::bucketUpperBound(i) + 1, LogHistogram::bucketLowerBound(i + 1));
+    }
+    EXPECT_EQ(LogHistogram::bucketIndex(INT64_MAX), LogHistogram::BUCKET_COUNT - 1);
+}
+
+TEST(IntervalLatencyHandoffTest, PublishesOnlyOnRequest) {
+    IntervalLatencyHandoff handoff;
+    LogHistogram histogram;
+    histogram.record(1000);
+    histogram.record(2000);
+
+    IntervalLatency interval;
+    handoff.request();
+    EXPECT_TRUE(handoff.requested());
+    EXPECT_FALSE(handoff.collect(interval));
+
+    handoff.publish(histogram);
+    EXPECT_FALSE(handoff.requested());
+    ASSERT_TRUE(handoff.collect(interval));
+    EXPECT_EQ(interval.count, 2u);
+    EXPECT_EQ(interval.max_ns, 2000);
+    EXPECT_EQ(histogram.count(), 0u);  // New interval started
+}
@@ -0,0 +1,206 @@
+#include "LedgerHistory.h"
+#include "EventFrames.h"
+#include "FixedPoint.h"
+#include "MappedLog.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+
+using namespace trading_ledger;
+using namespace trading_ledger::test;
+
+namespace {
+
+std::string trade(const std::string& account, const std::string& side, int quantity) {
+    return R"({"trade_id":"t","account_id":")" + account + R"(","symbol":"AAPL","side":")" + side +
+           R"(","quantity":)" + std::to_string(quantity) + R"(,"price":10})";
+}
+
+std::string entries(const std::string& account, int amount) {
+    return R"({"entries":[{"account_id":")" + account + R"(","entry_type":"DEBIT","amount":)" +
+           std::to_string(amount) + R"(},{"account_id":"CASH","entry_type":"CREDIT","amount":)" +
+           std::to_string(amount) + "}]}";
+}
+
+}  // namespace
+
+class LedgerHistoryTest : public ::testing::Test {
+protected:
+    std::string log_path = "/tmp/test_ledger_history.bin";
+    uint64_t next_seq = 1;
+
+    void SetUp() override {
+        removeFiles();
+        createLog(log_path);
+    }
+
+    void TearDown() override {
+        removeFiles();
+    }
+
+    void removeFiles() {
+        std::remove(log_path.c_str());
+        std::remove((log_path + ".idx").c_str());
+        std::remove((log_path + ".snap").c_str());
+    }
+
+    // Each round: a BUY of i, a SELL of 1, and a ledger debit of i
+    void appendRounds(int rounds) {
+        std::ofstream file(log_path, std::ios::binary | std::ios::app);
+        for (int i = 1; i <= rounds; ++i) {
+            for (const auto& frame : {frameEvent(next_seq, EventType::TRADE_CREATED, trade("ACC1", "BUY", i)),
+                                      frameEvent(next_seq + 1, EventType::TRADE_CREATED, trade("ACC1", "SELL", 1)),
+                                      frameEvent(next_seq + 2, EventType::LEDGER_ENTRIES_GENERATED,
+                                                 entries("ACC1", i))}) {
+                file.write(reinterpret_cast<const char*>(frame.data()), frame.size());
+            }
+            next_seq += 3;
+        }
+    }
+
+    static void expectSameState(const LedgerState& a, const LedgerState& b) {
+        EXPECT_EQ(a.sequence, b.sequence);
+        EXPECT_EQ(a.timestamp_ns, b.timestamp_ns);
+        EXPECT_EQ(a.events_applied, b.events_applied);
+        const auto* balance_a = a.balances.find("ACC1");
+        const auto* balance_b = b.balances.find("ACC1");
+        ASSERT_EQ(balance_a == nullptr, balance_b == nullptr);
+        if (balance_a != nullptr) {
+            EXPECT_EQ(balance_a->balance, balance_b->balance);
+            EXPECT_EQ(balance_a->entry_count, balance_b->entry_count);
+        }
+        const auto* position_a = a.positions.find("ACC1", "AAPL");
+        const auto* position_b = b.positions.find("ACC1", "AAPL");
+        ASSERT_EQ(position_a == nullptr, position_b == nullptr);
+        if (position_a != nullptr) {
+            EXPECT_EQ(position_a->net_quantity, position_b->net_quantity);
+            EXPECT_EQ(position_a->trade_count, position_b->trade_count);
+        }
+    }
+};
+
+TEST_F(LedgerHistoryTest, AsOfMatchesFullReplay) {
+    appendRounds(100);  // 300 events
+    LedgerHistory::Config config;
+    config.snapshot_interval = 50;
+    config.index_stride = 16;
+    LedgerHistory history(log_path, config);
+
+    LedgerHistory::UpdateStats update = history.update();
+    EXPECT_EQ(update.events_replayed, 300u);
+    EXPECT_EQ(update.snapshots_written, 6u);
+
+    for (uint64_t target : {1ull, 49ull, 50ull, 51ull, 173ull, 299ull, 300ull, 1000ull}) {
+        LedgerHistory::QueryStats stats;
+        auto state = history.asOfSequence(target, &stats);
+        EXPECT_LT(stats.events_replayed, 50u) << target;
+
+        // Reference: replay from the start with no sidecar files
+        LedgerState full;
+        MappedLog log(log_path);
+        size_t offset = FileHeader::SIZE;
+        while (offset + 28 <= log.size()) {
+            size_t total = 28 + EventParser::readUint32LE(log.data() + offset + 20);
+            EventView view = EventParser::parseView(log.data() + offset, total);
+            if (view.sequence_num > target) {
+                break;
+            }
+            full.apply(view);
+            offset += total;
+        }
+        expectSameState(*state, full);
+    }
+
+    auto state = history.asOfSequence(150);
+    // Rounds 1..50: bought 1+..+50, sold 50
+    EXPECT_EQ(state->positions.find("ACC1", "AAPL")->net_quantity, (1275 - 50) * FixedPoint::SCALE);
+    EXPECT_EQ(state->balances.find("ACC1")->entry_count, 50u);
+}
+
+TEST_F(LedgerHistoryTest, AsOfTimeUsesLogTimestamps) {
+    appendRounds(20);
+    LedgerHistory::Config config;
+    config.snapshot_interval = 10;
+    LedgerHistory history(log_path, config);
+    history.update();
+
+    LedgerHistory::QueryStats stats;
+    auto state = history.asOfTime(25500, &stats);   // Between seq 25 and 26
+    EXPECT_EQ(state->sequence, 25u);
+    EXPECT_EQ(stats.snapshot_sequence, 20u);
+    EXPECT_EQ(stats.events_replayed, 5u);
+
+    auto before = history.asOfTime(500);
+    EXPECT_EQ(before->sequence, 0u);
+    EXPECT_EQ(before->positions.size(), 0u);
+}
+
+TEST_F(LedgerHistoryTest, UpdateResumesFromLastSnapshot) {
+    appendRounds(10);
+    LedgerHistory::Config config;
+    config.snapshot_interval = 10;
+    LedgerHistory history(log_path, config);
+    EXPECT_EQ(history.update().snapshots_written, 3u);   // At 10, 20, 30
+
+    appendRounds(10);
+    LedgerHistory::UpdateStats second = history.update();
+    EXPECT_EQ(second.events_replayed, 30u);
+    EXPECT_EQ(second.snapshots_written, 3u);
+
+    SnapshotStore store(history.snapshotPath());
+    store.open();
+    ASSERT_EQ(store.catalog().size(), 6u);
+    EXPECT_EQ(store.catalog().back().sequence, 60u);
+
+    auto state = history.asOfSequence(60);
+    EXPECT_EQ(state->events_applied, 60u);
+    EXPECT_EQ(state->balances.find("ACC1")->entry_count, 20u);
+}
+
+TEST_F(LedgerHistoryTest, TornSnapshotTailIsIgnored) {
+    appendRounds(10);
+    LedgerHistory::Config config;
+    config.snapshot_interval = 10;
+    LedgerHistory history(log_path, config);
+    history.update();
+
+    // Simulate a crash mid-append: a length prefix with half a body
+    {
+        std::ofstream file(history.snapshotPath(), std::ios::binary | std::ios::app);
+        uint8_t partial[12] = {200, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8};
+        file.write(reinterpret_cast<const char*>(partial), sizeof(partial));
+    }
+    SnapshotStore store(history.snapshotPath());
+    store.open();
+    EXPECT_EQ(store.catalog().size(), 3u);
+
+    appendRounds(4);
+    history.update();
+    store.open();
+    ASSERT_EQ(store.catalog().size(), 4u);
+    EXPECT_EQ(store.catalog().back().sequence, 40u);
+    EXPECT_EQ(history.asOfSequence(40)->events_applied, 40u);
+}
+
+TEST_F(LedgerHistoryTest, SparseIndexFloorAndLocate) {
+    appendRounds(10);
+    MappedLog log(log_path);
+    SparseLogIndex index(4);
+    EXPECT_EQ(index.extend(log.data(), log.size()), 8u);   // Frames 1, 5, .., 29
+    EXPECT_EQ(index.floorBySequence(7)->sequence, 5u);
+    EXPECT_EQ(index.floorByTimestamp(12999)->sequence, 9u);
+    EXPECT_EQ(index.floorBySequence(0), nullptr);
+
+    uint64_t offset = index.locate(log.data(), log.size(), 7);
+    ASSERT_NE(offset, 0u);
+    EXPECT_EQ(EventParser::readUint64LE(log.data() + offset), 7u);
+    EXPECT_EQ(index.locate(log.data(), log.size(), 31), 0u);
+
+    std::string path = log_path + ".idx";
+    index.save(path);
+    SparseLogIndex loaded(4);
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.entries().size(), 8u);
+    EXPECT_EQ(loaded.scannedOffset(), log.size());
+    EXPECT_FALSE(SparseLogIndex(8).load(path));   // Stride mismatch
+}
@@ -0,0 +1,164 @@
+#include "MultiLedgerProcessor.h"
+#include "EventFrames.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+using namespace trading_ledger;
+using namespace trading_ledger::test;
+
+namespace {
+
+std::string tradePayload(uint64_t n) {
+    char trade_id[37];
+    std::snprintf(trade_id, sizeof(trade_id), "00000000-0000-4000-8000-%012llx",
+                  static_cast<unsigned long long>(n));
+    return std::string(R"({"trade_id":")") + trade_id +
+           R"(","account_id":"ACC1","symbol":"AAPL","quantity":10,"price":100.0,"side":"BUY"})";
+}
+
+void appendTrades(const std::string& path, uint64_t first, uint64_t count) {
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    for (uint64_t n = first; n < first + count; ++n) {
+        auto frame = frameEvent(n, EventType::TRADE_CREATED, tradePayload(n));
+        file.write(reinterpret_cast<const char*>(frame.data()), frame.size());
+    }
+}
+
+}  // namespace
+
+class MultiLedgerProcessorTest : public ::testing::Test {
+protected:
+    std::vector<std::string> paths = {
+        "/tmp/test_multi_ledger_a.bin",
+        "/tmp/test_multi_ledger_b.bin",
+        "/tmp/test_multi_ledger_c.bin",
+    };
+
+    void SetUp() override {
+        for (const auto& path : paths) {
+            createLog(path);
+        }
+    }
+
+    void TearDown() override {
+        for (const auto& path : paths) {
+            std::remove(path.c_str());
+        }
+    }
+
+    // Poll until fn() holds or 5 s elapse
+    template<typename Fn>
+    static bool waitFor(Fn fn) {
+        for (int i = 0; i < 500; ++i) {
+            if (fn()) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return fn();
+    }
+};
+
+TEST_F(MultiLedgerProcessorTest, ProcessesEveryLedgerWithIsolatedState) {
+    // Same trade ids in every ledger: duplicates only within a ledger
+    appendTrades(paths[0], 1, 10000);
+    appendTrades(paths[1], 1, 50);
+    appendTrades(paths[2], 1, 50);
+    appendTrades(paths[2], 1, 5);  // 5 duplicates in ledger c
+
+    MultiLedgerProcessor::Config config;
+    config.worker_count = 2;
+    config.quantum = 64;
+    MultiLedgerProcessor processor(config);
+    processor.addLedger("a", paths[0]);
+    processor.addLedger("b", paths[1]);
+    processor.addLedger("c", paths[2]);
+    processor.start();
+
+    ASSERT_TRUE(waitFor([&] {
+        auto s = processor.stats();
+        return s[0].events_processed == 10000 && s[1].events_processed == 50 &&
+               s[2].events_processed == 55;
+    }));
+    processor.stop();
+
+    auto stats = processor.stats();
+    EXPECT_EQ(stats[0].name, "a");
+    EXPECT_EQ(stats[0].validation_failures, 0u);
+    EXPECT_EQ(stats[1].validation_failures, 0u);
+    EXPECT_EQ(stats[2].validation_failures, 5u);
+
+    // The busy ledger was processed in quanta, not in one turn
+    EXPECT_GE(stats[0].turns, 10000u / config.quantum);
+}
+
+TEST_F(MultiLedgerProcessorTest, FollowsAppendsToAnyLedger) {
+    MultiLedgerProcessor processor;
+    processor.addLedger("a", paths[0]);
+    processor.addLedger("b", paths[1]);
+    processor.start();
+
+    appendTrades(paths[1], 1, 20);
+    ASSERT_TRUE(waitFor([&] { return processor.stats()[1].events_processed == 20; }));
+    EXPECT_EQ(processor.stats()[0].events_processed, 0u);
+
+    appendTrades(paths[0], 1, 7);
+    ASSERT_TRUE(waitFor([&] { return processor.stats()[0].events_processed == 7; }));
+
+    processor.stop();
+}
+
+TEST_F(MultiLedgerProcessorTest, CorruptedLogStopsOnlyItsLedger) {
+    appendTrades(paths[0], 1, 10);
+    appendTrades(paths[1], 1, 3);
+    {
+        // Flip a payload byte of ledger b's last event (CRC mismatch)
+        std::fstream file(paths[1], std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-10, std::ios::end);
+        file.put('#');
+    }
+
+    MultiLedgerProcessor processor;
+    processor.addLedger("a", paths[0]);
+    processor.addLedger("b", paths[1]);
+    processor.start();
+
+    ASSERT_TRUE(waitFor([&] { return processor.stats()[1].failed; }));
+    appendTrades(paths[0], 11, 5);
+    ASSERT_TRUE(waitFor([&] { return processor.stats()[0].events_processed == 15; }));
+    processor.stop();
+
+    auto stats = processor.stats();
+    EXPECT_FALSE(stats[0].failed);
+    EXPECT_EQ(stats[1].events_processed, 2u);
+}
+
+TEST_F(MultiLedgerProcessorTest, StopProcessesEveryEventRead) {
+    // Far more than a ring, stopped mid-log: whatever was read, including
+    // an event held by a reader parked on a full ring, is delivered. Whether
+    // the reader gets ahead of the worker depends on scheduling, so only the
+    // drain is asserted.
+    appendTrades(paths[0], 1, 4 * MultiLedgerProcessor::RING_SIZE);
+
+    MultiLedgerProcessor::Config config;
+    config.worker_count = 1;
+    MultiLedgerProcessor processor(config);
+    processor.addLedger("a", paths[0]);
+    processor.start();
+    ASSERT_TRUE(waitFor([&] { return processor.stats()[0].events_read > 0; }));
+    processor.stop();
+
+    auto stats = processor.stats();
+    EXPECT_GT(stats[0].events_read, 0u);
+    EXPECT_EQ(stats[0].events_processed, stats[0].events_read);
+    EXPECT_EQ(stats[0].backlog, 0u);
+}
+
+TEST_F(MultiLedgerProcessorTest, RejectsMissingLog) {
+    MultiLedgerProcessor processor;
+    EXPECT_THROW(processor.addLedger("missing", "/tmp/does_not_exist_multi_ledger.bin"),
+                 std::runtime_error);
+}
@@ -0,0 +1,238 @@
+#include "Pipeline.h"
+#include "EventFrames.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace trading_ledger;
+using namespace trading_ledger::test;
+
+namespace {
+
+TopologyConfig parseText(const std::string& text) {
+    std::istringstream in(text);
+    return TopologyConfig::parse(in);
+}
+
+std::string parseError(const std::string& text) {
+    try {
+        parseText(text);
+    } catch (const std::invalid_argument& e) {
+        return e.what();
+    }
+    return "";
+}
+
+// Each trade is followed by its balanced ledger entries
+void writeLog(const std::string& path, int trades) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    uint8_t header[16] = {0x44, 0x41, 0x52, 0x54, 0x01};  // "TRAD", version 1
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    uint64_t seq = 1;
+    for (int i = 0; i < trades; ++i) {
+        std::string id = "t-" + std::to_string(i);
+        std::string account = "ACC" + std::to_string(i % 5);
+        std::string trade = R"({"trade_id":")" + id + R"(","account_id":")" + account +
+                            R"(","symbol":"AAPL","side":"BUY","quantity":1,"price":10})";
+        std::string entries = R"({"trade_id":")" + id + R"(","entries":[{"account_id":")" + account +
+                              R"(","entry_type":"DEBIT","amount":10},{"account_id":"CASH","entry_type":"CREDIT","amount":10}]})";
+        for (const auto& frame : {frameEvent(seq, EventType::TRADE_CREATED, trade),
+                                  frameEvent(seq + 1, EventType::LEDGER_ENTRIES_GENERATED, entries)}) {
+            file.write(reinterpret_cast<const char*>(frame.data()), frame.size());
+        }
+        seq += 2;
+    }
+}
+
+const Pipeline::NodeStats& statsFor(const std::vector<Pipeline::NodeStats>& stats, const std::string& name) {
+    for (const auto& s : stats) {
+        if (s.name == name) {
+            return s;
+        }
+    }
+    throw std::runtime_error("no node " + name);
+}
+
+}  // namespace
+
+TEST(TopologyConfigTest, ParsesAndWritesBack) {
+    TopologyConfig config = parseText(
+        "# comment line\n"
+        "source events follow=no cpu=0\n"
+        "stage validate kind=validate input=events parallelism=2 ring=1024 wait=spin cpu=1,2\n"
+        "stage balances kind=balances input=validate ring=8192 wait=yield   # trailing comment\n"
+        "stage positions kind=positions input=validate ring=512 wait=sleep\n"
+        "monitor interval=0\n");
+
+    ASSERT_EQ(config.nodes.size(), 4u);
+    const NodeConfig* validate = config.find("validate");
+    ASSERT_NE(validate, nullptr);
+    EXPECT_EQ(validate->kind, NodeKind::VALIDATE);
+    EXPECT_EQ(validate->parallelism, 2u);
+    EXPECT_EQ(validate->ring_size, 1024u);
+    EXPECT_EQ(validate->wait, WaitStrategy::SPIN);
+    EXPECT_EQ(validate->cpus, (std::vector<int>{1, 2}));
+    EXPECT_FALSE(config.nodes[0].follow);
+    EXPECT_EQ(config.monitor_interval_seconds, 0u);
+
+    std::ostringstream written;
+    config.write(written);
+    std::istringstream again(written.str());
+    std::ostringstream rewritten;
+    TopologyConfig::parse(again).write(rewritten);
+    EXPECT_EQ(written.str(), rewritten.str());
+
+    EXPECT_EQ(TopologyConfig::defaultTopology().nodes.size(), 3u);
+}
+
+TEST(TopologyConfigTest, RejectsBadTopologies) {
+    EXPECT_EQ(parseError("source a\nstage b kind=validate input=c\n"),
+              "line 2: input 'c' of b is not declared above it");
+    EXPECT_EQ(parseError("source a\nstage b kind=mystery input=a\n").rfind("line 2: unknown stage kind", 0), 0u);
+    EXPECT_EQ(parseError("source a\nstage b input=a\n"), "line 2: stage b needs kind=");
+    EXPECT_EQ(parseError("source a\nsource a\n"), "line 2: duplicate node name 'a'");
+    EXPECT_EQ(parseError("source a\nstage b kind=sink input=a ring=1000\n"),
+              "stage b: ring must be a power of 2 in [2, 2^24]");
+    EXPECT_EQ(parseError("source a\nstage b kind=balances input=a parallelism=2\n"),
+              "stage b: balances cannot be sharded (an event spans accounts)");
+    EXPECT_EQ(parseError("source a\nstage b kind=sink input=a wait=nap\n").rfind("line 2: unknown wait", 0), 0u);
+    EXPECT_EQ(parseError("stage b kind=sink\n"), "stage b needs input=");
+    EXPECT_EQ(parseError("# nothing\n"), "topology needs a source");
+    EXPECT_EQ(parseError("sauce a\n").rfind("line 1: unknown directive", 0), 0u);
+    EXPECT_EQ(parseError("source a\nstage b kind=sink input=a ring=99999999999999999999999\n")
+                  .rfind("line 2: ring must be in [", 0), 0u);
+    EXPECT_EQ(parseError("source a cpu=4294967297\n").rfind("line 1: cpu must be in [0, ", 0), 0u);
+    EXPECT_EQ(parseError("source a\nstage b kind=sink input=a slo=-5\n"),
+              "line 2: slo needs a whole number, got '-5'");
+    EXPECT_EQ(parseError("monitor interval=4294967296\n").rfind("line 1: interval must be in [", 0), 0u);
+}
+
+TEST(TopologyConfigTest, ParsesElasticStages) {
+    TopologyConfig config = parseText(
+        "source events\n"
+        "stage validate kind=validate input=events parallelism=8 min=2 slo=250\n"
+        "stage sink kind=sink input=validate parallelism=2 min=2\n");
+    const NodeConfig* validate = config.find("validate");
+    EXPECT_TRUE(validate->elastic());
+    EXPECT_EQ(validate->min_parallelism, 2u);
+    EXPECT_EQ(validate->slo_us, 250u);
+    EXPECT_FALSE(config.find("sink")->elastic());   // min == parallelism: fixed
+
+    std::ostringstream written;
+    config.write(written);
+    EXPECT_NE(written.str().find("parallelism=8 ring=4096 wait=notify min=2 slo=250"), std::string::npos)
+        << written.str();
+
+    EXPECT_EQ(parseError("source a\nstage b kind=validate input=a parallelism=2 min=3\n"),
+              "stage b: min must not exceed parallelism");
+    EXPECT_EQ(parseError("source a\nstage b kind=positions input=a parallelism=4 min=1\n"),
+              "stage b: only validate stages can be elastic");
+    EXPECT_EQ(parseError("source a\nstage b kind=validate input=a parallelism=4 min=1 slo=0\n"),
+              "stage b: slo must be positive");
+}
+
+TEST(PipelineTest, ShardedStagesSeeEveryEvent) {
+    std::string path = "/tmp/test_pipeline.bin";
+    writeLog(path, 2000);
+
+    Pipeline pipeline(parseText(
+        "source events follow=no\n"
+        "stage validate kind=validate input=events parallelism=3 ring=64 wait=notify\n"
+        "stage balances kind=balances input=validate ring=128 wait=yield\n"
+        "stage positions kind=positions input=validate parallelism=2 ring=16 wait=sleep\n"
+        "stage sink kind=sink input=balances,positions ring=32 wait=spin\n"),
+        path);
+    pipeline.start();
+    pipeline.join();
+    EXPECT_TRUE(pipeline.finished());
+
+    std::vector<Pipeline::NodeStats> stats = pipeline.stats();
+    EXPECT_EQ(statsFor(stats, "events").events, 4000u);
+    EXPECT_EQ(statsFor(stats, "validate").events, 4000u);
+    EXPECT_EQ(statsFor(stats, "validate").failures, 0u);   // Both halves of a trade reach one shard
+    EXPECT_EQ(statsFor(stats, "balances").events, 4000u);
+    EXPECT_EQ(statsFor(stats, "positions").events, 4000u);
+    EXPECT_EQ(statsFor(stats, "sink").events, 8000u);       // Fan-in of two edges
+    for (const auto& s : stats) {
+        EXPECT_EQ(s.queued, 0u) << s.name;
+        EXPECT_TRUE(s.error.empty()) << s.name << ": " << s.error;
+    }
+
+    std::ostringstream report;
+    pipeline.report(report);
+    EXPECT_NE(report.str().find("trades validated: 2000, errors: 0"), std::string::npos) << report.str();
+    EXPECT_NE(report.str().find("positions: 5"), std::string::npos) << report.str();
+    std::remove(path.c_str());
+}
+
+TEST(PipelineTest, ElasticStageKeepsStateAcrossRebalances) {
+    std::string path = "/tmp/test_pipeline_elastic.bin";
+    writeLog(path, 50000);
+
+    // A 1us SLO: any backlog asks for another worker
+    Pipeline pipeline(parseText(
+        "source events follow=no\n"
+        "stage validate kind=validate input=events parallelism=4 min=1 slo=1 ring=256 wait=yield\n"
+        "stage balances kind=balances input=validate ring=1024 wait=yield\n"),
+        path);
+    pipeline.start();
+    pipeline.join();
+
+    std::vector<Pipeline::NodeStats> stats = pipeline.stats();
+    const Pipeline::NodeStats& validate = statsFor(stats, "validate");
+    EXPECT_EQ(validate.events, 100000u);
+    EXPECT_EQ(validate.failures, 0u);   // Each trade's shard state moved as a whole
+    EXPECT_GE(validate.active_workers, 1u);
+    EXPECT_LE(validate.active_workers, 4u);
+    EXPECT_EQ(statsFor(stats, "balances").events, 100000u);
+    for (const auto& s : stats) {
+        EXPECT_EQ(s.queued, 0u) << s.name;
+        EXPECT_TRUE(s.error.empty()) << s.name << ": " << s.error;
+    }
+
+    std::ostringstream report;
+    pipeline.report(report);
+    EXPECT_NE(report.str().find("trades validated: 50000, errors: 0, duplicates: 0"), std::string::npos)
+        << report.str();
+    std::remove(path.c_str());
+}
+
+TEST(PipelineTest, SlowDownstreamDoesNotScaleUpstream) {
+    std::string path = "/tmp/test_pipeline_backpressure.bin";
+    writeLog(path, 20000);
+
+    // The balances stage sleeps whenever its 2-slot ring runs dry, so it
+    // caps throughput; validate spends most of its time blocked in emit()
+    Pipeline pipeline(parseText(
+        "source events follow=no\n"
+        "stage validate kind=validate input=events parallelism=4 min=1 slo=1000000 ring=256 wait=yield\n"
+        "stage balances kind=balances input=validate ring=2 wait=sleep\n"),
+        path);
+    pipeline.start();
+    pipeline.join();
+
+    std::vector<Pipeline::NodeStats> stats = pipeline.stats();
+    const Pipeline::NodeStats& validate = statsFor(stats, "validate");
+    EXPECT_EQ(validate.events, 40000u);
+    EXPECT_EQ(validate.rebalances, 0u);
+    EXPECT_EQ(validate.active_workers, 1u);
+    EXPECT_EQ(statsFor(stats, "balances").events, 40000u);
+    std::remove(path.c_str());
+}
+
+TEST(PipelineTest, SourceErrorEndsPipeline) {
+    Pipeline pipeline(parseText("source events follow=no\nstage sink kind=sink input=events\n"),
+                      "/tmp/test_pipeline_missing.bin");
+    pipeline.start();
+    pipeline.join();
+    std::vector<Pipeline::NodeStats> stats = pipeline.stats();
+    EXPECT_FALSE(statsFor(stats, "events").error.empty());
+    EXPECT_EQ(statsFor(stats, "sink").events, 0u);
+
+    std::ostringstream report;
+    pipeline.report(report);
+    EXPECT_NE(report.str().find("  error: " + statsFor(stats, "events").error), std::string::npos)
+        << report.str();
+}
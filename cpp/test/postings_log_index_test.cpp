@@ -0,0 +1,178 @@
+#include "PostingsLogIndex.h"
+#include "EventFrames.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace trading_ledger;
+using namespace trading_ledger::test;
+
+namespace {
+
+std::string trade(const std::string& account, const std::string& symbol) {
+    return R"({"trade_id":"t","account_id":")" + account + R"(","symbol":")" + symbol +
+           R"(","side":"BUY","quantity":1,"price":10})";
+}
+
+std::string entries(const std::string& debit, const std::string& credit) {
+    return R"({"entries":[{"account_id":")" + debit + R"(","entry_type":"DEBIT","amount":10},)" +
+           R"({"account_id":")" + credit + R"(","entry_type":"CREDIT","amount":10}]})";
+}
+
+const char* const SYMBOLS[] = {"AAPL", "MSFT", "TSLA", "NVDA", "AMZN"};
+
+}  // namespace
+
+class PostingsLogIndexTest : public ::testing::Test {
+protected:
+    std::string path = "/tmp/test_postings_log_index.pidx";
+    std::vector<uint8_t> log = std::vector<uint8_t>(FileHeader::SIZE);
+    std::vector<uint64_t> offsets;   // Frame starts, by sequence - 1
+
+    void SetUp() override { std::remove(path.c_str()); }
+    void TearDown() override { std::remove(path.c_str()); }
+
+    // Event i: a trade of ACC(i % 3) in SYMBOLS[i % 5]; every fourth event is
+    // a ledger event debiting that account against CASH instead
+    void appendEvents(uint64_t count) {
+        for (uint64_t n = 0; n < count; ++n) {
+            uint64_t seq = offsets.size() + 1;
+            std::string account = "ACC" + std::to_string(seq % 3);
+            offsets.push_back(log.size());
+            if (seq % 4 == 0) {
+                appendFrame(log, seq, EventType::LEDGER_ENTRIES_GENERATED, entries(account, "CASH"));
+            } else {
+                appendFrame(log, seq, EventType::TRADE_CREATED, trade(account, SYMBOLS[seq % 5]));
+            }
+        }
+    }
+
+    // What a full scan would find
+    std::vector<uint64_t> scan(const std::string& account, const std::string& symbol) const {
+        std::vector<uint64_t> out;
+        for (size_t i = 0; i < offsets.size(); ++i) {
+            uint64_t seq = i + 1;
+            bool account_match = account.empty() || "ACC" + std::to_string(seq % 3) == account ||
+                                 (account == "CASH" && seq % 4 == 0);
+            bool symbol_match = symbol.empty() || (seq % 4 != 0 && symbol == SYMBOLS[seq % 5]);
+            if (account_match && symbol_match) {
+                out.push_back(offsets[i]);
+            }
+        }
+        return out;
+    }
+};
+
+TEST_F(PostingsLogIndexTest, PostingsMatchFullScan) {
+    appendEvents(3000);   // ~1000 postings per account: several packed blocks
+    PostingsLogIndex index;
+    EXPECT_EQ(index.extend(log.data(), log.size()), 3000u);
+    EXPECT_EQ(index.scannedOffset(), log.size());
+    EXPECT_EQ(index.lastSequence(), 3000u);
+    EXPECT_EQ(index.keyCount(PostingsLogIndex::Field::ACCOUNT), 4u);   // ACC0..2, CASH
+    EXPECT_EQ(index.keyCount(PostingsLogIndex::Field::SYMBOL), 5u);
+
+    for (const char* account : {"ACC0", "ACC1", "ACC2", "CASH"}) {
+        EXPECT_EQ(index.postings(PostingsLogIndex::Field::ACCOUNT, account), scan(account, ""));
+    }
+    EXPECT_EQ(index.postings(PostingsLogIndex::Field::SYMBOL, "NVDA"), scan("", "NVDA"));
+    EXPECT_TRUE(index.postings(PostingsLogIndex::Field::ACCOUNT, "ACC9").empty());
+
+    // Well under the 8 bytes of a raw offset, unpacked tails included
+    EXPECT_LT(index.compressedBytes() * 2, index.postingCount() * 8);
+}
+
+TEST_F(PostingsLogIndexTest, IntersectionMatchesFullScan) {
+    appendEvents(5000);
+    PostingsLogIndex index;
+    index.extend(log.data(), log.size());
+
+    for (const char* account : {"ACC0", "ACC1", "ACC2"}) {
+        for (const char* symbol : SYMBOLS) {
+            std::vector<uint64_t> expected = scan(account, symbol);
+            ASSERT_FALSE(expected.empty());
+            EXPECT_EQ(index.intersect(account, symbol), expected) << account << " AND " << symbol;
+        }
+    }
+    EXPECT_TRUE(index.intersect("CASH", "AAPL").empty());   // Ledger events have no symbol
+    EXPECT_TRUE(index.intersect("ACC1", "IBM").empty());
+
+    // The frames listed are the ones asked for
+    for (uint64_t offset : index.intersect("ACC1", "TSLA")) {
+        EventView event = EventParser::parseView(log.data() + offset, log.size() - offset);
+        EXPECT_NE(event.payload.find(R"("account_id":"ACC1")"), std::string_view::npos);
+        EXPECT_NE(event.payload.find(R"("symbol":"TSLA")"), std::string_view::npos);
+    }
+}
+
+TEST_F(PostingsLogIndexTest, ExtendsIncrementallyAndIgnoresIndexedFrames) {
+    appendEvents(200);
+    size_t partial = log.size() + 10;
+    appendEvents(300);
+
+    PostingsLogIndex index;
+    EXPECT_EQ(index.extend(log.data(), partial), 200u);   // Trailing frame left for later
+    EXPECT_EQ(index.scannedOffset(), offsets[200]);
+    EXPECT_EQ(index.extend(log.data(), log.size()), 300u);
+    EXPECT_EQ(index.extend(log.data(), log.size()), 0u);
+
+    // Fed again from the start (a restarted consumer): nothing is posted twice
+    EventView first = EventParser::parseView(log.data() + offsets[0], log.size() - offsets[0]);
+    EXPECT_FALSE(index.add(first, offsets[0]));
+    EXPECT_EQ(index.postings(PostingsLogIndex::Field::ACCOUNT, "ACC2"), scan("ACC2", ""));
+}
+
+TEST_F(PostingsLogIndexTest, WideGapsStoreBlockUnpacked) {
+    PostingsLogIndex index;
+    std::string payload = trade("ACC1", "AAPL");
+    std::vector<uint64_t> expected;
+    uint64_t offset = FileHeader::SIZE;
+    for (uint64_t seq = 1; seq <= 300; ++seq) {
+        EventView event{seq, seq, EventType::TRADE_CREATED, payload, 0};
+        ASSERT_TRUE(index.add(event, offset));
+        expected.push_back(offset);
+        offset += seq == 100 ? (uint64_t{5} << 32) : event.totalSize();   // One 20 GiB gap
+    }
+    EXPECT_EQ(index.postings(PostingsLogIndex::Field::ACCOUNT, "ACC1"), expected);
+    EXPECT_EQ(index.intersect("ACC1", "AAPL"), expected);
+
+    index.save(path);
+    PostingsLogIndex loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.postings(PostingsLogIndex::Field::SYMBOL, "AAPL"), expected);
+}
+
+TEST_F(PostingsLogIndexTest, SaveAndLoad) {
+    appendEvents(1000);
+    PostingsLogIndex index;
+    index.extend(log.data(), 0);   // Nothing yet
+    index.extend(log.data(), log.size());
+    index.save(path);
+
+    PostingsLogIndex loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.scannedOffset(), index.scannedOffset());
+    EXPECT_EQ(loaded.framesScanned(), 1000u);
+    EXPECT_EQ(loaded.lastOffset(), offsets.back());
+    EXPECT_EQ(loaded.lastSequence(), 1000u);
+    EXPECT_EQ(loaded.postingCount(), index.postingCount());
+    EXPECT_EQ(loaded.intersect("ACC0", "AMZN"), index.intersect("ACC0", "AMZN"));
+
+    // Loaded lists keep growing from their unpacked tails
+    appendEvents(500);
+    EXPECT_EQ(loaded.extend(log.data(), log.size()), 500u);
+    EXPECT_EQ(loaded.postings(PostingsLogIndex::Field::ACCOUNT, "CASH"), scan("CASH", ""));
+
+    // Damaged file: rejected, index left empty
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(60);
+        file.put('\x7f');
+    }
+    EXPECT_FALSE(loaded.load(path));
+    EXPECT_EQ(loaded.postingCount(), 0u);
+    EXPECT_EQ(loaded.scannedOffset(), FileHeader::SIZE);
+    EXPECT_FALSE(loaded.load(path + ".missing"));
+}
@@ -0,0 +1,79 @@
+#include "ProgressWatermark.h"
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+using namespace trading_ledger;
+
+class ProgressWatermarkTest : public ::testing::Test {
+protected:
+    std::string path = "/tmp/test_progress_watermark.wm";
+
+    void SetUp() override { std::remove(path.c_str()); }
+    void TearDown() override { std::remove(path.c_str()); }
+};
+
+TEST_F(ProgressWatermarkTest, ReaderSeesPublishedProgress) {
+    ProgressWatermark watermark(path);
+    watermark.open();
+    WatermarkReader reader(path);
+    EXPECT_EQ(reader.pid(), static_cast<uint32_t>(getpid()));
+    EXPECT_GT(reader.startedNs(), 0u);
+    EXPECT_EQ(reader.sequence(), 0u);
+
+    watermark.publish(42, 4096, 1000, 2000);
+    EXPECT_EQ(reader.sequence(), 42u);
+    EXPECT_EQ(reader.offset(), 4096u);
+    WatermarkProgress progress = reader.read();
+    EXPECT_EQ(progress.sequence, 42u);
+    EXPECT_EQ(progress.offset, 4096u);
+    EXPECT_EQ(progress.event_timestamp_ns, 1000u);
+    EXPECT_EQ(progress.published_ns, 2000u);
+
+    // Progress line starts on its own cache line
+    std::ifstream file(path, std::ios::binary);
+    uint8_t bytes[ProgressWatermark::FILE_SIZE];
+    file.read(reinterpret_cast<char*>(bytes), sizeof(bytes));
+    ASSERT_EQ(file.gcount(), static_cast<std::streamsize>(sizeof(bytes)));
+    EXPECT_EQ(bytes[ProgressWatermark::LINE], 42);
+    EXPECT_EQ(bytes[ProgressWatermark::LINE + 9], 0x10);   // 4096 little-endian
+}
+
+TEST_F(ProgressWatermarkTest, ReopenKeepsReadersMapping) {
+    WatermarkProgress progress;
+    {
+        ProgressWatermark first(path);
+        first.open();
+        first.publish(7, 100, 1, 2);
+    }
+    WatermarkReader reader(path);   // Mapped before the restart
+    EXPECT_EQ(reader.sequence(), 7u);
+
+    ProgressWatermark second(path);
+    second.open();
+    EXPECT_EQ(reader.sequence(), 7u);   // Kept until the first publish
+    second.publish(8, 200, 3, 4);
+    progress = reader.read();
+    EXPECT_EQ(progress.sequence, 8u);
+    EXPECT_EQ(progress.offset, 200u);
+}
+
+TEST_F(ProgressWatermarkTest, RejectsOtherFiles) {
+    EXPECT_THROW(WatermarkReader("/nonexistent/watermark"), std::runtime_error);
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << std::string(ProgressWatermark::FILE_SIZE, 'x');
+    }
+    EXPECT_THROW(WatermarkReader reader(path), std::runtime_error);
+
+    // The publisher takes such a file over from zero progress
+    ProgressWatermark watermark(path);
+    watermark.open();
+    WatermarkReader reader(path);
+    EXPECT_EQ(reader.sequence(), 0u);
+
+    ProgressWatermark unwritable("/nonexistent/watermark");
+    EXPECT_THROW(unwritable.open(), std::runtime_error);
+}
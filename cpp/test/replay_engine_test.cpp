@@ -0,0 +1,192 @@
+#include "ReplayEngine.h"
+#include "EventFrames.h"
+#include "FixedPoint.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace trading_ledger;
+using namespace trading_ledger::test;
+
+namespace {
+
+std::string trade(const std::string& id, int quantity, int price) {
+    return R"({"trade_id":")" + id + R"(","symbol":"AAPL","quantity":)" +
+           std::to_string(quantity) + R"(,"price":)" + std::to_string(price) + "}";
+}
+
+class ThrowingConsumer : public ReplayConsumer {
+public:
+    ThrowingConsumer() : ReplayConsumer("throwing") {}
+    void onBatch(const ReplayBatch&) override { throw std::runtime_error("rule crashed"); }
+    void report(std::ostream&) const override {}
+};
+
+}  // namespace
+
+class ReplayEngineTest : public ::testing::Test {
+protected:
+    std::string log_path = "/tmp/test_replay_log.bin";
+    uint64_t next_seq = 1;
+
+    void SetUp() override {
+        createLog(log_path);
+    }
+
+    void TearDown() override {
+        std::remove(log_path.c_str());
+    }
+
+    void append(EventType type, const std::string& payload) {
+        std::ofstream file(log_path, std::ios::binary | std::ios::app);
+        auto frame = frameEvent(next_seq++, type, payload);
+        file.write(reinterpret_cast<const char*>(frame.data()), frame.size());
+    }
+};
+
+TEST(ValidatorLimitsTest, QuantityAndNotionalLimits) {
+    DoubleEntryValidator::Config config;
+    config.max_quantity = 500 * FixedPoint::SCALE;
+    config.max_notional = 10000 * FixedPoint::SCALE;
+    DoubleEntryValidator validator(config);
+    validator.setLogging(false);
+
+    Event event;
+    event.event_type = EventType::TRADE_CREATED;
+    event.payload = trade("t-1", 50, 100);  // 5000
+    EXPECT_EQ(validator.processEvent(event).code, VerdictCode::PASSED);
+
+    event.payload = trade("t-2", 600, 1);
+    EXPECT_EQ(validator.processEvent(event).rule, ValidationRule::QUANTITY_LIMIT);
+
+    event.payload = trade("t-3", 200, 100);  // 20000
+    EXPECT_EQ(validator.processEvent(event).rule, ValidationRule::NOTIONAL_LIMIT);
+
+    // The id of a rejected trade is recorded: resubmitting it is a duplicate
+    event.payload = trade("t-3", 20, 100);
+    EXPECT_EQ(validator.processEvent(event).rule, ValidationRule::DUPLICATE_TRADE);
+
+    // A negative quantity is held to the same bound
+    event.payload = trade("t-4", -600, 1);
+    EXPECT_EQ(validator.processEvent(event).rule, ValidationRule::QUANTITY_LIMIT);
+    event.payload = trade("t-5", -50, 1);
+    EXPECT_EQ(validator.processEvent(event).code, VerdictCode::PASSED);
+}
+
+TEST(ValidatorLimitsTest, BatchChecksDuplicatesBeforeLimits) {
+    DoubleEntryValidator::Config config;
+    config.max_quantity = 500 * FixedPoint::SCALE;
+    DoubleEntryValidator validator(config);
+    validator.setLogging(false);
+
+    std::string payloads[] = {trade("t-1", 600, 1), trade("t-1", 10, 1), trade("t-2", 10, 1)};
+    EventView events[3];
+    for (size_t i = 0; i < 3; ++i) {
+        events[i].event_type = EventType::TRADE_CREATED;
+        events[i].payload = payloads[i];
+    }
+    Verdict verdicts[3];
+    validator.processBatch(events, 3, verdicts);
+
+    EXPECT_EQ(verdicts[0].rule, ValidationRule::QUANTITY_LIMIT);
+    EXPECT_EQ(verdicts[1].rule, ValidationRule::DUPLICATE_TRADE);
+    EXPECT_EQ(verdicts[2].code, VerdictCode::PASSED);
+}
+
+TEST_F(ReplayEngineTest, TruncatedTailAbortsReplay) {
+    append(EventType::TRADE_CREATED, trade("t-1", 1, 1));
+    append(EventType::TRADE_CREATED, trade("t-2", 1, 1));
+    size_t full_size = 0;
+    {
+        std::ifstream in(log_path, std::ios::binary | std::ios::ate);
+        full_size = static_cast<size_t>(in.tellg());
+    }
+    ASSERT_EQ(truncate(log_path.c_str(), static_cast<off_t>(full_size - 10)), 0);
+
+    ReplayEngine::Config unchecked;
+    unchecked.verify_crc = false;   // Not a CRC question: the frame is incomplete
+    ReplayEngine engine(unchecked);
+    engine.addConsumer(std::make_unique<ValidatorReplayConsumer>("v", DoubleEntryValidator::Config{}));
+    EXPECT_THROW(engine.run(log_path), TruncatedLogException);
+}
+
+TEST_F(ReplayEngineTest, OneScanFeedsEveryConfiguration) {
+    for (int i = 0; i < 3000; ++i) {
+        append(EventType::TRADE_CREATED, trade("t-" + std::to_string(i % 2500), 1 + i % 100, 100));
+        append(EventType::LEDGER_ENTRIES_GENERATED,
+               R"({"trade_id":"t","entries":[{"account_id":"A","entry_type":"DEBIT","amount":5.00},)"
+               R"({"account_id":"B","entry_type":"CREDIT","amount":5.00}]})");
+    }
+
+    ReplayEngine::Config config;
+    config.batch_size = 100;  // Many batches through the 64-slot rings
+    ReplayEngine engine(config);
+    engine.addConsumer(std::make_unique<ValidatorReplayConsumer>("baseline",
+                                                                 DoubleEntryValidator::Config{}));
+    DoubleEntryValidator::Config strict;
+    strict.max_notional = 5000 * FixedPoint::SCALE;
+    strict.detect_duplicates = false;
+    engine.addConsumer(std::make_unique<ValidatorReplayConsumer>("strict", strict));
+    engine.addConsumer(std::make_unique<BalanceBookReplayConsumer>("book"));
+
+    ReplayEngine::Stats stats = engine.run(log_path);
+    EXPECT_EQ(stats.events, 6000u);
+    EXPECT_EQ(stats.batches, 60u);
+    ASSERT_EQ(stats.consumers.size(), 3u);
+    for (const auto& consumer : stats.consumers) {
+        EXPECT_EQ(consumer.batches, 60u);
+        EXPECT_TRUE(consumer.error.empty());
+    }
+
+    auto& baseline = static_cast<ValidatorReplayConsumer&>(*engine.consumers()[0]);
+    EXPECT_EQ(baseline.verdictCount(VerdictCode::PASSED), 2500u);
+    EXPECT_EQ(baseline.ruleCount(ValidationRule::DUPLICATE_TRADE), 500u);
+    EXPECT_EQ(baseline.verdictCount(VerdictCode::SKIPPED), 3000u);
+
+    // quantity 51..100 at price 100 exceeds 5000
+    auto& limited = static_cast<ValidatorReplayConsumer&>(*engine.consumers()[1]);
+    EXPECT_EQ(limited.ruleCount(ValidationRule::NOTIONAL_LIMIT), 1500u);
+    EXPECT_EQ(limited.ruleCount(ValidationRule::DUPLICATE_TRADE), 0u);
+
+    auto& book = static_cast<BalanceBookReplayConsumer&>(*engine.consumers()[2]);
+    EXPECT_EQ(book.book().getStats().events_applied, 3000u);
+    EXPECT_EQ(book.book().totalDebits(), 15000 * FixedPoint::SCALE);
+}
+
+TEST_F(ReplayEngineTest, FailedConsumerDoesNotStopOthers) {
+    for (int i = 0; i < 500; ++i) {
+        append(EventType::TRADE_CREATED, trade("t-" + std::to_string(i), 1, 1));
+    }
+
+    ReplayEngine::Config config;
+    config.batch_size = 1;  // More batches than ring slots: the failed consumer must keep draining
+    ReplayEngine engine(config);
+    engine.addConsumer(std::make_unique<ThrowingConsumer>());
+    engine.addConsumer(std::make_unique<ValidatorReplayConsumer>("ok", DoubleEntryValidator::Config{}));
+
+    ReplayEngine::Stats stats = engine.run(log_path);
+    EXPECT_EQ(stats.consumers[0].error, "rule crashed");
+    EXPECT_EQ(stats.consumers[0].batches, 1u);
+    auto& ok = static_cast<ValidatorReplayConsumer&>(*engine.consumers()[1]);
+    EXPECT_EQ(ok.verdictCount(VerdictCode::PASSED), 500u);
+}
+
+TEST_F(ReplayEngineTest, CorruptedFrameAbortsReplay) {
+    append(EventType::TRADE_CREATED, trade("t-1", 1, 1));
+    {
+        std::fstream file(log_path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-10, std::ios::end);
+        file.put('#');
+    }
+
+    ReplayEngine engine;
+    engine.addConsumer(std::make_unique<ValidatorReplayConsumer>("v", DoubleEntryValidator::Config{}));
+    EXPECT_THROW(engine.run(log_path), CorruptedEventException);
+
+    ReplayEngine::Config unchecked;
+    unchecked.verify_crc = false;
+    ReplayEngine lenient(unchecked);
+    EXPECT_EQ(lenient.run(log_path).events, 1u);
+}
@@ -1,9 +1,12 @@
 #include "RingBuffer.h"
+#include "NotifyingRingBuffer.h"
+#include <sys/epoll.h>
 #include <gtest/gtest.h>
 #include <thread>
 #include <vector>
 #include <numeric>
 #include <chrono>
+#include <stdexcept>
 
 using namespace trading_ledger;
 
@@ -311,7 +314,6 @@ TEST(RingBufferStaticTest, PowerOfTwoEnforcement) {
     // These should NOT compile (uncomment to verify):
     // RingBuffer<int, 3> buf3;    // static_assert failure
     // RingBuffer<int, 5> buf5;    // static_assert failure
-    // RingBuffer<int, 0> buf0;    // static_assert failure
 
     SUCCEED();
 }
@@ -356,3 +358,170 @@ TEST_F(RingBufferTest, ExactlyCapacityItems) {
     int item;
     EXPECT_FALSE(buffer.try_pop(item));
 }
+
+// Runtime-sized rings (SIZE == DYNAMIC_RING_SIZE)
+
+TEST(RingBufferDynamicTest, SizedAtConstruction) {
+    RingBuffer<int, DYNAMIC_RING_SIZE> ring(8);
+    EXPECT_EQ(ring.capacity(), 7u);
+
+    // Wrap several times
+    for (int round = 0; round < 5; ++round) {
+        for (int i = 0; i < 7; ++i) {
+            EXPECT_TRUE(ring.try_push(round * 10 + i));
+        }
+        EXPECT_FALSE(ring.try_push(-1));
+        EXPECT_EQ(ring.size(), 7u);
+        for (int i = 0; i < 7; ++i) {
+            int item;
+            ASSERT_TRUE(ring.try_pop(item));
+            EXPECT_EQ(item, round * 10 + i);
+        }
+        EXPECT_TRUE(ring.empty());
+    }
+
+    EXPECT_THROW((RingBuffer<int, DYNAMIC_RING_SIZE>(0)), std::invalid_argument);
+    EXPECT_THROW((RingBuffer<int, DYNAMIC_RING_SIZE>(1)), std::invalid_argument);
+    EXPECT_THROW((RingBuffer<int, DYNAMIC_RING_SIZE>(12)), std::invalid_argument);
+}
+
+TEST(RingBufferDynamicTest, NotifyingRingSizedAtConstruction) {
+    NotifyingRingBuffer<int, DYNAMIC_RING_SIZE> ring(4);
+    EXPECT_EQ(ring.capacity(), 3u);
+    EXPECT_TRUE(ring.prepareWait());
+    EXPECT_TRUE(ring.try_push(1));
+    int item;
+    ring.finishWait();
+    ASSERT_TRUE(ring.try_pop(item));
+    EXPECT_EQ(item, 1);
+}
+
+// NotifyingRingBuffer tests
+
+namespace {
+
+// Non-blocking check whether the eventfd currently polls readable
+bool fdReadable(int fd) {
+    struct pollfd pfd = {fd, POLLIN, 0};
+    return poll(&pfd, 1, 0) == 1;
+}
+
+}  // namespace
+
+TEST(NotifyingRingBufferTest, NoSignalWhenConsumerNotArmed) {
+    NotifyingRingBuffer<int, 8> ring;
+
+    // Busy consumer: pushes must not touch the eventfd
+    EXPECT_TRUE(ring.try_push(1));
+    EXPECT_TRUE(ring.try_push(2));
+    EXPECT_FALSE(fdReadable(ring.fd()));
+}
+
+TEST(NotifyingRingBufferTest, SignalsOnceWhenArmed) {
+    NotifyingRingBuffer<int, 8> ring;
+
+    ASSERT_TRUE(ring.prepareWait());  // Empty: consumer may sleep
+    EXPECT_TRUE(ring.try_push(1));
+    EXPECT_TRUE(fdReadable(ring.fd()));
+
+    ring.finishWait();
+    EXPECT_FALSE(fdReadable(ring.fd()));
+
+    // Subsequent pushes without re-arming stay silent
+    EXPECT_TRUE(ring.try_push(2));
+    EXPECT_FALSE(fdReadable(ring.fd()));
+}
+
+TEST(NotifyingRingBufferTest, PrepareWaitFailsWhenNotEmpty) {
+    NotifyingRingBuffer<int, 8> ring;
+    ring.try_push(1);
+
+    EXPECT_FALSE(ring.prepareWait());
+}
+
+TEST(NotifyingRingBufferTest, ConsumerWakesInEpoll) {
+    NotifyingRingBuffer<int, 1024> ring;
+    constexpr int NUM_ITEMS = 10000;
+
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    ASSERT_GE(epfd, 0);
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = ring.fd();
+    ASSERT_EQ(epoll_ctl(epfd, EPOLL_CTL_ADD, ring.fd(), &ev), 0);
+
+    std::thread producer([&]() {
+        for (int i = 0; i < NUM_ITEMS; ++i) {
+            while (!ring.try_push(i)) {
+                std::this_thread::yield();
+            }
+            if (i % 1000 == 0) {
+                // Let the consumer go to sleep now and then
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    });
+
+    int expected = 0;
+    while (expected < NUM_ITEMS) {
+        int item;
+        if (ring.try_pop(item)) {
+            ASSERT_EQ(item, expected++);
+        } else if (ring.prepareWait()) {
+            struct epoll_event out;
+            int n = epoll_wait(epfd, &out, 1, 5000);
+            ring.finishWait();
+            ASSERT_GE(n, 0);
+        }
+    }
+
+    producer.join();
+    close(epfd);
+    EXPECT_EQ(expected, NUM_ITEMS);
+}
+
+TEST(NotifyingRingBufferTest, PopSignalsProducerWaitingForSpace) {
+    NotifyingRingBuffer<int, 4> ring;
+    EXPECT_FALSE(ring.prepareSpaceWait());  // Not full: producer must not sleep
+
+    while (ring.try_push(0)) {}
+    ASSERT_TRUE(ring.prepareSpaceWait());
+    int item;
+    ASSERT_TRUE(ring.try_pop(item));
+    EXPECT_TRUE(fdReadable(ring.spaceFd()));
+
+    ring.finishSpaceWait();
+    EXPECT_FALSE(fdReadable(ring.spaceFd()));
+    ASSERT_TRUE(ring.try_pop(item));
+    EXPECT_FALSE(fdReadable(ring.spaceFd()));  // Not re-armed
+}
+
+TEST(NotifyingRingBufferTest, ProducerBlocksUntilSpace) {
+    NotifyingRingBuffer<int, 8> ring;
+    constexpr int NUM_ITEMS = 10000;
+
+    std::thread producer([&]() {
+        for (int i = 0; i < NUM_ITEMS; ++i) {
+            while (!ring.try_push(i)) {
+                ring.waitForSpace(5000);
+            }
+        }
+    });
+
+    int expected = 0;
+    while (expected < NUM_ITEMS) {
+        int item;
+        if (ring.try_pop(item)) {
+            ASSERT_EQ(item, expected++);
+            if (expected % 1000 == 0) {
+                // Let the producer go to sleep on the full ring now and then
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        } else {
+            ring.wait(5000);
+        }
+    }
+
+    producer.join();
+    EXPECT_EQ(expected, NUM_ITEMS);
+}
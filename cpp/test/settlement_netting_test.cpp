@@ -0,0 +1,183 @@
+#include "SettlementNetting.h"
+#include "EventFrames.h"
+#include "FixedPoint.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+using namespace trading_ledger;
+using namespace trading_ledger::test;
+
+namespace {
+
+std::string trade(const std::string& account, const std::string& symbol, const std::string& side,
+                  const std::string& quantity, const std::string& price,
+                  const std::string& currency = "") {
+    std::string payload = R"({"trade_id":"t","account_id":")" + account + R"(","symbol":")" + symbol +
+                          R"(","quantity":)" + quantity + R"(,"price":)" + price +
+                          R"(,"side":")" + side + "\"";
+    if (!currency.empty()) {
+        payload += R"(,"currency":")" + currency + "\"";
+    }
+    return payload + "}";
+}
+
+}  // namespace
+
+class SettlementNettingTest : public ::testing::Test {
+protected:
+    std::string log_path = "/tmp/test_settlement_log.bin";
+    std::string output_path = "/tmp/test_settlement.csv";
+    uint64_t next_seq = 1;
+
+    void SetUp() override {
+        createLog(log_path);
+    }
+
+    void TearDown() override {
+        std::remove(log_path.c_str());
+        std::remove(output_path.c_str());
+    }
+
+    void append(EventType type, const std::string& payload) {
+        std::ofstream file(log_path, std::ios::binary | std::ios::app);
+        auto frame = frameEvent(next_seq++, type, payload);
+        file.write(reinterpret_cast<const char*>(frame.data()), frame.size());
+    }
+};
+
+TEST_F(SettlementNettingTest, NetsPerAccountSymbolCurrency) {
+    append(EventType::TRADE_CREATED, trade("ACC1", "AAPL", "BUY", "100", "150.25"));
+    append(EventType::TRADE_CREATED, trade("ACC1", "AAPL", "SELL", "40", "151.00"));
+    append(EventType::TRADE_CREATED, trade("ACC1", "MSFT", "BUY", "10", "300", "EUR"));
+    append(EventType::LEDGER_ENTRIES_GENERATED, R"({"trade_id":"t","entries":[]})");  // Ignored
+    append(EventType::TRADE_CREATED, trade("ACC2", "AAPL", "SELL", "5", "150"));
+    append(EventType::TRADE_CREATED, R"({"trade_id":"bad","symbol":"AAPL"})");          // Skipped
+
+    SettlementNetting netting;
+    auto obligations = netting.run(log_path);
+
+    ASSERT_EQ(obligations.size(), 3u);
+
+    const auto& aapl = obligations[0];
+    EXPECT_EQ(aapl.account_id, "ACC1");
+    EXPECT_EQ(aapl.symbol, "AAPL");
+    EXPECT_EQ(aapl.currency, "USD");
+    EXPECT_EQ(aapl.position.net_quantity, 60 * FixedPoint::SCALE);
+    EXPECT_EQ(aapl.position.buy_quantity, 100 * FixedPoint::SCALE);
+    EXPECT_EQ(aapl.position.sell_quantity, 40 * FixedPoint::SCALE);
+    EXPECT_EQ(aapl.position.trade_count, 2u);
+    // Pays 15025.00, receives 6040.00
+    EXPECT_EQ(SettlementNetting::formatAmount(aapl.position.net_cash), "-8985.00000000");
+
+    EXPECT_EQ(obligations[1].symbol, "MSFT");
+    EXPECT_EQ(obligations[1].currency, "EUR");
+
+    EXPECT_EQ(obligations[2].account_id, "ACC2");
+    EXPECT_EQ(SettlementNetting::formatAmount(obligations[2].position.net_cash), "750.00000000");
+
+    auto stats = netting.getStats();
+    EXPECT_EQ(stats.events_scanned, 6u);
+    EXPECT_EQ(stats.trades_netted, 4u);
+    EXPECT_EQ(stats.trades_skipped, 1u);
+}
+
+TEST_F(SettlementNettingTest, ParallelResultMatchesSingleThread) {
+    const char* accounts[] = {"ACC1", "ACC2", "ACC3", "ACC4", "ACC5"};
+    const char* symbols[] = {"AAPL", "MSFT", "GOOG"};
+    for (int i = 0; i < 5000; ++i) {
+        append(EventType::TRADE_CREATED,
+               trade(accounts[i % 5], symbols[i % 3], (i % 7 < 4) ? "BUY" : "SELL",
+                     std::to_string(1 + i % 13), std::to_string(100 + i % 50) + ".125"));
+    }
+
+    SettlementNetting::Config single;
+    single.thread_count = 1;
+    SettlementNetting::Config parallel;
+    parallel.thread_count = 4;
+    parallel.batch_size = 64;  // Small batches: several threads and batches each
+
+    std::ostringstream expected;
+    std::ostringstream actual;
+    SettlementNetting one(single);
+    SettlementNetting::writeCsv(one.run(log_path), expected);
+    SettlementNetting many(parallel);
+    SettlementNetting::writeCsv(many.run(log_path), actual);
+
+    EXPECT_EQ(many.getStats().threads, 4u);
+    EXPECT_EQ(many.getStats().trades_netted, 5000u);
+    EXPECT_EQ(actual.str(), expected.str());
+}
+
+TEST_F(SettlementNettingTest, CorruptedTradeAbortsRun) {
+    append(EventType::TRADE_CREATED, trade("ACC1", "AAPL", "BUY", "1", "1"));
+    {
+        std::fstream file(log_path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-10, std::ios::end);
+        file.put('#');
+    }
+
+    SettlementNetting netting;
+    EXPECT_THROW(netting.run(log_path), CorruptedEventException);
+
+    SettlementNetting::Config unchecked;
+    unchecked.verify_crc = false;
+    SettlementNetting lenient(unchecked);
+    EXPECT_NO_THROW(lenient.run(log_path));
+}
+
+TEST_F(SettlementNettingTest, CorruptedNonTradeFrameAbortsRun) {
+    append(EventType::TRADE_CREATED, trade("ACC1", "AAPL", "BUY", "1", "1"));
+    append(EventType::LEDGER_ENTRIES_GENERATED, R"({"entries":[]})");
+    append(EventType::TRADE_CREATED, trade("ACC1", "AAPL", "BUY", "1", "1"));
+    {
+        std::fstream file(log_path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(16 + 2 * 28 + static_cast<long>(trade("ACC1", "AAPL", "BUY", "1", "1").size()) + 5);
+        file.put('#');   // Inside the ledger entries payload
+    }
+
+    SettlementNetting netting;
+    EXPECT_THROW(netting.run(log_path), CorruptedEventException);
+}
+
+TEST_F(SettlementNettingTest, TruncatedTailIsReported) {
+    append(EventType::TRADE_CREATED, trade("ACC1", "AAPL", "BUY", "1", "1"));
+    append(EventType::TRADE_CREATED, trade("ACC1", "AAPL", "BUY", "2", "1"));
+    size_t full_size = 0;
+    {
+        std::ifstream in(log_path, std::ios::binary | std::ios::ate);
+        full_size = static_cast<size_t>(in.tellg());
+    }
+    ASSERT_EQ(truncate(log_path.c_str(), static_cast<off_t>(full_size - 10)), 0);
+
+    SettlementNetting strict;
+    EXPECT_THROW(strict.run(log_path), TruncatedLogException);
+
+    SettlementNetting::Config live;
+    live.allow_truncated_tail = true;
+    SettlementNetting lenient(live);
+    auto obligations = lenient.run(log_path);
+    ASSERT_EQ(obligations.size(), 1u);
+    EXPECT_EQ(obligations[0].position.net_quantity, 1 * FixedPoint::SCALE);
+    auto stats = lenient.getStats();
+    EXPECT_EQ(stats.events_scanned, 1u);
+    EXPECT_EQ(stats.truncated_bytes, full_size - 10 - stats.truncated_offset);
+    EXPECT_GT(stats.truncated_offset, 16u);
+}
+
+TEST_F(SettlementNettingTest, WritesSettlementFile) {
+    append(EventType::TRADE_CREATED, trade("ACC1", "AAPL", "BUY", "2", "10.5"));
+
+    SettlementNetting netting;
+    SettlementNetting::writeFile(netting.run(log_path), output_path);
+
+    std::ifstream in(output_path);
+    std::string header;
+    std::string row;
+    std::getline(in, header);
+    std::getline(in, row);
+    EXPECT_EQ(header, "account_id,symbol,currency,net_quantity,net_cash,buy_quantity,sell_quantity,trade_count");
+    EXPECT_EQ(row, "ACC1,AAPL,USD,2.00000000,-21.00000000,2.00000000,0.00000000,1");
+}
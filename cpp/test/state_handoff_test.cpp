@@ -0,0 +1,166 @@
+#include "StateHandoff.h"
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+using namespace trading_ledger;
+
+class StateHandoffTest : public ::testing::Test {
+protected:
+    std::string socket_path = "/tmp/test_state_handoff.sock";
+    std::string log_path = "/tmp/test_state_handoff.log";
+
+    void SetUp() override {
+        std::ofstream file(log_path, std::ios::binary);
+        file << "log bytes";
+    }
+    void TearDown() override {
+        std::remove(socket_path.c_str());
+        std::remove(log_path.c_str());
+    }
+};
+
+TEST_F(StateHandoffTest, PassesStateAndLogDescriptor) {
+    std::atomic<int> requests{0};
+    StateHandoffServer server(socket_path, [&requests] { requests++; });
+    server.start();
+    EXPECT_FALSE(server.requested());
+
+    std::vector<uint8_t> image(100000);
+    for (size_t i = 0; i < image.size(); ++i) {
+        image[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    // The successor blocks until the state arrives
+    std::unique_ptr<StateTakeover> takeover;
+    std::thread successor([&] {
+        takeover = std::make_unique<StateTakeover>(socket_path, std::chrono::seconds(5));
+    });
+    while (!server.requested()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(requests.load(), 1);
+
+    int log_fd = ::open(log_path.c_str(), O_RDONLY);
+    ASSERT_GE(log_fd, 0);
+    std::thread sender([&] {
+        server.send({42, 16, log_fd, 1234}, image, std::chrono::seconds(5));
+    });
+    successor.join();
+
+    ASSERT_NE(takeover, nullptr);
+    EXPECT_EQ(takeover->sequence(), 42u);
+    EXPECT_EQ(takeover->logOffset(), 16u);
+    EXPECT_EQ(takeover->pausedNs(), 1234);
+    ASSERT_EQ(takeover->imageSize(), image.size());
+    EXPECT_EQ(std::memcmp(takeover->image(), image.data(), image.size()), 0);
+
+    // Same open file, not just the same path
+    int received = takeover->releaseLogFd();
+    struct stat ours;
+    struct stat theirs;
+    ASSERT_EQ(fstat(log_fd, &ours), 0);
+    ASSERT_EQ(fstat(received, &theirs), 0);
+    EXPECT_EQ(ours.st_ino, theirs.st_ino);
+    EXPECT_EQ(takeover->releaseLogFd(), -1);
+
+    takeover->acknowledge(std::chrono::seconds(5));   // Returns on the confirmation
+    sender.join();
+    EXPECT_EQ(takeover->image(), nullptr);
+    ::close(received);
+    ::close(log_fd);
+
+    // A successor binding the same path keeps its socket when we stop
+    StateHandoffServer next(socket_path, {});
+    next.start();
+    server.stop();
+    EXPECT_EQ(access(socket_path.c_str(), F_OK), 0);
+    next.stop();
+    EXPECT_NE(access(socket_path.c_str(), F_OK), 0);
+}
+
+TEST_F(StateHandoffTest, FailuresAreReported) {
+    EXPECT_THROW(StateTakeover(socket_path, std::chrono::milliseconds(100)), std::runtime_error);
+
+    StateHandoffServer server(socket_path, {});
+    server.start();
+    EXPECT_THROW(server.send({1, 16, 0, 0}, {1}, std::chrono::milliseconds(10)), std::runtime_error);
+
+    // The predecessor stops without handing off: the successor sees EOF
+    std::thread stopper([&] {
+        while (!server.requested()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        server.stop();
+    });
+    EXPECT_THROW(StateTakeover(socket_path, std::chrono::seconds(5)), std::runtime_error);
+    stopper.join();
+}
+
+TEST_F(StateHandoffTest, MissingAckRollsBackAndRearms) {
+    StateHandoffServer server(socket_path, {});
+    server.start();
+    int log_fd = ::open(log_path.c_str(), O_RDONLY);
+    ASSERT_GE(log_fd, 0);
+    std::vector<uint8_t> image(64, 7);
+
+    // The successor loads the state too slowly: the predecessor gives up and
+    // the late acknowledgement is refused, so only the predecessor runs
+    std::unique_ptr<StateTakeover> slow;
+    std::thread successor([&] {
+        slow = std::make_unique<StateTakeover>(socket_path, std::chrono::seconds(5));
+    });
+    while (!server.requested()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_THROW(server.send({1, 16, log_fd, 0}, image, std::chrono::milliseconds(50)),
+                 std::runtime_error);
+    successor.join();
+    ASSERT_NE(slow, nullptr);
+    server.rearm();
+    EXPECT_FALSE(server.requested());
+    EXPECT_THROW(slow->acknowledge(std::chrono::seconds(5)), std::runtime_error);
+    slow.reset();
+
+    // A successor that hangs up before the state is sent also leaves the
+    // predecessor in charge
+    {
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+        ASSERT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        ASSERT_EQ(write(fd, "TAKEOVER\n", 9), 9);
+        while (!server.requested()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ::close(fd);
+    }
+    EXPECT_THROW(server.send({2, 16, log_fd, 0}, image, std::chrono::seconds(5)), std::runtime_error);
+    server.rearm();
+
+    // The next request is served normally
+    std::unique_ptr<StateTakeover> takeover;
+    std::thread next([&] {
+        takeover = std::make_unique<StateTakeover>(socket_path, std::chrono::seconds(5));
+        takeover->acknowledge(std::chrono::seconds(5));
+    });
+    while (!server.requested()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    server.send({3, 16, log_fd, 0}, image, std::chrono::seconds(5));
+    next.join();
+    EXPECT_EQ(takeover->sequence(), 3u);
+    ::close(takeover->releaseLogFd());
+    ::close(log_fd);
+}
@@ -0,0 +1,206 @@
+#include "TieredTradeTable.h"
+#include "DoubleEntryValidator.h"
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+using namespace trading_ledger;
+
+namespace {
+
+struct State {
+    uint64_t a = 0;
+    uint32_t b = 0;
+};
+
+std::vector<TradeKey> randomKeys(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<TradeKey> keys(count);
+    for (TradeKey& key : keys) {
+        key.hi = rng();
+        key.lo = rng() & ~TradeKey::INTERNED_MASK;
+    }
+    return keys;
+}
+
+bool fileExists(const std::string& path) {
+    return access(path.c_str(), F_OK) == 0;
+}
+
+}  // namespace
+
+TEST(ColdTradeStoreTest, PutTakeAcrossBlocks) {
+    std::string path = "/tmp/test_cold_store.bin";
+    std::vector<TradeKey> keys = randomKeys(1000, 1);
+    {
+        ColdTradeStore store(path, sizeof(uint64_t));
+        for (uint64_t i = 0; i < keys.size(); ++i) {
+            store.put(keys[i], &i);
+        }
+        EXPECT_EQ(store.size(), 1000u);
+        EXPECT_GT(store.stats().file_bytes, 0u);   // 62 full blocks written, 8 records pending
+
+        uint64_t value = 0;
+        EXPECT_TRUE(store.take(keys[7], &value));          // Written block
+        EXPECT_EQ(value, 7u);
+        EXPECT_TRUE(store.take(keys[999], &value));        // Pending block
+        EXPECT_EQ(value, 999u);
+        EXPECT_FALSE(store.take(keys[7], &value));         // Taken records are gone
+        EXPECT_FALSE(store.take(randomKeys(1, 99)[0], &value));
+        EXPECT_EQ(store.size(), 998u);
+
+        // Re-spilled after promotion: the new copy wins
+        uint64_t updated = 70;
+        store.put(keys[7], &updated);
+        size_t visited = 0;
+        store.forEach([&](const TradeKey& key, const void* bytes) {
+            uint64_t v;
+            std::memcpy(&v, bytes, sizeof(v));
+            size_t index = std::find(keys.begin(), keys.end(), key) - keys.begin();
+            EXPECT_NE(index, 999u);
+            EXPECT_EQ(v, index == 7 ? 70u : index);
+            visited++;
+        });
+        EXPECT_EQ(visited, 999u);
+        EXPECT_TRUE(store.take(keys[7], &value));
+        EXPECT_EQ(value, 70u);
+        EXPECT_TRUE(fileExists(path));
+    }
+    EXPECT_FALSE(fileExists(path));   // Scratch file removed
+    EXPECT_THROW(ColdTradeStore("/nonexistent-dir/cold.bin", 8), std::runtime_error);
+}
+
+TEST(ColdTradeStoreTest, CompactionBoundsFileUnderChurn) {
+    std::string path = "/tmp/test_cold_store_churn.bin";
+    std::vector<TradeKey> keys = randomKeys(10000, 4);
+    std::vector<uint64_t> expected(keys.size());
+    ColdTradeStore store(path, sizeof(uint64_t));
+    for (uint64_t i = 0; i < keys.size(); ++i) {
+        expected[i] = i;
+        store.put(keys[i], &expected[i]);
+    }
+    uint64_t filled_bytes = store.stats().file_bytes;
+
+    // Promote half the records and spill them back, over and over: without
+    // compaction every round would append another half file of dead records
+    std::mt19937_64 rng(5);
+    for (int round = 0; round < 20; ++round) {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (rng() % 2 != 0) {
+                continue;
+            }
+            uint64_t value = 0;
+            ASSERT_TRUE(store.take(keys[i], &value));
+            EXPECT_EQ(value, expected[i]);
+            expected[i] += keys.size();
+            store.put(keys[i], &expected[i]);
+        }
+        EXPECT_LE(store.stats().file_bytes, filled_bytes * 3);
+    }
+    ColdTradeStore::Stats stats = store.stats();
+    EXPECT_GT(stats.compactions, 0u);
+    EXPECT_LE(stats.dead_records * 2, stats.records + stats.dead_records + ColdTradeStore::COMPACT_MIN_DEAD);
+    EXPECT_EQ(store.size(), keys.size());
+
+    size_t visited = 0;
+    store.forEach([&](const TradeKey& key, const void* bytes) {
+        uint64_t v;
+        std::memcpy(&v, bytes, sizeof(v));
+        size_t index = std::find(keys.begin(), keys.end(), key) - keys.begin();
+        ASSERT_LT(index, keys.size());
+        EXPECT_EQ(v, expected[index]);
+        visited++;
+    });
+    EXPECT_EQ(visited, keys.size());
+    for (size_t i = 0; i < keys.size(); i += 97) {
+        uint64_t value = 0;
+        EXPECT_TRUE(store.take(keys[i], &value));
+        EXPECT_EQ(value, expected[i]);
+    }
+    EXPECT_FALSE(fileExists(path + ".compact"));
+}
+
+TEST(TieredTradeTableTest, SpillsAndPromotesTransparently) {
+    TieredTradeTable<State> table;
+    table.enableColdTier("/tmp/test_tiered_table.bin", 1000);
+    std::unordered_map<TradeKey, uint64_t, TradeKeyHash> reference;
+    std::vector<TradeKey> keys = randomKeys(20000, 2);
+
+    for (uint64_t i = 0; i < keys.size(); ++i) {
+        table.upsert(keys[i]).a = i;
+        reference[keys[i]] = i;
+    }
+    TradeTierStats stats = table.stats();
+    EXPECT_EQ(table.size(), 20000u);
+    EXPECT_LE(stats.hot, 1000u);
+    EXPECT_EQ(stats.hot + stats.cold.records, 20000u);
+
+    // Touch a hot working set repeatedly while cold keys come back in batches
+    std::mt19937_64 rng(3);
+    for (int round = 0; round < 50; ++round) {
+        for (size_t i = 0; i < 100; ++i) {
+            table.upsert(keys[i]).b++;
+        }
+        std::vector<TradeKey> batch;
+        for (int i = 0; i < 40; ++i) {
+            batch.push_back(keys[rng() % keys.size()]);
+        }
+        batch.push_back(batch.front());   // Repeat within the batch
+        std::vector<State*> out(batch.size());
+        table.upsertBatch(batch.data(), batch.size(), out.data());
+        EXPECT_EQ(out.back(), out.front());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            EXPECT_EQ(out[i]->a, reference[batch[i]]);
+        }
+    }
+    EXPECT_EQ(table.size(), 20000u);
+    EXPECT_GT(table.stats().cold.promoted, 0u);
+
+    size_t visited = 0;
+    table.forEach([&](const TradeKey& key, const State& state) {
+        EXPECT_EQ(state.a, reference.at(key));
+        visited++;
+    });
+    EXPECT_EQ(visited, 20000u);
+    for (size_t i = 0; i < 100; ++i) {
+        EXPECT_EQ(table.upsert(keys[i]).b, 50u);   // Hot set kept its updates
+    }
+    EXPECT_THROW(TieredTradeTable<State>().enableColdTier("/tmp/unused.bin", 0), std::invalid_argument);
+}
+
+TEST(TieredTradeTableTest, ValidatorDetectsDuplicatesOfColdTrades) {
+    std::vector<std::string> payloads;
+    for (int i = 0; i < 5000; ++i) {
+        payloads.push_back(R"({"trade_id":"t-)" + std::to_string(i) + R"(","symbol":"AAPL","quantity":5})");
+    }
+    DoubleEntryValidator validator;
+    validator.setLogging(false);
+    validator.enableColdTier("/tmp/test_tiered_validator.bin", 256);
+
+    std::vector<EventView> views;
+    for (size_t i = 0; i < payloads.size(); ++i) {
+        views.push_back({i + 1, i, EventType::TRADE_CREATED, payloads[i], 0});
+    }
+    std::vector<Verdict> verdicts(views.size());
+    validator.processBatch(views.data(), views.size(), verdicts.data());
+    EXPECT_EQ(validator.getStats().trades_validated, 5000u);
+    EXPECT_EQ(validator.tradeCount(), 5000u);
+    EXPECT_GT(validator.tierStats().cold.records, 4000u);
+
+    // Replays of long-idle trades are still duplicates
+    EXPECT_EQ(validator.processEvent(views[0]).rule, ValidationRule::DUPLICATE_TRADE);
+    validator.processBatch(views.data() + 100, 32, verdicts.data());
+    for (size_t i = 0; i < 32; ++i) {
+        EXPECT_EQ(verdicts[i].rule, ValidationRule::DUPLICATE_TRADE) << i;
+    }
+    EXPECT_EQ(validator.getStats().duplicate_trades, 33u);
+
+    size_t created = 0;
+    validator.forEachCreatedTrade([&](const TradeKey&) { created++; });
+    EXPECT_EQ(created, 5000u);
+}
@@ -0,0 +1,163 @@
+#include "TradeBatchBuilder.h"
+#include "FixedPoint.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+using namespace trading_ledger;
+
+namespace {
+
+EventView makeEvent(uint64_t seq, EventType type, std::string_view payload) {
+    return EventView{seq, seq * 1000, type, payload, 0};
+}
+
+std::string_view stringAt(const ArrowArray* column, int64_t row) {
+    auto* offsets = static_cast<const int32_t*>(column->buffers[1]);
+    auto* bytes = static_cast<const char*>(column->buffers[2]);
+    return std::string_view(bytes + offsets[row], static_cast<size_t>(offsets[row + 1] - offsets[row]));
+}
+
+WideAmount decimalAt(const ArrowArray* column, int64_t row) {
+    auto* words = static_cast<const uint64_t*>(column->buffers[1]) + 2 * row;
+    return (static_cast<WideAmount>(words[1]) << 64) | words[0];
+}
+
+bool isValid(const ArrowArray* column, int64_t row) {
+    auto* bitmap = static_cast<const uint8_t*>(column->buffers[0]);
+    return bitmap == nullptr || (bitmap[row / 8] >> (row % 8)) & 1;
+}
+
+const std::string TRADE_1 =
+    R"({"trade_id":"T1","account_id":"ACC001","symbol":"AAPL","quantity":100,"price":150.25,"side":"BUY"})";
+const std::string TRADE_2 =
+    R"({"trade_id":"T2","account_id":"ACC002","symbol":"MSFT","quantity":0.5,"price":310,"side":"SELL"})";
+const std::string MALFORMED = R"({"trade_id":"T3","quantity":1})";
+const std::string LEDGER = R"({"trade_id":"T1","entries":[]})";
+
+}  // namespace
+
+TEST(TradeBatchBuilderTest, ColumnsHoldDecodedFields) {
+    std::string payloads[] = {TRADE_1, LEDGER, TRADE_2};
+    EventView events[] = {
+        makeEvent(1, EventType::TRADE_CREATED, payloads[0]),
+        makeEvent(2, EventType::LEDGER_ENTRIES_GENERATED, payloads[1]),
+        makeEvent(3, EventType::TRADE_CREATED, payloads[2]),
+    };
+    TradeBatchBuilder builder;
+    builder.append(events, 3);
+    EXPECT_EQ(builder.rows(), 2u);
+
+    ArrowArray array;
+    ArrowSchema schema;
+    builder.finish(&array, &schema);
+    EXPECT_EQ(builder.rows(), 0u);   // Next batch starts empty
+
+    // The batch no longer refers to the payloads
+    for (std::string& payload : payloads) {
+        std::memset(payload.data(), 'x', payload.size());
+    }
+
+    ASSERT_EQ(array.length, 2);
+    ASSERT_EQ(array.n_children, static_cast<int64_t>(TradeBatchBuilder::COLUMNS));
+    EXPECT_STREQ(schema.format, "+s");
+    EXPECT_STREQ(schema.children[0]->format, "L");
+    EXPECT_STREQ(schema.children[9]->name, "notional");
+    EXPECT_STREQ(schema.children[9]->format, "d:38,8");
+    EXPECT_EQ(schema.children[0]->flags, 0);
+    EXPECT_EQ(schema.children[3]->flags, ARROW_FLAG_NULLABLE);
+
+    auto* sequence = static_cast<const uint64_t*>(array.children[0]->buffers[1]);
+    EXPECT_EQ(sequence[0], 1u);
+    EXPECT_EQ(sequence[1], 3u);
+    auto* timestamp = static_cast<const int64_t*>(array.children[1]->buffers[1]);
+    EXPECT_EQ(timestamp[1], 3000);
+    EXPECT_EQ(stringAt(array.children[2], 1), "T2");
+    EXPECT_EQ(stringAt(array.children[3], 0), "ACC001");
+    EXPECT_EQ(stringAt(array.children[4], 1), "MSFT");
+    EXPECT_EQ(stringAt(array.children[5], 0), "BUY");
+    auto* direction = static_cast<const int8_t*>(array.children[6]->buffers[1]);
+    EXPECT_EQ(direction[0], 1);
+    EXPECT_EQ(direction[1], -1);
+    EXPECT_EQ(decimalAt(array.children[7], 1), FixedPoint::SCALE / 2);
+    EXPECT_EQ(decimalAt(array.children[8], 0), 15025 * FixedPoint::SCALE / 100);
+    EXPECT_EQ(decimalAt(array.children[9], 1), 155 * FixedPoint::SCALE);
+
+    // No nulls: no bitmaps
+    for (int64_t i = 0; i < array.n_children; ++i) {
+        EXPECT_EQ(array.children[i]->null_count, 0);
+        EXPECT_EQ(array.children[i]->buffers[0], nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(array.children[i]->buffers[1]) % 64, 0u);
+    }
+
+    array.release(&array);
+    schema.release(&schema);
+    EXPECT_EQ(array.release, nullptr);
+    EXPECT_EQ(schema.release, nullptr);
+}
+
+TEST(TradeBatchBuilderTest, UndecodablePayloadBecomesNullRow) {
+    TradeBatchBuilder builder(4);
+    // More than one bitmap byte
+    for (uint64_t seq = 1; seq <= 10; ++seq) {
+        builder.append(makeEvent(seq, EventType::TRADE_CREATED, seq == 9 ? MALFORMED : TRADE_1));
+    }
+    builder.append(makeEvent(11, EventType::TRADE_CREATED, R"({"symbol":"X"})"));
+    EXPECT_EQ(builder.malformed(), 2u);
+
+    ArrowArray array;
+    ArrowSchema schema;
+    builder.finish(&array, &schema);
+    ASSERT_EQ(array.length, 11);
+
+    const ArrowArray* trade_id = array.children[2];
+    EXPECT_EQ(trade_id->null_count, 1);
+    EXPECT_EQ(stringAt(trade_id, 8), "T3");   // Recovered without a full decode
+    EXPECT_FALSE(isValid(trade_id, 10));
+
+    for (int64_t column = 3; column < array.n_children; ++column) {
+        const ArrowArray* child = array.children[column];
+        EXPECT_EQ(child->null_count, 2);
+        EXPECT_TRUE(isValid(child, 0));
+        EXPECT_FALSE(isValid(child, 8));
+        EXPECT_TRUE(isValid(child, 9));
+        EXPECT_FALSE(isValid(child, 10));
+    }
+    EXPECT_EQ(stringAt(array.children[4], 8), "");
+    EXPECT_EQ(decimalAt(array.children[7], 8), 0);
+    EXPECT_EQ(decimalAt(array.children[7], 9), 100 * FixedPoint::SCALE);
+
+    array.release(&array);
+    schema.release(&schema);
+}
+
+TEST(TradeBatchBuilderTest, ChildOutlivesReleasedParent) {
+    TradeBatchBuilder builder;
+    builder.append(makeEvent(1, EventType::TRADE_CREATED, TRADE_1));
+    ArrowArray array;
+    ArrowSchema schema;
+    builder.finish(&array, &schema);
+
+    // Move the symbol column out, as a consumer keeping one column would
+    ArrowArray symbol = *array.children[4];
+    array.children[4]->release = nullptr;
+    array.release(&array);
+    schema.release(&schema);
+
+    EXPECT_EQ(stringAt(&symbol, 0), "AAPL");
+    symbol.release(&symbol);
+    EXPECT_EQ(symbol.release, nullptr);
+}
+
+TEST(TradeBatchBuilderTest, EmptyBatchExports) {
+    TradeBatchBuilder builder;
+    ArrowArray array;
+    ArrowSchema schema;
+    builder.finish(&array, &schema);
+    EXPECT_EQ(array.length, 0);
+    auto* offsets = static_cast<const int32_t*>(array.children[3]->buffers[1]);
+    EXPECT_EQ(offsets[0], 0);
+    array.release(&array);
+    schema.release(&schema);
+}
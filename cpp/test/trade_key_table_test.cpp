@@ -0,0 +1,167 @@
+#include "TradeKeyTable.h"
+#include "DoubleEntryValidator.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+using namespace trading_ledger;
+
+namespace {
+
+std::vector<TradeKey> randomKeys(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<TradeKey> keys(count);
+    for (TradeKey& key : keys) {
+        key.hi = rng();
+        key.lo = rng() & ~TradeKey::INTERNED_MASK;   // Valid UUID variant
+    }
+    return keys;
+}
+
+EventView tradeView(uint64_t seq, const std::string& payload) {
+    EventView view{};
+    view.sequence_num = seq;
+    view.event_type = EventType::TRADE_CREATED;
+    view.payload = payload;
+    return view;
+}
+
+}  // namespace
+
+TEST(TradeKeyTableTest, MatchesUnorderedMapThroughGrowth) {
+    TradeKeyTable<int> table(16);
+    std::unordered_map<TradeKey, int, TradeKeyHash> reference;
+    std::vector<TradeKey> keys = randomKeys(5000, 1);
+
+    // Sequential interned keys cluster in the low bits: exercise them too
+    for (uint64_t i = 0; i < 5000; ++i) {
+        keys.push_back({0, TradeKey::INTERNED_TAG | i});
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+        table.upsert(keys[i]) += static_cast<int>(i);
+        reference[keys[i]] += static_cast<int>(i);
+    }
+    EXPECT_EQ(table.size(), reference.size());
+    EXPECT_LE(table.size() * 4, table.capacity() * 3);
+
+    for (const auto& [key, value] : reference) {
+        const int* found = table.find(key);
+        ASSERT_NE(found, nullptr);
+        EXPECT_EQ(*found, value);
+    }
+    EXPECT_EQ(table.find(randomKeys(1, 99)[0]), nullptr);
+    EXPECT_EQ(table.find(TradeKeyTable<int>::EMPTY_KEY), nullptr);
+    EXPECT_THROW(table.upsert(TradeKeyTable<int>::EMPTY_KEY), std::invalid_argument);
+
+    size_t visited = 0;
+    table.forEach([&](const TradeKey& key, int value) {
+        EXPECT_EQ(reference.at(key), value);
+        visited++;
+    });
+    EXPECT_EQ(visited, reference.size());
+}
+
+TEST(TradeKeyTableTest, EraseAndSweepKeepProbeChainsIntact) {
+    TradeKeyTable<int> table(64);
+    std::unordered_map<TradeKey, int, TradeKeyHash> reference;
+    std::vector<TradeKey> keys;
+    for (uint64_t i = 0; i < 3000; ++i) {
+        keys.push_back({0, TradeKey::INTERNED_TAG | i});   // Clustered homes: long chains
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+        table.upsert(keys[i]) = static_cast<int>(i);
+        reference[keys[i]] = static_cast<int>(i);
+    }
+    for (size_t i = 0; i < keys.size(); i += 3) {
+        EXPECT_TRUE(table.erase(keys[i]));
+        reference.erase(keys[i]);
+    }
+    EXPECT_FALSE(table.erase(keys[0]));
+
+    // Evict odd values, at most 100 per sweep, until a full pass finds none
+    size_t cursor = 0;
+    size_t erased;
+    do {
+        erased = table.sweep(cursor, table.capacity() - 1, 100, [&](const TradeKey& key, int& value) {
+            if (value % 2 == 0) {
+                return false;
+            }
+            reference.erase(key);
+            return true;
+        });
+        EXPECT_LE(erased, 100u);
+    } while (erased > 0);
+
+    EXPECT_EQ(table.size(), reference.size());
+    for (const TradeKey& key : keys) {
+        auto it = reference.find(key);
+        const int* found = table.find(key);
+        if (it == reference.end()) {
+            EXPECT_EQ(found, nullptr);
+        } else {
+            ASSERT_NE(found, nullptr);
+            EXPECT_EQ(*found, it->second);
+        }
+    }
+}
+
+TEST(TradeKeyTableTest, BatchedLookupsMatchSingleLookups) {
+    TradeKeyTable<int> table;
+    std::vector<TradeKey> keys = randomKeys(1000, 2);
+    keys.push_back(keys[3]);   // Repeat within the batch
+
+    std::vector<int*> out(keys.size());
+    table.upsertBatch(keys.data(), keys.size(), out.data());
+    EXPECT_EQ(table.size(), 1000u);
+    EXPECT_EQ(out.back(), out[3]);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        *out[i] += 1;
+    }
+    EXPECT_EQ(*table.find(keys[3]), 2);
+
+    std::vector<TradeKey> probes = {keys[0], randomKeys(1, 77)[0], keys[999]};
+    std::vector<int*> found(probes.size());
+    table.findBatch(probes.data(), probes.size(), found.data());
+    EXPECT_EQ(found[0], table.find(keys[0]));
+    EXPECT_EQ(found[1], nullptr);
+    EXPECT_EQ(found[2], table.find(keys[999]));
+
+    // A reserved key rejects the whole batch before anything is inserted
+    std::vector<TradeKey> bad = {randomKeys(1, 5)[0], TradeKeyTable<int>::EMPTY_KEY};
+    EXPECT_THROW(table.upsertBatch(bad.data(), bad.size(), out.data()), std::invalid_argument);
+    EXPECT_EQ(table.size(), 1000u);
+}
+
+TEST(TradeKeyTableTest, ValidatorBatchMatchesPerEventProcessing) {
+    std::vector<std::string> payloads;
+    for (int i = 0; i < 100; ++i) {
+        payloads.push_back(R"({"trade_id":"t-)" + std::to_string(i % 70) + R"(","symbol":"AAPL","quantity":5})");
+    }
+    payloads[10] = R"({"trade_id":"t-x","quantity":5})";   // Missing symbol
+    payloads[11] = "";
+    std::vector<EventView> views;
+    for (size_t i = 0; i < payloads.size(); ++i) {
+        views.push_back(tradeView(i + 1, payloads[i]));
+    }
+    views[50].event_type = EventType::LEDGER_ENTRIES_GENERATED;
+
+    DoubleEntryValidator single;
+    DoubleEntryValidator batched;
+    single.setLogging(false);
+    batched.setLogging(false);
+    std::vector<Verdict> verdicts(views.size());
+    batched.processBatch(views.data(), views.size(), verdicts.data());
+
+    for (size_t i = 0; i < views.size(); ++i) {
+        Verdict expected = single.processEvent(views[i]);
+        EXPECT_EQ(verdicts[i].code, expected.code) << i;
+        EXPECT_EQ(verdicts[i].rule, expected.rule) << i;
+    }
+    EXPECT_EQ(batched.getStats().events_processed, single.getStats().events_processed);
+    EXPECT_EQ(batched.getStats().trades_validated, single.getStats().trades_validated);
+    EXPECT_EQ(batched.getStats().duplicate_trades, single.getStats().duplicate_trades);
+    EXPECT_EQ(batched.getStats().validation_errors, single.getStats().validation_errors);
+    EXPECT_EQ(batched.tradeCount(), single.tradeCount());
+}
@@ -0,0 +1,86 @@
+#include "TradeKey.h"
+#include "JsonFields.h"
+#include <gtest/gtest.h>
+#include <unordered_set>
+
+using namespace trading_ledger;
+
+TEST(TradeKeyTest, DecodeUuid) {
+    TradeKey key;
+    ASSERT_TRUE(TradeKey::fromUuid("0123abcd-4567-89ef-8123-456789abcdef", key));
+
+    EXPECT_EQ(key.hi, 0x0123abcd456789efULL);
+    EXPECT_EQ(key.lo, 0x8123456789abcdefULL);
+    EXPECT_FALSE(key.isInterned());
+}
+
+TEST(TradeKeyTest, DecodeUppercaseUuid) {
+    TradeKey lower, upper;
+    ASSERT_TRUE(TradeKey::fromUuid("550e8400-e29b-41d4-a716-446655440000", lower));
+    ASSERT_TRUE(TradeKey::fromUuid("550E8400-E29B-41D4-A716-446655440000", upper));
+
+    EXPECT_EQ(lower, upper);
+}
+
+TEST(TradeKeyTest, RoundTripToString) {
+    const std::string uuid = "550e8400-e29b-41d4-a716-446655440000";
+    TradeKey key;
+    ASSERT_TRUE(TradeKey::fromUuid(uuid, key));
+
+    EXPECT_EQ(key.toUuidString(), uuid);
+}
+
+TEST(TradeKeyTest, RejectsMalformedUuid) {
+    TradeKey key;
+    EXPECT_FALSE(TradeKey::fromUuid("test-123", key));
+    EXPECT_FALSE(TradeKey::fromUuid("550e8400-e29b-41d4-a716-44665544000", key));   // Too short
+    EXPECT_FALSE(TradeKey::fromUuid("550e8400ae29b-41d4-a716-446655440000", key));  // Missing dash
+    EXPECT_FALSE(TradeKey::fromUuid("550e8400-e29b-41d4-a716-44665544000g", key));  // Bad hex
+    EXPECT_FALSE(TradeKey::fromUuid("550e8400-e29b-41d4-f716-446655440000", key));  // Reserved variant
+}
+
+TEST(TradeKeyTest, InternerFallbackForNonUuid) {
+    TradeKeyInterner interner;
+
+    TradeKey a = interner.resolve("test-123");
+    TradeKey b = interner.resolve("test-456");
+    TradeKey a_again = interner.resolve("test-123");
+
+    EXPECT_TRUE(a.isInterned());
+    EXPECT_EQ(a, a_again);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(interner.size(), 2);
+    EXPECT_EQ(interner.lookup(b), "test-456");
+}
+
+TEST(TradeKeyTest, InternerDecodesUuidWithoutInterning) {
+    TradeKeyInterner interner;
+
+    TradeKey key = interner.resolve("550e8400-e29b-41d4-a716-446655440000");
+
+    EXPECT_FALSE(key.isInterned());
+    EXPECT_EQ(interner.size(), 0);
+}
+
+TEST(TradeKeyTest, HashDistinguishesInternedKeys) {
+    TradeKeyInterner interner;
+    std::unordered_set<size_t> hashes;
+
+    for (int i = 0; i < 1000; ++i) {
+        hashes.insert(TradeKeyHash{}(interner.intern("id-" + std::to_string(i))));
+    }
+
+    EXPECT_EQ(hashes.size(), 1000);
+}
+
+TEST(JsonFieldsTest, FindStringAndNumber) {
+    const std::string json =
+        R"({"trade_id":"abc","account_id": "ACC1","quantity":100.5,"price":"12.25"})";
+
+    EXPECT_EQ(JsonFields::findString(json, "trade_id"), "abc");
+    EXPECT_EQ(JsonFields::findString(json, "account_id"), "ACC1");
+    EXPECT_EQ(JsonFields::findNumber(json, "quantity"), "100.5");
+    EXPECT_EQ(JsonFields::findNumber(json, "price"), "12.25");
+    EXPECT_FALSE(JsonFields::findString(json, "symbol").has_value());
+    EXPECT_FALSE(JsonFields::findString(json, "trade").has_value());  // Prefix must not match
+}
@@ -0,0 +1,206 @@
+#include "VerdictLogWriter.h"
+#include "VerdictLogReader.h"
+#include "DoubleEntryValidator.h"
+#include "EventParser.h"
+#include <gtest/gtest.h>
+#include <csignal>
+#include <fstream>
+#include <sys/resource.h>
+
+using namespace trading_ledger;
+
+class VerdictLogTest : public ::testing::Test {
+protected:
+    std::string test_file_path = "/tmp/test_verdict_log.bin";
+
+    void SetUp() override {
+        std::remove(test_file_path.c_str());
+    }
+
+    void TearDown() override {
+        std::remove(test_file_path.c_str());
+    }
+};
+
+TEST_F(VerdictLogTest, WriteAndReadBack) {
+    VerdictLogWriter writer(test_file_path);
+    writer.open();
+
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        VerdictRecord record;
+        record.sequence_num = i;
+        record.timestamp_ns = i * 10;
+        record.code = (i % 10 == 0) ? VerdictCode::FAILED : VerdictCode::PASSED;
+        record.rule = (i % 10 == 0) ? ValidationRule::MISSING_FIELDS : ValidationRule::NONE;
+        ASSERT_TRUE(writer.submit(record));
+    }
+    writer.close();
+
+    EXPECT_EQ(writer.written(), 1000);
+    EXPECT_EQ(writer.dropped(), 0);
+
+    VerdictLogReader reader(test_file_path);
+    reader.open();
+
+    VerdictRecord record;
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        ASSERT_TRUE(reader.readNext(record));
+        EXPECT_EQ(record.sequence_num, i);
+        EXPECT_EQ(record.timestamp_ns, i * 10);
+        if (i % 10 == 0) {
+            EXPECT_EQ(record.code, VerdictCode::FAILED);
+            EXPECT_EQ(record.rule, ValidationRule::MISSING_FIELDS);
+        }
+    }
+    EXPECT_FALSE(reader.readNext(record));
+    EXPECT_TRUE(reader.eof());
+}
+
+TEST_F(VerdictLogTest, TailFollowsGrowingLog) {
+    VerdictLogWriter writer(test_file_path);
+    writer.open();
+
+    VerdictRecord record;
+    record.sequence_num = 1;
+    writer.submit(record);
+    writer.close();
+
+    VerdictLogReader reader(test_file_path);
+    reader.open();
+    ASSERT_TRUE(reader.readNext(record));
+    EXPECT_FALSE(reader.readNext(record));
+
+    // Reopening appends without rewriting the header
+    VerdictLogWriter appender(test_file_path);
+    appender.open();
+    record.sequence_num = 2;
+    appender.submit(record);
+    appender.close();
+
+    EXPECT_TRUE(reader.remapIfGrown());
+    ASSERT_TRUE(reader.readNext(record));
+    EXPECT_EQ(record.sequence_num, 2);
+}
+
+TEST_F(VerdictLogTest, DetectsCorruptedRecord) {
+    VerdictLogWriter writer(test_file_path);
+    writer.open();
+    VerdictRecord record;
+    record.sequence_num = 7;
+    writer.submit(record);
+    writer.close();
+
+    // Flip a byte in the sequence number
+    std::fstream file(test_file_path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(VerdictFileHeader::SIZE);
+    file.put(0x55);
+    file.close();
+
+    VerdictLogReader reader(test_file_path);
+    reader.open();
+    EXPECT_THROW(reader.readNext(record), CorruptedEventException);
+}
+
+TEST(ValidatorVerdictTest, ReportsRuleForFailures) {
+    DoubleEntryValidator validator;
+
+    Event event;
+    event.sequence_num = 1;
+    event.event_type = EventType::TRADE_CREATED;
+    event.payload = R"({"trade_id":"t-1","symbol":"AAPL","quantity":100})";
+
+    Verdict verdict = validator.processEvent(event);
+    EXPECT_EQ(verdict.code, VerdictCode::PASSED);
+
+    verdict = validator.processEvent(event);
+    EXPECT_EQ(verdict.code, VerdictCode::FAILED);
+    EXPECT_EQ(verdict.rule, ValidationRule::DUPLICATE_TRADE);
+
+    event.payload = R"({"symbol":"AAPL"})";
+    verdict = validator.processEvent(event);
+    EXPECT_EQ(verdict.rule, ValidationRule::MISSING_FIELDS);
+
+    event.event_type = EventType::POSITION_UPDATED;
+    verdict = validator.processEvent(event);
+    EXPECT_EQ(verdict.code, VerdictCode::SKIPPED);
+}
+
+TEST_F(VerdictLogTest, FullRingAppliesBackpressure) {
+    VerdictLogWriter writer(test_file_path);
+    writer.open();
+
+    // Several rings' worth as fast as possible: nothing may be dropped
+    constexpr uint64_t COUNT = VerdictLogWriter::RING_SIZE * 3;
+    VerdictRecord record;
+    for (uint64_t i = 1; i <= COUNT; ++i) {
+        record.sequence_num = i;
+        ASSERT_TRUE(writer.submit(record));
+    }
+    writer.close();
+
+    EXPECT_EQ(writer.written(), COUNT);
+    EXPECT_EQ(writer.dropped(), 0);
+}
+
+TEST_F(VerdictLogTest, RejectsForeignFile) {
+    {
+        std::ofstream file(test_file_path, std::ios::binary);
+        file << "not a verdict log at all";
+    }
+    VerdictLogWriter writer(test_file_path);
+    EXPECT_THROW(writer.open(), std::runtime_error);
+}
+
+TEST_F(VerdictLogTest, ReopenCutsPartialTrailingRecord) {
+    VerdictLogWriter writer(test_file_path);
+    writer.open();
+    VerdictRecord record;
+    record.sequence_num = 1;
+    writer.submit(record);
+    writer.close();
+    {
+        std::ofstream file(test_file_path, std::ios::binary | std::ios::app);
+        file.write("\x01\x02\x03\x04\x05", 5);   // Torn append
+    }
+
+    VerdictLogWriter appender(test_file_path);
+    appender.open();
+    record.sequence_num = 2;
+    appender.submit(record);
+    appender.close();
+
+    VerdictLogReader reader(test_file_path);
+    reader.open();
+    ASSERT_TRUE(reader.readNext(record));
+    EXPECT_EQ(record.sequence_num, 1);
+    ASSERT_TRUE(reader.readNext(record));
+    EXPECT_EQ(record.sequence_num, 2);
+    EXPECT_FALSE(reader.readNext(record));
+}
+
+TEST_F(VerdictLogTest, WriterFailureIsReportedAndCounted) {
+    // Writes past the size limit fail with EFBIG instead of raising SIGXFSZ
+    struct rlimit saved;
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &saved), 0);
+    auto saved_handler = signal(SIGXFSZ, SIG_IGN);
+    struct rlimit limited = saved;
+    limited.rlim_cur = VerdictFileHeader::SIZE + 10 * VerdictRecord::SIZE;
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &limited), 0);
+
+    VerdictLogWriter writer(test_file_path);
+    writer.open();
+    VerdictRecord record;
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        record.sequence_num = i;
+        writer.submit(record);
+    }
+    writer.close();
+
+    setrlimit(RLIMIT_FSIZE, &saved);
+    signal(SIGXFSZ, saved_handler);
+
+    EXPECT_TRUE(writer.failed());
+    EXPECT_NE(writer.error().find("Failed to write verdict log"), std::string::npos);
+    EXPECT_EQ(writer.written() + writer.dropped(), 1000u);
+    EXPECT_GT(writer.dropped(), 0u);
+}